@@ -0,0 +1,407 @@
+#include "file_cache.h"
+
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <chrono>
+#include <system_error>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+#include "file_io.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+namespace {
+
+const std::size_t kSharedCacheMaxBytes = 8 * 1024 * 1024;
+const std::size_t kSharedCacheMaxEntries = 512;
+
+#if defined(__linux__)
+const unsigned int kDirectoryWatchMask =
+    IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+    IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+std::string WatchPathFor(const std::string& directory) {
+    return directory.empty() ? std::string(".") : directory;
+}
+
+// Symlinked files are reported so the caller can skip inotify: a watch on the link's
+// directory does not see writes to the target.
+bool StatFile(const fs::path& path, long long& mtime_ns, unsigned long long& size,
+              unsigned long long& inode, unsigned long long& device, bool& symlink_out) {
+#ifdef _WIN32
+    std::error_code error;
+    symlink_out = fs::is_symlink(path, error);
+    const unsigned long long file_size = fs::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    const fs::file_time_type write_time = fs::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(write_time.time_since_epoch()).count();
+    size = file_size;
+    inode = 0;
+    device = 0;
+    return true;
+#else
+    struct stat info;
+    if (lstat(path.string().c_str(), &info) != 0) {
+        return false;
+    }
+    symlink_out = S_ISLNK(info.st_mode);
+    if (symlink_out && stat(path.string().c_str(), &info) != 0) {
+        return false;
+    }
+#if defined(__linux__)
+    mtime_ns = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+    mtime_ns = static_cast<long long>(info.st_mtime) * 1000000000LL;
+#endif
+    size = static_cast<unsigned long long>(info.st_size);
+    inode = static_cast<unsigned long long>(info.st_ino);
+    device = static_cast<unsigned long long>(info.st_dev);
+    return true;
+#endif
+}
+
+}  // namespace
+
+FileContentCache::FileContentCache(std::size_t max_bytes, std::size_t max_entries)
+    : max_bytes_(max_bytes),
+      max_entries_(max_entries),
+      inotify_fd_(-1),
+      bytes_(0),
+      next_version_(0),
+      hits_(0),
+      misses_(0),
+      invalidations_(0),
+      evictions_(0) {
+#if defined(__linux__)
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileContentCache::~FileContentCache() {
+#ifndef _WIN32
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+    }
+#endif
+}
+
+bool FileContentCache::ReadText(
+    const fs::path& path,
+    std::shared_ptr<const std::string>& text_out,
+    unsigned long long& version_out) {
+    const std::string key = path.string();
+    const std::string directory = path.parent_path().string();
+    version_out = 0;
+
+    bool watched = false;
+    unsigned long long events_before = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DrainEventsLocked();
+
+        const std::unordered_map<std::string, Entry>::iterator iter = entries_.find(key);
+        if (iter != entries_.end()) {
+            bool valid = true;
+            if (!iter->second.watched) {
+                Validator current;
+                bool symlink = false;
+                valid = StatFile(path, current.mtime_ns, current.size, current.inode, current.device, symlink) &&
+                    current.mtime_ns == iter->second.validator.mtime_ns &&
+                    current.size == iter->second.validator.size &&
+                    current.inode == iter->second.validator.inode &&
+                    current.device == iter->second.validator.device;
+            }
+            if (valid) {
+                ++hits_;
+                lru_.splice(lru_.begin(), lru_, iter->second.lru_position);
+                text_out = iter->second.text;
+                version_out = iter->second.version;
+                return true;
+            }
+            ++invalidations_;
+            EraseLocked(key);
+        }
+
+        ++misses_;
+        // Watch before reading so a write racing the read is seen as an event.
+        watched = WatchDirectoryLocked(directory);
+        if (watched) {
+            events_before = watches_[directory].event_count;
+        }
+    }
+
+    Validator validator;
+    bool symlink = false;
+    const bool have_validator =
+        StatFile(path, validator.mtime_ns, validator.size, validator.inode, validator.device, symlink);
+    std::string text;
+    const bool read_ok = ReadTextFile(path, text);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!read_ok) {
+        if (watched) {
+            ReleaseDirectoryLocked(directory);
+        }
+        return false;
+    }
+
+    const std::shared_ptr<const std::string> shared_text = std::make_shared<const std::string>(std::move(text));
+    text_out = shared_text;
+
+    DrainEventsLocked();
+    bool cacheable = have_validator && shared_text->size() <= max_bytes_ / 4;
+    if (watched) {
+        const std::map<std::string, DirectoryWatch>::const_iterator watch = watches_.find(directory);
+        if (watch == watches_.end() || watch->second.event_count != events_before) {
+            cacheable = false;
+        }
+        if (!cacheable || symlink) {
+            ReleaseDirectoryLocked(directory);
+            watched = false;
+        }
+    }
+    if (!cacheable) {
+        return true;
+    }
+
+    if (entries_.find(key) != entries_.end()) {
+        EraseLocked(key);
+    }
+    lru_.push_front(key);
+    Entry& entry = entries_[key];
+    entry.text = shared_text;
+    entry.version = ++next_version_;
+    entry.validator = validator;
+    entry.watched = watched;
+    entry.directory = directory;
+    entry.derived.clear();
+    entry.derived_bytes = 0;
+    entry.lru_position = lru_.begin();
+    bytes_ += shared_text->size();
+    version_out = entry.version;
+    EvictLocked();
+    return true;
+}
+
+std::shared_ptr<const void> FileContentCache::FindDerived(
+    const fs::path& path,
+    const std::string& kind,
+    unsigned long long version) {
+    if (version == 0) {
+        return std::shared_ptr<const void>();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::unordered_map<std::string, Entry>::const_iterator iter = entries_.find(path.string());
+    if (iter == entries_.end() || iter->second.version != version) {
+        return std::shared_ptr<const void>();
+    }
+    const std::map<std::string, DerivedValue>::const_iterator derived = iter->second.derived.find(kind);
+    if (derived == iter->second.derived.end()) {
+        return std::shared_ptr<const void>();
+    }
+    return derived->second.value;
+}
+
+void FileContentCache::StoreDerived(
+    const fs::path& path,
+    const std::string& kind,
+    unsigned long long version,
+    const std::shared_ptr<const void>& value,
+    std::size_t estimated_bytes) {
+    if (version == 0 || estimated_bytes > max_bytes_ / 4) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::unordered_map<std::string, Entry>::iterator iter = entries_.find(path.string());
+    if (iter == entries_.end() || iter->second.version != version) {
+        return;
+    }
+    DerivedValue& derived = iter->second.derived[kind];
+    if (derived.value) {
+        bytes_ -= derived.bytes;
+        iter->second.derived_bytes -= derived.bytes;
+    }
+    derived.value = value;
+    derived.bytes = estimated_bytes;
+    bytes_ += estimated_bytes;
+    iter->second.derived_bytes += estimated_bytes;
+    EvictLocked();
+}
+
+FileCacheStats FileContentCache::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FileCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.invalidations = invalidations_;
+    stats.evictions = evictions_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    stats.inotify = inotify_fd_ >= 0;
+    return stats;
+}
+
+bool FileContentCache::WatchDirectoryLocked(const std::string& directory) {
+#if defined(__linux__)
+    if (inotify_fd_ < 0) {
+        return false;
+    }
+
+    const std::map<std::string, DirectoryWatch>::iterator existing = watches_.find(directory);
+    if (existing != watches_.end()) {
+        if (existing->second.watch_descriptor < 0) {
+            return false;
+        }
+        existing->second.references += 1;
+        return true;
+    }
+
+    const int watch_descriptor = inotify_add_watch(inotify_fd_, WatchPathFor(directory).c_str(), kDirectoryWatchMask);
+    if (watch_descriptor < 0) {
+        return false;
+    }
+    DirectoryWatch watch;
+    watch.watch_descriptor = watch_descriptor;
+    watch.references = 1;
+    watch.event_count = 0;
+    watches_[directory] = watch;
+    watch_directories_[watch_descriptor] = directory;
+    return true;
+#else
+    (void)directory;
+    return false;
+#endif
+}
+
+void FileContentCache::ReleaseDirectoryLocked(const std::string& directory) {
+    const std::map<std::string, DirectoryWatch>::iterator watch = watches_.find(directory);
+    if (watch == watches_.end()) {
+        return;
+    }
+    if (watch->second.references > 1) {
+        watch->second.references -= 1;
+        return;
+    }
+#if defined(__linux__)
+    if (watch->second.watch_descriptor >= 0) {
+        inotify_rm_watch(inotify_fd_, watch->second.watch_descriptor);
+        watch_directories_.erase(watch->second.watch_descriptor);
+    }
+#endif
+    watches_.erase(watch);
+}
+
+void FileContentCache::DrainEventsLocked() {
+#if defined(__linux__)
+    if (inotify_fd_ < 0) {
+        return;
+    }
+
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return;
+        }
+
+        ssize_t offset = 0;
+        while (offset < length) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+
+            std::vector<std::string> stale;
+            if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                // Events were dropped; nothing cached can be trusted.
+                std::map<std::string, DirectoryWatch>::iterator watch;
+                for (watch = watches_.begin(); watch != watches_.end(); ++watch) {
+                    watch->second.event_count += 1;
+                }
+                std::unordered_map<std::string, Entry>::const_iterator iter;
+                for (iter = entries_.begin(); iter != entries_.end(); ++iter) {
+                    stale.push_back(iter->first);
+                }
+            } else {
+                const std::map<int, std::string>::const_iterator found = watch_directories_.find(event->wd);
+                if (found == watch_directories_.end()) {
+                    continue;
+                }
+                const std::string directory = found->second;
+                DirectoryWatch& watch = watches_[directory];
+                watch.event_count += 1;
+
+                if ((event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) != 0) {
+                    // The directory itself went away; its watch is dead and lookups fall back to stat.
+                    if ((event->mask & IN_IGNORED) != 0) {
+                        watch_directories_.erase(event->wd);
+                        watch.watch_descriptor = -1;
+                    }
+                    std::unordered_map<std::string, Entry>::const_iterator iter;
+                    for (iter = entries_.begin(); iter != entries_.end(); ++iter) {
+                        if (iter->second.directory == directory) {
+                            stale.push_back(iter->first);
+                        }
+                    }
+                } else if (event->len > 0) {
+                    const std::string key = (fs::path(directory) / event->name).string();
+                    if (entries_.find(key) != entries_.end()) {
+                        stale.push_back(key);
+                    }
+                }
+            }
+
+            std::size_t index;
+            for (index = 0; index < stale.size(); ++index) {
+                ++invalidations_;
+                EraseLocked(stale[index]);
+            }
+        }
+    }
+#endif
+}
+
+void FileContentCache::EraseLocked(const std::string& key) {
+    const std::unordered_map<std::string, Entry>::iterator iter = entries_.find(key);
+    if (iter == entries_.end()) {
+        return;
+    }
+    bytes_ -= iter->second.text->size() + iter->second.derived_bytes;
+    lru_.erase(iter->second.lru_position);
+    if (iter->second.watched) {
+        ReleaseDirectoryLocked(iter->second.directory);
+    }
+    entries_.erase(iter);
+}
+
+void FileContentCache::EvictLocked() {
+    while ((bytes_ > max_bytes_ || entries_.size() > max_entries_) && !lru_.empty()) {
+        const std::string key = lru_.back();
+        ++evictions_;
+        EraseLocked(key);
+    }
+}
+
+FileContentCache& SharedFileContentCache() {
+    static FileContentCache cache(kSharedCacheMaxBytes, kSharedCacheMaxEntries);
+    return cache;
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
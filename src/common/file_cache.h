@@ -0,0 +1,124 @@
+#ifndef PROCESS_INTERFACE_COMMON_FILE_CACHE_H
+#define PROCESS_INTERFACE_COMMON_FILE_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "fs_compat.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+struct FileCacheStats {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long invalidations;
+    unsigned long long evictions;
+    std::size_t entries;
+    std::size_t bytes;
+    bool inotify;
+};
+
+// Caches file contents by path, plus parsed forms ("derived" values) that callers
+// attach to one version of a file. Entries are invalidated by inotify watches on the
+// parent directory, so an unchanged file is served without any file I/O; where
+// inotify is unavailable (other platforms, watch limits, symlinked files) each lookup
+// compares mtime, size and inode instead. Memory is bounded by the cached text bytes plus
+// the estimated size of each derived value.
+class FileContentCache {
+public:
+    FileContentCache(std::size_t max_bytes, std::size_t max_entries);
+    ~FileContentCache();
+
+    FileContentCache(const FileContentCache&) = delete;
+    FileContentCache& operator=(const FileContentCache&) = delete;
+
+    // Returns false when the file cannot be read. version_out is 0 when the content
+    // could not be cached (too large, or changed while it was being read).
+    bool ReadText(
+        const fs::path& path,
+        std::shared_ptr<const std::string>& text_out,
+        unsigned long long& version_out);
+
+    // Null unless a value of this kind was stored for exactly this version. estimated_bytes
+    // is charged against max_bytes like text; values over a quarter of it are not kept.
+    std::shared_ptr<const void> FindDerived(
+        const fs::path& path,
+        const std::string& kind,
+        unsigned long long version);
+    void StoreDerived(
+        const fs::path& path,
+        const std::string& kind,
+        unsigned long long version,
+        const std::shared_ptr<const void>& value,
+        std::size_t estimated_bytes);
+
+    FileCacheStats Stats() const;
+
+private:
+    struct Validator {
+        long long mtime_ns;
+        unsigned long long size;
+        unsigned long long inode;
+        unsigned long long device;
+    };
+
+    struct DerivedValue {
+        std::shared_ptr<const void> value;
+        std::size_t bytes;
+    };
+
+    struct Entry {
+        std::shared_ptr<const std::string> text;
+        unsigned long long version;
+        Validator validator;
+        // False when changes must be detected by stat (no watch covers the file).
+        bool watched;
+        std::string directory;
+        std::map<std::string, DerivedValue> derived;
+        std::size_t derived_bytes;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    struct DirectoryWatch {
+        int watch_descriptor;
+        std::size_t references;
+        // Bumped for every event in the directory; detects changes during a read.
+        unsigned long long event_count;
+    };
+
+    bool WatchDirectoryLocked(const std::string& directory);
+    void ReleaseDirectoryLocked(const std::string& directory);
+    void DrainEventsLocked();
+    void EraseLocked(const std::string& key);
+    void EvictLocked();
+
+    std::size_t max_bytes_;
+    std::size_t max_entries_;
+    int inotify_fd_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;
+    std::map<std::string, DirectoryWatch> watches_;
+    std::map<int, std::string> watch_directories_;
+    std::size_t bytes_;
+    unsigned long long next_version_;
+    unsigned long long hits_;
+    unsigned long long misses_;
+    unsigned long long invalidations_;
+    unsigned long long evictions_;
+};
+
+// Process-wide cache used by the spec, catalog and file_json loaders.
+FileContentCache& SharedFileContentCache();
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_FILE_CACHE_H
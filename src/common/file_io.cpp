@@ -1,8 +1,16 @@
 #include "file_io.h"
 
+#include <chrono>
 #include <fstream>
 #include <sstream>
 
+#ifdef _WIN32
+#include <system_error>
+#else
+#include <sys/stat.h>
+#include <time.h>
+#endif
+
 namespace ProcessInterface {
 namespace Common {
 
@@ -41,5 +49,48 @@ bool WriteTextFile(const fs::path& path, const std::string& text, std::string& e
     return true;
 }
 
+bool StatFileStamp(const fs::path& path, FileStamp& stamp_out) {
+    // Coarse filesystem timestamps advance in ticks of a few milliseconds; a second is
+    // well past any of them.
+    const long long kRecentWriteNs = 1000000000LL;
+#ifdef _WIN32
+    std::error_code error;
+    const unsigned long long file_size = fs::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    const fs::file_time_type write_time = fs::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    stamp_out.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(write_time.time_since_epoch()).count();
+    stamp_out.size = file_size;
+    stamp_out.inode = 0;
+    stamp_out.device = 0;
+    stamp_out.recent = std::chrono::duration_cast<std::chrono::nanoseconds>(fs::file_time_type::clock::now() - write_time).count() <
+                       kRecentWriteNs;
+    return true;
+#else
+    struct stat info;
+    if (stat(path.string().c_str(), &info) != 0) {
+        return false;
+    }
+#if defined(__linux__)
+    stamp_out.mtime_ns = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+    stamp_out.mtime_ns = static_cast<long long>(info.st_mtime) * 1000000000LL;
+#endif
+    stamp_out.size = static_cast<unsigned long long>(info.st_size);
+    stamp_out.inode = static_cast<unsigned long long>(info.st_ino);
+    stamp_out.device = static_cast<unsigned long long>(info.st_dev);
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    const long long now_ns = static_cast<long long>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+    stamp_out.recent = now_ns - stamp_out.mtime_ns < kRecentWriteNs;
+    return true;
+#endif
+}
+
 }  // namespace Common
 }  // namespace ProcessInterface
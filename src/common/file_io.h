@@ -11,6 +11,20 @@ namespace Common {
 bool ReadTextFile(const fs::path& path, std::string& text_out);
 bool WriteTextFile(const fs::path& path, const std::string& text, std::string& error_message);
 
+// What a file looked like when it was stat'ed. Two equal stamps mean the file was not
+// replaced or rewritten in between, unless it was written again within the same timestamp
+// tick; recent marks stamps taken that close to the last write, which must not be trusted.
+struct FileStamp {
+    long long mtime_ns;
+    unsigned long long size;
+    unsigned long long inode;
+    unsigned long long device;
+    bool recent;
+};
+
+// Follows symlinks. False when path does not exist or cannot be stat'ed.
+bool StatFileStamp(const fs::path& path, FileStamp& stamp_out);
+
 }  // namespace Common
 }  // namespace ProcessInterface
 
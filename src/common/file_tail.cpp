@@ -0,0 +1,400 @@
+#include "file_tail.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#include <chrono>
+#include <fstream>
+#include <system_error>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ProcessInterface {
+namespace Common {
+
+namespace {
+
+const std::size_t kSharedTailCacheMaxEntries = 256;
+const std::size_t kReadChunkBytes = 64 * 1024;
+const std::size_t kMaxLineBytes = 4 * 1024 * 1024;
+
+// Read-only handle with positioned reads.
+class TailFile {
+public:
+    TailFile()
+#ifdef _WIN32
+        : open_(false) {}
+#else
+        : fd_(-1) {}
+#endif
+
+    ~TailFile() {
+#ifndef _WIN32
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    TailFile(const TailFile&) = delete;
+    TailFile& operator=(const TailFile&) = delete;
+
+    bool Open(const fs::path& path) {
+#ifdef _WIN32
+        stream_.open(path, std::ios::in | std::ios::binary);
+        open_ = stream_.is_open();
+        return open_;
+#else
+        fd_ = open(path.string().c_str(), O_RDONLY | O_CLOEXEC);
+        return fd_ >= 0;
+#endif
+    }
+
+    // Identity and size of the opened file, so a rotation between stat and open is not
+    // mistaken for an append.
+    bool Identify(long long& mtime_ns, unsigned long long& size, unsigned long long& inode,
+                  unsigned long long& device) {
+#ifdef _WIN32
+        (void)mtime_ns;
+        (void)inode;
+        (void)device;
+        stream_.seekg(0, std::ios::end);
+        const std::streamoff end = stream_.tellg();
+        if (end < 0) {
+            return false;
+        }
+        size = static_cast<unsigned long long>(end);
+        return true;
+#else
+        struct stat info;
+        if (fstat(fd_, &info) != 0) {
+            return false;
+        }
+#if defined(__linux__)
+        mtime_ns = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+        mtime_ns = static_cast<long long>(info.st_mtime) * 1000000000LL;
+#endif
+        size = static_cast<unsigned long long>(info.st_size);
+        inode = static_cast<unsigned long long>(info.st_ino);
+        device = static_cast<unsigned long long>(info.st_dev);
+        return true;
+#endif
+    }
+
+    bool ReadAt(unsigned long long offset, std::size_t length, char* buffer) {
+#ifdef _WIN32
+        stream_.clear();
+        stream_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+        stream_.read(buffer, static_cast<std::streamsize>(length));
+        return static_cast<std::size_t>(stream_.gcount()) == length;
+#else
+        std::size_t done = 0;
+        while (done < length) {
+            const ssize_t got = pread(fd_, buffer + done, length - done, static_cast<off_t>(offset + done));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                return false;
+            }
+            done += static_cast<std::size_t>(got);
+        }
+        return true;
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    std::ifstream stream_;
+    bool open_;
+#else
+    int fd_;
+#endif
+};
+
+// Splits [lower, upper) of a file into lines from the end. The first segment returned is the
+// unterminated text after the last newline (possibly empty), every later one a complete line.
+// lower must be the start of a line.
+class ReverseLineScanner {
+public:
+    ReverseLineScanner(TailFile& file, unsigned long long lower, unsigned long long upper)
+        : file_(file),
+          lower_(lower),
+          position_(upper),
+          first_(true),
+          done_(false),
+          failed_(false),
+          complete_end_(lower) {}
+
+    bool Previous(std::string& line_out) {
+        if (done_ || failed_) {
+            return false;
+        }
+        std::string::size_type newline = buffer_.rfind('\n');
+        while (newline == std::string::npos && position_ > lower_) {
+            const std::size_t length =
+                static_cast<std::size_t>(std::min<unsigned long long>(kReadChunkBytes, position_ - lower_));
+            if (buffer_.size() + length > kMaxLineBytes) {
+                failed_ = true;
+                return false;
+            }
+            std::string chunk(length, '\0');
+            if (!file_.ReadAt(position_ - length, length, &chunk[0])) {
+                failed_ = true;
+                return false;
+            }
+            position_ -= length;
+            buffer_.insert(0, chunk);
+            // Only the new bytes can hold a newline.
+            newline = buffer_.rfind('\n', length - 1);
+        }
+
+        if (newline == std::string::npos) {
+            line_out.swap(buffer_);
+            buffer_.clear();
+            done_ = true;
+        } else {
+            if (first_) {
+                complete_end_ = position_ + newline + 1;
+            }
+            line_out.assign(buffer_, newline + 1, std::string::npos);
+            buffer_.erase(newline);
+        }
+        first_ = false;
+        if (!line_out.empty() && line_out[line_out.size() - 1] == '\r') {
+            line_out.erase(line_out.size() - 1);
+        }
+        return true;
+    }
+
+    bool Failed() const {
+        return failed_;
+    }
+
+    // Offset just past the last newline in the range, or lower when there is none.
+    unsigned long long CompleteEnd() const {
+        return complete_end_;
+    }
+
+private:
+    TailFile& file_;
+    const unsigned long long lower_;
+    unsigned long long position_;
+    bool first_;
+    bool done_;
+    bool failed_;
+    unsigned long long complete_end_;
+    std::string buffer_;
+};
+
+bool StatPath(const fs::path& path, long long& mtime_ns, unsigned long long& size, unsigned long long& inode,
+              unsigned long long& device) {
+#ifdef _WIN32
+    std::error_code error;
+    const unsigned long long file_size = fs::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    const fs::file_time_type write_time = fs::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(write_time.time_since_epoch()).count();
+    size = file_size;
+    inode = 0;
+    device = 0;
+    return true;
+#else
+    struct stat info;
+    if (stat(path.string().c_str(), &info) != 0) {
+        return false;
+    }
+#if defined(__linux__)
+    mtime_ns = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+    mtime_ns = static_cast<long long>(info.st_mtime) * 1000000000LL;
+#endif
+    size = static_cast<unsigned long long>(info.st_size);
+    inode = static_cast<unsigned long long>(info.st_ino);
+    device = static_cast<unsigned long long>(info.st_dev);
+    return true;
+#endif
+}
+
+}  // namespace
+
+FileTailCache::FileTailCache(std::size_t max_entries)
+    : max_entries_(max_entries) {}
+
+bool FileTailCache::TailLines(const fs::path& path, std::size_t max_lines, std::vector<std::string>& lines_out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* entry = NULL;
+    if (!RefreshLocked(path, "tail:" + std::to_string(max_lines) + "\n" + path.string(), max_lines, NULL, entry)) {
+        return false;
+    }
+    lines_out = entry->result_lines;
+    return true;
+}
+
+bool FileTailCache::LastMatchingLine(
+    const fs::path& path,
+    const std::string& matcher_key,
+    const std::function<bool(const std::string&)>& accept,
+    std::string& line_out,
+    bool& found_out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* entry = NULL;
+    if (!RefreshLocked(path, "match:" + matcher_key + "\n" + path.string(), 0, &accept, entry)) {
+        return false;
+    }
+    found_out = entry->result_found;
+    line_out = entry->result_line;
+    return true;
+}
+
+bool FileTailCache::RefreshLocked(
+    const fs::path& path,
+    const std::string& key,
+    std::size_t max_lines,
+    const std::function<bool(const std::string&)>* accept,
+    Entry*& entry_out) {
+    Validator current;
+    if (!StatPath(path, current.mtime_ns, current.size, current.inode, current.device)) {
+        EraseLocked(key);
+        return false;
+    }
+
+    std::unordered_map<std::string, Entry>::iterator iter = entries_.find(key);
+    if (iter != entries_.end() && iter->second.validator.mtime_ns == current.mtime_ns &&
+        iter->second.validator.size == current.size && iter->second.validator.inode == current.inode &&
+        iter->second.validator.device == current.device) {
+        lru_.splice(lru_.begin(), lru_, iter->second.lru_position);
+        entry_out = &iter->second;
+        return true;
+    }
+
+    TailFile file;
+    if (!file.Open(path) || !file.Identify(current.mtime_ns, current.size, current.inode, current.device)) {
+        EraseLocked(key);
+        return false;
+    }
+
+    if (iter == entries_.end()) {
+        lru_.push_front(key);
+        iter = entries_.insert(std::make_pair(key, Entry())).first;
+        iter->second.lru_position = lru_.begin();
+        iter->second.validator.mtime_ns = 0;
+        iter->second.validator.size = 0;
+        iter->second.validator.inode = 0;
+        iter->second.validator.device = 0;
+        iter->second.scan_end = 0;
+        iter->second.has_match = false;
+        iter->second.result_found = false;
+    } else {
+        lru_.splice(lru_.begin(), lru_, iter->second.lru_position);
+    }
+    Entry& entry = iter->second;
+
+    // Appended to in place: same file, not shorter, and the last scanned line still ends where it did.
+    bool appended = entry.validator.inode != 0 && entry.validator.inode == current.inode &&
+                    entry.validator.device == current.device && entry.validator.size <= current.size &&
+                    entry.scan_end <= current.size;
+    if (appended && entry.scan_end > 0) {
+        char last = '\0';
+        appended = file.ReadAt(entry.scan_end - 1, 1, &last) && last == '\n';
+    }
+    if (!appended) {
+        entry.scan_end = 0;
+        entry.complete_lines.clear();
+        entry.has_match = false;
+        entry.match.clear();
+    }
+
+    ReverseLineScanner scanner(file, entry.scan_end, current.size);
+    std::string partial;
+    std::vector<std::string> newest_first;
+    bool new_match = false;
+    std::string line;
+    bool first = true;
+    bool reached_lower = true;
+    while (scanner.Previous(line)) {
+        if (first) {
+            partial.swap(line);
+            first = false;
+        } else if (accept == NULL) {
+            newest_first.push_back(line);
+        } else if ((*accept)(line)) {
+            entry.has_match = true;
+            entry.match.swap(line);
+            new_match = true;
+        }
+        if ((accept == NULL && newest_first.size() >= max_lines) || new_match) {
+            reached_lower = false;
+            break;
+        }
+    }
+    if (scanner.Failed()) {
+        EraseLocked(key);
+        return false;
+    }
+
+    if (accept == NULL) {
+        if (!reached_lower) {
+            entry.complete_lines.clear();
+        }
+        std::vector<std::string>::reverse_iterator newest;
+        for (newest = newest_first.rbegin(); newest != newest_first.rend(); ++newest) {
+            entry.complete_lines.push_back(*newest);
+        }
+        if (entry.complete_lines.size() > max_lines) {
+            entry.complete_lines.erase(
+                entry.complete_lines.begin(),
+                entry.complete_lines.begin() + static_cast<std::ptrdiff_t>(entry.complete_lines.size() - max_lines));
+        }
+        entry.result_lines = entry.complete_lines;
+        if (!partial.empty()) {
+            entry.result_lines.push_back(partial);
+            if (entry.result_lines.size() > max_lines) {
+                entry.result_lines.erase(entry.result_lines.begin());
+            }
+        }
+    } else if (!partial.empty() && (*accept)(partial)) {
+        entry.result_found = true;
+        entry.result_line = partial;
+    } else {
+        entry.result_found = entry.has_match;
+        entry.result_line = entry.match;
+    }
+
+    entry.validator = current;
+    entry.scan_end = scanner.CompleteEnd();
+    entry_out = &entry;
+
+    while (entries_.size() > max_entries_ && !lru_.empty()) {
+        EraseLocked(lru_.back());
+    }
+    return true;
+}
+
+void FileTailCache::EraseLocked(const std::string& key) {
+    const std::unordered_map<std::string, Entry>::iterator iter = entries_.find(key);
+    if (iter == entries_.end()) {
+        return;
+    }
+    lru_.erase(iter->second.lru_position);
+    entries_.erase(iter);
+}
+
+FileTailCache& SharedFileTailCache() {
+    static FileTailCache cache(kSharedTailCacheMaxEntries);
+    return cache;
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
@@ -0,0 +1,90 @@
+#ifndef PROCESS_INTERFACE_COMMON_FILE_TAIL_H
+#define PROCESS_INTERFACE_COMMON_FILE_TAIL_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fs_compat.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+// Answers "last lines" questions about append-only files (logs, JSONL) by reading backwards
+// from the end, so the cost does not grow with the file. Each question is cached per path
+// together with the file's inode, size and mtime and the offset just past its last complete
+// line: an unchanged file costs one stat, an appended file only reads the appended bytes, and
+// a rotated (new inode), truncated (smaller) or rewritten file is scanned again from its end.
+//
+// A final line without a newline is still being written; it is returned by TailLines and
+// offered to the matcher, but it is never cached as complete.
+class FileTailCache {
+public:
+    explicit FileTailCache(std::size_t max_entries);
+
+    FileTailCache(const FileTailCache&) = delete;
+    FileTailCache& operator=(const FileTailCache&) = delete;
+
+    // The last max_lines lines, oldest first, without line terminators. False when the file
+    // cannot be read or a line is longer than 4 MiB.
+    bool TailLines(const fs::path& path, std::size_t max_lines, std::vector<std::string>& lines_out);
+
+    // The last line accept returns true for. matcher_key identifies accept: two calls with the
+    // same key must pass equivalent matchers. found_out is false when no line matches; fails
+    // like TailLines.
+    bool LastMatchingLine(
+        const fs::path& path,
+        const std::string& matcher_key,
+        const std::function<bool(const std::string&)>& accept,
+        std::string& line_out,
+        bool& found_out);
+
+private:
+    struct Validator {
+        long long mtime_ns;
+        unsigned long long size;
+        unsigned long long inode;
+        unsigned long long device;
+    };
+
+    struct Entry {
+        Validator validator;
+        // Offset just past the last newline seen; everything before it has been scanned.
+        unsigned long long scan_end;
+        // TailLines: the last lines before scan_end, oldest first.
+        std::vector<std::string> complete_lines;
+        // LastMatchingLine: the last matching line before scan_end.
+        bool has_match;
+        std::string match;
+        // Answer for validator, including the unterminated final line.
+        std::vector<std::string> result_lines;
+        bool result_found;
+        std::string result_line;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    bool RefreshLocked(
+        const fs::path& path,
+        const std::string& key,
+        std::size_t max_lines,
+        const std::function<bool(const std::string&)>* accept,
+        Entry*& entry_out);
+    void EraseLocked(const std::string& key);
+
+    std::size_t max_entries_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;
+};
+
+// Process-wide cache used by the file_tail and jsonl_last status ops.
+FileTailCache& SharedFileTailCache();
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_FILE_TAIL_H
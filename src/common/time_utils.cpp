@@ -1,11 +1,26 @@
 #include "time_utils.h"
 
 #include <chrono>
+#include <cstdio>
 #include <ctime>
 
 namespace ProcessInterface {
 namespace Common {
 
+namespace {
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar.
+long long DaysFromCivil(long long year, unsigned int month, unsigned int day) {
+    year -= month <= 2 ? 1 : 0;
+    const long long era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned int year_of_era = static_cast<unsigned int>(year - era * 400);
+    const unsigned int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<long long>(day_of_era) - 719468;
+}
+
+}  // namespace
+
 std::string CurrentUtcIso8601() {
     const std::time_t now = std::time(NULL);
     std::tm utc_tm = {};
@@ -24,5 +39,41 @@ long long CurrentEpochMs() {
         std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+bool ParseUtcIso8601(const std::string& text, long long& epoch_ms_out) {
+    int year = 0;
+    unsigned int month = 0;
+    unsigned int day = 0;
+    unsigned int hour = 0;
+    unsigned int minute = 0;
+    unsigned int second = 0;
+    int consumed = 0;
+    if (std::sscanf(text.c_str(), "%4d-%2u-%2uT%2u:%2u:%2u%n", &year, &month, &day, &hour, &minute, &second, &consumed) != 6 ||
+        consumed != 19) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+
+    std::size_t position = 19;
+    long long millis = 0;
+    if (position < text.size() && text[position] == '.') {
+        long long scale = 100;
+        ++position;
+        while (position < text.size() && text[position] >= '0' && text[position] <= '9') {
+            millis += (text[position] - '0') * scale;
+            scale /= 10;
+            ++position;
+        }
+    }
+    if (position + 1 != text.size() || text[position] != 'Z') {
+        return false;
+    }
+
+    const long long seconds = DaysFromCivil(year, month, day) * 86400LL + hour * 3600LL + minute * 60LL + second;
+    epoch_ms_out = seconds * 1000LL + millis;
+    return true;
+}
+
 }  // namespace Common
 }  // namespace ProcessInterface
@@ -8,6 +8,8 @@ namespace Common {
 
 std::string CurrentUtcIso8601();
 long long CurrentEpochMs();
+// Accepts YYYY-MM-DDTHH:MM:SS[.fff]Z, the form CurrentUtcIso8601 produces.
+bool ParseUtcIso8601(const std::string& text, long long& epoch_ms_out);
 
 }  // namespace Common
 }  // namespace ProcessInterface
@@ -10,6 +10,8 @@ namespace HostRuntime {
 
 namespace {
 
+const unsigned long long kMaxStatusDeadlineMs = 600000;
+
 bool RequireString(
     const nlohmann::json& root,
     const std::string& key,
@@ -28,6 +30,122 @@ bool RequireString(
     return true;
 }
 
+bool ReadRetentionLimits(
+    const nlohmann::json& root,
+    Common::ActionJobRetentionPolicy& policy_inout,
+    const std::string& profile_path,
+    std::string& error_message) {
+    static const char* const kKeys[] = {"maxCount", "maxAgeSeconds", "maxBytes"};
+
+    std::size_t index = 0;
+    for (index = 0; index < sizeof(kKeys) / sizeof(kKeys[0]); ++index) {
+        const std::string key = kKeys[index];
+        if (!root.contains(key)) {
+            continue;
+        }
+        if (!root[key].is_number_unsigned()) {
+            error_message = "host profile actionJobRetention." + key + " must be a non-negative integer: " + profile_path;
+            return false;
+        }
+        const unsigned long long value = root[key].get<unsigned long long>();
+        if (key == "maxCount") {
+            policy_inout.max_count = static_cast<std::size_t>(value);
+        } else if (key == "maxAgeSeconds") {
+            policy_inout.max_age_seconds = static_cast<long long>(value);
+        } else {
+            policy_inout.max_bytes = value;
+        }
+    }
+    return true;
+}
+
+bool ReadActionJobRetention(
+    const nlohmann::json& root,
+    Common::ActionJobStoreOptions& options_inout,
+    const std::string& profile_path,
+    std::string& error_message) {
+    if (!root.contains("actionJobRetention")) {
+        return true;
+    }
+
+    const nlohmann::json& retention = root["actionJobRetention"];
+    if (!retention.is_object()) {
+        error_message = "host profile actionJobRetention must be object: " + profile_path;
+        return false;
+    }
+    if (!ReadRetentionLimits(retention, options_inout.default_retention, profile_path, error_message)) {
+        return false;
+    }
+
+    if (!retention.contains("apps")) {
+        return true;
+    }
+    if (!retention["apps"].is_object()) {
+        error_message = "host profile actionJobRetention.apps must be object: " + profile_path;
+        return false;
+    }
+
+    nlohmann::json::const_iterator iter;
+    for (iter = retention["apps"].begin(); iter != retention["apps"].end(); ++iter) {
+        if (!iter.value().is_object()) {
+            error_message = "host profile actionJobRetention.apps." + iter.key() + " must be object: " + profile_path;
+            return false;
+        }
+        // Per-app limits override the defaults key by key.
+        Common::ActionJobRetentionPolicy policy = options_inout.default_retention;
+        if (!ReadRetentionLimits(iter.value(), policy, profile_path, error_message)) {
+            return false;
+        }
+        options_inout.app_retention[iter.key()] = policy;
+    }
+    return true;
+}
+
+bool ReadStatusPlugins(
+    const nlohmann::json& root,
+    std::vector<Status::StatusProbePluginSpec>& plugins_out,
+    const std::string& profile_path,
+    std::string& error_message) {
+    if (!root.contains("statusPlugins")) {
+        return true;
+    }
+    if (!root["statusPlugins"].is_array()) {
+        error_message = "host profile statusPlugins must be array: " + profile_path;
+        return false;
+    }
+
+    std::size_t index = 0;
+    for (index = 0; index < root["statusPlugins"].size(); ++index) {
+        const nlohmann::json& entry = root["statusPlugins"][index];
+        if (!entry.is_object()) {
+            error_message = "host profile statusPlugins entries must be objects: " + profile_path;
+            return false;
+        }
+
+        Status::StatusProbePluginSpec plugin;
+        std::string library;
+        if (!RequireString(entry, "name", plugin.name, profile_path, error_message) ||
+            !RequireString(entry, "library", library, profile_path, error_message)) {
+            error_message = "statusPlugins: " + error_message;
+            return false;
+        }
+        if (plugin.name.find(':') != std::string::npos) {
+            error_message = "host profile statusPlugins name must not contain ':': " + plugin.name;
+            return false;
+        }
+        plugin.library_path = library;
+        if (entry.contains("init") && !RequireString(entry, "init", plugin.init_symbol, profile_path, error_message)) {
+            error_message = "statusPlugins: " + error_message;
+            return false;
+        }
+        if (entry.contains("config")) {
+            plugin.config_json = entry["config"].dump();
+        }
+        plugins_out.push_back(plugin);
+    }
+    return true;
+}
+
 }  // namespace
 
 bool LoadHostProfile(
@@ -94,6 +212,20 @@ bool LoadHostProfile(
         return false;
     }
 
+    profile.action_job_store = Common::DefaultActionJobStoreOptions();
+    if (paths.contains("actionJobStore")) {
+        std::string job_store;
+        if (!RequireString(paths, "actionJobStore", job_store, profile_path.string(), error_message)) {
+            return false;
+        }
+        if (job_store == "log") {
+            profile.action_job_store.backend = Common::ActionJobBackendKind::kLog;
+        } else if (job_store != "files") {
+            error_message = "unsupported paths.actionJobStore in host profile: " + job_store;
+            return false;
+        }
+    }
+
     if (!root.contains("ipc") || !root["ipc"].is_object()) {
         error_message = "host profile missing ipc object: " + profile_path.string();
         return false;
@@ -106,6 +238,30 @@ bool LoadHostProfile(
     if (!RequireString(ipc, "endpoint", profile.ipc.endpoint, profile_path.string(), error_message)) {
         return false;
     }
+    if (ipc.contains("eventEndpoint") &&
+        !RequireString(ipc, "eventEndpoint", profile.ipc.event_endpoint, profile_path.string(), error_message)) {
+        return false;
+    }
+
+    profile.action_job_store.app_ids = profile.allowed_apps;
+    if (!ReadActionJobRetention(root, profile.action_job_store, profile_path.string(), error_message)) {
+        return false;
+    }
+
+    if (!ReadStatusPlugins(root, profile.status_plugins, profile_path.string(), error_message)) {
+        return false;
+    }
+
+    profile.status_deadline_ms = 0;
+    if (root.contains("statusDeadlineMs")) {
+        if (!root["statusDeadlineMs"].is_number_unsigned() ||
+            root["statusDeadlineMs"].get<unsigned long long>() > kMaxStatusDeadlineMs) {
+            error_message = "host profile statusDeadlineMs must be an integer from 0 to " +
+                            std::to_string(kMaxStatusDeadlineMs) + ": " + profile_path.string();
+            return false;
+        }
+        profile.status_deadline_ms = root["statusDeadlineMs"].get<int>();
+    }
 
     if (profile.ipc.backend != "zmq") {
         error_message = "unsupported ipc.backend in host profile: " + profile.ipc.backend;
@@ -6,6 +6,8 @@
 
 #include "../common/fs_compat.h"
 #include "../common/path_templates.h"
+#include "../process_interface/common/action_job_store.h"
+#include "../status/probe_plugins.h"
 
 namespace ProcessInterface {
 namespace HostRuntime {
@@ -13,12 +15,18 @@ namespace HostRuntime {
 struct HostIpcProfile {
     std::string backend;
     std::string endpoint;
+    std::string event_endpoint;
 };
 
 struct HostProfile {
     std::vector<std::string> allowed_apps;
     Common::PathTemplateSet path_templates;
     HostIpcProfile ipc;
+    Common::ActionJobStoreOptions action_job_store;
+    // "statusPlugins"; library paths are as written and resolved against the repo root at startup.
+    std::vector<Status::StatusProbePluginSpec> status_plugins;
+    // "statusDeadlineMs"; 0 (default) evaluates status specs without a deadline.
+    int status_deadline_ms;
 };
 
 bool LoadHostProfile(
@@ -8,6 +8,8 @@
 #include "host_profile.h"
 #include "../common/fs_compat.h"
 #include "../ipc/factory/IpcFactory.h"
+#include "../platform/native_action.h"
+#include "../process_interface/common/action_job_log.h"
 #include "../process_interface/common/control_script_runner.h"
 #include "../process_interface/host/dispatcher.h"
 #include "../wire_v0/wire_v0.h"
@@ -21,10 +23,12 @@ struct LaunchArgs {
     std::string repo_root;
     std::string host_config_path;
     std::string ipc_endpoint_override;
+    bool export_action_jobs;
 };
 
 bool ParseLaunchArgs(int argc, char** argv, LaunchArgs& args_out, std::string& error_message) {
     LaunchArgs args;
+    args.export_action_jobs = false;
 
     int index = 0;
     for (index = 1; index < argc; ++index) {
@@ -53,6 +57,10 @@ bool ParseLaunchArgs(int argc, char** argv, LaunchArgs& args_out, std::string& e
             args.ipc_endpoint_override = argv[++index];
             continue;
         }
+        if (token == "--export-action-jobs") {
+            args.export_action_jobs = true;
+            continue;
+        }
         error_message = "unsupported arg: " + token;
         return false;
     }
@@ -70,9 +78,57 @@ bool ParseLaunchArgs(int argc, char** argv, LaunchArgs& args_out, std::string& e
     return true;
 }
 
+// Rewrites the job log of every allowed app into the legacy per-job JSON files.
+int ExportActionJobs(const LaunchArgs& launch_args, const HostProfile& profile) {
+    if (profile.action_job_store.backend != ProcessInterface::Common::ActionJobBackendKind::kLog) {
+        std::cerr << "--export-action-jobs requires paths.actionJobStore \"log\"" << std::endl;
+        return 2;
+    }
+
+    std::size_t index = 0;
+    for (index = 0; index < profile.allowed_apps.size(); ++index) {
+        std::size_t exported = 0;
+        std::string export_error;
+        if (!ProcessInterface::Common::ExportActionJobLog(
+                launch_args.repo_root,
+                profile.path_templates,
+                profile.allowed_apps[index],
+                exported,
+                export_error)) {
+            std::cerr << profile.allowed_apps[index] << ": " << export_error << std::endl;
+            return 2;
+        }
+        std::cout << profile.allowed_apps[index] << ": exported " << exported << " action jobs" << std::endl;
+    }
+    return 0;
+}
+
+bool RegisterStatusPlugins(const LaunchArgs& launch_args, const HostProfile& profile) {
+    std::size_t index = 0;
+    for (index = 0; index < profile.status_plugins.size(); ++index) {
+        ProcessInterface::Status::StatusProbePluginSpec plugin = profile.status_plugins[index];
+        // Relative libraries are taken from the repo when present, else left to the loader's search path.
+        const ProcessInterface::Common::fs::path in_repo = ProcessInterface::Common::fs::path(launch_args.repo_root) / plugin.library_path;
+        if (plugin.library_path.is_relative() && ProcessInterface::Common::fs::exists(in_repo)) {
+            plugin.library_path = in_repo;
+        }
+
+        std::string plugin_error;
+        if (!ProcessInterface::Status::RegisterStatusProbePlugin(plugin, plugin_error)) {
+            std::cerr << plugin_error << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace
 
 int RunHost(int argc, char** argv) {
+    if (argc == 2 && std::string(argv[1]) == ProcessInterface::Platform::kNativeActionWorkerArg) {
+        return ProcessInterface::Platform::RunNativeActionWorker();
+    }
+
     LaunchArgs launch_args;
     std::string launch_error;
     if (!ParseLaunchArgs(argc, argv, launch_args, launch_error)) {
@@ -87,6 +143,14 @@ int RunHost(int argc, char** argv) {
         return 2;
     }
 
+    if (launch_args.export_action_jobs) {
+        return ExportActionJobs(launch_args, profile);
+    }
+
+    if (!RegisterStatusPlugins(launch_args, profile)) {
+        return 2;
+    }
+
     const std::string endpoint =
         launch_args.ipc_endpoint_override.empty() ? profile.ipc.endpoint : launch_args.ipc_endpoint_override;
 
@@ -94,10 +158,35 @@ int RunHost(int argc, char** argv) {
         launch_args.repo_root,
         profile.allowed_apps,
         profile.path_templates,
-        ProcessInterface::Common::CreateControlScriptRunner(launch_args.repo_root, profile.path_templates),
+        ProcessInterface::Common::CreateControlScriptRunner(
+            launch_args.repo_root,
+            profile.path_templates,
+            profile.action_job_store),
+        profile.status_deadline_ms,
     };
 
     std::string factory_error;
+    if (!profile.ipc.event_endpoint.empty()) {
+        std::shared_ptr<ProcessInterface::Ipc::IIpcPublisher> event_publisher(
+            ProcessInterface::Ipc::CreateIpcPublisher(profile.ipc.backend, factory_error).release());
+        if (!event_publisher) {
+            std::cerr << factory_error << std::endl;
+            return 2;
+        }
+
+        std::string event_bind_error;
+        if (!event_publisher->Bind(profile.ipc.event_endpoint, event_bind_error)) {
+            std::cerr << event_bind_error << std::endl;
+            return 2;
+        }
+
+        host_context.control_runner.SetEventSink(
+            [event_publisher](const std::string& event_name, const std::string& event_json) {
+                std::string publish_error;
+                event_publisher->Publish(event_name, event_json, publish_error);
+            });
+    }
+
     std::unique_ptr<ProcessInterface::Ipc::IIpcServer> ipc_server =
         ProcessInterface::Ipc::CreateIpcServer(profile.ipc.backend, factory_error);
     if (!ipc_server) {
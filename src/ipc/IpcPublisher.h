@@ -0,0 +1,21 @@
+#ifndef PROCESS_INTERFACE_IPC_PUBLISHER_H
+#define PROCESS_INTERFACE_IPC_PUBLISHER_H
+
+#include <string>
+
+namespace ProcessInterface {
+namespace Ipc {
+
+// One-way event channel. Publish may be called from any thread.
+class IIpcPublisher {
+public:
+    virtual ~IIpcPublisher() {}
+
+    virtual bool Bind(const std::string& endpoint, std::string& error_message) = 0;
+    virtual bool Publish(const std::string& topic, const std::string& payload, std::string& error_message) = 0;
+};
+
+}  // namespace Ipc
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_IPC_PUBLISHER_H
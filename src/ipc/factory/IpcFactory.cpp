@@ -1,6 +1,7 @@
 #include "IpcFactory.h"
 
 #include "../impl/ZmqIpcClient.h"
+#include "../impl/ZmqIpcPublisher.h"
 #include "../impl/ZmqIpcServer.h"
 
 namespace ProcessInterface {
@@ -28,5 +29,16 @@ std::unique_ptr<IIpcClient> CreateIpcClient(
     return std::unique_ptr<IIpcClient>();
 }
 
+std::unique_ptr<IIpcPublisher> CreateIpcPublisher(
+    const std::string& backend,
+    std::string& error_message) {
+    if (backend == "zmq") {
+        return std::unique_ptr<IIpcPublisher>(new ZmqIpcPublisher());
+    }
+
+    error_message = "unsupported ipc backend: " + backend;
+    return std::unique_ptr<IIpcPublisher>();
+}
+
 }  // namespace Ipc
 }  // namespace ProcessInterface
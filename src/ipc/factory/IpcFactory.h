@@ -5,6 +5,7 @@
 #include <string>
 
 #include "../IpcClient.h"
+#include "../IpcPublisher.h"
 #include "../IpcServer.h"
 
 namespace ProcessInterface {
@@ -18,6 +19,10 @@ std::unique_ptr<IIpcClient> CreateIpcClient(
     const std::string& backend,
     std::string& error_message);
 
+std::unique_ptr<IIpcPublisher> CreateIpcPublisher(
+    const std::string& backend,
+    std::string& error_message);
+
 }  // namespace Ipc
 }  // namespace ProcessInterface
 
@@ -0,0 +1,74 @@
+#include "ZmqIpcPublisher.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <zmq.h>
+
+namespace ProcessInterface {
+namespace Ipc {
+
+ZmqIpcPublisher::ZmqIpcPublisher()
+    : socket_(NULL) {}
+
+ZmqIpcPublisher::~ZmqIpcPublisher() {
+    if (socket_ != NULL) {
+        zmq_close(socket_);
+        socket_ = NULL;
+    }
+}
+
+bool ZmqIpcPublisher::Bind(const std::string& endpoint, std::string& error_message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!context_.valid()) {
+        error_message = "failed to initialize zmq context";
+        return false;
+    }
+
+    if (socket_ != NULL) {
+        zmq_close(socket_);
+        socket_ = NULL;
+    }
+
+    socket_ = zmq_socket(context_.raw(), ZMQ_PUB);
+    if (socket_ == NULL) {
+        error_message = std::string("zmq_socket failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    const int linger = 0;
+    zmq_setsockopt(socket_, ZMQ_LINGER, &linger, sizeof(linger));
+
+    if (zmq_bind(socket_, endpoint.c_str()) != 0) {
+        error_message = std::string("zmq_bind failed: ") + std::strerror(errno);
+        zmq_close(socket_);
+        socket_ = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+bool ZmqIpcPublisher::Publish(const std::string& topic, const std::string& payload, std::string& error_message) {
+    // ZMQ sockets are not thread-safe; job workers publish concurrently.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_ == NULL) {
+        error_message = "ipc publisher is not bound";
+        return false;
+    }
+
+    // Slow subscribers drop messages at the high-water mark instead of blocking workers.
+    if (zmq_send(socket_, topic.data(), topic.size(), ZMQ_SNDMORE | ZMQ_DONTWAIT) < 0) {
+        error_message = std::string("zmq_send failed: ") + std::strerror(errno);
+        return false;
+    }
+    if (zmq_send(socket_, payload.data(), payload.size(), ZMQ_DONTWAIT) < 0) {
+        error_message = std::string("zmq_send failed: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace Ipc
+}  // namespace ProcessInterface
@@ -0,0 +1,30 @@
+#ifndef PROCESS_INTERFACE_IPC_IMPL_ZMQ_IPC_PUBLISHER_H
+#define PROCESS_INTERFACE_IPC_IMPL_ZMQ_IPC_PUBLISHER_H
+
+#include <mutex>
+#include <string>
+
+#include "../IpcPublisher.h"
+#include "ZmqContext.h"
+
+namespace ProcessInterface {
+namespace Ipc {
+
+class ZmqIpcPublisher : public IIpcPublisher {
+public:
+    ZmqIpcPublisher();
+    virtual ~ZmqIpcPublisher();
+
+    virtual bool Bind(const std::string& endpoint, std::string& error_message);
+    virtual bool Publish(const std::string& topic, const std::string& payload, std::string& error_message);
+
+private:
+    ZmqContext context_;
+    void* socket_;
+    std::mutex mutex_;
+};
+
+}  // namespace Ipc
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_IPC_IMPL_ZMQ_IPC_PUBLISHER_H
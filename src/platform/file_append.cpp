@@ -0,0 +1,80 @@
+#include "file_append.h"
+
+#include <cstdint>
+#include <system_error>
+
+#include "file_replace.h"
+
+namespace ProcessInterface {
+namespace Platform {
+
+AppendOnlyFile::AppendOnlyFile()
+    : file_(NULL),
+      size_(0) {}
+
+AppendOnlyFile::~AppendOnlyFile() {
+    Close();
+}
+
+bool AppendOnlyFile::Open(const Common::fs::path& path, std::string& error_message) {
+    Close();
+
+    std::error_code error;
+    Common::fs::create_directories(path.parent_path(), error);
+
+    file_ = std::fopen(path.string().c_str(), "ab");
+    if (file_ == NULL) {
+        error_message = "failed to open append file: " + path.string();
+        return false;
+    }
+
+    const std::uintmax_t size = Common::fs::file_size(path, error);
+    size_ = error ? 0 : static_cast<unsigned long long>(size);
+    path_ = path;
+    return true;
+}
+
+bool AppendOnlyFile::Append(const std::string& data, bool durable, std::string& error_message) {
+    if (file_ == NULL) {
+        error_message = "append file is not open";
+        return false;
+    }
+
+    if (!data.empty() && std::fwrite(data.data(), 1, data.size(), file_) != data.size()) {
+        error_message = "failed to append to file: " + path_.string();
+        return false;
+    }
+    size_ += data.size();
+
+    if (durable) {
+        return Sync(error_message);
+    }
+    return true;
+}
+
+bool AppendOnlyFile::Sync(std::string& error_message) {
+    return FlushFileDurable(file_, error_message);
+}
+
+void AppendOnlyFile::Close() {
+    if (file_ != NULL) {
+        std::fclose(file_);
+        file_ = NULL;
+    }
+    size_ = 0;
+}
+
+bool AppendOnlyFile::IsOpen() const {
+    return file_ != NULL;
+}
+
+unsigned long long AppendOnlyFile::Size() const {
+    return size_;
+}
+
+const Common::fs::path& AppendOnlyFile::Path() const {
+    return path_;
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
@@ -0,0 +1,40 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_FILE_APPEND_H
+#define PROCESS_INTERFACE_PLATFORM_FILE_APPEND_H
+
+#include <cstdio>
+#include <string>
+
+#include "../common/fs_compat.h"
+
+namespace ProcessInterface {
+namespace Platform {
+
+// Append-only file handle for log segments. Not thread-safe; callers serialize access.
+class AppendOnlyFile {
+public:
+    AppendOnlyFile();
+    ~AppendOnlyFile();
+
+    AppendOnlyFile(const AppendOnlyFile&) = delete;
+    AppendOnlyFile& operator=(const AppendOnlyFile&) = delete;
+
+    bool Open(const Common::fs::path& path, std::string& error_message);
+    // One write per call; durable adds a single flush+fsync covering everything appended so far.
+    bool Append(const std::string& data, bool durable, std::string& error_message);
+    bool Sync(std::string& error_message);
+    void Close();
+
+    bool IsOpen() const;
+    unsigned long long Size() const;
+    const Common::fs::path& Path() const;
+
+private:
+    FILE* file_;
+    unsigned long long size_;
+    Common::fs::path path_;
+};
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_FILE_APPEND_H
@@ -65,42 +65,6 @@ Common::fs::path BuildTempPath(const Common::fs::path& target_path) {
     return target_path.parent_path() / (target_path.filename().string() + suffix);
 }
 
-bool FlushFileDurable(FILE* file, std::string& error_message) {
-    if (file == NULL) {
-        error_message = "invalid temp file handle";
-        return false;
-    }
-
-    if (std::fflush(file) != 0) {
-        error_message = "failed to flush temp file stream";
-        return false;
-    }
-
-#if PROCESS_INTERFACE_PLATFORM_WINDOWS
-    const int fd = ::_fileno(file);
-    if (fd < 0) {
-        error_message = "failed to get temp file descriptor";
-        return false;
-    }
-    if (::_commit(fd) != 0) {
-        error_message = "failed to commit temp file";
-        return false;
-    }
-#else
-    const int fd = ::fileno(file);
-    if (fd < 0) {
-        error_message = "failed to get temp file descriptor";
-        return false;
-    }
-    if (::fsync(fd) != 0) {
-        error_message = "failed to fsync temp file";
-        return false;
-    }
-#endif
-
-    return true;
-}
-
 bool WriteTempFileDurable(const Common::fs::path& temp_path,
                           const std::string& contents,
                           std::string& error_message) {
@@ -205,6 +169,42 @@ bool ReplaceTargetWithTemp(const Common::fs::path& temp_path,
 
 }  // namespace
 
+bool FlushFileDurable(FILE* file, std::string& error_message) {
+    if (file == NULL) {
+        error_message = "invalid file handle";
+        return false;
+    }
+
+    if (std::fflush(file) != 0) {
+        error_message = "failed to flush file stream";
+        return false;
+    }
+
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    const int fd = ::_fileno(file);
+    if (fd < 0) {
+        error_message = "failed to get file descriptor";
+        return false;
+    }
+    if (::_commit(fd) != 0) {
+        error_message = "failed to commit file";
+        return false;
+    }
+#else
+    const int fd = ::fileno(file);
+    if (fd < 0) {
+        error_message = "failed to get file descriptor";
+        return false;
+    }
+    if (::fsync(fd) != 0) {
+        error_message = "failed to fsync file";
+        return false;
+    }
+#endif
+
+    return true;
+}
+
 bool AtomicReplaceFile(const Common::fs::path& target_path, const std::string& contents, std::string& error_message) {
     std::error_code ec;
     Common::fs::create_directories(target_path.parent_path(), ec);
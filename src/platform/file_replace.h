@@ -1,6 +1,7 @@
 #ifndef PROCESS_INTERFACE_PLATFORM_FILE_REPLACE_H
 #define PROCESS_INTERFACE_PLATFORM_FILE_REPLACE_H
 
+#include <cstdio>
 #include <string>
 
 #include "../common/fs_compat.h"
@@ -8,6 +9,8 @@
 namespace ProcessInterface {
 namespace Platform {
 
+// fflush plus fsync (_commit on Windows) so the bytes survive a crash.
+bool FlushFileDurable(FILE* file, std::string& error_message);
 bool AtomicReplaceFile(const Common::fs::path& target_path, const std::string& contents, std::string& error_message);
 
 }  // namespace Platform
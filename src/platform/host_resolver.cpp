@@ -0,0 +1,235 @@
+#include "host_resolver.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <system_error>
+#include <thread>
+
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
+#define PROCESS_INTERFACE_PLATFORM_WINDOWS 1
+#else
+#define PROCESS_INTERFACE_PLATFORM_WINDOWS 0
+#endif
+
+#if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+#include <netdb.h>
+#include <netinet/in.h>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+namespace {
+
+const int kPositiveTtlMs = 30000;
+const int kNegativeTtlMs = 5000;
+const int kFailureTtlMs = 1000;
+const std::size_t kMaxInFlightLookups = 8;
+const std::size_t kMaxCachedHosts = 256;
+
+std::string GaiErrorCode(const int gai_rc) {
+    if (gai_rc == EAI_NONAME) {
+        return "not_found";
+    }
+#if defined(EAI_NODATA) && (!defined(EAI_NONAME) || EAI_NODATA != EAI_NONAME)
+    if (gai_rc == EAI_NODATA) {
+        return "not_found";
+    }
+#endif
+    if (gai_rc == EAI_AGAIN) {
+        return "temporary_failure";
+    }
+    return "failed";
+}
+
+std::string GaiErrorMessage(const int gai_rc, const int saved_errno) {
+#if defined(EAI_SYSTEM)
+    if (gai_rc == EAI_SYSTEM) {
+        return std::string("getaddrinfo: ") + std::strerror(saved_errno);
+    }
+#else
+    (void)saved_errno;
+#endif
+    return std::string("getaddrinfo: ") + gai_strerror(gai_rc);
+}
+
+HostLookupResult ResolveBlocking(const std::string& host) {
+    HostLookupResult result;
+    result.ok = false;
+
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    struct addrinfo* results = NULL;
+    const int gai_rc = ::getaddrinfo(host.c_str(), NULL, &hints, &results);
+    const int saved_errno = errno;
+    if (gai_rc != 0) {
+        result.error_code = GaiErrorCode(gai_rc);
+        result.error_message = GaiErrorMessage(gai_rc, saved_errno);
+        return result;
+    }
+
+    for (struct addrinfo* ai = results; ai != NULL; ai = ai->ai_next) {
+        if (ai->ai_addr == NULL || ai->ai_addrlen > sizeof(struct sockaddr_storage)) {
+            continue;
+        }
+        ResolvedAddress address;
+        std::memset(&address, 0, sizeof(address));
+        std::memcpy(&address.address, ai->ai_addr, ai->ai_addrlen);
+        address.length = static_cast<socklen_t>(ai->ai_addrlen);
+        address.family = ai->ai_family;
+        address.socktype = ai->ai_socktype;
+        address.protocol = ai->ai_protocol;
+        result.addresses.push_back(address);
+    }
+    ::freeaddrinfo(results);
+
+    if (result.addresses.empty()) {
+        result.error_code = "not_found";
+        result.error_message = "getaddrinfo returned no addresses";
+        return result;
+    }
+    result.ok = true;
+    return result;
+}
+
+HostLookupResult FailedResult(const std::string& code, const std::string& message) {
+    HostLookupResult result;
+    result.ok = false;
+    result.error_code = code;
+    result.error_message = message;
+    return result;
+}
+
+}  // namespace
+
+struct HostLookup {
+    std::mutex mutex;
+    std::condition_variable completed;
+    bool done;
+    HostLookupResult result;
+
+    HostLookup()
+        : done(false) {}
+};
+
+HostResolver::HostResolver()
+    : state_(std::make_shared<State>()) {}
+
+std::shared_ptr<HostLookup> HostResolver::Start(const std::string& host) {
+    std::shared_ptr<HostLookup> lookup;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::map<std::string, CacheEntry>::iterator cached = state_->cache.find(host);
+        if (cached != state_->cache.end()) {
+            if (now < cached->second.expires) {
+                lookup = std::make_shared<HostLookup>();
+                lookup->done = true;
+                lookup->result = cached->second.result;
+                return lookup;
+            }
+            state_->cache.erase(cached);
+        }
+
+        std::map<std::string, std::shared_ptr<HostLookup> >::iterator running = state_->in_flight.find(host);
+        if (running != state_->in_flight.end()) {
+            return running->second;
+        }
+
+        lookup = std::make_shared<HostLookup>();
+        if (state_->in_flight.size() >= kMaxInFlightLookups) {
+            lookup->done = true;
+            lookup->result = FailedResult("busy", "too many host lookups in flight; resolver may be unresponsive");
+            return lookup;
+        }
+        state_->in_flight[host] = lookup;
+    }
+
+    const std::shared_ptr<State> state = state_;
+    try {
+        std::thread resolver_thread([state, host, lookup]() {
+            Complete(state, host, lookup, ResolveBlocking(host));
+        });
+        resolver_thread.detach();
+    } catch (const std::system_error& error) {
+        Complete(state, host, lookup, FailedResult("failed", std::string("failed to start lookup thread: ") + error.what()));
+    }
+    return lookup;
+}
+
+void HostResolver::Complete(
+    const std::shared_ptr<State>& state,
+    const std::string& host,
+    const std::shared_ptr<HostLookup>& lookup,
+    const HostLookupResult& result) {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->in_flight.erase(host);
+
+        int ttl_ms = kFailureTtlMs;
+        if (result.ok) {
+            ttl_ms = kPositiveTtlMs;
+        } else if (result.error_code == "not_found") {
+            ttl_ms = kNegativeTtlMs;
+        }
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (state->cache.size() >= kMaxCachedHosts) {
+            std::map<std::string, CacheEntry>::iterator iter = state->cache.begin();
+            while (iter != state->cache.end()) {
+                if (iter->second.expires <= now) {
+                    iter = state->cache.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+            if (state->cache.size() >= kMaxCachedHosts) {
+                state->cache.clear();
+            }
+        }
+        CacheEntry entry;
+        entry.result = result;
+        entry.expires = now + std::chrono::milliseconds(ttl_ms);
+        state->cache[host] = entry;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(lookup->mutex);
+        lookup->result = result;
+        lookup->done = true;
+    }
+    lookup->completed.notify_all();
+}
+
+bool HostResolver::TryGet(const std::shared_ptr<HostLookup>& lookup, HostLookupResult& result_out) {
+    std::lock_guard<std::mutex> lock(lookup->mutex);
+    if (!lookup->done) {
+        return false;
+    }
+    result_out = lookup->result;
+    return true;
+}
+
+void HostResolver::Wait(
+    const std::shared_ptr<HostLookup>& lookup,
+    const std::chrono::steady_clock::time_point deadline,
+    HostLookupResult& result_out) {
+    std::unique_lock<std::mutex> lock(lookup->mutex);
+    if (!lookup->completed.wait_until(lock, deadline, [&lookup]() { return lookup->done; })) {
+        result_out = FailedResult("timeout", "host lookup did not finish within the probe timeout");
+        return;
+    }
+    result_out = lookup->result;
+}
+
+HostResolver& SharedHostResolver() {
+    static HostResolver resolver;
+    return resolver;
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
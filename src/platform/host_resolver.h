@@ -0,0 +1,96 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_HOST_RESOLVER_H
+#define PROCESS_INTERFACE_PLATFORM_HOST_RESOLVER_H
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+struct ResolvedAddress {
+    struct sockaddr_storage address;
+    socklen_t length;
+    int family;
+    int socktype;
+    int protocol;
+};
+
+struct HostLookupResult {
+    bool ok;
+    // TCP stream addresses with port 0; callers set the port.
+    std::vector<ResolvedAddress> addresses;
+    // Empty when ok. "not_found", "temporary_failure", "timeout", "busy" or "failed".
+    std::string error_code;
+    std::string error_message;
+};
+
+// One resolution, possibly still running. Shared by the resolver thread and every caller
+// waiting for the same host.
+struct HostLookup;
+
+// getaddrinfo with a cache and without blocking callers past their deadline.
+//
+// Each lookup runs on its own detached thread; callers poll or wait for it with a deadline
+// and, when that passes, get a "timeout" result while the lookup keeps running and fills the
+// cache for the next caller. Concurrent lookups of one host share a thread. Answers are
+// cached for kPositiveTtlMs, "not_found" for kNegativeTtlMs and other failures for
+// kFailureTtlMs; getaddrinfo does not expose DNS TTLs. At most kMaxInFlightLookups threads
+// run at once so a hung resolver cannot pile up threads; past that, lookups fail "busy".
+class HostResolver {
+public:
+    HostResolver();
+
+    HostResolver(const HostResolver&) = delete;
+    HostResolver& operator=(const HostResolver&) = delete;
+
+    // Starts (or joins) a lookup of host; already complete on a cache hit.
+    std::shared_ptr<HostLookup> Start(const std::string& host);
+
+    // Copies the outcome into result_out once the lookup completed; false while it runs.
+    static bool TryGet(const std::shared_ptr<HostLookup>& lookup, HostLookupResult& result_out);
+
+    // Waits for the lookup until deadline; a lookup still running then yields "timeout".
+    static void Wait(
+        const std::shared_ptr<HostLookup>& lookup,
+        std::chrono::steady_clock::time_point deadline,
+        HostLookupResult& result_out);
+
+private:
+    struct CacheEntry {
+        HostLookupResult result;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    struct State {
+        std::mutex mutex;
+        std::map<std::string, CacheEntry> cache;
+        std::map<std::string, std::shared_ptr<HostLookup> > in_flight;
+    };
+
+    static void Complete(
+        const std::shared_ptr<State>& state,
+        const std::string& host,
+        const std::shared_ptr<HostLookup>& lookup,
+        const HostLookupResult& result);
+
+    std::shared_ptr<State> state_;
+};
+
+HostResolver& SharedHostResolver();
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_HOST_RESOLVER_H
@@ -0,0 +1,280 @@
+#include "listen_table.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <cstdlib>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+namespace {
+
+#if defined(__linux__)
+
+const char* const kListenState = "0A";
+
+// /proc/net/tcp{,6} print each 32-bit word of the address with %08X in host byte order, so
+// the parsed words are copied back as-is to get network byte order.
+bool ParseProcAddress(const std::string& text, const int version, IpAddress& address_out, int& port_out) {
+    const std::size_t colon = text.find(':');
+    const std::size_t word_count = version == 4 ? 1 : 4;
+    if (colon != word_count * 8) {
+        return false;
+    }
+    std::memset(&address_out, 0, sizeof(address_out));
+    address_out.version = version;
+    std::size_t index;
+    for (index = 0; index < word_count; ++index) {
+        const std::string word_text = text.substr(index * 8, 8);
+        char* end = NULL;
+        const unsigned long word = std::strtoul(word_text.c_str(), &end, 16);
+        if (end == NULL || *end != '\0') {
+            return false;
+        }
+        const std::uint32_t word32 = static_cast<std::uint32_t>(word);
+        std::memcpy(address_out.bytes + index * 4, &word32, 4);
+    }
+    char* end = NULL;
+    const unsigned long port = std::strtoul(text.c_str() + colon + 1, &end, 16);
+    if (end == NULL || *end != '\0' || port > 65535) {
+        return false;
+    }
+    port_out = static_cast<int>(port);
+    return true;
+}
+
+bool ReadListenSockets(const char* path, const int version, std::vector<ListeningSocket>& sockets_out) {
+    std::ifstream input(path);
+    if (!input) {
+        return false;
+    }
+    std::string line;
+    std::getline(input, line);
+    while (std::getline(input, line)) {
+        std::istringstream fields(line);
+        std::string slot;
+        std::string local_address;
+        std::string remote_address;
+        std::string state;
+        std::string queues;
+        std::string timer;
+        std::string retransmits;
+        std::string uid;
+        std::string timeout;
+        unsigned long long inode = 0;
+        if (!(fields >> slot >> local_address >> remote_address >> state >> queues >> timer >> retransmits >> uid >> timeout >> inode)) {
+            continue;
+        }
+        if (state != kListenState) {
+            continue;
+        }
+        ListeningSocket socket_entry;
+        if (!ParseProcAddress(local_address, version, socket_entry.address, socket_entry.port)) {
+            continue;
+        }
+        socket_entry.inode = inode;
+        sockets_out.push_back(socket_entry);
+    }
+    return true;
+}
+
+void ReadInterfaceAddresses(std::vector<IpAddress>& addresses_out) {
+    struct ifaddrs* interfaces = NULL;
+    if (::getifaddrs(&interfaces) != 0) {
+        return;
+    }
+    for (struct ifaddrs* entry = interfaces; entry != NULL; entry = entry->ifa_next) {
+        if (entry->ifa_addr == NULL) {
+            continue;
+        }
+        IpAddress address;
+        std::memset(&address, 0, sizeof(address));
+        if (entry->ifa_addr->sa_family == AF_INET) {
+            const struct sockaddr_in* in4 = reinterpret_cast<const struct sockaddr_in*>(entry->ifa_addr);
+            address.version = 4;
+            std::memcpy(address.bytes, &in4->sin_addr, 4);
+        } else if (entry->ifa_addr->sa_family == AF_INET6) {
+            const struct sockaddr_in6* in6 = reinterpret_cast<const struct sockaddr_in6*>(entry->ifa_addr);
+            // Link-local addresses need a scope; hosts naming one go through connect.
+            if (IN6_IS_ADDR_LINKLOCAL(&in6->sin6_addr)) {
+                continue;
+            }
+            address.version = 6;
+            std::memcpy(address.bytes, &in6->sin6_addr, 16);
+        } else {
+            continue;
+        }
+        addresses_out.push_back(address);
+    }
+    ::freeifaddrs(interfaces);
+}
+
+bool ParseIpLiteral(const std::string& text, IpAddress& address_out) {
+    std::memset(&address_out, 0, sizeof(address_out));
+    std::string literal = text;
+    if (literal.size() > 2 && literal[0] == '[' && literal[literal.size() - 1] == ']') {
+        literal = literal.substr(1, literal.size() - 2);
+    }
+    if (::inet_pton(AF_INET, literal.c_str(), address_out.bytes) == 1) {
+        address_out.version = 4;
+        return true;
+    }
+    struct in6_addr in6;
+    if (::inet_pton(AF_INET6, literal.c_str(), &in6) != 1) {
+        return false;
+    }
+    if (IN6_IS_ADDR_V4MAPPED(&in6)) {
+        address_out.version = 4;
+        std::memcpy(address_out.bytes, in6.s6_addr + 12, 4);
+        return true;
+    }
+    address_out.version = 6;
+    std::memcpy(address_out.bytes, in6.s6_addr, 16);
+    return true;
+}
+
+bool SameAddress(const IpAddress& left, const IpAddress& right) {
+    const std::size_t size = left.version == 4 ? 4 : 16;
+    return left.version == right.version && std::memcmp(left.bytes, right.bytes, size) == 0;
+}
+
+bool IsUnspecified(const IpAddress& address) {
+    const std::size_t size = address.version == 4 ? 4 : 16;
+    std::size_t index;
+    for (index = 0; index < size; ++index) {
+        if (address.bytes[index] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsLoopback(const IpAddress& address) {
+    if (address.version == 4) {
+        return address.bytes[0] == 127;
+    }
+    std::size_t index;
+    for (index = 0; index < 15; ++index) {
+        if (address.bytes[index] != 0) {
+            return false;
+        }
+    }
+    return address.bytes[15] == 1;
+}
+
+// ::ffff:a.b.c.d
+bool IsV4MappedOf(const IpAddress& v6, const IpAddress& v4) {
+    static const unsigned char kPrefix[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+    return std::memcmp(v6.bytes, kPrefix, 12) == 0 && std::memcmp(v6.bytes + 12, v4.bytes, 4) == 0;
+}
+
+// Whether a connect to target reaches a socket listening on bound. A wildcard IPv6 listener
+// is assumed to be dual-stack (the Linux default); IPV6_V6ONLY is not visible in /proc.
+bool ListenerAccepts(const IpAddress& bound, const IpAddress& target) {
+    if (bound.version == target.version) {
+        return IsUnspecified(bound) || SameAddress(bound, target);
+    }
+    if (bound.version == 6 && target.version == 4) {
+        return IsUnspecified(bound) || IsV4MappedOf(bound, target);
+    }
+    return false;
+}
+
+#endif
+
+}  // namespace
+
+ListenTable::ListenTable()
+    : loaded_(false) {}
+
+bool ListenTable::Load() {
+    sockets_.clear();
+    interface_addresses_.clear();
+    loaded_ = false;
+#if defined(__linux__)
+    // tcp6 is missing when IPv6 is disabled; tcp alone is still a complete answer for IPv4.
+    if (!ReadListenSockets("/proc/net/tcp", 4, sockets_)) {
+        sockets_.clear();
+        return false;
+    }
+    (void)ReadListenSockets("/proc/net/tcp6", 6, sockets_);
+    ReadInterfaceAddresses(interface_addresses_);
+    loaded_ = true;
+#endif
+    return loaded_;
+}
+
+bool ListenTable::Loaded() const {
+    return loaded_;
+}
+
+bool ListenTable::FindLocalListeners(
+    const std::string& host,
+    const int port,
+    std::vector<ListeningSocket>& matches_out) const {
+    matches_out.clear();
+    if (!loaded_ || port <= 0 || port > 65535) {
+        return false;
+    }
+#if defined(__linux__)
+    std::vector<IpAddress> targets;
+    if (host == "localhost") {
+        // getaddrinfo yields both; connect succeeds if either accepts.
+        IpAddress address;
+        ParseIpLiteral("127.0.0.1", address);
+        targets.push_back(address);
+        ParseIpLiteral("::1", address);
+        targets.push_back(address);
+    } else {
+        IpAddress address;
+        if (!ParseIpLiteral(host, address) || IsUnspecified(address)) {
+            return false;
+        }
+        bool local = IsLoopback(address);
+        std::size_t index;
+        for (index = 0; !local && index < interface_addresses_.size(); ++index) {
+            local = SameAddress(interface_addresses_[index], address);
+        }
+        if (!local) {
+            return false;
+        }
+        targets.push_back(address);
+    }
+
+    std::size_t socket_index;
+    for (socket_index = 0; socket_index < sockets_.size(); ++socket_index) {
+        const ListeningSocket& listener = sockets_[socket_index];
+        if (listener.port != port) {
+            continue;
+        }
+        std::size_t target_index;
+        for (target_index = 0; target_index < targets.size(); ++target_index) {
+            if (ListenerAccepts(listener.address, targets[target_index])) {
+                matches_out.push_back(listener);
+                break;
+            }
+        }
+    }
+    return true;
+#else
+    (void)host;
+    return false;
+#endif
+}
+
+const std::vector<ListeningSocket>& ListenTable::Sockets() const {
+    return sockets_;
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
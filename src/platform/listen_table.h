@@ -0,0 +1,55 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_LISTEN_TABLE_H
+#define PROCESS_INTERFACE_PLATFORM_LISTEN_TABLE_H
+
+#include <string>
+#include <vector>
+
+namespace ProcessInterface {
+namespace Platform {
+
+struct IpAddress {
+    // 4 or 6.
+    int version;
+    // Network byte order; IPv4 uses the first 4 bytes.
+    unsigned char bytes[16];
+};
+
+struct ListeningSocket {
+    IpAddress address;
+    int port;
+    unsigned long long inode;
+};
+
+// Snapshot of the TCP sockets in LISTEN state of this host's network namespace, read from
+// /proc/net/tcp and /proc/net/tcp6 (Linux only), plus the addresses of the local interfaces.
+// Answers "is something listening on host:port" for hosts that name this machine without
+// connecting to the target. Meant to be loaded once and queried for all port probes of one
+// status evaluation; it is not refreshed.
+class ListenTable {
+public:
+    ListenTable();
+
+    // Returns false when the listen tables cannot be read (not Linux, no /proc).
+    bool Load();
+    bool Loaded() const;
+
+    // Listeners a TCP connect to host:port would reach. Handles "localhost" and IP literals
+    // of loopback or local interface addresses; returns false for any other host (remote,
+    // unresolved names, scoped IPv6), which callers probe with a connect instead.
+    bool FindLocalListeners(
+        const std::string& host,
+        int port,
+        std::vector<ListeningSocket>& matches_out) const;
+
+    const std::vector<ListeningSocket>& Sockets() const;
+
+private:
+    bool loaded_;
+    std::vector<ListeningSocket> sockets_;
+    std::vector<IpAddress> interface_addresses_;
+};
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_LISTEN_TABLE_H
@@ -0,0 +1,912 @@
+#include "native_action.h"
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "native_action_abi.h"
+#include "native_library.h"
+
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
+#define PROCESS_INTERFACE_PLATFORM_WINDOWS 1
+#else
+#define PROCESS_INTERFACE_PLATFORM_WINDOWS 0
+#endif
+
+#if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+namespace {
+
+typedef std::chrono::steady_clock SteadyClock;
+
+const int kWaitTickMs = 50;
+const int kDefaultKillGraceMs = 5000;
+// In-process runs that ignored should_stop keep their thread; past this many, new
+// in-process runs are refused instead of piling up more stuck threads.
+const int kMaxAbandonedRuns = 4;
+
+std::atomic<int> g_abandoned_runs(0);
+
+ProcessRunResult EmptyRunResult(const bool isolated) {
+    ProcessRunResult result;
+    result.launch_ok = false;
+    result.completed = false;
+    result.timed_out = false;
+    result.canceled = false;
+    result.exit_code = -1;
+    result.pid = 0;
+    result.supports_pid = isolated;
+    result.supports_timeout = true;
+    result.supports_cancel = true;
+    result.supports_separate_stderr = false;
+    return result;
+}
+
+// Entry points by library path and symbol; the ABI version is checked on first use.
+class NativeActionSymbols {
+public:
+    bool Resolve(
+        const Common::fs::path& library_path,
+        const std::string& symbol,
+        gpi_native_action_fn& fn_out,
+        std::string& error_message) {
+        const std::string key = library_path.string();
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const std::map<std::string, gpi_native_action_fn>::const_iterator cached = symbols_.find(key + "\n" + symbol);
+        if (cached != symbols_.end()) {
+            fn_out = cached->second;
+            return true;
+        }
+
+        void* handle = NULL;
+        if (!LoadNativeLibrary(library_path, handle, error_message)) {
+            return false;
+        }
+        const gpi_native_action_abi_version_fn version_fn = reinterpret_cast<gpi_native_action_abi_version_fn>(
+            FindNativeSymbol(handle, GPI_NATIVE_ACTION_ABI_VERSION_SYMBOL));
+        if (version_fn == NULL) {
+            error_message = "native action library does not export " +
+                std::string(GPI_NATIVE_ACTION_ABI_VERSION_SYMBOL) + ": " + key;
+            return false;
+        }
+        const unsigned int version = version_fn();
+        if (version != GPI_NATIVE_ACTION_ABI_VERSION) {
+            error_message = "native action library ABI version " + std::to_string(version) +
+                " is not supported (host is " + std::to_string(GPI_NATIVE_ACTION_ABI_VERSION) + "): " + key;
+            return false;
+        }
+
+        const gpi_native_action_fn fn = reinterpret_cast<gpi_native_action_fn>(FindNativeSymbol(handle, symbol));
+        if (fn == NULL) {
+            error_message = "native action symbol not found: " + symbol + " in " + key;
+            return false;
+        }
+        symbols_[key + "\n" + symbol] = fn;
+        fn_out = fn;
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, gpi_native_action_fn> symbols_;
+};
+
+NativeActionSymbols& SharedNativeActionSymbols() {
+    static NativeActionSymbols symbols;
+    return symbols;
+}
+
+// State shared by the waiting job thread and the executor thread. The executor holds its own
+// reference, so an abandoned run keeps it alive until the plugin finally returns.
+struct InProcessRun {
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done;
+    // Set when the waiter gave up; later output is dropped.
+    bool abandoned;
+    int rc;
+    std::string args_json;
+    std::string result_json;
+    std::string output_text;
+    std::function<void(const char*, std::size_t)> output_sink;
+    std::atomic<bool> stop;
+    gpi_native_action_host host;
+};
+
+void InProcessWriteOutput(void* context, const char* data, size_t size) {
+    InProcessRun* run = static_cast<InProcessRun*>(context);
+    if (data == NULL || size == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(run->mutex);
+    if (run->abandoned || run->done) {
+        return;
+    }
+    if (run->output_sink) {
+        run->output_sink(data, size);
+    } else {
+        run->output_text.append(data, size);
+    }
+}
+
+void InProcessSetResult(void* context, const char* json, size_t size) {
+    InProcessRun* run = static_cast<InProcessRun*>(context);
+    std::lock_guard<std::mutex> lock(run->mutex);
+    if (run->abandoned || run->done) {
+        return;
+    }
+    run->result_json.assign(json != NULL ? json : "", json != NULL ? size : 0);
+}
+
+int InProcessShouldStop(void* context) {
+    return static_cast<InProcessRun*>(context)->stop.load() ? 1 : 0;
+}
+
+bool RunInProcess(
+    const NativeActionRunOptions& options,
+    const gpi_native_action_fn fn,
+    ProcessRunResult& result,
+    std::string& result_json_out) {
+    if (g_abandoned_runs.load() >= kMaxAbandonedRuns) {
+        result.error_message = "too many native action runs did not stop; restart the host or use isolation";
+        return false;
+    }
+
+    const std::shared_ptr<InProcessRun> run = std::make_shared<InProcessRun>();
+    run->done = false;
+    run->abandoned = false;
+    run->rc = -1;
+    run->args_json = options.args_json;
+    run->output_sink = options.output_sink;
+    run->stop.store(false);
+    run->host.abi_version = GPI_NATIVE_ACTION_ABI_VERSION;
+    run->host.context = run.get();
+    run->host.write_output = InProcessWriteOutput;
+    run->host.set_result = InProcessSetResult;
+    run->host.should_stop = InProcessShouldStop;
+
+    try {
+        std::thread executor([run, fn]() {
+            int rc = -1;
+            try {
+                rc = fn(run->args_json.c_str(), &run->host);
+            } catch (...) {
+                InProcessWriteOutput(run.get(), "native action threw an exception\n", 34);
+            }
+            std::lock_guard<std::mutex> lock(run->mutex);
+            if (run->abandoned) {
+                g_abandoned_runs.fetch_sub(1);
+            }
+            run->rc = rc;
+            run->done = true;
+            run->done_cv.notify_all();
+        });
+        executor.detach();
+    } catch (const std::system_error& error) {
+        result.error_message = std::string("failed to start native action thread: ") + error.what();
+        return false;
+    }
+
+    result.launch_ok = true;
+
+    const int kill_grace_ms = options.kill_grace_ms > 0 ? options.kill_grace_ms : kDefaultKillGraceMs;
+    const bool has_deadline = options.timeout_ms > 0;
+    const SteadyClock::time_point deadline = SteadyClock::now() + std::chrono::milliseconds(options.timeout_ms);
+    SteadyClock::time_point give_up_at = SteadyClock::time_point::max();
+
+    std::unique_lock<std::mutex> lock(run->mutex);
+    while (!run->done) {
+        run->done_cv.wait_for(lock, std::chrono::milliseconds(kWaitTickMs));
+        if (run->done) {
+            break;
+        }
+
+        const SteadyClock::time_point now = SteadyClock::now();
+        if (!run->stop.load()) {
+            if (options.cancel_requested != NULL && options.cancel_requested->load()) {
+                result.canceled = true;
+            } else if (has_deadline && now >= deadline) {
+                result.timed_out = true;
+            }
+            if (result.canceled || result.timed_out) {
+                run->stop.store(true);
+                give_up_at = now + std::chrono::milliseconds(kill_grace_ms);
+            }
+        } else if (now >= give_up_at) {
+            run->abandoned = true;
+            g_abandoned_runs.fetch_add(1);
+            result.error_message = "native action did not stop; its thread was abandoned";
+            result.stdout_text = run->output_text;
+            result.completed = true;
+            return true;
+        }
+    }
+
+    result.exit_code = run->rc;
+    result.stdout_text = run->output_text;
+    result_json_out = run->result_json;
+    result.completed = true;
+    return true;
+}
+
+#if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+
+// Isolated runs go to worker processes: the host executable re-exec'd with
+// kNativeActionWorkerArg, speaking over a socket on its stdin/stdout. Every message is a
+// frame of a type byte, a 4-byte native-endian length and the payload.
+//   host -> worker: library path, symbol and cwd, then the args JSON, which starts the call
+//                   and carries the write end of the call's output pipe (SCM_RIGHTS).
+//   worker -> host: ready once started; per call set_result values, then the exit code in
+//                   decimal, or a load error instead of running the call.
+// Output goes straight into the pipe, so it survives a worker that crashes mid-call.
+const char kFrameLibrary = 'L';
+const char kFrameSymbol = 'F';
+const char kFrameCwd = 'C';
+const char kFrameArgs = 'A';
+const char kFrameReady = 'Y';
+const char kFrameResult = 'S';
+const char kFrameDone = 'D';
+const char kFrameLoadError = 'E';
+const std::size_t kFrameHeaderBytes = 1 + sizeof(std::uint32_t);
+const std::size_t kMaxFrameBytes = 64 * 1024 * 1024;
+const char kWorkerExecutable[] = "/proc/self/exe";
+const int kWorkerStartupTimeoutMs = 10000;
+// Idle workers kept for reuse; busier moments start more and retire the surplus.
+const std::size_t kMaxIdleWorkers = 2;
+
+volatile sig_atomic_t g_worker_stop_requested = 0;
+
+void HandleWorkerStop(int) {
+    g_worker_stop_requested = 1;
+}
+
+void CloseFd(int& fd) {
+    if (fd >= 0) {
+        (void)::close(fd);
+        fd = -1;
+    }
+}
+
+void WriteAll(const int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t wrote = ::write(fd, data, size);
+        if (wrote < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += wrote;
+        size -= static_cast<std::size_t>(wrote);
+    }
+}
+
+bool SendAll(const int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t wrote = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (wrote < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += wrote;
+        size -= static_cast<std::size_t>(wrote);
+    }
+    return true;
+}
+
+bool SendFrame(const int fd, const char type, const char* data, const std::size_t size) {
+    char header[kFrameHeaderBytes];
+    header[0] = type;
+    const std::uint32_t length = static_cast<std::uint32_t>(size);
+    std::memcpy(header + 1, &length, sizeof(length));
+    return SendAll(fd, header, sizeof(header)) && SendAll(fd, data, size);
+}
+
+bool SendFrame(const int fd, const char type, const std::string& payload) {
+    return SendFrame(fd, type, payload.data(), payload.size());
+}
+
+bool ReadInto(const int fd, std::string& buffer) {
+    char chunk[65536];
+    ssize_t got = 0;
+    do {
+        got = ::read(fd, chunk, sizeof(chunk));
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        return false;
+    }
+    buffer.append(chunk, static_cast<std::size_t>(got));
+    return true;
+}
+
+enum class FrameStatus {
+    kFrame,
+    kIncomplete,
+    kOversized,
+};
+
+FrameStatus TakeFrame(std::string& pending, char& type_out, std::string& payload_out) {
+    if (pending.size() < kFrameHeaderBytes) {
+        return FrameStatus::kIncomplete;
+    }
+    std::uint32_t length = 0;
+    std::memcpy(&length, pending.data() + 1, sizeof(length));
+    if (length > kMaxFrameBytes) {
+        return FrameStatus::kOversized;
+    }
+    if (pending.size() - kFrameHeaderBytes < length) {
+        return FrameStatus::kIncomplete;
+    }
+    type_out = pending[0];
+    payload_out.assign(pending, kFrameHeaderBytes, length);
+    pending.erase(0, kFrameHeaderBytes + length);
+    return FrameStatus::kFrame;
+}
+
+// Sends a frame with fd attached to its first byte; the receiver gets its own copy.
+bool SendFrameWithFd(const int fd, const char type, const std::string& payload, const int passed_fd) {
+    char header[kFrameHeaderBytes];
+    header[0] = type;
+    const std::uint32_t length = static_cast<std::uint32_t>(payload.size());
+    std::memcpy(header + 1, &length, sizeof(length));
+
+    struct iovec io;
+    io.iov_base = header;
+    io.iov_len = sizeof(header);
+    union {
+        char buffer[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    std::memset(&control, 0, sizeof(control));
+    struct msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &io;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+    struct cmsghdr* header_entry = CMSG_FIRSTHDR(&message);
+    header_entry->cmsg_level = SOL_SOCKET;
+    header_entry->cmsg_type = SCM_RIGHTS;
+    header_entry->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(header_entry), &passed_fd, sizeof(int));
+
+    ssize_t sent = 0;
+    do {
+        sent = ::sendmsg(fd, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent <= 0) {
+        return false;
+    }
+    return SendAll(fd, header + sent, sizeof(header) - static_cast<std::size_t>(sent)) &&
+        SendAll(fd, payload.data(), payload.size());
+}
+
+// Like ReadInto, and keeps the last fd passed along with the bytes in passed_fd (closing
+// any earlier one that was not taken).
+bool ReceiveInto(const int fd, std::string& buffer, int& passed_fd) {
+    char chunk[65536];
+    struct iovec io;
+    io.iov_base = chunk;
+    io.iov_len = sizeof(chunk);
+    union {
+        char buffer[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &io;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    ssize_t got = 0;
+    do {
+        got = ::recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        return false;
+    }
+    struct cmsghdr* entry;
+    for (entry = CMSG_FIRSTHDR(&message); entry != NULL; entry = CMSG_NXTHDR(&message, entry)) {
+        if (entry->cmsg_level == SOL_SOCKET && entry->cmsg_type == SCM_RIGHTS) {
+            CloseFd(passed_fd);
+            std::memcpy(&passed_fd, CMSG_DATA(entry), sizeof(int));
+        }
+    }
+    buffer.append(chunk, static_cast<std::size_t>(got));
+    return true;
+}
+
+// Worker side. The call's fd 1 and 2 are the host's output pipe, so host->write_output goes
+// there too and keeps its order relative to what the plugin prints itself.
+void WorkerWriteOutput(void*, const char* data, size_t size) {
+    if (data != NULL && size > 0) {
+        WriteAll(STDOUT_FILENO, data, size);
+    }
+}
+
+void WorkerSetResult(void* context, const char* json, size_t size) {
+    (void)SendFrame(*static_cast<int*>(context), kFrameResult, json != NULL ? json : "", json != NULL ? size : 0);
+}
+
+int WorkerShouldStop(void*) {
+    return g_worker_stop_requested != 0 ? 1 : 0;
+}
+
+void RunWorkerCall(
+    int channel_fd,
+    const std::string& library,
+    const std::string& symbol,
+    const std::string& cwd,
+    const std::string& args_json,
+    int& output_fd,
+    const std::string& base_cwd,
+    const int null_fd) {
+    gpi_native_action_fn fn = NULL;
+    std::string error_message;
+    if (output_fd < 0) {
+        error_message = "native action call arrived without an output pipe";
+    } else {
+        (void)SharedNativeActionSymbols().Resolve(library, symbol, fn, error_message);
+    }
+    if (fn == NULL) {
+        CloseFd(output_fd);
+        (void)SendFrame(channel_fd, kFrameLoadError, error_message);
+        return;
+    }
+
+    (void)::dup2(output_fd, STDOUT_FILENO);
+    (void)::dup2(output_fd, STDERR_FILENO);
+    CloseFd(output_fd);
+
+    int rc = 127;
+    if (!cwd.empty() && ::chdir(cwd.c_str()) != 0) {
+        const std::string message = "failed to set native action cwd: " + cwd + ": " + std::strerror(errno) + "\n";
+        WorkerWriteOutput(NULL, message.data(), message.size());
+    } else {
+        gpi_native_action_host host;
+        host.abi_version = GPI_NATIVE_ACTION_ABI_VERSION;
+        host.context = &channel_fd;
+        host.write_output = WorkerWriteOutput;
+        host.set_result = WorkerSetResult;
+        host.should_stop = WorkerShouldStop;
+
+        g_worker_stop_requested = 0;
+        try {
+            rc = fn(args_json.c_str(), &host) & 0xff;
+        } catch (...) {
+            WorkerWriteOutput(NULL, "native action threw an exception\n", 34);
+            rc = 255;
+        }
+        std::fflush(NULL);
+        (void)::chdir(base_cwd.c_str());
+    }
+
+    (void)::dup2(null_fd, STDOUT_FILENO);
+    (void)::dup2(null_fd, STDERR_FILENO);
+    (void)SendFrame(channel_fd, kFrameDone, std::to_string(rc));
+}
+
+// Host side.
+struct NativeActionWorker {
+    int pid;
+    int socket_fd;
+    // Bytes received after the last complete frame.
+    std::string pending;
+};
+
+bool WorkerAlive(const int pid) {
+    int status = 0;
+    return ::waitpid(pid, &status, WNOHANG) == 0;
+}
+
+void RetireWorker(const std::shared_ptr<NativeActionWorker>& worker) {
+    (void)::close(worker->socket_fd);
+    (void)TerminateProcessGroup(worker->pid, 0);
+}
+
+class NativeActionWorkers {
+public:
+    ~NativeActionWorkers() {
+        std::size_t index;
+        for (index = 0; index < idle_.size(); ++index) {
+            RetireWorker(idle_[index]);
+        }
+    }
+
+    std::shared_ptr<NativeActionWorker> Acquire(std::string& error_message) {
+        while (true) {
+            std::shared_ptr<NativeActionWorker> candidate;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (idle_.empty()) {
+                    break;
+                }
+                candidate = idle_.back();
+                idle_.pop_back();
+            }
+            if (WorkerAlive(candidate->pid)) {
+                return candidate;
+            }
+            RetireWorker(candidate);
+        }
+        return Start(error_message);
+    }
+
+    void Release(const std::shared_ptr<NativeActionWorker>& worker, const bool reusable) {
+        if (reusable) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (idle_.size() < kMaxIdleWorkers) {
+                idle_.push_back(worker);
+                return;
+            }
+        }
+        RetireWorker(worker);
+    }
+
+private:
+    std::shared_ptr<NativeActionWorker> Start(std::string& error_message) {
+        int sockets[2] = {-1, -1};
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+            error_message = std::string("socketpair failed: ") + std::strerror(errno);
+            return std::shared_ptr<NativeActionWorker>();
+        }
+
+        // argv is built before fork; the child only makes async-signal-safe calls until exec.
+        char* const argv[] = {
+            const_cast<char*>(kWorkerExecutable),
+            const_cast<char*>(kNativeActionWorkerArg),
+            NULL,
+        };
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            (void)::setpgid(0, 0);
+            (void)::signal(SIGPIPE, SIG_DFL);
+            (void)::dup2(sockets[1], STDIN_FILENO);
+            (void)::dup2(sockets[1], STDOUT_FILENO);
+            const int null_fd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+            if (null_fd >= 0) {
+                (void)::dup2(null_fd, STDERR_FILENO);
+            }
+            ::execv(kWorkerExecutable, argv);
+            ::_exit(127);
+        }
+        (void)::close(sockets[1]);
+
+        if (pid < 0) {
+            error_message = std::string("fork failed: ") + std::strerror(errno);
+            (void)::close(sockets[0]);
+            return std::shared_ptr<NativeActionWorker>();
+        }
+        (void)::setpgid(pid, pid);
+
+        std::shared_ptr<NativeActionWorker> worker = std::make_shared<NativeActionWorker>();
+        worker->pid = static_cast<int>(pid);
+        worker->socket_fd = sockets[0];
+
+        const SteadyClock::time_point deadline = SteadyClock::now() + std::chrono::milliseconds(kWorkerStartupTimeoutMs);
+        char type = 0;
+        std::string payload;
+        while (TakeFrame(worker->pending, type, payload) == FrameStatus::kIncomplete) {
+            struct pollfd entry;
+            entry.fd = worker->socket_fd;
+            entry.events = POLLIN;
+            entry.revents = 0;
+            if (SteadyClock::now() >= deadline ||
+                (::poll(&entry, 1, kWaitTickMs) > 0 && !ReadInto(worker->socket_fd, worker->pending))) {
+                break;
+            }
+        }
+        if (type != kFrameReady) {
+            error_message = "native action worker did not start";
+            RetireWorker(worker);
+            return std::shared_ptr<NativeActionWorker>();
+        }
+        return worker;
+    }
+
+    std::mutex mutex_;
+    // Most recently used last.
+    std::vector<std::shared_ptr<NativeActionWorker> > idle_;
+};
+
+NativeActionWorkers& SharedNativeActionWorkers() {
+    static NativeActionWorkers workers;
+    return workers;
+}
+
+void ForwardOutput(const NativeActionRunOptions& options, std::string& pending, std::string& text_out) {
+    if (pending.empty()) {
+        return;
+    }
+    if (options.output_sink) {
+        options.output_sink(pending.data(), pending.size());
+    } else {
+        text_out.append(pending);
+    }
+    pending.clear();
+}
+
+bool RunIsolated(
+    const NativeActionRunOptions& options,
+    ProcessRunResult& result,
+    std::string& result_json_out) {
+    int output_pipe[2] = {-1, -1};
+    if (!OpenCloseOnExecPipe(output_pipe)) {
+        result.error_message = std::string("pipe failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    const std::shared_ptr<NativeActionWorker> worker = SharedNativeActionWorkers().Acquire(result.error_message);
+    if (!worker) {
+        CloseFd(output_pipe[0]);
+        CloseFd(output_pipe[1]);
+        return false;
+    }
+    const bool sent = SendFrame(worker->socket_fd, kFrameLibrary, options.library_path.string()) &&
+        SendFrame(worker->socket_fd, kFrameSymbol, options.symbol) &&
+        SendFrame(worker->socket_fd, kFrameCwd, options.cwd.string()) &&
+        SendFrameWithFd(worker->socket_fd, kFrameArgs, options.args_json, output_pipe[1]);
+    CloseFd(output_pipe[1]);
+    if (!sent) {
+        CloseFd(output_pipe[0]);
+        SharedNativeActionWorkers().Release(worker, false);
+        result.error_message = "native action worker rejected the call";
+        return false;
+    }
+
+    result.launch_ok = true;
+    result.pid = worker->pid;
+
+    const int kill_grace_ms = options.kill_grace_ms > 0 ? options.kill_grace_ms : kDefaultKillGraceMs;
+    const bool has_deadline = options.timeout_ms > 0;
+    const SteadyClock::time_point deadline = SteadyClock::now() + std::chrono::milliseconds(options.timeout_ms);
+    SteadyClock::time_point kill_at = SteadyClock::time_point::max();
+
+    bool terminating = false;
+    bool killed = false;
+    bool done = false;
+    bool closed = false;
+    bool oversized = false;
+    bool load_failed = false;
+    int exit_code = -1;
+    std::string pending_output;
+
+    // Runs until the worker reports the end of the call or goes away, then drains whatever
+    // is already buffered in the output pipe without waiting on descendants holding it open.
+    while (true) {
+        char type = 0;
+        std::string payload;
+        const FrameStatus status = done || closed ? FrameStatus::kIncomplete : TakeFrame(worker->pending, type, payload);
+        if (status == FrameStatus::kOversized) {
+            oversized = true;
+            closed = true;
+        } else if (status == FrameStatus::kFrame) {
+            if (type == kFrameResult) {
+                result_json_out = payload;
+            } else if (type == kFrameDone) {
+                exit_code = std::atoi(payload.c_str());
+                done = true;
+            } else if (type == kFrameLoadError) {
+                load_failed = true;
+                result.error_message = payload;
+                done = true;
+            }
+            continue;
+        }
+
+        const bool finished = done || closed;
+        const SteadyClock::time_point now = SteadyClock::now();
+        if (!terminating && !finished) {
+            if (options.cancel_requested != NULL && options.cancel_requested->load()) {
+                result.canceled = true;
+                terminating = true;
+            } else if (has_deadline && now >= deadline) {
+                result.timed_out = true;
+                terminating = true;
+            }
+            if (terminating) {
+                // Turns should_stop on in the worker and signals whatever the plugin started.
+                (void)::kill(-worker->pid, SIGTERM);
+                kill_at = now + std::chrono::milliseconds(kill_grace_ms);
+            }
+        } else if (terminating && !killed && !finished && now >= kill_at) {
+            (void)::kill(-worker->pid, SIGKILL);
+            killed = true;
+        }
+
+        struct pollfd entries[2];
+        nfds_t count = 0;
+        if (output_pipe[0] >= 0) {
+            entries[count].fd = output_pipe[0];
+            entries[count].events = POLLIN;
+            entries[count].revents = 0;
+            ++count;
+        }
+        if (!finished) {
+            entries[count].fd = worker->socket_fd;
+            entries[count].events = POLLIN;
+            entries[count].revents = 0;
+            ++count;
+        }
+        if (count == 0 || ::poll(entries, count, finished ? 0 : kWaitTickMs) <= 0) {
+            if (finished) {
+                break;
+            }
+            continue;
+        }
+
+        nfds_t entry_index;
+        for (entry_index = 0; entry_index < count; ++entry_index) {
+            if ((entries[entry_index].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+                continue;
+            }
+            if (entries[entry_index].fd == output_pipe[0]) {
+                if (!ReadInto(output_pipe[0], pending_output)) {
+                    CloseFd(output_pipe[0]);
+                }
+            } else if (!ReadInto(worker->socket_fd, worker->pending)) {
+                closed = true;
+            }
+        }
+        ForwardOutput(options, pending_output, result.stdout_text);
+    }
+    CloseFd(output_pipe[0]);
+
+    if (load_failed) {
+        result.launch_ok = false;
+        result.pid = 0;
+        SharedNativeActionWorkers().Release(worker, true);
+        return false;
+    }
+    if (done && !terminating) {
+        result.exit_code = exit_code;
+        SharedNativeActionWorkers().Release(worker, true);
+        result.completed = true;
+        return true;
+    }
+
+    // A stopped, crashed or broken worker is not reused; its process group goes with it.
+    (void)::close(worker->socket_fd);
+    const int worker_exit_code = TerminateProcessGroup(worker->pid, 0);
+    if (done) {
+        result.exit_code = exit_code;
+    } else {
+        result.exit_code = worker_exit_code;
+        if (oversized) {
+            result.error_message = "native action worker sent an oversized frame";
+        } else if (!terminating) {
+            result.error_message = worker_exit_code > 128
+                ? "native action crashed with signal " + std::to_string(worker_exit_code - 128)
+                : "native action worker exited during the call";
+        }
+    }
+    result.completed = true;
+    return true;
+}
+
+#endif
+
+}  // namespace
+
+bool RunNativeAction(
+    const NativeActionRunOptions& options,
+    ProcessRunResult& result_out,
+    std::string& result_json_out) {
+    ProcessRunResult result = EmptyRunResult(options.isolated);
+    result_json_out.clear();
+
+    // Isolated runs load the library in a worker only, never in the host.
+    gpi_native_action_fn fn = NULL;
+    if (!options.isolated &&
+        !SharedNativeActionSymbols().Resolve(options.library_path, options.symbol, fn, result.error_message)) {
+        result_out = result;
+        return false;
+    }
+
+    if (options.cancel_requested != NULL && options.cancel_requested->load()) {
+        result.launch_ok = true;
+        result.canceled = true;
+        result.completed = true;
+        result_out = result;
+        return true;
+    }
+
+    bool launched = false;
+    if (options.isolated) {
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+        result.error_message = "native action isolation is not available on this platform";
+#else
+        launched = RunIsolated(options, result, result_json_out);
+#endif
+    } else {
+        launched = RunInProcess(options, fn, result, result_json_out);
+    }
+    result_out = result;
+    return launched;
+}
+
+const char kNativeActionWorkerArg[] = "--native-action-worker";
+
+int RunNativeActionWorker() {
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    return 2;
+#else
+    (void)::signal(SIGPIPE, SIG_IGN);
+    struct sigaction stop_action;
+    std::memset(&stop_action, 0, sizeof(stop_action));
+    stop_action.sa_handler = HandleWorkerStop;
+    (void)::sigaction(SIGTERM, &stop_action, NULL);
+
+    // The protocol socket moves off 0/1 so that calls can point those at their capture pipe.
+    const int channel_fd = ::fcntl(STDIN_FILENO, F_DUPFD_CLOEXEC, 3);
+    const int null_fd = ::open("/dev/null", O_RDWR | O_CLOEXEC);
+    if (channel_fd < 0 || null_fd < 0) {
+        return 2;
+    }
+    (void)::dup2(null_fd, STDIN_FILENO);
+    (void)::dup2(null_fd, STDOUT_FILENO);
+    (void)::dup2(null_fd, STDERR_FILENO);
+
+    std::error_code cwd_error;
+    const std::string base_cwd = Common::fs::current_path(cwd_error).string();
+    const std::string pid_text = std::to_string(static_cast<long>(::getpid()));
+    (void)SendFrame(channel_fd, kFrameReady, pid_text);
+
+    std::string pending;
+    std::string library;
+    std::string symbol;
+    std::string cwd;
+    int output_fd = -1;
+    while (true) {
+        char type = 0;
+        std::string payload;
+        const FrameStatus status = TakeFrame(pending, type, payload);
+        if (status == FrameStatus::kOversized) {
+            return 2;
+        }
+        if (status == FrameStatus::kIncomplete) {
+            if (!ReceiveInto(channel_fd, pending, output_fd)) {
+                return 0;
+            }
+            continue;
+        }
+        if (type == kFrameLibrary) {
+            library = payload;
+        } else if (type == kFrameSymbol) {
+            symbol = payload;
+        } else if (type == kFrameCwd) {
+            cwd = payload;
+        } else if (type == kFrameArgs) {
+            RunWorkerCall(channel_fd, library, symbol, cwd, payload, output_fd, base_cwd, null_fd);
+        }
+    }
+#endif
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
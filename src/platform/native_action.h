@@ -0,0 +1,56 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_NATIVE_ACTION_H
+#define PROCESS_INTERFACE_PLATFORM_NATIVE_ACTION_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "../common/fs_compat.h"
+#include "process_exec.h"
+
+namespace ProcessInterface {
+namespace Platform {
+
+struct NativeActionRunOptions {
+    Common::fs::path library_path;
+    std::string symbol;
+    // JSON object handed to the entry point.
+    std::string args_json;
+    // Applied in isolated runs only; in-process runs share the host's cwd.
+    Common::fs::path cwd;
+    // Runs the entry point in a reusable worker process so a crash only ends that worker.
+    bool isolated;
+    int timeout_ms;
+    // Time a stopped plugin gets to return before it is abandoned (in-process) or killed.
+    int kill_grace_ms;
+    const std::atomic<bool>* cancel_requested;
+    std::function<void(const char*, std::size_t)> output_sink;
+};
+
+// Loads library_path once per host process (it is never unloaded; replacing the file needs
+// a host restart) and calls symbol with the native action ABI from native_action_abi.h.
+// The result mirrors RunForkExecProcess: exit_code is the entry point's return value and
+// output goes to output_sink or stdout_text. result_json_out is the last set_result value.
+// In-process runs execute on their own thread; on timeout or cancel should_stop turns on
+// and a plugin that does not return within kill_grace_ms is abandoned and keeps its thread.
+// Isolated runs go to a worker that loads the library itself; a worker whose call timed out,
+// was canceled or crashed is killed with its process group and replaced on the next run.
+// Returns false with launch_ok=false when the library or symbol cannot be loaded.
+bool RunNativeAction(
+    const NativeActionRunOptions& options,
+    ProcessRunResult& result_out,
+    std::string& result_json_out);
+
+// Isolation workers are the host executable (/proc/self/exe) started with this as its only
+// argument; its main must then return RunNativeActionWorker() before doing anything else.
+extern const char kNativeActionWorkerArg[];
+
+// Serves isolated calls over the socket on stdin/stdout until the host closes it; returns
+// the worker's exit code.
+int RunNativeActionWorker();
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_NATIVE_ACTION_H
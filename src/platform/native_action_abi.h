@@ -0,0 +1,47 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_NATIVE_ACTION_ABI_H
+#define PROCESS_INTERFACE_PLATFORM_NATIVE_ACTION_ABI_H
+
+/*
+ * C ABI for "type": "native" catalog actions. A plugin is a shared library that exports
+ * gpi_native_action_abi_version() plus one entry point per action:
+ *
+ *     int my_action(const char* args_json, const gpi_native_action_host* host);
+ *
+ * args_json is a JSON object of the invocation args (string values). The return value is
+ * the action's exit code; 0 means success. Plugins must not keep pointers to args_json or
+ * host after returning. Every host callback may be called from the thread the entry point
+ * runs on; none of them may be called after it returns.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPI_NATIVE_ACTION_ABI_VERSION 1u
+#define GPI_NATIVE_ACTION_ABI_VERSION_SYMBOL "gpi_native_action_abi_version"
+
+typedef struct gpi_native_action_host {
+    /* GPI_NATIVE_ACTION_ABI_VERSION of the host. */
+    unsigned int abi_version;
+    /* Opaque; pass back unchanged to the callbacks below. */
+    void* context;
+    /* Appends to the job's output, the same stream a process action's stdout goes to. */
+    void (*write_output)(void* context, const char* data, size_t size);
+    /* Sets the job result; json must be an object. The last call wins. Without a call the
+       first JSON object in the output is used, as for process actions. */
+    void (*set_result)(void* context, const char* json, size_t size);
+    /* Non-zero once the job is canceled or timed out; long-running plugins should poll it
+       and return promptly. */
+    int (*should_stop)(void* context);
+} gpi_native_action_host;
+
+typedef int (*gpi_native_action_fn)(const char* args_json, const gpi_native_action_host* host);
+typedef unsigned int (*gpi_native_action_abi_version_fn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROCESS_INTERFACE_PLATFORM_NATIVE_ACTION_ABI_H */
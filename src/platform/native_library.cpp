@@ -0,0 +1,70 @@
+#include "native_library.h"
+
+#include <map>
+#include <mutex>
+
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
+#define PROCESS_INTERFACE_PLATFORM_WINDOWS 1
+#else
+#define PROCESS_INTERFACE_PLATFORM_WINDOWS 0
+#endif
+
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+namespace {
+
+std::mutex g_libraries_mutex;
+std::map<std::string, void*> g_libraries;
+
+}  // namespace
+
+bool LoadNativeLibrary(const Common::fs::path& library_path, void*& handle_out, std::string& error_message) {
+    const std::string key = library_path.string();
+    std::lock_guard<std::mutex> lock(g_libraries_mutex);
+
+    const std::map<std::string, void*>::const_iterator loaded = g_libraries.find(key);
+    if (loaded != g_libraries.end()) {
+        handle_out = loaded->second;
+        return true;
+    }
+
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    void* handle = reinterpret_cast<void*>(::LoadLibraryA(key.c_str()));
+    if (handle == NULL) {
+        error_message = "failed to load native library: " + key;
+        return false;
+    }
+#else
+    void* handle = ::dlopen(key.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == NULL) {
+        const char* detail = ::dlerror();
+        error_message = "failed to load native library: " + (detail != NULL ? std::string(detail) : key);
+        return false;
+    }
+#endif
+
+    g_libraries[key] = handle;
+    handle_out = handle;
+    return true;
+}
+
+void* FindNativeSymbol(void* handle, const std::string& symbol) {
+    if (handle == NULL) {
+        return NULL;
+    }
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    return reinterpret_cast<void*>(::GetProcAddress(reinterpret_cast<HMODULE>(handle), symbol.c_str()));
+#else
+    return ::dlsym(handle, symbol.c_str());
+#endif
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
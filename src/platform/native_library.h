@@ -0,0 +1,22 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_NATIVE_LIBRARY_H
+#define PROCESS_INTERFACE_PLATFORM_NATIVE_LIBRARY_H
+
+#include <string>
+
+#include "../common/fs_compat.h"
+
+namespace ProcessInterface {
+namespace Platform {
+
+// Loads a shared library once per host process and keeps it loaded: plugin code may still
+// be running on an abandoned thread, and callers cache entry points by address. Repeated
+// calls with the same path return the same handle.
+bool LoadNativeLibrary(const Common::fs::path& library_path, void*& handle_out, std::string& error_message);
+
+// NULL when the library does not export symbol.
+void* FindNativeSymbol(void* handle, const std::string& symbol);
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_NATIVE_LIBRARY_H
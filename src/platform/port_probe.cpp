@@ -3,8 +3,13 @@
 #include <cerrno>
 #include <chrono>
 #include <cstring>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include "host_resolver.h"
 
 #if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
 #define PROCESS_INTERFACE_PLATFORM_WINDOWS 1
@@ -18,8 +23,8 @@
 #pragma comment(lib, "Ws2_32.lib")
 #else
 #include <fcntl.h>
-#include <netdb.h>
-#include <sys/select.h>
+#include <netinet/in.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -143,234 +148,448 @@ static void CloseSocket(const int fd)
 
 #endif
 
-static bool ConnectWithTimeout(const char* host,
-                               const char* port_str,
-                               const int timeout_ms)
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+typedef SOCKET SocketHandle;
+typedef WSAPOLLFD PollEntry;
+static const SocketHandle kInvalidSocket = INVALID_SOCKET;
+
+static bool ConnectInProgress()
 {
-    bool connected = false;
+    const int wsa_err = ::WSAGetLastError();
+    return wsa_err == WSAEWOULDBLOCK || wsa_err == WSAEINPROGRESS || wsa_err == WSAEALREADY;
+}
+
+static int PollSockets(PollEntry* entries, const std::size_t count, const int wait_ms)
+{
+    return ::WSAPoll(entries, static_cast<ULONG>(count), wait_ms);
+}
+
+static bool PollInterrupted()
+{
+    return false;
+}
+
+static bool ReadSocketError(SocketHandle s, int& so_error)
+{
+    int so_len = static_cast<int>(sizeof(so_error));
+    return ::getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&so_error), &so_len) == 0;
+}
+#else
+typedef int SocketHandle;
+typedef struct pollfd PollEntry;
+static const SocketHandle kInvalidSocket = -1;
+
+static bool ConnectInProgress()
+{
+    return errno == EINPROGRESS;
+}
+
+static int PollSockets(PollEntry* entries, const std::size_t count, const int wait_ms)
+{
+    return ::poll(entries, static_cast<nfds_t>(count), wait_ms);
+}
+
+static bool PollInterrupted()
+{
+    return errno == EINTR;
+}
 
-    if (host == NULL || port_str == NULL)
+static bool ReadSocketError(const SocketHandle fd, int& so_error)
+{
+    socklen_t so_len = static_cast<socklen_t>(sizeof(so_error));
+    return ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &so_len) == 0;
+}
+#endif
+
+static int LastSocketError()
+{
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    return ::WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+static void SetConnectError(const int socket_error, PortProbeResult& result)
+{
+    result.error_stage = "connect";
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    if (socket_error == WSAECONNREFUSED)
     {
-        connected = false;
+        result.error_code = "refused";
+    }
+    else if (socket_error == WSAENETUNREACH || socket_error == WSAEHOSTUNREACH)
+    {
+        result.error_code = "unreachable";
     }
     else
     {
-#if PROCESS_INTERFACE_PLATFORM_WINDOWS
-        if (!EnsureWinSockInitialized())
+        result.error_code = "failed";
+    }
+    result.error_message = "winsock error " + std::to_string(socket_error);
+#else
+    if (socket_error == ECONNREFUSED)
+    {
+        result.error_code = "refused";
+    }
+    else if (socket_error == ENETUNREACH || socket_error == EHOSTUNREACH)
+    {
+        result.error_code = "unreachable";
+    }
+    else
+    {
+        result.error_code = "failed";
+    }
+    result.error_message = std::strerror(socket_error);
+#endif
+}
+
+// A non-blocking connect that has not completed yet; target indexes the batch.
+struct PendingConnect
+{
+    std::size_t target;
+    SocketHandle socket_handle;
+};
+
+struct TargetState
+{
+    std::chrono::steady_clock::time_point deadline;
+    std::shared_ptr<HostLookup> lookup;
+    bool resolved;
+    bool done;
+    bool timed_out;
+    std::size_t connects_in_flight;
+    int last_error;
+};
+
+// How often lookups still running are checked while the batch waits on sockets.
+static const int kLookupPollMs = 5;
+
+// Starts a non-blocking connect to every resolved address. Returns true when one of them
+// completed at once; the others are appended to pending.
+static bool StartConnects(const HostLookupResult& lookup,
+                          const int port,
+                          const std::size_t target_index,
+                          TargetState& state,
+                          std::vector<PendingConnect>& pending)
+{
+    bool connected = false;
+
+    std::size_t index;
+    for (index = 0; index < lookup.addresses.size() && !connected; ++index)
+    {
+        ResolvedAddress address = lookup.addresses[index];
+        if (address.family == AF_INET)
+        {
+            reinterpret_cast<struct sockaddr_in*>(&address.address)->sin_port =
+                htons(static_cast<unsigned short>(port));
+        }
+        else if (address.family == AF_INET6)
+        {
+            reinterpret_cast<struct sockaddr_in6*>(&address.address)->sin6_port =
+                htons(static_cast<unsigned short>(port));
+        }
+        else
+        {
+            continue;
+        }
+
+        SocketHandle s = ::socket(address.family, address.socktype, address.protocol);
+        if (s == kInvalidSocket)
+        {
+            state.last_error = LastSocketError();
+            continue;
+        }
+
+        if (!SetNonBlocking(s, true))
+        {
+            state.last_error = LastSocketError();
+            CloseSocket(s);
+            continue;
+        }
+
+        const int rc = ::connect(s,
+                                 reinterpret_cast<const struct sockaddr*>(&address.address),
+                                 address.length);
+
+        if (rc == 0)
+        {
+            connected = true;
+            CloseSocket(s);
+        }
+        else if (ConnectInProgress())
         {
-            connected = false;
+            PendingConnect entry;
+            entry.target = target_index;
+            entry.socket_handle = s;
+            pending.push_back(entry);
+            ++state.connects_in_flight;
         }
         else
+        {
+            state.last_error = LastSocketError();
+            CloseSocket(s);
+        }
+    }
+
+    return connected;
+}
+
+}  // namespace
+
+void CheckPortsListening(const std::vector<PortProbeTarget>& targets,
+                         std::vector<PortProbeResult>& results_out)
+{
+    results_out.assign(targets.size(), PortProbeResult());
+
+    std::size_t index;
+    for (index = 0; index < results_out.size(); ++index)
+    {
+        results_out[index].listening = false;
+    }
+
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    if (!EnsureWinSockInitialized())
+    {
+        for (index = 0; index < results_out.size(); ++index)
+        {
+            results_out[index].error_stage = "connect";
+            results_out[index].error_code = "failed";
+            results_out[index].error_message = "WSAStartup failed";
+        }
+        return;
+    }
 #endif
+
+    // Lookups start together and share each target's deadline with its connects, so a slow
+    // resolver eats into the probe budget instead of extending it.
+    const std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    std::vector<TargetState> states(targets.size());
+    HostResolver& resolver = SharedHostResolver();
+
+    for (index = 0; index < targets.size(); ++index)
+    {
+        TargetState& state = states[index];
+        state.deadline = started + std::chrono::milliseconds(ClampTimeoutMs(targets[index].timeout_ms));
+        state.resolved = false;
+        state.done = false;
+        state.timed_out = false;
+        state.connects_in_flight = 0;
+        state.last_error = 0;
+
+        if (targets[index].host.empty() || !IsValidPort(targets[index].port))
         {
-            struct addrinfo hints;
-            std::memset(&hints, 0, sizeof(hints));
+            state.done = true;
+            results_out[index].error_stage = "resolve";
+            results_out[index].error_code = "invalid";
+            results_out[index].error_message = targets[index].host.empty() ? "empty host" : "invalid port";
+            continue;
+        }
 
-            hints.ai_family = AF_UNSPEC;
-            hints.ai_socktype = SOCK_STREAM;
-            hints.ai_protocol = IPPROTO_TCP;
+        state.lookup = resolver.Start(targets[index].host);
+    }
 
-            struct addrinfo* results = NULL;
-            const int gai_rc = ::getaddrinfo(host, port_str, &hints, &results);
+    std::vector<PendingConnect> pending;
+    std::vector<PollEntry> entries;
+    while (true)
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point nearest = now;
+        bool have_nearest = false;
+        bool lookups_running = false;
 
-            if (gai_rc != 0 || results == NULL)
+        for (index = 0; index < targets.size(); ++index)
+        {
+            TargetState& state = states[index];
+            if (state.done || state.resolved)
             {
-                connected = false;
+                continue;
+            }
+
+            HostLookupResult lookup;
+            if (HostResolver::TryGet(state.lookup, lookup))
+            {
+                state.resolved = true;
+                if (!lookup.ok)
+                {
+                    state.done = true;
+                    results_out[index].error_stage = "resolve";
+                    results_out[index].error_code = lookup.error_code;
+                    results_out[index].error_message = lookup.error_message;
+                }
+                else if (StartConnects(lookup, targets[index].port, index, state, pending))
+                {
+                    state.done = true;
+                    results_out[index].listening = true;
+                }
+                else if (state.connects_in_flight == 0)
+                {
+                    state.done = true;
+                }
+            }
+            else if (now >= state.deadline)
+            {
+                state.done = true;
+                results_out[index].error_stage = "resolve";
+                results_out[index].error_code = "timeout";
+                results_out[index].error_message = "host lookup did not finish within the probe timeout";
             }
             else
             {
-                for (struct addrinfo* ai = results; ai != NULL; ai = ai->ai_next)
+                lookups_running = true;
+                if (!have_nearest || state.deadline < nearest)
                 {
-#if PROCESS_INTERFACE_PLATFORM_WINDOWS
-                    SOCKET s = ::socket(ai->ai_family,
-                                        ai->ai_socktype,
-                                        ai->ai_protocol);
-                    if (s == INVALID_SOCKET)
-                    {
-                        continue;
-                    }
-
-                    if (!SetNonBlocking(s, true))
-                    {
-                        CloseSocket(s);
-                        continue;
-                    }
-
-                    int rc = ::connect(s, ai->ai_addr,
-                                      static_cast<int>(ai->ai_addrlen));
-
-                    if (rc == 0)
-                    {
-                        connected = true;
-                        CloseSocket(s);
-                        break;
-                    }
-
-                    const int wsa_err = ::WSAGetLastError();
-                    if (wsa_err != WSAEWOULDBLOCK
-                        && wsa_err != WSAEINPROGRESS
-                        && wsa_err != WSAEALREADY
-                        && wsa_err != WSAEINVAL)
-                    {
-                        CloseSocket(s);
-                        continue;
-                    }
-
-                    fd_set write_fds;
-                    FD_ZERO(&write_fds);
-                    FD_SET(s, &write_fds);
-
-                    timeval tv;
-                    tv.tv_sec = timeout_ms / 1000;
-                    tv.tv_usec = (timeout_ms % 1000) * 1000;
-
-                    rc = ::select(0, NULL, &write_fds, NULL, &tv);
-                    if (rc > 0 && FD_ISSET(s, &write_fds))
-                    {
-                        int so_error = 0;
-                        int so_len = static_cast<int>(sizeof(so_error));
-                        const int grc = ::getsockopt(s,
-                                                     SOL_SOCKET,
-                                                     SO_ERROR,
-                                                     reinterpret_cast<char*>(
-                                                         &so_error),
-                                                     &so_len);
-
-                        if (grc == 0 && so_error == 0)
-                        {
-                            connected = true;
-                            CloseSocket(s);
-                            break;
-                        }
-                    }
-
-                    CloseSocket(s);
-#else
-                    int fd = ::socket(ai->ai_family,
-                                      ai->ai_socktype,
-                                      ai->ai_protocol);
-                    if (fd < 0)
-                    {
-                        continue;
-                    }
-
-                    if (!SetNonBlocking(fd, true))
-                    {
-                        CloseSocket(fd);
-                        continue;
-                    }
-
-                    int rc = ::connect(fd, ai->ai_addr, ai->ai_addrlen);
-
-                    if (rc == 0)
-                    {
-                        connected = true;
-                        CloseSocket(fd);
-                        break;
-                    }
-
-                    if (errno != EINPROGRESS)
-                    {
-                        CloseSocket(fd);
-                        continue;
-                    }
-
-                    const std::chrono::steady_clock::time_point deadline =
-                        std::chrono::steady_clock::now()
-                        + std::chrono::milliseconds(timeout_ms);
-
-                    fd_set write_fds;
-                    rc = -1;
-                    while (true)
-                    {
-                        const std::chrono::steady_clock::time_point now =
-                            std::chrono::steady_clock::now();
-                        if (now >= deadline)
-                        {
-                            rc = 0;
-                            break;
-                        }
-
-                        const std::chrono::microseconds remaining =
-                            std::chrono::duration_cast<std::chrono::microseconds>(
-                                deadline - now);
-
-                        FD_ZERO(&write_fds);
-                        FD_SET(fd, &write_fds);
-
-                        timeval tv;
-                        tv.tv_sec = static_cast<long>(
-                            remaining.count() / 1000000LL);
-                        tv.tv_usec = static_cast<long>(
-                            remaining.count() % 1000000LL);
-
-                        rc = ::select(fd + 1, NULL, &write_fds, NULL, &tv);
-                        if (rc < 0 && errno == EINTR)
-                        {
-                            continue;
-                        }
-                        if (rc > 0 && !FD_ISSET(fd, &write_fds))
-                        {
-                            rc = 0;
-                        }
-                        break;
-                    }
-
-                    if (rc > 0 && FD_ISSET(fd, &write_fds))
-                    {
-                        int so_error = 0;
-                        socklen_t so_len = static_cast<socklen_t>(
-                            sizeof(so_error));
-
-                        const int grc = ::getsockopt(fd,
-                                                     SOL_SOCKET,
-                                                     SO_ERROR,
-                                                     &so_error,
-                                                     &so_len);
-
-                        if (grc == 0 && so_error == 0)
-                        {
-                            connected = true;
-                            CloseSocket(fd);
-                            break;
-                        }
-                    }
-
-                    CloseSocket(fd);
-#endif
+                    nearest = state.deadline;
+                    have_nearest = true;
                 }
+            }
+        }
 
-                ::freeaddrinfo(results);
+        std::vector<PendingConnect> still_pending;
+        for (index = 0; index < pending.size(); ++index)
+        {
+            TargetState& state = states[pending[index].target];
+            if (state.done || now >= state.deadline)
+            {
+                if (!state.done)
+                {
+                    state.timed_out = true;
+                }
+                CloseSocket(pending[index].socket_handle);
+                continue;
             }
+            if (!have_nearest || state.deadline < nearest)
+            {
+                nearest = state.deadline;
+                have_nearest = true;
+            }
+            still_pending.push_back(pending[index]);
         }
-    }
+        pending.swap(still_pending);
 
-    return connected;
-}
+        if (pending.empty() && !lookups_running)
+        {
+            break;
+        }
 
-}  // namespace
+        long long wait_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(nearest - now).count() + 1;
+        if (lookups_running && wait_ms > kLookupPollMs)
+        {
+            wait_ms = kLookupPollMs;
+        }
 
-bool CheckPortListening(const std::string& host, int port, int timeout_ms)
-{
-    bool ok = false;
+        if (pending.empty())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms));
+            continue;
+        }
 
-    if (host.empty())
-    {
-        ok = false;
+        entries.resize(pending.size());
+        for (index = 0; index < pending.size(); ++index)
+        {
+            std::memset(&entries[index], 0, sizeof(entries[index]));
+            entries[index].fd = pending[index].socket_handle;
+            entries[index].events = POLLOUT;
+        }
+
+        const int rc = PollSockets(&entries[0], entries.size(), static_cast<int>(wait_ms));
+        if (rc < 0)
+        {
+            if (PollInterrupted())
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (index = 0; index < pending.size(); ++index)
+        {
+            if (entries[index].revents == 0)
+            {
+                continue;
+            }
+
+            TargetState& state = states[pending[index].target];
+            int so_error = 0;
+            if (!ReadSocketError(pending[index].socket_handle, so_error))
+            {
+                so_error = LastSocketError();
+            }
+            if (so_error == 0)
+            {
+                results_out[pending[index].target].listening = true;
+                state.done = true;
+            }
+            else
+            {
+                state.last_error = so_error;
+            }
+
+            // Completed either way; a failed address must not be polled again.
+            CloseSocket(pending[index].socket_handle);
+            pending[index].socket_handle = kInvalidSocket;
+            --state.connects_in_flight;
+            if (state.connects_in_flight == 0)
+            {
+                state.done = true;
+            }
+        }
+
+        still_pending.clear();
+        for (index = 0; index < pending.size(); ++index)
+        {
+            if (pending[index].socket_handle != kInvalidSocket)
+            {
+                still_pending.push_back(pending[index]);
+            }
+        }
+        pending.swap(still_pending);
     }
-    else if (!IsValidPort(port))
+
+    for (index = 0; index < pending.size(); ++index)
     {
-        ok = false;
+        states[pending[index].target].timed_out = true;
+        CloseSocket(pending[index].socket_handle);
     }
-    else
-    {
-        const int timeout_value = ClampTimeoutMs(timeout_ms);
-        const std::string port_str = std::to_string(port);
 
-        ok = ConnectWithTimeout(host.c_str(), port_str.c_str(), timeout_value);
+    for (index = 0; index < targets.size(); ++index)
+    {
+        PortProbeResult& result = results_out[index];
+        if (result.listening || !result.error_stage.empty())
+        {
+            continue;
+        }
+        if (states[index].timed_out)
+        {
+            result.error_stage = "connect";
+            result.error_code = "timeout";
+            result.error_message = "connect did not complete within the probe timeout";
+        }
+        else if (states[index].last_error != 0)
+        {
+            SetConnectError(states[index].last_error, result);
+        }
+        else
+        {
+            result.error_stage = "connect";
+            result.error_code = "failed";
+            result.error_message = "no usable address";
+        }
     }
+}
 
-    return ok;
+bool CheckPortListening(const std::string& host, int port, int timeout_ms)
+{
+    std::vector<PortProbeTarget> targets(1);
+    targets[0].host = host;
+    targets[0].port = port;
+    targets[0].timeout_ms = timeout_ms;
+
+    std::vector<PortProbeResult> results;
+    CheckPortsListening(targets, results);
+
+    return results[0].listening;
 }
 
 }  // namespace Platform
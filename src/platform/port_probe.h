@@ -2,10 +2,38 @@
 #define PROCESS_INTERFACE_PLATFORM_PORT_PROBE_H
 
 #include <string>
+#include <vector>
 
 namespace ProcessInterface {
 namespace Platform {
 
+struct PortProbeTarget {
+    std::string host;
+    int port;
+    // Clamped to (0, 30000]; 0 or less means 250.
+    int timeout_ms;
+};
+
+struct PortProbeResult {
+    bool listening;
+    // Why a target is not listening; all empty when it is.
+    // error_stage: "resolve" or "connect".
+    // error_code: for resolve, "not_found", "temporary_failure", "timeout", "busy", "invalid"
+    // or "failed"; for connect, "refused", "unreachable", "timeout" or "failed".
+    std::string error_stage;
+    std::string error_code;
+    // getaddrinfo or socket error text.
+    std::string error_message;
+};
+
+// Probes every target with non-blocking TCP connects, all started up front and waited on
+// by one poll loop, so N targets cost about the longest timeout rather than the sum. Hosts
+// are resolved through SharedHostResolver() within the same timeout. All resolved
+// addresses of a target are tried at once; the first to connect answers it.
+// results_out[i] belongs to targets[i].
+void CheckPortsListening(const std::vector<PortProbeTarget>& targets,
+                         std::vector<PortProbeResult>& results_out);
+
 bool CheckPortListening(const std::string& host, int port, int timeout_ms);
 
 }  // namespace Platform
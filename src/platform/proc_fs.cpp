@@ -0,0 +1,60 @@
+#include "proc_fs.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+int ParseProcNumber(const char* text) {
+    if (text == NULL || *text == '\0') {
+        return -1;
+    }
+    int value = 0;
+    const char* cursor = text;
+    for (; *cursor != '\0'; ++cursor) {
+        if (*cursor < '0' || *cursor > '9' || value > 100000000) {
+            return -1;
+        }
+        value = value * 10 + (*cursor - '0');
+    }
+    return value;
+}
+
+bool ReadProcComm(const int pid, std::string& comm_out) {
+#if defined(__linux__)
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[64];
+    ssize_t got = 0;
+    do {
+        got = ::read(fd, buffer, sizeof(buffer));
+    } while (got < 0 && errno == EINTR);
+    (void)::close(fd);
+    if (got <= 0) {
+        return false;
+    }
+    std::size_t length = static_cast<std::size_t>(got);
+    while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\0')) {
+        --length;
+    }
+    comm_out.assign(buffer, length);
+    return true;
+#else
+    (void)pid;
+    (void)comm_out;
+    return false;
+#endif
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
@@ -0,0 +1,20 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_PROC_FS_H
+#define PROCESS_INTERFACE_PLATFORM_PROC_FS_H
+
+#include <string>
+
+namespace ProcessInterface {
+namespace Platform {
+
+// Numeric /proc directory entry ("1234" under /proc or /proc/<pid>/fd); -1 for anything
+// else, including "self" and names too large for a pid.
+int ParseProcNumber(const char* text);
+
+// /proc/<pid>/comm without its trailing newline. False when the process is gone or the
+// file cannot be read (not Linux).
+bool ReadProcComm(int pid, std::string& comm_out);
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_PROC_FS_H
@@ -1,8 +1,13 @@
 #include "process_exec.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -13,7 +18,12 @@
 #endif
 
 #if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
 #include <sys/wait.h>
+#include <unistd.h>
 #endif
 
 namespace ProcessInterface {
@@ -23,6 +33,9 @@ namespace {
 
 namespace fs = ProcessInterface::Common::fs;
 
+// The shell runner changes the host cwd around popen, so concurrent runs must not overlap.
+std::mutex g_shell_cwd_mutex;
+
 std::string QuoteForShellWindows(const std::string& value) {
     std::string quoted = "\"";
     std::size_t index = 0;
@@ -179,14 +192,283 @@ private:
     bool active_;
 };
 
+#if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+
+typedef std::chrono::steady_clock SteadyClock;
+
+const int kOutputPollTickMs = 50;
+const int kReapPollTickMs = 10;
+const int kDefaultKillGraceMs = 5000;
+
+enum ChildFailureStage {
+    kChildFailureCwd = 1,
+    kChildFailureExec = 2,
+};
+
+void SetCloseOnExec(const int fd) {
+    const int flags = ::fcntl(fd, F_GETFD, 0);
+    if (flags >= 0) {
+        (void)::fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+    }
+}
+
+void CloseFd(int& fd) {
+    if (fd >= 0) {
+        (void)::close(fd);
+        fd = -1;
+    }
+}
+
+// argv is materialized before fork so the child never allocates.
+class ExecArgv {
+public:
+    explicit ExecArgv(const std::vector<std::string>& command)
+        : storage_(command) {
+        std::size_t index = 0;
+        for (index = 0; index < storage_.size(); ++index) {
+            pointers_.push_back(const_cast<char*>(storage_[index].c_str()));
+        }
+        pointers_.push_back(NULL);
+    }
+
+    char* const* data() const {
+        return pointers_.data();
+    }
+
+private:
+    std::vector<std::string> storage_;
+    std::vector<char*> pointers_;
+};
+
+void WriteChildFailure(const int error_fd, const int stage) {
+    const int report[2] = {stage, errno};
+    ssize_t wrote = 0;
+    do {
+        wrote = ::write(error_fd, report, sizeof(report));
+    } while (wrote < 0 && errno == EINTR);
+}
+
+// Runs in the forked child: only async-signal-safe calls from here on.
+void ExecChild(const ExecArgv& argv, const char* cwd, const int input_fd, const int output_fd, const int error_fd) {
+    (void)::signal(SIGPIPE, SIG_DFL);
+
+    if (cwd != NULL && ::chdir(cwd) != 0) {
+        WriteChildFailure(error_fd, kChildFailureCwd);
+        ::_exit(127);
+    }
+
+    (void)::dup2(input_fd, STDIN_FILENO);
+    (void)::dup2(output_fd, STDOUT_FILENO);
+    (void)::dup2(output_fd, STDERR_FILENO);
+
+    ::execvp(argv.data()[0], argv.data());
+    WriteChildFailure(error_fd, kChildFailureExec);
+    ::_exit(127);
+}
+
+// Blocks until the child execs (pipe closed by FD_CLOEXEC) or reports a failure.
+bool ReadChildFailure(const int fd, int& stage_out, int& errno_out) {
+    int report[2] = {0, 0};
+    ssize_t got = 0;
+    do {
+        got = ::read(fd, report, sizeof(report));
+    } while (got < 0 && errno == EINTR);
+
+    if (got != static_cast<ssize_t>(sizeof(report))) {
+        return false;
+    }
+    stage_out = report[0];
+    errno_out = report[1];
+    return true;
+}
+
+std::string DescribeChildFailure(const ProcessRunOptions& options, const int stage, const int child_errno) {
+    if (stage == kChildFailureCwd) {
+        return "failed to set process cwd: " + options.cwd.string() + ": " + std::strerror(child_errno);
+    }
+    return "failed to launch " + options.command[0] + ": " + std::strerror(child_errno);
+}
+
+void SignalProcessGroup(const pid_t pgid, const int signal_number) {
+    if (pgid > 0) {
+        (void)::kill(-pgid, signal_number);
+    }
+}
+
+bool ReadOutputChunk(const int fd, const ProcessRunOptions& options, std::string& text_out) {
+    char buffer[4096];
+    ssize_t got = 0;
+    do {
+        got = ::read(fd, buffer, sizeof(buffer));
+    } while (got < 0 && errno == EINTR);
+
+    if (got > 0) {
+        if (options.output_sink) {
+            options.output_sink(buffer, static_cast<std::size_t>(got));
+        } else {
+            text_out.append(buffer, static_cast<std::size_t>(got));
+        }
+        return true;
+    }
+    return false;
+}
+
+// Collects output already buffered in the pipe without waiting on descendants that still hold it open.
+void DrainAvailableOutput(const int fd, const ProcessRunOptions& options, std::string& text_out) {
+    while (true) {
+        struct pollfd entry;
+        entry.fd = fd;
+        entry.events = POLLIN;
+        entry.revents = 0;
+        const int rc = ::poll(&entry, 1, 0);
+        if (rc <= 0 || (entry.revents & (POLLIN | POLLHUP)) == 0) {
+            return;
+        }
+        if (!ReadOutputChunk(fd, options, text_out)) {
+            return;
+        }
+    }
+}
+
+bool LaunchDetachedForkExec(const ProcessRunOptions& options, ProcessRunResult& result) {
+    const ExecArgv argv(options.command);
+    const std::string cwd_text = options.cwd.string();
+    const char* cwd = cwd_text.empty() ? NULL : cwd_text.c_str();
+
+    int info_pipe[2] = {-1, -1};
+    int error_pipe[2] = {-1, -1};
+    if (!OpenCloseOnExecPipe(info_pipe) || !OpenCloseOnExecPipe(error_pipe)) {
+        result.error_message = std::string("pipe failed: ") + std::strerror(errno);
+        CloseFd(info_pipe[0]);
+        CloseFd(info_pipe[1]);
+        CloseFd(error_pipe[0]);
+        CloseFd(error_pipe[1]);
+        return false;
+    }
+
+    int null_fd = ::open("/dev/null", O_RDWR);
+    if (null_fd >= 0) {
+        SetCloseOnExec(null_fd);
+    }
+
+    // Double fork so the launched process is reparented to init and never left as our zombie.
+    const pid_t middle = ::fork();
+    if (middle == 0) {
+        (void)::setsid();
+        const pid_t grandchild = ::fork();
+        if (grandchild == 0) {
+            ExecChild(argv, cwd, null_fd, null_fd, error_pipe[1]);
+        }
+        ssize_t wrote = 0;
+        do {
+            wrote = ::write(info_pipe[1], &grandchild, sizeof(grandchild));
+        } while (wrote < 0 && errno == EINTR);
+        ::_exit(grandchild > 0 ? 0 : 1);
+    }
+
+    CloseFd(info_pipe[1]);
+    CloseFd(error_pipe[1]);
+    CloseFd(null_fd);
+
+    if (middle < 0) {
+        result.error_message = std::string("fork failed: ") + std::strerror(errno);
+        CloseFd(info_pipe[0]);
+        CloseFd(error_pipe[0]);
+        return false;
+    }
+
+    int middle_status = 0;
+    while (::waitpid(middle, &middle_status, 0) < 0 && errno == EINTR) {
+    }
+
+    pid_t launched_pid = -1;
+    ssize_t got = 0;
+    do {
+        got = ::read(info_pipe[0], &launched_pid, sizeof(launched_pid));
+    } while (got < 0 && errno == EINTR);
+    CloseFd(info_pipe[0]);
+
+    int stage = 0;
+    int child_errno = 0;
+    const bool child_failed = got == static_cast<ssize_t>(sizeof(launched_pid)) && launched_pid > 0
+        && ReadChildFailure(error_pipe[0], stage, child_errno);
+    CloseFd(error_pipe[0]);
+
+    if (got != static_cast<ssize_t>(sizeof(launched_pid)) || launched_pid <= 0) {
+        result.error_message = "fork failed for detached launch";
+        return false;
+    }
+    if (child_failed) {
+        result.error_message = DescribeChildFailure(options, stage, child_errno);
+        return false;
+    }
+
+    result.launch_ok = true;
+    result.pid = static_cast<int>(launched_pid);
+    return true;
+}
+
+#endif
+
 }  // namespace
 
+bool OpenCloseOnExecPipe(int fds[2]) {
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    fds[0] = -1;
+    fds[1] = -1;
+    return false;
+#elif defined(__linux__)
+    if (::pipe2(fds, O_CLOEXEC) != 0) {
+        fds[0] = -1;
+        fds[1] = -1;
+        return false;
+    }
+    return true;
+#else
+    if (::pipe(fds) != 0) {
+        fds[0] = -1;
+        fds[1] = -1;
+        return false;
+    }
+    SetCloseOnExec(fds[0]);
+    SetCloseOnExec(fds[1]);
+    return true;
+#endif
+}
+
+int TerminateProcessGroup(const int pid, const int grace_ms) {
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    (void)pid;
+    (void)grace_ms;
+    return -1;
+#else
+    int raw_status = -1;
+    if (grace_ms > 0) {
+        (void)::kill(-pid, SIGTERM);
+        const std::chrono::steady_clock::time_point kill_at =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(grace_ms);
+        while (std::chrono::steady_clock::now() < kill_at) {
+            if (::waitpid(pid, &raw_status, WNOHANG) == pid) {
+                (void)::kill(-pid, SIGKILL);
+                return DecodeExitCode(raw_status);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(kReapPollTickMs));
+        }
+    }
+    (void)::kill(-pid, SIGKILL);
+    while (::waitpid(pid, &raw_status, 0) < 0 && errno == EINTR) {
+    }
+    return DecodeExitCode(raw_status);
+#endif
+}
+
 bool RunShellProcess(const ProcessRunOptions& options, ProcessRunResult& result_out) {
     ProcessRunResult result;
     result.launch_ok = false;
     result.completed = false;
     // This shell-based implementation does not support enforced timeouts.
     result.timed_out = false;
+    result.canceled = false;
     result.exit_code = -1;
     // PID is not available from system()/popen() here.
     result.pid = 0;
@@ -195,10 +477,13 @@ bool RunShellProcess(const ProcessRunOptions& options, ProcessRunResult& result_
     result.stderr_text.clear();
     result.supports_pid = false;
     result.supports_timeout = false;
+    result.supports_cancel = false;
     result.supports_separate_stderr = false;
     result.error_message.clear();
 
     (void)options.timeout_ms;
+    (void)options.kill_grace_ms;
+    (void)options.cancel_requested;
 
     if (options.command.empty()) {
         result.error_message = "command cannot be empty";
@@ -206,6 +491,8 @@ bool RunShellProcess(const ProcessRunOptions& options, ProcessRunResult& result_
         return false;
     }
 
+    std::lock_guard<std::mutex> cwd_lock(g_shell_cwd_mutex);
+
     std::error_code capture_ec;
     const fs::path original_cwd = fs::current_path(capture_ec);
     if (capture_ec) {
@@ -260,7 +547,11 @@ bool RunShellProcess(const ProcessRunOptions& options, ProcessRunResult& result_
 
     char buffer[4096];
     while (std::fgets(buffer, static_cast<int>(sizeof(buffer)), pipe) != NULL) {
-        result.stdout_text += buffer;
+        if (options.output_sink) {
+            options.output_sink(buffer, std::strlen(buffer));
+        } else {
+            result.stdout_text += buffer;
+        }
     }
 
     const int close_rc = ClosePipe(pipe);
@@ -271,8 +562,200 @@ bool RunShellProcess(const ProcessRunOptions& options, ProcessRunResult& result_
     return true;
 }
 
+bool RunForkExecProcess(const ProcessRunOptions& options, ProcessRunResult& result_out) {
+    ProcessRunResult result;
+    result.launch_ok = false;
+    result.completed = false;
+    result.timed_out = false;
+    result.canceled = false;
+    result.exit_code = -1;
+    result.pid = 0;
+    result.stdout_text.clear();
+    // stderr is redirected into the same pipe as stdout, matching the shell runner.
+    result.stderr_text.clear();
+    result.supports_pid = true;
+    result.supports_timeout = true;
+    result.supports_cancel = true;
+    result.supports_separate_stderr = false;
+    result.error_message.clear();
+
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    (void)options;
+    result.supports_pid = false;
+    result.supports_timeout = false;
+    result.supports_cancel = false;
+    result.error_message = "fork/exec runner is not available on this platform";
+    result_out = result;
+    return false;
+#else
+    if (options.command.empty()) {
+        result.error_message = "command cannot be empty";
+        result_out = result;
+        return false;
+    }
+
+    if (options.detached) {
+        // Detached launches are not tracked after start, so they cannot be timed out or canceled.
+        result.supports_timeout = false;
+        result.supports_cancel = false;
+        const bool launched = LaunchDetachedForkExec(options, result);
+        result_out = result;
+        return launched;
+    }
+
+    if (options.cancel_requested != NULL && options.cancel_requested->load()) {
+        result.launch_ok = true;
+        result.canceled = true;
+        result.completed = true;
+        result_out = result;
+        return true;
+    }
+
+    const ExecArgv argv(options.command);
+    const std::string cwd_text = options.cwd.string();
+    const char* cwd = cwd_text.empty() ? NULL : cwd_text.c_str();
+
+    int output_pipe[2] = {-1, -1};
+    int error_pipe[2] = {-1, -1};
+    if (!OpenCloseOnExecPipe(output_pipe) || !OpenCloseOnExecPipe(error_pipe)) {
+        result.error_message = std::string("pipe failed: ") + std::strerror(errno);
+        CloseFd(output_pipe[0]);
+        CloseFd(output_pipe[1]);
+        CloseFd(error_pipe[0]);
+        CloseFd(error_pipe[1]);
+        result_out = result;
+        return false;
+    }
+
+    int null_fd = ::open("/dev/null", O_RDONLY);
+    if (null_fd >= 0) {
+        SetCloseOnExec(null_fd);
+    }
+
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        // New process group so cancel/timeout can signal every descendant at once.
+        (void)::setpgid(0, 0);
+        ExecChild(argv, cwd, null_fd, output_pipe[1], error_pipe[1]);
+    }
+
+    CloseFd(output_pipe[1]);
+    CloseFd(error_pipe[1]);
+    CloseFd(null_fd);
+
+    if (pid < 0) {
+        result.error_message = std::string("fork failed: ") + std::strerror(errno);
+        CloseFd(output_pipe[0]);
+        CloseFd(error_pipe[0]);
+        result_out = result;
+        return false;
+    }
+
+    // Also set from the parent so the group exists before any signal is sent.
+    (void)::setpgid(pid, pid);
+
+    int stage = 0;
+    int child_errno = 0;
+    const bool child_failed = ReadChildFailure(error_pipe[0], stage, child_errno);
+    CloseFd(error_pipe[0]);
+    if (child_failed) {
+        int ignored_status = 0;
+        while (::waitpid(pid, &ignored_status, 0) < 0 && errno == EINTR) {
+        }
+        CloseFd(output_pipe[0]);
+        result.error_message = DescribeChildFailure(options, stage, child_errno);
+        result_out = result;
+        return false;
+    }
+
+    result.launch_ok = true;
+    result.pid = static_cast<int>(pid);
+
+    const int kill_grace_ms = options.kill_grace_ms > 0 ? options.kill_grace_ms : kDefaultKillGraceMs;
+    const bool has_deadline = options.timeout_ms > 0;
+    const SteadyClock::time_point deadline = SteadyClock::now() + std::chrono::milliseconds(options.timeout_ms);
+    SteadyClock::time_point kill_at = SteadyClock::time_point::max();
+
+    bool terminating = false;
+    bool killed = false;
+    bool reaped = false;
+    int raw_status = -1;
+    int output_fd = output_pipe[0];
+
+    while (true) {
+        if (!reaped) {
+            const pid_t waited = ::waitpid(pid, &raw_status, WNOHANG);
+            if (waited == pid) {
+                reaped = true;
+            } else if (waited < 0 && errno != EINTR) {
+                reaped = true;
+                raw_status = -1;
+            }
+        }
+
+        if (reaped) {
+            if (output_fd >= 0) {
+                DrainAvailableOutput(output_fd, options, result.stdout_text);
+            }
+            break;
+        }
+
+        const SteadyClock::time_point now = SteadyClock::now();
+        if (!terminating) {
+            if (options.cancel_requested != NULL && options.cancel_requested->load()) {
+                result.canceled = true;
+                terminating = true;
+            } else if (has_deadline && now >= deadline) {
+                result.timed_out = true;
+                terminating = true;
+            }
+
+            if (terminating) {
+                SignalProcessGroup(pid, SIGTERM);
+                kill_at = now + std::chrono::milliseconds(kill_grace_ms);
+            }
+        } else if (!killed && now >= kill_at) {
+            SignalProcessGroup(pid, SIGKILL);
+            killed = true;
+        }
+
+        if (output_fd < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kReapPollTickMs));
+            continue;
+        }
+
+        struct pollfd entry;
+        entry.fd = output_fd;
+        entry.events = POLLIN;
+        entry.revents = 0;
+        const int poll_rc = ::poll(&entry, 1, kOutputPollTickMs);
+        if (poll_rc > 0 && (entry.revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+            if (!ReadOutputChunk(output_fd, options, result.stdout_text)) {
+                CloseFd(output_fd);
+            }
+        }
+    }
+
+    CloseFd(output_fd);
+
+    if (terminating) {
+        // Sweep descendants that outlived the group leader.
+        SignalProcessGroup(pid, SIGKILL);
+    }
+
+    result.exit_code = DecodeExitCode(raw_status);
+    result.completed = true;
+    result_out = result;
+    return true;
+#endif
+}
+
 bool RunProcess(const ProcessRunOptions& options, ProcessRunResult& result_out) {
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
     return RunShellProcess(options, result_out);
+#else
+    return RunForkExecProcess(options, result_out);
+#endif
 }
 
 }  // namespace Platform
@@ -1,6 +1,9 @@
 #ifndef PROCESS_INTERFACE_PLATFORM_PROCESS_EXEC_H
 #define PROCESS_INTERFACE_PLATFORM_PROCESS_EXEC_H
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -17,8 +20,15 @@ struct ProcessRunOptions
     Common::fs::path cwd;
     // Detached mode is fire-and-forget for this backend.
     bool detached;
-    // Timeout is accepted for API compatibility but is not enforced by this backend.
+    // Enforced by the fork/exec backend; accepted but ignored by the shell runner.
     int timeout_ms;
+    // Delay between SIGTERM and SIGKILL when a run is timed out or canceled.
+    int kill_grace_ms;
+    // Optional flag polled while the process runs; NULL when the run cannot be canceled.
+    const std::atomic<bool>* cancel_requested;
+    // Optional receiver for output chunks as they arrive. When set, output is handed to the
+    // sink instead of being accumulated in ProcessRunResult::stdout_text.
+    std::function<void(const char*, std::size_t)> output_sink;
 };
 
 struct ProcessRunResult 
@@ -28,6 +38,8 @@ struct ProcessRunResult
     // In detached mode completed remains false.
     bool completed;
     bool timed_out;
+    // True when cancel_requested was observed and the process group was terminated.
+    bool canceled;
     int exit_code;
     int pid;
     // For this backend, stdout_text contains combined process output (stdout + stderr).
@@ -37,6 +49,7 @@ struct ProcessRunResult
     // Capability flags for callers to avoid assuming unsupported process controls.
     bool supports_pid;
     bool supports_timeout;
+    bool supports_cancel;
     bool supports_separate_stderr;
     std::string error_message;
 };
@@ -46,10 +59,24 @@ struct ProcessRunResult
 // - detached=false: synchronous execution with combined output in stdout_text.
 bool RunShellProcess(const ProcessRunOptions& options, ProcessRunResult& result_out);
 
-// Backward-compatible alias.
+// fork/exec runner that places the child in its own process group:
+// - real pid, enforced timeout and cancellation (SIGTERM, then SIGKILL after kill_grace_ms).
+// - combined output in stdout_text, same as the shell runner.
+// Returns false with an error on platforms without fork/exec.
+bool RunForkExecProcess(const ProcessRunOptions& options, ProcessRunResult& result_out);
+
+// Selects the best runner for the platform: fork/exec where available, shell runner otherwise.
 bool RunProcess(const ProcessRunOptions& options, ProcessRunResult& result_out);
 
+// Pipe with FD_CLOEXEC set on both ends, atomically where the platform has pipe2.
+bool OpenCloseOnExecPipe(int fds[2]);
+
+// Sends SIGTERM to the process group led by pid, then SIGKILL once grace_ms has passed
+// (immediately when grace_ms <= 0), and reaps pid. Returns its exit code, 128 + signal
+// for a signaled process, or -1.
+int TerminateProcessGroup(int pid, int grace_ms);
+
 }  // namespace Platform
 }  // namespace ProcessInterface
 
-#endif  // PROCESS_INTERFACE_PLATFORM_PROCESS_EXEC_H
+#endif  // PROCESS_INTERFACE_PLATFORM_PROCESS_EXEC_H
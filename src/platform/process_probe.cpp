@@ -19,6 +19,7 @@
 #include "../common/file_io.h"
 #include "../common/fs_compat.h"
 #include "../common/text.h"
+#include "process_table.h"
 
 namespace ProcessInterface {
 namespace Platform {
@@ -134,6 +135,7 @@ bool ProbeFromToolhelp(const std::string& process_name, std::vector<int>& pids_o
 }
 #endif
 
+#if !defined(_WIN32) && !defined(__linux__)
 void ProbeFromPgrep(const std::string& process_name, std::vector<int>& pids_out) {
     std::string output;
     if (!RunCommandCapture("pgrep -i -x " + QuoteForShell(process_name), output)) {
@@ -149,6 +151,7 @@ void ProbeFromPgrep(const std::string& process_name, std::vector<int>& pids_out)
         }
     }
 }
+#endif
 
 void ProbeFromTaskList(const std::string& process_name, std::vector<int>& pids_out) {
     std::string output;
@@ -204,6 +207,8 @@ ProcessQueryResult QueryProcessByName(const std::string& process_name) {
     if (pids.empty()) {
         ProbeFromTaskList(process_name, pids);
     }
+#elif defined(__linux__)
+    pids = SharedProcessTable().FindByName(process_name);
 #else
     ProbeFromPgrep(process_name, pids);
 #endif
@@ -219,5 +224,13 @@ ProcessQueryResult QueryProcessByName(const std::string& process_name) {
     return result;
 }
 
+void TrackProcess(const int pid) {
+#if defined(__linux__)
+    SharedProcessTable().Track(pid);
+#else
+    (void)pid;
+#endif
+}
+
 }  // namespace Platform
 }  // namespace ProcessInterface
@@ -14,8 +14,14 @@ struct ProcessQueryResult {
     std::string error_message;
 };
 
+// Exact, case-insensitive match on the process name. On Linux this is a lookup in the live
+// process table (process_table.h); elsewhere it lists processes per call.
 ProcessQueryResult QueryProcessByName(const std::string& process_name);
 
+// Registers a process the host launched (e.g. a detached action) with the live process
+// table so name lookups see it at once and its exit is watched. No-op off Linux.
+void TrackProcess(int pid);
+
 }  // namespace Platform
 }  // namespace ProcessInterface
 
@@ -0,0 +1,257 @@
+#include "process_stats.h"
+
+#include "proc_fs.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+namespace {
+
+// Samples closer together than this keep the previous base so that two evaluations in quick
+// succession do not report a percentage over a few microseconds.
+const long long kMinCpuIntervalMs = 250;
+const std::size_t kMaxCpuHistory = 4096;
+const long long kCpuHistoryIdleMs = 10 * 60 * 1000;
+
+struct CpuHistory {
+    unsigned long long start_ticks;
+    unsigned long long base_ticks;
+    std::chrono::steady_clock::time_point base_time;
+    double percent;
+};
+
+std::mutex g_cpu_history_mutex;
+std::map<int, CpuHistory> g_cpu_history;
+
+#if defined(__linux__)
+
+bool ReadSmallFile(const char* path, std::string& text_out) {
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[1024];
+    ssize_t got = 0;
+    do {
+        got = ::read(fd, buffer, sizeof(buffer) - 1);
+    } while (got < 0 && errno == EINTR);
+    (void)::close(fd);
+    if (got <= 0) {
+        return false;
+    }
+    text_out.assign(buffer, static_cast<std::size_t>(got));
+    return true;
+}
+
+int CountFds(const int pid) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/fd", pid);
+    DIR* fd_dir = ::opendir(path);
+    if (fd_dir == NULL) {
+        return -1;
+    }
+    int count = 0;
+    struct dirent* entry = NULL;
+    while ((entry = ::readdir(fd_dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            ++count;
+        }
+    }
+    (void)::closedir(fd_dir);
+    return count;
+}
+
+#endif
+
+double UpdateCpuPercent(const ProcessStatsSample& sample) {
+#if defined(__linux__)
+    static const long ticks_per_second = ::sysconf(_SC_CLK_TCK);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(g_cpu_history_mutex);
+    if (g_cpu_history.size() > kMaxCpuHistory) {
+        std::map<int, CpuHistory>::iterator iter = g_cpu_history.begin();
+        while (iter != g_cpu_history.end()) {
+            if (std::chrono::duration_cast<std::chrono::milliseconds>(now - iter->second.base_time).count() >
+                kCpuHistoryIdleMs) {
+                iter = g_cpu_history.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    std::map<int, CpuHistory>::iterator found = g_cpu_history.find(sample.pid);
+    if (found == g_cpu_history.end() || found->second.start_ticks != sample.start_ticks) {
+        CpuHistory history;
+        history.start_ticks = sample.start_ticks;
+        history.base_ticks = sample.cpu_ticks;
+        history.base_time = now;
+        history.percent = -1.0;
+        g_cpu_history[sample.pid] = history;
+        return -1.0;
+    }
+
+    CpuHistory& history = found->second;
+    const long long elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - history.base_time).count();
+    if (elapsed_ms < kMinCpuIntervalMs || ticks_per_second <= 0) {
+        return history.percent;
+    }
+    const unsigned long long used_ticks =
+        sample.cpu_ticks >= history.base_ticks ? sample.cpu_ticks - history.base_ticks : 0;
+    history.percent = (static_cast<double>(used_ticks) * 1000.0 / static_cast<double>(ticks_per_second)) * 100.0 /
+                      static_cast<double>(elapsed_ms);
+    history.base_ticks = sample.cpu_ticks;
+    history.base_time = now;
+    return history.percent;
+#else
+    (void)sample;
+    return -1.0;
+#endif
+}
+
+}  // namespace
+
+ProcessStatsSnapshot::ProcessStatsSnapshot()
+    : scanned_(false) {}
+
+bool ProcessStatsSnapshot::Sample(const int pid, ProcessStatsSample& sample_out) {
+    if (pid <= 0 || missing_.count(pid) != 0) {
+        return false;
+    }
+    std::map<int, ProcessStatsSample>::iterator found = samples_.find(pid);
+    if (found == samples_.end()) {
+        ProcessStatsSample sample;
+        if (!ReadBaseSample(pid, sample)) {
+            missing_.insert(pid);
+            return false;
+        }
+        found = samples_.insert(std::make_pair(pid, sample)).first;
+    }
+    if (completed_.count(pid) == 0) {
+#if defined(__linux__)
+        found->second.fds = CountFds(pid);
+#endif
+        found->second.cpu_percent = UpdateCpuPercent(found->second);
+        completed_.insert(pid);
+    }
+    sample_out = found->second;
+    return true;
+}
+
+std::vector<int> ProcessStatsSnapshot::WithDescendants(const std::vector<int>& roots) {
+    std::set<int> selected(roots.begin(), roots.end());
+#if defined(__linux__)
+    if (!scanned_) {
+        scanned_ = true;
+        DIR* proc_dir = ::opendir("/proc");
+        if (proc_dir != NULL) {
+            struct dirent* entry = NULL;
+            while ((entry = ::readdir(proc_dir)) != NULL) {
+                const int pid = ParseProcNumber(entry->d_name);
+                if (pid <= 0 || samples_.count(pid) != 0) {
+                    continue;
+                }
+                ProcessStatsSample sample;
+                if (ReadBaseSample(pid, sample)) {
+                    samples_[pid] = sample;
+                }
+            }
+            (void)::closedir(proc_dir);
+        }
+    }
+
+    std::map<int, std::vector<int> > children;
+    std::map<int, ProcessStatsSample>::const_iterator iter;
+    for (iter = samples_.begin(); iter != samples_.end(); ++iter) {
+        children[iter->second.ppid].push_back(iter->first);
+    }
+    std::vector<int> frontier(selected.begin(), selected.end());
+    while (!frontier.empty()) {
+        const int parent = frontier.back();
+        frontier.pop_back();
+        const std::map<int, std::vector<int> >::const_iterator found = children.find(parent);
+        if (found == children.end()) {
+            continue;
+        }
+        std::size_t index;
+        for (index = 0; index < found->second.size(); ++index) {
+            if (selected.insert(found->second[index]).second) {
+                frontier.push_back(found->second[index]);
+            }
+        }
+    }
+#endif
+    return std::vector<int>(selected.begin(), selected.end());
+}
+
+bool ProcessStatsSnapshot::ReadBaseSample(const int pid, ProcessStatsSample& sample_out) {
+#if defined(__linux__)
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    std::string stat_text;
+    if (!ReadSmallFile(path, stat_text)) {
+        return false;
+    }
+    // The command name may contain spaces and parentheses; fields resume after the last ')'.
+    const std::string::size_type name_end = stat_text.rfind(')');
+    if (name_end == std::string::npos) {
+        return false;
+    }
+    std::istringstream fields(stat_text.substr(name_end + 1));
+    std::string field;
+    std::vector<std::string> values;
+    while (fields >> field && values.size() < 22) {
+        values.push_back(field);
+    }
+    // values[0] is field 3 (state) of proc(5).
+    if (values.size() < 22) {
+        return false;
+    }
+
+    std::memset(&sample_out, 0, sizeof(sample_out));
+    sample_out.pid = pid;
+    sample_out.ppid = std::atoi(values[1].c_str());
+    sample_out.cpu_ticks = std::strtoull(values[11].c_str(), NULL, 10) + std::strtoull(values[12].c_str(), NULL, 10);
+    sample_out.threads = std::atoi(values[17].c_str());
+    sample_out.start_ticks = std::strtoull(values[19].c_str(), NULL, 10);
+    sample_out.fds = -1;
+    sample_out.cpu_percent = -1.0;
+
+    static const long page_size = ::sysconf(_SC_PAGESIZE);
+    std::snprintf(path, sizeof(path), "/proc/%d/statm", pid);
+    std::string statm_text;
+    if (ReadSmallFile(path, statm_text)) {
+        std::istringstream statm_fields(statm_text);
+        unsigned long long size_pages = 0;
+        unsigned long long resident_pages = 0;
+        if (statm_fields >> size_pages >> resident_pages) {
+            sample_out.rss_bytes = resident_pages * static_cast<unsigned long long>(page_size > 0 ? page_size : 4096);
+        }
+    }
+    return true;
+#else
+    (void)pid;
+    (void)sample_out;
+    return false;
+#endif
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
@@ -0,0 +1,55 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_PROCESS_STATS_H
+#define PROCESS_INTERFACE_PLATFORM_PROCESS_STATS_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ProcessInterface {
+namespace Platform {
+
+struct ProcessStatsSample {
+    int pid;
+    int ppid;
+    // utime + stime in clock ticks.
+    unsigned long long cpu_ticks;
+    // Start time in clock ticks after boot; tells a reused pid from the process it replaced.
+    unsigned long long start_ticks;
+    int threads;
+    unsigned long long rss_bytes;
+    // -1 when /proc/<pid>/fd is not readable by the host.
+    int fds;
+    // Percent of one CPU since this pid was last sampled by any evaluation; -1 on the first
+    // sample (no delta yet).
+    double cpu_percent;
+};
+
+// Per-evaluation view of /proc/<pid>/stat, statm and fd counts (Linux only). Each pid is
+// read at most once, and the whole of /proc at most once (for WithDescendants), however many
+// process_stats ops ask. CPU% comes from the previous sample of the same process kept
+// process-wide, so no op has to sleep between two reads.
+class ProcessStatsSnapshot {
+public:
+    ProcessStatsSnapshot();
+
+    // False when the pid does not exist (anymore) or /proc is unavailable.
+    bool Sample(int pid, ProcessStatsSample& sample_out);
+
+    // roots plus every process descending from them, ascending, each once.
+    std::vector<int> WithDescendants(const std::vector<int>& roots);
+
+private:
+    // stat and statm only; fds and cpu_percent are filled in by Sample.
+    bool ReadBaseSample(int pid, ProcessStatsSample& sample_out);
+
+    bool scanned_;
+    std::map<int, ProcessStatsSample> samples_;
+    // Pids whose fds and cpu_percent are filled in.
+    std::set<int> completed_;
+    std::set<int> missing_;
+};
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_PROCESS_STATS_H
@@ -0,0 +1,449 @@
+#include "process_table.h"
+
+#include "proc_fs.h"
+
+#include <cctype>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+namespace {
+
+const int kRescanIntervalMs = 200;
+const std::size_t kMaxWatchedPids = 256;
+// How long the connector self-test waits for the events of its probe child.
+const int kSelfTestTimeoutMs = 200;
+
+std::string ToLowerCopy(const std::string& text) {
+    std::string lowered;
+    lowered.reserve(text.size());
+    std::size_t index;
+    for (index = 0; index < text.size(); ++index) {
+        lowered.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(text[index]))));
+    }
+    return lowered;
+}
+
+#if defined(__linux__)
+
+// Child pid of a PROC_EVENT_FORK, exiting pid of a PROC_EVENT_EXIT; 0 for threads and
+// other events.
+int ForkedPid(const struct proc_event& event) {
+    if (event.what == proc_event::PROC_EVENT_FORK &&
+        event.event_data.fork.child_pid == event.event_data.fork.child_tgid) {
+        return event.event_data.fork.child_pid;
+    }
+    return 0;
+}
+
+int ExitedPid(const struct proc_event& event) {
+    if (event.what == proc_event::PROC_EVENT_EXIT &&
+        event.event_data.exit.process_pid == event.event_data.exit.process_tgid) {
+        return event.event_data.exit.process_pid;
+    }
+    return 0;
+}
+
+// Calls handler for every proc connector event currently queued. Returns false when the
+// socket overflowed and events were lost.
+template <typename Handler>
+bool ReadProcEvents(const int fd, Handler handler) {
+    alignas(struct nlmsghdr) char buffer[8192];
+    while (true) {
+        const ssize_t got = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno != ENOBUFS;
+        }
+        if (got == 0) {
+            return true;
+        }
+
+        int remaining = static_cast<int>(got);
+        const struct nlmsghdr* header = reinterpret_cast<const struct nlmsghdr*>(buffer);
+        for (; NLMSG_OK(header, static_cast<unsigned int>(remaining)); header = NLMSG_NEXT(header, remaining)) {
+            if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) {
+                continue;
+            }
+            const struct cn_msg* message = reinterpret_cast<const struct cn_msg*>(NLMSG_DATA(header));
+            if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC ||
+                message->len < sizeof(struct proc_event)) {
+                continue;
+            }
+            handler(*reinterpret_cast<const struct proc_event*>(message->data));
+        }
+    }
+}
+
+#endif
+
+}  // namespace
+
+ProcessTable::ProcessTable()
+    : started_(false),
+      netlink_fd_(-1),
+      pidfd_supported_(true) {}
+
+ProcessTable::~ProcessTable() {
+#if defined(__linux__)
+    if (netlink_fd_ >= 0) {
+        (void)::close(netlink_fd_);
+    }
+    std::map<int, int>::const_iterator iter;
+    for (iter = watched_.begin(); iter != watched_.end(); ++iter) {
+        (void)::close(iter->second);
+    }
+#endif
+}
+
+std::vector<int> ProcessTable::FindByName(const std::string& name) {
+    std::vector<int> pids;
+#if defined(__linux__)
+    std::lock_guard<std::mutex> lock(mutex_);
+    EnsureStartedLocked();
+    if (netlink_fd_ >= 0) {
+        DrainEventsLocked();
+    } else if (std::chrono::steady_clock::now() - last_scan_ >= std::chrono::milliseconds(kRescanIntervalMs)) {
+        RescanLocked();
+    }
+    ReapWatchedLocked();
+
+    const std::unordered_map<std::string, std::set<int> >::const_iterator found = pids_by_name_.find(ToLowerCopy(name));
+    if (found == pids_by_name_.end()) {
+        return pids;
+    }
+    const std::vector<int> candidates(found->second.begin(), found->second.end());
+    std::size_t index;
+    for (index = 0; index < candidates.size(); ++index) {
+        // Opening the pidfd doubles as a liveness check for pids the table has not seen exit.
+        if (WatchLocked(candidates[index])) {
+            pids.push_back(candidates[index]);
+        } else {
+            RemoveProcessLocked(candidates[index]);
+        }
+    }
+#else
+    (void)name;
+#endif
+    return pids;
+}
+
+void ProcessTable::Track(const int pid) {
+#if defined(__linux__)
+    if (pid <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    EnsureStartedLocked();
+    std::string comm;
+    if (ReadProcComm(pid, comm) && WatchLocked(pid)) {
+        SetProcessLocked(pid, comm);
+    }
+#else
+    (void)pid;
+#endif
+}
+
+std::string ProcessTable::Mode() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!started_) {
+        return std::string();
+    }
+    return netlink_fd_ >= 0 ? "netlink" : "scan";
+}
+
+void ProcessTable::EnsureStartedLocked() {
+    if (started_) {
+        return;
+    }
+    started_ = true;
+#if defined(__linux__)
+    // Subscribe before the first scan so nothing between the two is missed.
+    SubscribeProcConnectorLocked();
+    RescanLocked();
+#endif
+}
+
+bool ProcessTable::SubscribeProcConnectorLocked() {
+#if defined(__linux__)
+    const int fd = ::socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct sockaddr_nl address;
+    std::memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    // Joining the group needs CAP_NET_ADMIN; unprivileged hosts fall back to scanning.
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+        (void)::close(fd);
+        return false;
+    }
+
+    const int receive_buffer = 1024 * 1024;
+    (void)::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));
+
+    alignas(struct nlmsghdr) char request[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+    std::memset(request, 0, sizeof(request));
+    struct nlmsghdr* header = reinterpret_cast<struct nlmsghdr*>(request);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = static_cast<unsigned int>(::getpid());
+    struct cn_msg* message = reinterpret_cast<struct cn_msg*>(NLMSG_DATA(header));
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(enum proc_cn_mcast_op);
+    const enum proc_cn_mcast_op listen = PROC_CN_MCAST_LISTEN;
+    std::memcpy(message->data, &listen, sizeof(listen));
+    if (::send(fd, request, header->nlmsg_len, 0) < 0) {
+        (void)::close(fd);
+        return false;
+    }
+
+    // Events are only delivered in the initial namespaces and carry pids from there. Fork a
+    // child that exits at once and require both of its events with the pid we see.
+    const pid_t probe = ::fork();
+    if (probe == 0) {
+        ::_exit(0);
+    }
+    if (probe < 0) {
+        (void)::close(fd);
+        return false;
+    }
+    int ignored_status = 0;
+    while (::waitpid(probe, &ignored_status, 0) < 0 && errno == EINTR) {
+    }
+
+    bool saw_fork = false;
+    bool saw_exit = false;
+    const std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(kSelfTestTimeoutMs);
+    while (!(saw_fork && saw_exit)) {
+        const long long left_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left_ms <= 0) {
+            break;
+        }
+        struct pollfd entry;
+        entry.fd = fd;
+        entry.events = POLLIN;
+        entry.revents = 0;
+        if (::poll(&entry, 1, static_cast<int>(left_ms)) <= 0) {
+            continue;
+        }
+        ReadProcEvents(fd, [&](const struct proc_event& event) {
+            saw_fork = saw_fork || ForkedPid(event) == probe;
+            saw_exit = saw_exit || ExitedPid(event) == probe;
+        });
+    }
+    if (!(saw_fork && saw_exit)) {
+        (void)::close(fd);
+        return false;
+    }
+
+    netlink_fd_ = fd;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProcessTable::DrainEventsLocked() {
+#if defined(__linux__)
+    // Names are re-read from /proc rather than taken from events, so replaying an event
+    // that predates the last scan is harmless.
+    const bool complete = ReadProcEvents(netlink_fd_, [this](const struct proc_event& event) {
+        int pid = ForkedPid(event);
+        if (pid == 0 && event.what == proc_event::PROC_EVENT_EXEC &&
+            event.event_data.exec.process_pid == event.event_data.exec.process_tgid) {
+            pid = event.event_data.exec.process_pid;
+        }
+        if (pid == 0 && event.what == proc_event::PROC_EVENT_COMM &&
+            event.event_data.comm.process_pid == event.event_data.comm.process_tgid) {
+            pid = event.event_data.comm.process_pid;
+        }
+        if (pid != 0) {
+            std::string comm;
+            if (ReadProcComm(pid, comm)) {
+                SetProcessLocked(pid, comm);
+            }
+            return;
+        }
+        const int exited = ExitedPid(event);
+        if (exited != 0) {
+            RemoveProcessLocked(exited);
+        }
+    });
+    if (!complete) {
+        RescanLocked();
+    }
+#endif
+}
+
+void ProcessTable::RescanLocked() {
+#if defined(__linux__)
+    last_scan_ = std::chrono::steady_clock::now();
+    DIR* proc_dir = ::opendir("/proc");
+    if (proc_dir == NULL) {
+        return;
+    }
+
+    std::set<int> seen;
+    const struct dirent* entry = NULL;
+    while ((entry = ::readdir(proc_dir)) != NULL) {
+        const int pid = ParseProcNumber(entry->d_name);
+        if (pid <= 0) {
+            continue;
+        }
+        std::string comm;
+        if (ReadProcComm(pid, comm)) {
+            seen.insert(pid);
+            SetProcessLocked(pid, comm);
+        }
+    }
+    (void)::closedir(proc_dir);
+
+    std::vector<int> gone;
+    std::unordered_map<int, std::string>::const_iterator iter;
+    for (iter = names_.begin(); iter != names_.end(); ++iter) {
+        if (seen.find(iter->first) == seen.end()) {
+            gone.push_back(iter->first);
+        }
+    }
+    std::size_t index;
+    for (index = 0; index < gone.size(); ++index) {
+        RemoveProcessLocked(gone[index]);
+    }
+#endif
+}
+
+void ProcessTable::ReapWatchedLocked() {
+#if defined(__linux__)
+    if (watched_.empty()) {
+        return;
+    }
+    std::vector<struct pollfd> entries;
+    std::vector<int> pids;
+    std::map<int, int>::const_iterator iter;
+    for (iter = watched_.begin(); iter != watched_.end(); ++iter) {
+        struct pollfd entry;
+        entry.fd = iter->second;
+        entry.events = POLLIN;
+        entry.revents = 0;
+        entries.push_back(entry);
+        pids.push_back(iter->first);
+    }
+    if (::poll(entries.data(), static_cast<nfds_t>(entries.size()), 0) <= 0) {
+        return;
+    }
+    std::size_t index;
+    for (index = 0; index < entries.size(); ++index) {
+        if ((entries[index].revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) != 0) {
+            RemoveProcessLocked(pids[index]);
+        }
+    }
+#endif
+}
+
+bool ProcessTable::WatchLocked(const int pid) {
+#if defined(__linux__)
+    if (watched_.find(pid) != watched_.end() || !pidfd_supported_ || watched_.size() >= kMaxWatchedPids) {
+        return true;
+    }
+    const long fd = ::syscall(SYS_pidfd_open, pid, 0);
+    if (fd < 0) {
+        if (errno == ESRCH) {
+            return false;
+        }
+        if (errno == ENOSYS) {
+            pidfd_supported_ = false;
+        }
+        return true;
+    }
+    // A zombie's pidfd is readable at once; it no longer counts as running.
+    struct pollfd entry;
+    entry.fd = static_cast<int>(fd);
+    entry.events = POLLIN;
+    entry.revents = 0;
+    if (::poll(&entry, 1, 0) > 0) {
+        (void)::close(static_cast<int>(fd));
+        return false;
+    }
+    (void)::fcntl(static_cast<int>(fd), F_SETFD, FD_CLOEXEC);
+    watched_[pid] = static_cast<int>(fd);
+#else
+    (void)pid;
+#endif
+    return true;
+}
+
+void ProcessTable::SetProcessLocked(const int pid, const std::string& comm) {
+    const std::unordered_map<int, std::string>::iterator existing = names_.find(pid);
+    if (existing != names_.end()) {
+        if (existing->second == comm) {
+            return;
+        }
+        // Exec renamed it; keep the watch, the process is the same.
+        const std::string old_key = ToLowerCopy(existing->second);
+        pids_by_name_[old_key].erase(pid);
+        if (pids_by_name_[old_key].empty()) {
+            pids_by_name_.erase(old_key);
+        }
+        existing->second = comm;
+    } else {
+        names_[pid] = comm;
+    }
+    pids_by_name_[ToLowerCopy(comm)].insert(pid);
+}
+
+void ProcessTable::RemoveProcessLocked(const int pid) {
+    const std::unordered_map<int, std::string>::iterator existing = names_.find(pid);
+    if (existing != names_.end()) {
+        const std::string key = ToLowerCopy(existing->second);
+        pids_by_name_[key].erase(pid);
+        if (pids_by_name_[key].empty()) {
+            pids_by_name_.erase(key);
+        }
+        names_.erase(existing);
+    }
+#if defined(__linux__)
+    const std::map<int, int>::iterator watch = watched_.find(pid);
+    if (watch != watched_.end()) {
+        (void)::close(watch->second);
+        watched_.erase(watch);
+    }
+#endif
+}
+
+ProcessTable& SharedProcessTable() {
+    static ProcessTable table;
+    return table;
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
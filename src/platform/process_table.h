@@ -0,0 +1,65 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_PROCESS_TABLE_H
+#define PROCESS_INTERFACE_PLATFORM_PROCESS_TABLE_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ProcessInterface {
+namespace Platform {
+
+// Live pid -> process name (comm) table for Linux, indexed by lowercased name.
+//
+// Kept current from the netlink proc connector (fork/exec/comm/exit events) when the host
+// may subscribe and the events carry pids of this pid namespace; otherwise from /proc
+// rescans, diffed against the table, at most every kRescanIntervalMs. Pids handed out by
+// lookups or passed to Track are also watched with pidfds, so their exit is seen on the next
+// lookup without a rescan. Pending events are applied on access; there is no thread.
+class ProcessTable {
+public:
+    ProcessTable();
+    ~ProcessTable();
+
+    ProcessTable(const ProcessTable&) = delete;
+    ProcessTable& operator=(const ProcessTable&) = delete;
+
+    // Pids whose comm equals name, ignoring case (pgrep -i -x), ascending.
+    std::vector<int> FindByName(const std::string& name);
+
+    // Adds a process the host started so it is known before the next event or rescan.
+    void Track(int pid);
+
+    // "netlink" or "scan"; empty before first use.
+    std::string Mode() const;
+
+private:
+    void EnsureStartedLocked();
+    bool SubscribeProcConnectorLocked();
+    void DrainEventsLocked();
+    void RescanLocked();
+    void ReapWatchedLocked();
+    bool WatchLocked(int pid);
+    void SetProcessLocked(int pid, const std::string& comm);
+    void RemoveProcessLocked(int pid);
+
+    mutable std::mutex mutex_;
+    bool started_;
+    int netlink_fd_;
+    std::chrono::steady_clock::time_point last_scan_;
+    std::unordered_map<int, std::string> names_;
+    std::unordered_map<std::string, std::set<int> > pids_by_name_;
+    // pid -> pidfd; bounded by kMaxWatchedPids.
+    std::map<int, int> watched_;
+    bool pidfd_supported_;
+};
+
+ProcessTable& SharedProcessTable();
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_PROCESS_TABLE_H
@@ -0,0 +1,600 @@
+#include "python_worker_pool.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "../../external/nlohmann/json.hpp"
+
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
+#define PROCESS_INTERFACE_PLATFORM_WINDOWS 1
+#else
+#define PROCESS_INTERFACE_PLATFORM_WINDOWS 0
+#endif
+
+#if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+namespace {
+
+typedef std::chrono::steady_clock SteadyClock;
+
+const int kReplyPollTickMs = 50;
+const int kPingTimeoutMs = 2000;
+const int kDefaultKillGraceMs = 5000;
+// Output chunks are read 16 KiB at a time, so even a fully escaped chunk frame stays well
+// below this; anything longer is a broken worker.
+const std::size_t kMaxReplyLineBytes = 1024 * 1024;
+
+// Protocol fds are private duplicates; 0/1/2 point at /dev/null between runs and at a
+// capture pipe during a run, so subprocesses of the script are captured as well. A pump
+// thread forwards the pipe as {"id","chunk"} frames while the script runs.
+const char* kWorkerSource = R"PY(
+import codecs, json, os, runpy, select, sys, threading, traceback
+
+CHUNK_BYTES = 16384
+
+def main():
+    proto_in = os.fdopen(os.dup(0), 'rb')
+    proto_out = os.fdopen(os.dup(1), 'wb')
+    null_fd = os.open(os.devnull, os.O_RDWR)
+    os.dup2(null_fd, 0)
+    os.dup2(null_fd, 1)
+    os.dup2(null_fd, 2)
+    base_env = dict(os.environ)
+    base_cwd = os.getcwd()
+    base_path = list(sys.path)
+    base_argv = list(sys.argv)
+
+    send_lock = threading.Lock()
+
+    def send(message):
+        with send_lock:
+            proto_out.write(json.dumps(message).encode('utf-8') + b'\n')
+            proto_out.flush()
+
+    def pump(read_fd, request_id, done):
+        decoder = codecs.getincrementaldecoder('utf-8')('replace')
+        while True:
+            ready = select.select([read_fd], [], [], 0.05)[0]
+            if not ready:
+                # Output from descendants that outlive the script is dropped.
+                if done.is_set():
+                    break
+                continue
+            data = os.read(read_fd, CHUNK_BYTES)
+            if not data:
+                break
+            text = decoder.decode(data)
+            if text:
+                send({'id': request_id, 'chunk': text})
+        text = decoder.decode(b'', True)
+        if text:
+            send({'id': request_id, 'chunk': text})
+
+    def rss_kb():
+        try:
+            with open('/proc/self/statm') as statm:
+                return int(statm.read().split()[1]) * os.sysconf('SC_PAGE_SIZE') // 1024
+        except Exception:
+            return 0
+
+    send({'ready': True, 'pid': os.getpid()})
+    for line in proto_in:
+        try:
+            request = json.loads(line)
+        except ValueError:
+            continue
+        if request.get('op') == 'ping':
+            send({'id': request.get('id'), 'pong': True, 'rssKb': rss_kb()})
+            continue
+
+        read_fd, write_fd = os.pipe()
+        os.dup2(write_fd, 1)
+        os.dup2(write_fd, 2)
+        os.close(write_fd)
+        done = threading.Event()
+        pumper = threading.Thread(target=pump, args=(read_fd, request.get('id'), done))
+        pumper.daemon = True
+        pumper.start()
+        rc = 0
+        try:
+            os.chdir(request.get('cwd') or base_cwd)
+            mode = request.get('mode')
+            target = request.get('target')
+            argv = request.get('argv') or []
+            if mode == 'module':
+                sys.argv = [target] + argv
+                runpy.run_module(target, run_name='__main__', alter_sys=True)
+            elif mode == 'code':
+                sys.argv = ['-c'] + argv
+                exec(compile(target, '<string>', 'exec'), {'__name__': '__main__'})
+            else:
+                sys.argv = [target] + argv
+                sys.path.insert(0, os.path.dirname(os.path.abspath(target)))
+                runpy.run_path(target, run_name='__main__')
+        except SystemExit as exit_request:
+            if exit_request.code is None:
+                rc = 0
+            elif isinstance(exit_request.code, int):
+                rc = exit_request.code
+            else:
+                sys.stderr.write(str(exit_request.code) + '\n')
+                rc = 1
+        except BaseException:
+            error_type, error_value, trace = sys.exc_info()
+            # Hide the worker loop and runpy frames, as a spawned interpreter would.
+            trace = trace.tb_next
+            while trace is not None and 'runpy' in trace.tb_frame.f_code.co_filename:
+                trace = trace.tb_next
+            traceback.print_exception(error_type, error_value, trace)
+            rc = 1
+        finally:
+            sys.stdout = sys.__stdout__
+            sys.stderr = sys.__stderr__
+            try:
+                sys.stdout.flush()
+                sys.stderr.flush()
+            except Exception:
+                pass
+            os.dup2(null_fd, 1)
+            os.dup2(null_fd, 2)
+            os.environ.clear()
+            os.environ.update(base_env)
+            os.chdir(base_cwd)
+            sys.path[:] = base_path
+            sys.argv = base_argv
+
+        done.set()
+        pumper.join()
+        os.close(read_fd)
+        send({'id': request.get('id'), 'rc': rc, 'rssKb': rss_kb()})
+
+main()
+)PY";
+
+}  // namespace
+
+struct PythonWorkerPool::Worker {
+    std::string interpreter;
+    int pid;
+    int socket_fd;
+    std::size_t runs;
+    unsigned long long rss_kb;
+    SteadyClock::time_point last_used;
+    // Bytes received after the last complete reply line.
+    std::string pending;
+};
+
+namespace {
+
+#if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+
+enum class ReplyStatus {
+    kLine,
+    kClosed,
+    kOverflow,
+    kTimedOut,
+    kCanceled,
+};
+
+bool SendLine(const int fd, const std::string& line) {
+    std::size_t sent = 0;
+    while (sent < line.size()) {
+        const ssize_t wrote = ::send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+        if (wrote < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent += static_cast<std::size_t>(wrote);
+    }
+    return true;
+}
+
+// deadline_ms <= 0 waits without a deadline.
+ReplyStatus ReadReplyLine(
+    int fd,
+    std::string& pending,
+    int deadline_ms,
+    const std::atomic<bool>* cancel_requested,
+    std::string& line_out) {
+    const SteadyClock::time_point deadline = SteadyClock::now() + std::chrono::milliseconds(deadline_ms);
+    while (true) {
+        const std::string::size_type newline = pending.find('\n');
+        if (newline != std::string::npos) {
+            line_out = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            return ReplyStatus::kLine;
+        }
+
+        if (cancel_requested != NULL && cancel_requested->load()) {
+            return ReplyStatus::kCanceled;
+        }
+        if (deadline_ms > 0 && SteadyClock::now() >= deadline) {
+            return ReplyStatus::kTimedOut;
+        }
+
+        struct pollfd entry;
+        entry.fd = fd;
+        entry.events = POLLIN;
+        entry.revents = 0;
+        const int poll_rc = ::poll(&entry, 1, kReplyPollTickMs);
+        if (poll_rc <= 0 || (entry.revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+            continue;
+        }
+
+        char buffer[65536];
+        ssize_t got = 0;
+        do {
+            got = ::read(fd, buffer, sizeof(buffer));
+        } while (got < 0 && errno == EINTR);
+        if (got <= 0) {
+            return ReplyStatus::kClosed;
+        }
+        pending.append(buffer, static_cast<std::size_t>(got));
+        if (pending.size() > kMaxReplyLineBytes && pending.find('\n') == std::string::npos) {
+            return ReplyStatus::kOverflow;
+        }
+    }
+}
+
+bool WorkerAlive(const int pid) {
+    int status = 0;
+    return ::waitpid(pid, &status, WNOHANG) == 0;
+}
+
+#endif
+
+}  // namespace
+
+PythonWorkerPoolOptions DefaultPythonWorkerPoolOptions() {
+    PythonWorkerPoolOptions options;
+    options.max_workers = 2;
+    options.max_runs_per_worker = 200;
+    options.max_rss_kb = 256 * 1024;
+    options.idle_health_check_ms = 30000;
+    options.startup_timeout_ms = 10000;
+    return options;
+}
+
+PythonWorkerPool::PythonWorkerPool(const PythonWorkerPoolOptions& options)
+    : options_(options),
+      live_count_(0),
+      next_request_id_(0) {}
+
+PythonWorkerPool::~PythonWorkerPool() {
+#if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+    std::size_t index;
+    for (index = 0; index < idle_.size(); ++index) {
+        (void)::close(idle_[index]->socket_fd);
+        (void)TerminateProcessGroup(idle_[index]->pid, 0);
+    }
+#endif
+    idle_.clear();
+}
+
+std::shared_ptr<PythonWorkerPool::Worker> PythonWorkerPool::Acquire(
+    const std::string& interpreter,
+    std::string& error_message) {
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    (void)interpreter;
+    error_message = "python workers are not available on this platform";
+    return std::shared_ptr<Worker>();
+#else
+    while (true) {
+        std::shared_ptr<Worker> candidate;
+        std::shared_ptr<Worker> displaced;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::size_t index = idle_.size();
+            while (index > 0) {
+                --index;
+                if (idle_[index]->interpreter == interpreter) {
+                    candidate = idle_[index];
+                    idle_.erase(idle_.begin() + static_cast<std::ptrdiff_t>(index));
+                    break;
+                }
+            }
+
+            if (!candidate) {
+                if (live_count_ >= options_.max_workers) {
+                    if (idle_.empty()) {
+                        error_message = "python worker pool exhausted";
+                        return std::shared_ptr<Worker>();
+                    }
+                    // An idle worker for another interpreter gives up its slot.
+                    displaced = idle_.front();
+                    idle_.erase(idle_.begin());
+                } else {
+                    live_count_ += 1;
+                }
+            }
+        }
+
+        if (displaced) {
+            // Its slot now belongs to the worker started below.
+            (void)::close(displaced->socket_fd);
+            (void)TerminateProcessGroup(displaced->pid, 0);
+        }
+
+        if (candidate) {
+            bool healthy = WorkerAlive(candidate->pid);
+            const long long idle_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                SteadyClock::now() - candidate->last_used).count();
+            if (healthy && idle_ms > options_.idle_health_check_ms) {
+                std::string reply;
+                healthy = SendLine(candidate->socket_fd, "{\"op\":\"ping\"}\n") &&
+                    ReadReplyLine(candidate->socket_fd, candidate->pending, kPingTimeoutMs, NULL, reply) ==
+                        ReplyStatus::kLine &&
+                    reply.find("\"pong\"") != std::string::npos;
+            }
+            if (healthy) {
+                return candidate;
+            }
+            (void)::close(candidate->socket_fd);
+            (void)TerminateProcessGroup(candidate->pid, 0);
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_count_ -= 1;
+            continue;
+        }
+
+        // A slot is reserved; start a new interpreter outside the lock.
+        int sockets[2] = {-1, -1};
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+            error_message = std::string("socketpair failed: ") + std::strerror(errno);
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_count_ -= 1;
+            return std::shared_ptr<Worker>();
+        }
+
+        std::vector<std::string> args;
+        args.push_back(interpreter);
+        args.push_back("-u");
+        args.push_back("-c");
+        args.push_back(kWorkerSource);
+        std::vector<char*> argv;
+        std::size_t arg_index;
+        for (arg_index = 0; arg_index < args.size(); ++arg_index) {
+            argv.push_back(const_cast<char*>(args[arg_index].c_str()));
+        }
+        argv.push_back(NULL);
+
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            (void)::setpgid(0, 0);
+            (void)::signal(SIGPIPE, SIG_DFL);
+            (void)::dup2(sockets[1], STDIN_FILENO);
+            (void)::dup2(sockets[1], STDOUT_FILENO);
+            const int null_fd = ::open("/dev/null", O_WRONLY);
+            if (null_fd >= 0) {
+                (void)::dup2(null_fd, STDERR_FILENO);
+            }
+            ::execvp(argv[0], argv.data());
+            ::_exit(127);
+        }
+        (void)::close(sockets[1]);
+
+        if (pid < 0) {
+            error_message = std::string("fork failed: ") + std::strerror(errno);
+            (void)::close(sockets[0]);
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_count_ -= 1;
+            return std::shared_ptr<Worker>();
+        }
+        (void)::setpgid(pid, pid);
+
+        std::shared_ptr<Worker> worker = std::make_shared<Worker>();
+        worker->interpreter = interpreter;
+        worker->pid = static_cast<int>(pid);
+        worker->socket_fd = sockets[0];
+        worker->runs = 0;
+        worker->rss_kb = 0;
+        worker->last_used = SteadyClock::now();
+
+        std::string ready;
+        if (ReadReplyLine(worker->socket_fd, worker->pending, options_.startup_timeout_ms, NULL, ready) !=
+                ReplyStatus::kLine ||
+            ready.find("\"ready\"") == std::string::npos) {
+            error_message = "python worker did not start: " + interpreter;
+            (void)::close(worker->socket_fd);
+            (void)TerminateProcessGroup(worker->pid, 0);
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_count_ -= 1;
+            return std::shared_ptr<Worker>();
+        }
+        return worker;
+    }
+#endif
+}
+
+void PythonWorkerPool::Release(const std::shared_ptr<Worker>& worker, bool reusable) {
+#if !PROCESS_INTERFACE_PLATFORM_WINDOWS
+    if (reusable) {
+        worker->last_used = SteadyClock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(worker);
+        return;
+    }
+
+    (void)::close(worker->socket_fd);
+    (void)TerminateProcessGroup(worker->pid, 0);
+    std::lock_guard<std::mutex> lock(mutex_);
+    live_count_ -= 1;
+#else
+    (void)worker;
+    (void)reusable;
+#endif
+}
+
+bool PythonWorkerPool::Run(const ProcessRunOptions& options, ProcessRunResult& result_out, std::string& error_message) {
+    ProcessRunResult result;
+    result.launch_ok = false;
+    result.completed = false;
+    result.timed_out = false;
+    result.canceled = false;
+    result.exit_code = -1;
+    result.pid = 0;
+    result.supports_pid = true;
+    result.supports_timeout = true;
+    result.supports_cancel = true;
+    result.supports_separate_stderr = false;
+
+#if PROCESS_INTERFACE_PLATFORM_WINDOWS
+    (void)options;
+    (void)result_out;
+    error_message = "python workers are not available on this platform";
+    return false;
+#else
+    if (options.detached || options.command.size() < 2) {
+        error_message = "command cannot run in a python worker";
+        return false;
+    }
+
+    nlohmann::json request;
+    std::size_t argv_start = 2;
+    if (options.command[1] == "-m" || options.command[1] == "-c") {
+        if (options.command.size() < 3) {
+            error_message = "command cannot run in a python worker";
+            return false;
+        }
+        request["mode"] = options.command[1] == "-m" ? "module" : "code";
+        request["target"] = options.command[2];
+        argv_start = 3;
+    } else if (!options.command[1].empty() && options.command[1][0] == '-') {
+        error_message = "interpreter options are not supported by python workers";
+        return false;
+    } else {
+        request["mode"] = "script";
+        request["target"] = options.command[1];
+    }
+    request["argv"] = nlohmann::json::array();
+    std::size_t index;
+    for (index = argv_start; index < options.command.size(); ++index) {
+        request["argv"].push_back(options.command[index]);
+    }
+    request["cwd"] = options.cwd.string();
+
+    const std::shared_ptr<Worker> worker = Acquire(options.command[0], error_message);
+    if (!worker) {
+        return false;
+    }
+
+    if (options.cancel_requested != NULL && options.cancel_requested->load()) {
+        Release(worker, true);
+        result.launch_ok = true;
+        result.canceled = true;
+        result.completed = true;
+        result_out = result;
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        request["id"] = ++next_request_id_;
+    }
+    if (!SendLine(worker->socket_fd, request.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) + "\n")) {
+        Release(worker, false);
+        error_message = "python worker rejected the request";
+        return false;
+    }
+
+    result.launch_ok = true;
+    result.pid = worker->pid;
+
+    // Output chunk frames are forwarded as they arrive; the frame with "rc" ends the run.
+    const SteadyClock::time_point run_deadline = SteadyClock::now() + std::chrono::milliseconds(options.timeout_ms);
+    std::string reply_line;
+    nlohmann::json reply;
+    ReplyStatus status = ReplyStatus::kLine;
+    while (true) {
+        int remaining_ms = 0;
+        if (options.timeout_ms > 0) {
+            remaining_ms = static_cast<int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(run_deadline - SteadyClock::now()).count());
+            if (remaining_ms <= 0) {
+                status = ReplyStatus::kTimedOut;
+                break;
+            }
+        }
+        status = ReadReplyLine(worker->socket_fd, worker->pending, remaining_ms, options.cancel_requested, reply_line);
+        if (status != ReplyStatus::kLine) {
+            break;
+        }
+
+        try {
+            reply = nlohmann::json::parse(reply_line);
+        } catch (const std::exception&) {
+            reply = nlohmann::json();
+        }
+        if (!reply.is_object() || !reply.contains("chunk")) {
+            break;
+        }
+        const std::string chunk = reply.value("chunk", std::string());
+        if (options.output_sink) {
+            if (!chunk.empty()) {
+                options.output_sink(chunk.data(), chunk.size());
+            }
+        } else {
+            result.stdout_text.append(chunk);
+        }
+    }
+
+    if (status != ReplyStatus::kLine) {
+        // The run is abandoned with the worker; its process group goes down with it.
+        (void)::close(worker->socket_fd);
+        const int kill_grace_ms = options.kill_grace_ms > 0 ? options.kill_grace_ms : kDefaultKillGraceMs;
+        result.exit_code = TerminateProcessGroup(worker->pid, status == ReplyStatus::kClosed ? 0 : kill_grace_ms);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_count_ -= 1;
+        }
+        result.timed_out = status == ReplyStatus::kTimedOut;
+        result.canceled = status == ReplyStatus::kCanceled;
+        if (status == ReplyStatus::kClosed || status == ReplyStatus::kOverflow) {
+            result.error_message = status == ReplyStatus::kClosed
+                ? "python worker exited during the run"
+                : "python worker sent an oversized frame";
+            if (result.exit_code == 0) {
+                result.exit_code = -1;
+            }
+        }
+        result.completed = true;
+        result_out = result;
+        return true;
+    }
+
+    if (reply.is_object()) {
+        result.exit_code = reply.value("rc", -1);
+        worker->rss_kb = reply.value("rssKb", 0ULL);
+    } else {
+        result.exit_code = -1;
+        result.error_message = "python worker sent an unreadable reply";
+    }
+    worker->runs += 1;
+
+    const bool reusable = result.error_message.empty() &&
+        worker->runs < options_.max_runs_per_worker &&
+        (options_.max_rss_kb == 0 || worker->rss_kb <= options_.max_rss_kb);
+    Release(worker, reusable);
+
+    result.completed = true;
+    result_out = result;
+    return true;
+#endif
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
@@ -0,0 +1,64 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_PYTHON_WORKER_POOL_H
+#define PROCESS_INTERFACE_PLATFORM_PYTHON_WORKER_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "process_exec.h"
+
+namespace ProcessInterface {
+namespace Platform {
+
+struct PythonWorkerPoolOptions {
+    // Upper bound on live workers across all interpreters.
+    std::size_t max_workers;
+    // A worker is replaced after this many runs, or once its RSS exceeds max_rss_kb.
+    std::size_t max_runs_per_worker;
+    unsigned long long max_rss_kb;
+    // Workers idle for longer than this are pinged before they are handed a run.
+    int idle_health_check_ms;
+    // Time allowed for a new interpreter to import and report ready.
+    int startup_timeout_ms;
+};
+
+PythonWorkerPoolOptions DefaultPythonWorkerPoolOptions();
+
+// Long-lived Python interpreters that run catalog scripts in-process to skip interpreter
+// startup. Each worker is its own process group and speaks NDJSON over a socket on its
+// stdin/stdout: {"id","mode","target","argv","cwd"} in; {"id","chunk"} output frames of at
+// most 16 KiB of text while the script runs, then {"id","rc","rssKb"} out. Timeouts and
+// cancellation terminate the worker's whole process group, and the worker is replaced.
+class PythonWorkerPool {
+public:
+    explicit PythonWorkerPool(const PythonWorkerPoolOptions& options);
+    ~PythonWorkerPool();
+
+    PythonWorkerPool(const PythonWorkerPool&) = delete;
+    PythonWorkerPool& operator=(const PythonWorkerPool&) = delete;
+
+    // command is [interpreter, script, args...], [interpreter, "-m", module, args...] or
+    // [interpreter, "-c", code, args...]. Returns false, before anything has run, when no
+    // worker can take the run; callers then fall back to RunProcess.
+    bool Run(const ProcessRunOptions& options, ProcessRunResult& result_out, std::string& error_message);
+
+private:
+    struct Worker;
+
+    std::shared_ptr<Worker> Acquire(const std::string& interpreter, std::string& error_message);
+    void Release(const std::shared_ptr<Worker>& worker, bool reusable);
+
+    PythonWorkerPoolOptions options_;
+    std::mutex mutex_;
+    // Most recently used last.
+    std::vector<std::shared_ptr<Worker> > idle_;
+    std::size_t live_count_;
+    unsigned long long next_request_id_;
+};
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_PYTHON_WORKER_POOL_H
@@ -0,0 +1,106 @@
+#include "socket_owners.h"
+
+#include "proc_fs.h"
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace ProcessInterface {
+namespace Platform {
+
+namespace {
+
+#if defined(__linux__)
+
+// "socket:[12345]" -> 12345.
+bool ParseSocketLink(const char* link, unsigned long long& inode_out) {
+    static const char kPrefix[] = "socket:[";
+    if (std::strncmp(link, kPrefix, sizeof(kPrefix) - 1) != 0) {
+        return false;
+    }
+    char* end = NULL;
+    inode_out = std::strtoull(link + sizeof(kPrefix) - 1, &end, 10);
+    return end != NULL && *end == ']';
+}
+
+#endif
+
+}  // namespace
+
+bool BuildSocketOwnerIndex(
+    const std::set<unsigned long long>& inodes,
+    std::map<unsigned long long, SocketOwner>& owners_out) {
+    owners_out.clear();
+#if defined(__linux__)
+    DIR* proc_dir = ::opendir("/proc");
+    if (proc_dir == NULL) {
+        return false;
+    }
+    if (inodes.empty()) {
+        (void)::closedir(proc_dir);
+        return true;
+    }
+
+    std::map<unsigned long long, int> owner_pids;
+    struct dirent* proc_entry = NULL;
+    while ((proc_entry = ::readdir(proc_dir)) != NULL) {
+        const int pid = ParseProcNumber(proc_entry->d_name);
+        if (pid <= 0) {
+            continue;
+        }
+        char fd_path[64];
+        std::snprintf(fd_path, sizeof(fd_path), "/proc/%d/fd", pid);
+        DIR* fd_dir = ::opendir(fd_path);
+        if (fd_dir == NULL) {
+            continue;
+        }
+        struct dirent* fd_entry = NULL;
+        while ((fd_entry = ::readdir(fd_dir)) != NULL) {
+            if (ParseProcNumber(fd_entry->d_name) < 0) {
+                continue;
+            }
+            char link[64];
+            const ssize_t length = ::readlinkat(::dirfd(fd_dir), fd_entry->d_name, link, sizeof(link) - 1);
+            if (length <= 0) {
+                continue;
+            }
+            link[length] = '\0';
+            unsigned long long inode = 0;
+            if (!ParseSocketLink(link, inode) || inodes.count(inode) == 0) {
+                continue;
+            }
+            std::map<unsigned long long, int>::iterator owner = owner_pids.find(inode);
+            if (owner == owner_pids.end()) {
+                owner_pids[inode] = pid;
+            } else if (pid < owner->second) {
+                owner->second = pid;
+            }
+        }
+        (void)::closedir(fd_dir);
+    }
+    (void)::closedir(proc_dir);
+
+    std::map<unsigned long long, int>::const_iterator iter;
+    for (iter = owner_pids.begin(); iter != owner_pids.end(); ++iter) {
+        SocketOwner owner;
+        owner.pid = iter->second;
+        (void)ReadProcComm(iter->second, owner.comm);
+        owners_out[iter->first] = owner;
+    }
+    return true;
+#else
+    (void)inodes;
+    return false;
+#endif
+}
+
+}  // namespace Platform
+}  // namespace ProcessInterface
@@ -0,0 +1,28 @@
+#ifndef PROCESS_INTERFACE_PLATFORM_SOCKET_OWNERS_H
+#define PROCESS_INTERFACE_PLATFORM_SOCKET_OWNERS_H
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace ProcessInterface {
+namespace Platform {
+
+struct SocketOwner {
+    int pid;
+    std::string comm;
+};
+
+// Maps socket inodes (as listed in /proc/net/tcp{,6}) to the process holding them by
+// walking /proc/<pid>/fd once; only the inodes asked for are kept. A socket shared by
+// several processes (forked workers, inherited listeners) maps to the lowest pid.
+// Processes whose fds the host may not read are skipped, so an inode can stay unmapped.
+// Returns false when /proc cannot be listed (not Linux).
+bool BuildSocketOwnerIndex(
+    const std::set<unsigned long long>& inodes,
+    std::map<unsigned long long, SocketOwner>& owners_out);
+
+}  // namespace Platform
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_PLATFORM_SOCKET_OWNERS_H
@@ -1,16 +1,233 @@
 #include "action_catalog.h"
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+
 #include "../../../external/nlohmann/json.hpp"
-#include "../../common/file_io.h"
+#include "../../common/file_cache.h"
+#include "../../common/text.h"
 
 namespace ProcessInterface {
 namespace Common {
 
+namespace {
+
+const double kDefaultCacheTtlSeconds = 5.0;
+// Charged to the file cache for a compiled catalog: command templates, resolved paths and
+// the config provider.
+const std::size_t kCompiledCatalogBytesPerTextByte = 4;
+
+// Same matching as the former "\{([^{}]+)\}" pattern: a placeholder is the first
+// brace pair enclosing at least one character and no other brace.
+std::vector<CommandSegment> ParseCommandToken(const std::string& token) {
+    std::vector<CommandSegment> segments;
+    std::string literal;
+    std::size_t index = 0;
+    while (index < token.size()) {
+        if (token[index] == '{') {
+            const std::size_t close = token.find_first_of("{}", index + 1);
+            if (close != std::string::npos && token[close] == '}' && close > index + 1) {
+                if (!literal.empty()) {
+                    const CommandSegment literal_segment = {false, literal};
+                    segments.push_back(literal_segment);
+                    literal.clear();
+                }
+                const CommandSegment placeholder_segment = {true, TrimCopy(token.substr(index + 1, close - index - 1))};
+                segments.push_back(placeholder_segment);
+                index = close + 1;
+                continue;
+            }
+        }
+        literal.push_back(token[index]);
+        ++index;
+    }
+    if (!literal.empty() || segments.empty()) {
+        const CommandSegment literal_segment = {false, literal};
+        segments.push_back(literal_segment);
+    }
+    return segments;
+}
+
+bool IsLiteralToken(const std::vector<CommandSegment>& segments) {
+    return segments.size() == 1 && !segments[0].placeholder;
+}
+
+fs::path ResolveActionCwd(const fs::path& repo_root, const ActionDefinition& action) {
+    if (action.cwd.empty()) {
+        return repo_root;
+    }
+
+    if (action.cwd.size() >= 2 && action.cwd[0] == '\\' && action.cwd[1] == '\\') {
+        return repo_root;
+    }
+
+    const fs::path configured(action.cwd);
+    if (configured.is_absolute()) {
+        if (fs::exists(configured)) {
+            return configured;
+        }
+        return repo_root;
+    }
+
+    const fs::path combined = repo_root / configured;
+    if (fs::exists(combined)) {
+        return combined;
+    }
+    return repo_root;
+}
+
+bool IsPythonToken(const std::string& token) {
+    const std::string lowered = TrimCopy(token);
+    if (lowered.empty()) {
+        return false;
+    }
+
+    std::string text;
+    text.reserve(lowered.size());
+    std::size_t index;
+    for (index = 0; index < lowered.size(); ++index) {
+        const char c = lowered[index];
+        if (c >= 'A' && c <= 'Z') {
+            text.push_back(static_cast<char>(c - 'A' + 'a'));
+        } else {
+            text.push_back(c);
+        }
+    }
+
+    if (text == "python" || text == "python.exe") {
+        return true;
+    }
+
+    const std::size_t pos = text.find("python");
+    return pos != std::string::npos;
+}
+
+void CompileActionDefinition(const fs::path& repo_root, ActionDefinition& action) {
+    action.command_template.clear();
+    action.required_args.clear();
+
+    std::size_t index;
+    for (index = 0; index < action.command.size(); ++index) {
+        action.command_template.push_back(ParseCommandToken(action.command[index]));
+
+        const std::vector<CommandSegment>& segments = action.command_template.back();
+        std::size_t segment_index;
+        for (segment_index = 0; segment_index < segments.size(); ++segment_index) {
+            if (segments[segment_index].placeholder &&
+                std::find(action.required_args.begin(), action.required_args.end(), segments[segment_index].text) ==
+                    action.required_args.end()) {
+                action.required_args.push_back(segments[segment_index].text);
+            }
+        }
+    }
+
+    action.resolved_cwd = ResolveActionCwd(repo_root, action);
+    if (action.python_worker) {
+        action.python_worker = !action.detached && action.command_template.size() >= 2 &&
+            IsLiteralToken(action.command_template[0]) && IsPythonToken(action.command_template[0][0].text);
+    }
+
+    // The interpreter and script tokens are fixed, so the script lookup can be done once here.
+    action.script_fallback_at_run = false;
+    if (action.command_template.size() >= 2) {
+        if (IsLiteralToken(action.command_template[0]) && IsLiteralToken(action.command_template[1])) {
+            std::vector<std::string> command_parts;
+            command_parts.push_back(action.command_template[0][0].text);
+            command_parts.push_back(action.command_template[1][0].text);
+            ApplyPythonScriptFallback(command_parts, action.resolved_cwd);
+            action.command_template[1][0].text = command_parts[1];
+        } else {
+            action.script_fallback_at_run = true;
+        }
+    }
+}
+
+// A relative library is taken from the repo root when it exists there; otherwise the name is
+// left to the platform loader's search path.
+bool ParseNativeActionTarget(
+    const nlohmann::json& item,
+    const fs::path& repo_root,
+    const Common::PathTemplateArgs& path_args,
+    ActionDefinition& action) {
+    if (!item.contains("library") || !item["library"].is_string() || !item.contains("symbol") ||
+        !item["symbol"].is_string()) {
+        return false;
+    }
+    const std::string library = item["library"].get<std::string>();
+    action.native_symbol = item["symbol"].get<std::string>();
+    if (library.empty() || action.native_symbol.empty()) {
+        return false;
+    }
+
+    action.native_library = Common::RenderTemplatePath(library, path_args);
+    if (action.native_library.is_relative() && fs::exists(repo_root / action.native_library)) {
+        action.native_library = repo_root / action.native_library;
+    }
+    action.native_isolated =
+        item.contains("isolation") && item["isolation"].is_string() && item["isolation"].get<std::string>() == "fork";
+    return true;
+}
+
+}  // namespace
+
+const ActionDefinition* ActionCatalog::Find(const std::string& action_name) const {
+    const std::unordered_map<std::string, std::size_t>::const_iterator iter = action_index.find(action_name);
+    if (iter == action_index.end()) {
+        return NULL;
+    }
+    return &actions[iter->second];
+}
+
+void ApplyPythonScriptFallback(std::vector<std::string>& command_parts, const fs::path& cwd) {
+    if (command_parts.size() < 2) {
+        return;
+    }
+    if (!IsPythonToken(command_parts[0])) {
+        return;
+    }
+
+    const std::string entry = TrimCopy(command_parts[1]);
+    if (entry.empty() || entry[0] == '-') {
+        return;
+    }
+
+    const fs::path raw_entry(entry);
+    if (raw_entry.has_extension()) {
+        return;
+    }
+    if (entry.find('/') != std::string::npos || entry.find('\\') != std::string::npos) {
+        return;
+    }
+
+    const fs::path direct = cwd / raw_entry;
+    if (fs::exists(direct)) {
+        return;
+    }
+
+    const fs::path direct_py = cwd / (entry + ".py");
+    if (fs::exists(direct_py)) {
+        command_parts[1] = direct_py.string();
+        return;
+    }
+
+    const fs::path ops_py = cwd / "ops" / "scripts" / (entry + ".py");
+    if (fs::exists(ops_py)) {
+        command_parts[1] = ops_py.string();
+        return;
+    }
+
+    const fs::path scripts_py = cwd / "scripts" / (entry + ".py");
+    if (fs::exists(scripts_py)) {
+        command_parts[1] = scripts_py.string();
+    }
+}
+
 bool LoadActionCatalog(
     const fs::path& repo_root,
     const Common::PathTemplateSet& path_templates,
     const std::string& app_id,
-    std::vector<ActionDefinition>& actions_out,
+    std::shared_ptr<const ActionCatalog>& catalog_out,
     std::string& error_message) {
     const Common::PathTemplateArgs path_args = {
         repo_root.string(),
@@ -20,15 +237,27 @@ bool LoadActionCatalog(
     const fs::path catalog_path =
         Common::RenderTemplatePath(path_templates.action_catalog_path, path_args);
 
-    std::string catalog_text;
-    if (!ReadTextFile(catalog_path, catalog_text)) {
+    FileContentCache& file_cache = SharedFileContentCache();
+    std::shared_ptr<const std::string> catalog_text;
+    unsigned long long catalog_version = 0;
+    if (!file_cache.ReadText(catalog_path, catalog_text, catalog_version)) {
         error_message = "action catalog file not found: " + catalog_path.string();
         return false;
     }
 
+    // Compiled actions embed cwd probes relative to this repo root, and config provider
+    // paths may render {appId}.
+    const std::string derived_kind = "action_catalog:" + repo_root.string() + ":" + app_id;
+    const std::shared_ptr<const ActionCatalog> cached_catalog =
+        std::static_pointer_cast<const ActionCatalog>(file_cache.FindDerived(catalog_path, derived_kind, catalog_version));
+    if (cached_catalog) {
+        catalog_out = cached_catalog;
+        return true;
+    }
+
     nlohmann::json root;
     try {
-        root = nlohmann::json::parse(catalog_text);
+        root = nlohmann::json::parse(*catalog_text);
     } catch (const std::exception&) {
         error_message = "action catalog is not valid JSON: " + catalog_path.string();
         return false;
@@ -39,7 +268,7 @@ bool LoadActionCatalog(
         return false;
     }
 
-    actions_out.clear();
+    const std::shared_ptr<ActionCatalog> catalog = std::make_shared<ActionCatalog>();
     const nlohmann::json& actions_json = root["actions"];
 
     std::size_t index;
@@ -52,11 +281,12 @@ bool LoadActionCatalog(
         if (!item.contains("name") || !item["name"].is_string()) {
             continue;
         }
-        if (!item.contains("cmd") || !item["cmd"].is_array()) {
+        ActionDefinition action;
+        action.native = item.contains("type") && item["type"].is_string() && item["type"].get<std::string>() == "native";
+        if (!action.native && (!item.contains("cmd") || !item["cmd"].is_array())) {
             continue;
         }
 
-        ActionDefinition action;
         action.name = item["name"].get<std::string>();
         if (action.name.empty()) {
             continue;
@@ -70,16 +300,23 @@ bool LoadActionCatalog(
         }
 
         action.command.clear();
-        const nlohmann::json& cmd = item["cmd"];
-        std::size_t cmd_index;
-        for (cmd_index = 0; cmd_index < cmd.size(); ++cmd_index) {
-            const nlohmann::json& token = cmd[cmd_index];
-            if (token.is_string()) {
-                action.command.push_back(token.get<std::string>());
+        action.native_isolated = false;
+        if (action.native) {
+            if (!ParseNativeActionTarget(item, repo_root, path_args, action)) {
+                continue;
+            }
+        } else {
+            const nlohmann::json& cmd = item["cmd"];
+            std::size_t cmd_index;
+            for (cmd_index = 0; cmd_index < cmd.size(); ++cmd_index) {
+                const nlohmann::json& token = cmd[cmd_index];
+                if (token.is_string()) {
+                    action.command.push_back(token.get<std::string>());
+                }
+            }
+            if (action.command.empty()) {
+                continue;
             }
-        }
-        if (action.command.empty()) {
-            continue;
         }
 
         action.cwd.clear();
@@ -96,24 +333,65 @@ bool LoadActionCatalog(
         }
 
         action.detached = false;
-        if (item.contains("detached") && item["detached"].is_boolean()) {
+        if (!action.native && item.contains("detached") && item["detached"].is_boolean()) {
             action.detached = item["detached"].get<bool>();
         }
 
+        action.python_worker = false;
+        if (!action.native && item.contains("runner") && item["runner"].is_string()) {
+            action.python_worker = item["runner"].get<std::string>() == "python-worker";
+        }
+
+        action.cacheable = false;
+        action.cache_ttl_seconds = kDefaultCacheTtlSeconds;
+        if (item.contains("cacheable") && item["cacheable"].is_boolean()) {
+            action.cacheable = item["cacheable"].get<bool>() && !action.detached;
+        }
+        if (item.contains("cacheTtlSeconds") && item["cacheTtlSeconds"].is_number()) {
+            action.cache_ttl_seconds = std::max(0.0, item["cacheTtlSeconds"].get<double>());
+        }
+
+        if (item.contains("dependsOn") && item["dependsOn"].is_array()) {
+            const nlohmann::json& depends_on = item["dependsOn"];
+            std::size_t depends_index;
+            for (depends_index = 0; depends_index < depends_on.size(); ++depends_index) {
+                if (!depends_on[depends_index].is_string() || depends_on[depends_index].get<std::string>().empty()) {
+                    continue;
+                }
+                fs::path dependency = Common::RenderTemplatePath(depends_on[depends_index].get<std::string>(), path_args);
+                if (dependency.is_relative()) {
+                    dependency = repo_root / dependency;
+                }
+                action.depends_on.push_back(dependency);
+            }
+        }
+
         if (item.contains("args") && item["args"].is_array()) {
             action.args_json = item["args"].dump();
         } else {
             action.args_json = "[]";
         }
 
-        actions_out.push_back(action);
+        CompileActionDefinition(repo_root, action);
+        catalog->action_index.insert(std::make_pair(action.name, catalog->actions.size()));
+        catalog->actions.push_back(action);
+    }
+
+    if (root.contains("configProvider")) {
+        const std::shared_ptr<ConfigProviderSpec> provider = std::make_shared<ConfigProviderSpec>();
+        if (ParseConfigProviderSpec(root["configProvider"], repo_root, app_id, *provider, catalog->config_provider_error)) {
+            catalog->config_provider = provider;
+        }
     }
 
-    if (actions_out.empty()) {
+    if (catalog->actions.empty() && !catalog->config_provider) {
         error_message = "action catalog has no runnable actions: " + catalog_path.string();
         return false;
     }
 
+    file_cache.StoreDerived(
+        catalog_path, derived_kind, catalog_version, catalog, catalog_text->size() * kCompiledCatalogBytesPerTextByte);
+    catalog_out = catalog;
     return true;
 }
 
@@ -1,15 +1,24 @@
 #ifndef PROCESS_INTERFACE_COMMON_ACTION_CATALOG_H
 #define PROCESS_INTERFACE_COMMON_ACTION_CATALOG_H
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../../common/fs_compat.h"
 #include "../../common/path_templates.h"
+#include "config_provider.h"
 
 namespace ProcessInterface {
 namespace Common {
 
+// One piece of a command token: literal text, or the trimmed name of a {placeholder}.
+struct CommandSegment {
+    bool placeholder;
+    std::string text;
+};
+
 struct ActionDefinition {
     std::string name;
     std::string label;
@@ -18,13 +27,55 @@ struct ActionDefinition {
     double timeout_seconds;
     bool detached;
     std::string args_json;
+    // "runner": "python-worker" on a python command; runs in a warm interpreter when one is free.
+    bool python_worker;
+    // "dependsOn": files the action's output is derived from; lets config.get reuse a
+    // config_show response until one of them changes.
+    std::vector<fs::path> depends_on;
+    // "cacheable": identical invocations (same rendered args) share one run, and a
+    // succeeded result is reused for cache_ttl_seconds ("cacheTtlSeconds"; 0 = share only).
+    bool cacheable;
+    double cache_ttl_seconds;
+    // "type": "native": calls "symbol" from the shared library "library" through the C ABI in
+    // platform/native_action_abi.h instead of running cmd. "isolation": "fork" runs it in a
+    // forked child so a crash fails only the job.
+    bool native;
+    fs::path native_library;
+    std::string native_symbol;
+    bool native_isolated;
+
+    // Compiled at load time from command and cwd.
+    std::vector<std::vector<CommandSegment> > command_template;
+    // Distinct placeholder names in first-use order.
+    std::vector<std::string> required_args;
+    fs::path resolved_cwd;
+    // The script token depends on args, so the python script lookup runs per invocation.
+    bool script_fallback_at_run;
 };
 
+// Compiled once per catalog file version and shared read-only between requests and jobs.
+struct ActionCatalog {
+    // Catalog order, as listed by action.list.
+    std::vector<ActionDefinition> actions;
+    // First definition wins when names repeat.
+    std::unordered_map<std::string, std::size_t> action_index;
+    // Set when the catalog declares "configProvider"; config.get/config.set then skip the
+    // config_show/config_set_key actions. A malformed block is kept as config_provider_error.
+    std::shared_ptr<const ConfigProviderSpec> config_provider;
+    std::string config_provider_error;
+
+    const ActionDefinition* Find(const std::string& action_name) const;
+};
+
+// Rewrites an extensionless script argument of a python command to the first existing
+// <entry>.py in cwd, cwd/ops/scripts or cwd/scripts.
+void ApplyPythonScriptFallback(std::vector<std::string>& command_parts, const fs::path& cwd);
+
 bool LoadActionCatalog(
     const fs::path& repo_root,
     const Common::PathTemplateSet& path_templates,
     const std::string& app_id,
-    std::vector<ActionDefinition>& actions_out,
+    std::shared_ptr<const ActionCatalog>& catalog_out,
     std::string& error_message);
 
 }  // namespace Common
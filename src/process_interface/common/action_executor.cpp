@@ -1,17 +1,22 @@
 #include "action_executor.h"
 
-#include <regex>
+#include <functional>
 #include <sstream>
 
 #include "../../../external/nlohmann/json.hpp"
-#include "../../common/text.h"
+#include "../../platform/native_action.h"
 #include "../../platform/process_exec.h"
+#include "../../platform/process_probe.h"
 
 namespace ProcessInterface {
 namespace Common {
 
 namespace {
 
+const int kActionKillGraceMs = 5000;
+// Result payloads are the first JSON object in the output; scan at most this much of it.
+const std::size_t kPayloadScanBytes = 1024 * 1024;
+
 bool TryExtractFirstJsonObject(const std::string& text, std::string& object_json_out) {
     std::size_t start = 0;
     while (start < text.size() && text[start] != '{') {
@@ -73,147 +78,46 @@ std::string CompactObjectJson(const std::string& raw_json) {
     return std::string("{}");
 }
 
-fs::path ResolveActionCwd(const fs::path& repo_root, const ActionDefinition& action) {
-    if (action.cwd.empty()) {
-        return repo_root;
-    }
-
-    if (action.cwd.size() >= 2 && action.cwd[0] == '\\' && action.cwd[1] == '\\') {
-        return repo_root;
-    }
-
-    const fs::path configured(action.cwd);
-    if (configured.is_absolute()) {
-        if (fs::exists(configured)) {
-            return configured;
-        }
-        return repo_root;
-    }
-
-    const fs::path combined = repo_root / configured;
-    if (fs::exists(combined)) {
-        return combined;
-    }
-    return repo_root;
-}
-
 bool RenderCommand(
     const ActionDefinition& action,
     const std::map<std::string, std::string>& args_map,
     std::vector<std::string>& command_out,
     std::string& missing_arg_name) {
-    command_out.clear();
-    command_out.reserve(action.command.size());
-
-    static const std::regex token_pattern("\\{([^{}]+)\\}");
-
     std::size_t index;
-    for (index = 0; index < action.command.size(); ++index) {
-        const std::string& token = action.command[index];
-
-        std::string rendered;
-        std::string remaining = token;
-        std::smatch match;
-
-        while (std::regex_search(remaining, match, token_pattern)) {
-            rendered.append(remaining.substr(0, static_cast<std::size_t>(match.position(0))));
-
-            const std::string token_name = TrimCopy(match[1].str());
-            const std::map<std::string, std::string>::const_iterator iter = args_map.find(token_name);
-            if (iter == args_map.end()) {
-                missing_arg_name = token_name;
-                return false;
-            }
-            rendered.append(iter->second);
-
-            remaining = match.suffix().str();
+    for (index = 0; index < action.required_args.size(); ++index) {
+        if (args_map.find(action.required_args[index]) == args_map.end()) {
+            missing_arg_name = action.required_args[index];
+            return false;
         }
-
-        rendered.append(remaining);
-        command_out.push_back(rendered);
     }
 
-    return true;
-}
-
-bool IsPythonToken(const std::string& token) {
-    const std::string lowered = TrimCopy(token);
-    if (lowered.empty()) {
-        return false;
-    }
+    command_out.clear();
+    command_out.reserve(action.command_template.size());
+    for (index = 0; index < action.command_template.size(); ++index) {
+        const std::vector<CommandSegment>& segments = action.command_template[index];
 
-    std::string text;
-    text.reserve(lowered.size());
-    std::size_t index;
-    for (index = 0; index < lowered.size(); ++index) {
-        const char c = lowered[index];
-        if (c >= 'A' && c <= 'Z') {
-            text.push_back(static_cast<char>(c - 'A' + 'a'));
-        } else {
-            text.push_back(c);
+        std::string rendered;
+        std::size_t segment_index;
+        for (segment_index = 0; segment_index < segments.size(); ++segment_index) {
+            const CommandSegment& segment = segments[segment_index];
+            rendered.append(segment.placeholder ? args_map.find(segment.text)->second : segment.text);
         }
+        command_out.push_back(rendered);
     }
 
-    if (text == "python" || text == "python.exe") {
-        return true;
-    }
-
-    const std::size_t pos = text.find("python");
-    return pos != std::string::npos;
-}
-
-void ApplyPythonScriptFallback(std::vector<std::string>& command_parts, const fs::path& cwd) {
-    if (command_parts.size() < 2) {
-        return;
-    }
-    if (!IsPythonToken(command_parts[0])) {
-        return;
-    }
-
-    const std::string entry = TrimCopy(command_parts[1]);
-    if (entry.empty() || entry[0] == '-') {
-        return;
-    }
-
-    const fs::path raw_entry(entry);
-    if (raw_entry.has_extension()) {
-        return;
-    }
-    if (entry.find('/') != std::string::npos || entry.find('\\') != std::string::npos) {
-        return;
-    }
-
-    const fs::path direct = cwd / raw_entry;
-    if (fs::exists(direct)) {
-        return;
-    }
-
-    const fs::path direct_py = cwd / (entry + ".py");
-    if (fs::exists(direct_py)) {
-        command_parts[1] = direct_py.string();
-        return;
-    }
-
-    const fs::path ops_py = cwd / "ops" / "scripts" / (entry + ".py");
-    if (fs::exists(ops_py)) {
-        command_parts[1] = ops_py.string();
-        return;
-    }
-
-    const fs::path scripts_py = cwd / "scripts" / (entry + ".py");
-    if (fs::exists(scripts_py)) {
-        command_parts[1] = scripts_py.string();
-    }
+    return true;
 }
 
 }  // namespace
 
 bool ExecuteCatalogAction(
-    const fs::path& repo_root,
-    const std::vector<ActionDefinition>& actions,
+    const ActionCatalog& catalog,
+    Platform::PythonWorkerPool* python_workers,
     const std::string& action_name,
     const std::map<std::string, std::string>& args_map,
     double timeout_override_seconds,
+    const std::atomic<bool>* cancel_requested,
+    ActionJobOutput* output_capture,
     ActionRunResult& result_out,
     std::string& error_message) {
     ActionRunResult result;
@@ -222,21 +126,15 @@ bool ExecuteCatalogAction(
     result.detached = false;
     result.pid = 0;
     result.timed_out = false;
+    result.canceled = false;
     result.payload_json = "{}";
     result.stdout_text.clear();
     result.stderr_text.clear();
     result.error_code.clear();
     result.error_message.clear();
+    result.payload_scan_error.clear();
 
-    const ActionDefinition* selected = NULL;
-    std::size_t index;
-    for (index = 0; index < actions.size(); ++index) {
-        if (actions[index].name == action_name) {
-            selected = &actions[index];
-            break;
-        }
-    }
-
+    const ActionDefinition* selected = catalog.Find(action_name);
     if (selected == NULL) {
         result.error_code = "unknown_action";
         result.error_message = "unknown action: " + action_name;
@@ -253,21 +151,68 @@ bool ExecuteCatalogAction(
         return true;
     }
 
-    const fs::path action_cwd = ResolveActionCwd(repo_root, *selected);
-    ApplyPythonScriptFallback(rendered_command, action_cwd);
+    const fs::path& action_cwd = selected->resolved_cwd;
+    if (selected->script_fallback_at_run) {
+        ApplyPythonScriptFallback(rendered_command, action_cwd);
+    }
     const double timeout_seconds = timeout_override_seconds > 0.0 ? timeout_override_seconds : selected->timeout_seconds;
     const int timeout_ms = timeout_seconds > 0.0
         ? static_cast<int>(timeout_seconds * 1000.0)
         : 30000;
 
-    Platform::ProcessRunOptions run_options;
-    run_options.command = rendered_command;
-    run_options.cwd = action_cwd;
-    run_options.detached = selected->detached;
-    run_options.timeout_ms = timeout_ms;
+    std::function<void(const char*, std::size_t)> output_sink;
+    if (output_capture != NULL) {
+        output_sink = [output_capture](const char* data, std::size_t size) {
+            output_capture->Append(data, size);
+        };
+    }
 
     Platform::ProcessRunResult process_result;
-    if (!Platform::RunProcess(run_options, process_result)) {
+    bool launched = false;
+    std::string native_result_json;
+    if (selected->native) {
+        Platform::NativeActionRunOptions native_options;
+        native_options.library_path = selected->native_library;
+        native_options.symbol = selected->native_symbol;
+        native_options.args_json = nlohmann::json(args_map).dump();
+        native_options.cwd = action_cwd;
+        native_options.isolated = selected->native_isolated;
+        native_options.timeout_ms = timeout_ms;
+        native_options.kill_grace_ms = kActionKillGraceMs;
+        native_options.cancel_requested = cancel_requested;
+        native_options.output_sink = output_sink;
+        launched = Platform::RunNativeAction(native_options, process_result, native_result_json);
+    } else {
+        Platform::ProcessRunOptions run_options;
+        run_options.command = rendered_command;
+        run_options.cwd = action_cwd;
+        run_options.detached = selected->detached;
+        run_options.timeout_ms = timeout_ms;
+        run_options.kill_grace_ms = kActionKillGraceMs;
+        run_options.cancel_requested = cancel_requested;
+        run_options.output_sink = output_sink;
+
+        std::string worker_error;
+        if (selected->python_worker && python_workers != NULL &&
+            python_workers->Run(run_options, process_result, worker_error)) {
+            launched = process_result.launch_ok;
+        } else {
+            launched = Platform::RunProcess(run_options, process_result);
+        }
+    }
+    std::string payload_scan_text = process_result.stdout_text;
+    if (output_capture != NULL) {
+        output_capture->Close();
+        std::string read_error;
+        process_result.stdout_text = output_capture->Tail();
+        if (!output_capture->Read(0, kPayloadScanBytes, payload_scan_text, read_error)) {
+            // The head of a spilled stream is gone; scan what is still in memory instead.
+            payload_scan_text = process_result.stdout_text;
+            result.payload_scan_error = read_error;
+        }
+    }
+
+    if (!launched) {
         result.error_code = "action_launch_failed";
         result.error_message = process_result.error_message.empty() ? "action launch failed" : process_result.error_message;
         result_out = result;
@@ -279,8 +224,12 @@ bool ExecuteCatalogAction(
     result.stdout_text = process_result.stdout_text;
     result.stderr_text = process_result.stderr_text;
     result.timed_out = process_result.timed_out;
+    result.canceled = process_result.canceled;
 
     if (selected->detached) {
+        // Nothing waits on a detached process; the process table watches it instead.
+        Platform::TrackProcess(process_result.pid);
+
         nlohmann::json payload;
         payload["detached"] = true;
         payload["pid"] = process_result.pid > 0 ? nlohmann::json(process_result.pid) : nlohmann::json(nullptr);
@@ -301,10 +250,20 @@ bool ExecuteCatalogAction(
     result.rc = process_result.exit_code;
 
     std::string parsed_payload;
-    if (TryExtractFirstJsonObject(process_result.stdout_text, parsed_payload)) {
+    if (!native_result_json.empty()) {
+        result.payload_json = CompactObjectJson(native_result_json);
+    } else if (TryExtractFirstJsonObject(payload_scan_text, parsed_payload)) {
         result.payload_json = CompactObjectJson(parsed_payload);
     }
 
+    if (process_result.canceled) {
+        result.ok = false;
+        result.error_code = "action_canceled";
+        result.error_message = "action canceled";
+        result_out = result;
+        return true;
+    }
+
     if (process_result.timed_out) {
         result.ok = false;
         result.error_code = "action_timeout";
@@ -318,7 +277,7 @@ bool ExecuteCatalogAction(
     } else {
         result.ok = false;
         result.error_code = "action_failed";
-        result.error_message = "action failed";
+        result.error_message = process_result.error_message.empty() ? "action failed" : process_result.error_message;
     }
 
     result_out = result;
@@ -1,11 +1,14 @@
 #ifndef PROCESS_INTERFACE_COMMON_ACTION_EXECUTOR_H
 #define PROCESS_INTERFACE_COMMON_ACTION_EXECUTOR_H
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
 
+#include "../../platform/python_worker_pool.h"
 #include "action_catalog.h"
+#include "action_job_output.h"
 
 namespace ProcessInterface {
 namespace Common {
@@ -16,19 +19,25 @@ struct ActionRunResult {
     bool detached;
     int pid;
     bool timed_out;
+    bool canceled;
     std::string payload_json;
     std::string stdout_text;
     std::string stderr_text;
     std::string error_code;
     std::string error_message;
+    // Why the result payload scan did not see the start of the output; empty when it did.
+    std::string payload_scan_error;
 };
 
+// python_workers may be NULL; python-worker actions then spawn like any other action.
 bool ExecuteCatalogAction(
-    const fs::path& repo_root,
-    const std::vector<ActionDefinition>& actions,
+    const ActionCatalog& catalog,
+    Platform::PythonWorkerPool* python_workers,
     const std::string& action_name,
     const std::map<std::string, std::string>& args_map,
     double timeout_override_seconds,
+    const std::atomic<bool>* cancel_requested,
+    ActionJobOutput* output_capture,
     ActionRunResult& result_out,
     std::string& error_message);
 
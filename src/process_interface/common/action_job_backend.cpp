@@ -0,0 +1,120 @@
+#include "action_job_backend.h"
+
+#include <cstdint>
+#include <system_error>
+
+namespace ProcessInterface {
+namespace Common {
+
+namespace {
+
+const char kJobIdProbe[] = "\x01";
+
+unsigned long long FileSizeOrZero(const fs::path& path) {
+    std::error_code error;
+    const std::uintmax_t size = fs::file_size(path, error);
+    return error ? 0 : static_cast<unsigned long long>(size);
+}
+
+// Splits the rendered job path into directory and file name around the {jobId} token.
+bool ResolveJobFilePattern(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    fs::path& directory_out,
+    std::string& prefix_out,
+    std::string& suffix_out) {
+    const fs::path probe = ResolveActionJobPath(repo_root, path_templates, app_id, kJobIdProbe);
+    const std::string file_name = probe.filename().string();
+    const std::string::size_type token = file_name.find(kJobIdProbe);
+    if (token == std::string::npos || probe.parent_path().string().find(kJobIdProbe) != std::string::npos) {
+        return false;
+    }
+    directory_out = probe.parent_path();
+    prefix_out = file_name.substr(0, token);
+    suffix_out = file_name.substr(token + 1);
+    return true;
+}
+
+// Legacy layout: one atomically replaced JSON file per job.
+class FileActionJobBackend : public ActionJobBackend {
+public:
+    FileActionJobBackend(const fs::path& repo_root, const Common::PathTemplateSet& path_templates)
+        : repo_root_(repo_root),
+          path_templates_(path_templates) {}
+
+    virtual bool Write(
+        const std::string& app_id,
+        const ActionJobRecord& record,
+        unsigned long long& bytes_out,
+        std::string& error_message) {
+        if (!WriteActionJobRecord(repo_root_, path_templates_, app_id, record, error_message)) {
+            return false;
+        }
+        bytes_out = FileSizeOrZero(ResolveActionJobPath(repo_root_, path_templates_, app_id, record.job_id));
+        return true;
+    }
+
+    virtual bool Read(
+        const std::string& app_id,
+        const std::string& job_id,
+        ActionJobRecord& record_out,
+        std::string& error_message) {
+        return ReadActionJobRecord(repo_root_, path_templates_, app_id, job_id, record_out, error_message);
+    }
+
+    virtual void List(const std::string& app_id, std::map<std::string, unsigned long long>& jobs_out) {
+        jobs_out.clear();
+
+        fs::path directory;
+        std::string prefix;
+        std::string suffix;
+        if (!ResolveJobFilePattern(repo_root_, path_templates_, app_id, directory, prefix, suffix)) {
+            return;
+        }
+
+        std::error_code error;
+        fs::directory_iterator iter(directory, error);
+        const fs::directory_iterator end;
+        for (; !error && iter != end; iter.increment(error)) {
+            const std::string file_name = iter->path().filename().string();
+            if (file_name.size() <= prefix.size() + suffix.size() ||
+                file_name.compare(0, prefix.size(), prefix) != 0 ||
+                file_name.compare(file_name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                continue;
+            }
+
+            const std::string job_id = file_name.substr(prefix.size(), file_name.size() - prefix.size() - suffix.size());
+            jobs_out[job_id] = FileSizeOrZero(iter->path());
+        }
+    }
+
+    virtual void Remove(const std::string& app_id, const std::vector<std::string>& job_ids) {
+        std::size_t index;
+        for (index = 0; index < job_ids.size(); ++index) {
+            std::error_code error;
+            fs::remove(ResolveActionJobPath(repo_root_, path_templates_, app_id, job_ids[index]), error);
+        }
+    }
+
+    virtual void Maintain() {}
+
+    virtual bool WantsMaintenance() {
+        return false;
+    }
+
+private:
+    fs::path repo_root_;
+    Common::PathTemplateSet path_templates_;
+};
+
+}  // namespace
+
+std::unique_ptr<ActionJobBackend> CreateFileActionJobBackend(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates) {
+    return std::unique_ptr<ActionJobBackend>(new FileActionJobBackend(repo_root, path_templates));
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
@@ -0,0 +1,52 @@
+#ifndef PROCESS_INTERFACE_COMMON_ACTION_JOB_BACKEND_H
+#define PROCESS_INTERFACE_COMMON_ACTION_JOB_BACKEND_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../common/fs_compat.h"
+#include "../../common/path_templates.h"
+#include "action_jobs.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+enum class ActionJobBackendKind {
+    kFiles,
+    kLog,
+};
+
+// Persistence behind ActionJobStore. Implementations synchronize internally.
+class ActionJobBackend {
+public:
+    virtual ~ActionJobBackend() {}
+
+    // bytes_out is the record's own storage cost, excluding spilled output.
+    virtual bool Write(
+        const std::string& app_id,
+        const ActionJobRecord& record,
+        unsigned long long& bytes_out,
+        std::string& error_message) = 0;
+    virtual bool Read(
+        const std::string& app_id,
+        const std::string& job_id,
+        ActionJobRecord& record_out,
+        std::string& error_message) = 0;
+    // Every stored job of the app, mapped to its record storage bytes.
+    virtual void List(const std::string& app_id, std::map<std::string, unsigned long long>& jobs_out) = 0;
+    virtual void Remove(const std::string& app_id, const std::vector<std::string>& job_ids) = 0;
+    // Housekeeping run from the store's background thread.
+    virtual void Maintain() = 0;
+    virtual bool WantsMaintenance() = 0;
+};
+
+std::unique_ptr<ActionJobBackend> CreateFileActionJobBackend(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates);
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_ACTION_JOB_BACKEND_H
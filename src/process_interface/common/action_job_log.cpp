@@ -0,0 +1,605 @@
+#include "action_job_log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../external/nlohmann/json.hpp"
+#include "../../platform/file_append.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+namespace {
+
+const unsigned long long kSegmentMaxBytes = 8ULL * 1024 * 1024;
+const unsigned long long kCompactionMinBytes = 1024 * 1024;
+const std::size_t kFrameHeaderBytes = 8;
+const unsigned int kFrameMaxPayloadBytes = 64U * 1024 * 1024;
+
+struct Crc32Table {
+    unsigned int values[256];
+
+    Crc32Table() {
+        unsigned int index;
+        for (index = 0; index < 256; ++index) {
+            unsigned int value = index;
+            int bit;
+            for (bit = 0; bit < 8; ++bit) {
+                value = (value & 1U) ? (0xEDB88320U ^ (value >> 1)) : (value >> 1);
+            }
+            values[index] = value;
+        }
+    }
+};
+
+unsigned int Crc32(const char* data, std::size_t size) {
+    static const Crc32Table table;
+
+    unsigned int crc = 0xFFFFFFFFU;
+    std::size_t index;
+    for (index = 0; index < size; ++index) {
+        crc = table.values[(crc ^ static_cast<unsigned char>(data[index])) & 0xFFU] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+void AppendU32(std::string& out, unsigned int value) {
+    out.push_back(static_cast<char>(value & 0xFFU));
+    out.push_back(static_cast<char>((value >> 8) & 0xFFU));
+    out.push_back(static_cast<char>((value >> 16) & 0xFFU));
+    out.push_back(static_cast<char>((value >> 24) & 0xFFU));
+}
+
+unsigned int ReadU32(const char* data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<unsigned int>(bytes[0]) |
+        (static_cast<unsigned int>(bytes[1]) << 8) |
+        (static_cast<unsigned int>(bytes[2]) << 16) |
+        (static_cast<unsigned int>(bytes[3]) << 24);
+}
+
+std::string BuildFrame(const std::string& payload) {
+    std::string frame;
+    frame.reserve(kFrameHeaderBytes + payload.size());
+    AppendU32(frame, static_cast<unsigned int>(payload.size()));
+    AppendU32(frame, Crc32(payload.data(), payload.size()));
+    frame += payload;
+    return frame;
+}
+
+std::string BuildTombstone(const std::string& job_id) {
+    nlohmann::json root;
+    root["jobId"] = job_id;
+    root["removed"] = true;
+    return root.dump();
+}
+
+fs::path SegmentPath(const fs::path& directory, unsigned int segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment-%06u.log", segment);
+    return directory / name;
+}
+
+bool ParseSegmentNumber(const std::string& file_name, unsigned int& segment_out) {
+    unsigned int segment = 0;
+    char tail = 0;
+    if (std::sscanf(file_name.c_str(), "segment-%u.lo%c", &segment, &tail) != 2 || tail != 'g' ||
+        file_name != SegmentPath(fs::path(), segment).filename().string()) {
+        return false;
+    }
+    segment_out = segment;
+    return true;
+}
+
+fs::path JournalDirectory(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id) {
+    return ResolveActionJobPath(repo_root, path_templates, app_id, "journal").parent_path() / "journal";
+}
+
+// Segment numbers in the directory, oldest first; empty when the directory does not exist.
+std::vector<unsigned int> ListSegments(const fs::path& directory) {
+    std::vector<unsigned int> segments;
+    std::error_code error;
+    fs::directory_iterator iter(directory, error);
+    const fs::directory_iterator end;
+    for (; !error && iter != end; iter.increment(error)) {
+        unsigned int segment = 0;
+        if (ParseSegmentNumber(iter->path().filename().string(), segment)) {
+            segments.push_back(segment);
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+// Calls visit(offset, length) for each intact frame and returns the offset just past the
+// last one; scanning stops at the first frame that is short or fails its CRC.
+std::size_t ScanFrames(
+    const std::string& contents,
+    const std::function<void(std::size_t, unsigned int)>& visit) {
+    std::size_t offset = 0;
+    while (offset + kFrameHeaderBytes <= contents.size()) {
+        const unsigned int length = ReadU32(contents.data() + offset);
+        const unsigned int crc = ReadU32(contents.data() + offset + 4);
+        if (length > kFrameMaxPayloadBytes ||
+            offset + kFrameHeaderBytes + length > contents.size() ||
+            Crc32(contents.data() + offset + kFrameHeaderBytes, length) != crc) {
+            break;
+        }
+        visit(offset, length);
+        offset += kFrameHeaderBytes + length;
+    }
+    return offset;
+}
+
+bool ReadWholeFile(const fs::path& path, std::string& contents_out) {
+    std::ifstream input(path.string().c_str(), std::ios::in | std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    contents_out.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    return true;
+}
+
+struct FrameLocation {
+    unsigned int segment;
+    unsigned long long offset;
+    unsigned int length;
+};
+
+unsigned long long FrameBytes(const FrameLocation& location) {
+    return kFrameHeaderBytes + location.length;
+}
+
+struct SegmentUsage {
+    unsigned long long bytes;
+    unsigned long long live_bytes;
+};
+
+struct AppLog {
+    fs::path directory;
+    std::map<unsigned int, SegmentUsage> segments;
+    unsigned int active_segment;
+    Platform::AppendOnlyFile active;
+    std::unordered_map<std::string, FrameLocation> index;
+};
+
+class LogActionJobBackend : public ActionJobBackend {
+public:
+    LogActionJobBackend(const fs::path& repo_root, const Common::PathTemplateSet& path_templates)
+        : repo_root_(repo_root),
+          path_templates_(path_templates) {}
+
+    virtual bool Write(
+        const std::string& app_id,
+        const ActionJobRecord& record,
+        unsigned long long& bytes_out,
+        std::string& error_message) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        AppLog* app = OpenAppLocked(app_id, error_message);
+        if (app == NULL) {
+            return false;
+        }
+
+        FrameLocation location;
+        if (!AppendLocked(*app, SerializeActionJobRecord(record), true, location, error_message)) {
+            return false;
+        }
+        IndexLocked(*app, record.job_id, location);
+        bytes_out = FrameBytes(location);
+        return true;
+    }
+
+    virtual bool Read(
+        const std::string& app_id,
+        const std::string& job_id,
+        ActionJobRecord& record_out,
+        std::string& error_message) {
+        std::string payload;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            AppLog* app = OpenAppLocked(app_id, error_message);
+            if (app == NULL) {
+                return false;
+            }
+
+            const std::unordered_map<std::string, FrameLocation>::const_iterator iter = app->index.find(job_id);
+            if (iter == app->index.end()) {
+                error_message = "job not found";
+                return false;
+            }
+            if (!ReadPayloadLocked(*app, iter->second, payload, error_message)) {
+                return false;
+            }
+        }
+        return ParseActionJobRecord(payload, record_out, error_message);
+    }
+
+    virtual void List(const std::string& app_id, std::map<std::string, unsigned long long>& jobs_out) {
+        jobs_out.clear();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string error_message;
+        AppLog* app = OpenAppLocked(app_id, error_message);
+        if (app == NULL) {
+            return;
+        }
+
+        std::unordered_map<std::string, FrameLocation>::const_iterator iter;
+        for (iter = app->index.begin(); iter != app->index.end(); ++iter) {
+            jobs_out[iter->first] = FrameBytes(iter->second);
+        }
+    }
+
+    virtual void Remove(const std::string& app_id, const std::vector<std::string>& job_ids) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string error_message;
+        AppLog* app = OpenAppLocked(app_id, error_message);
+        if (app == NULL) {
+            return;
+        }
+
+        bool appended = false;
+        std::size_t index;
+        for (index = 0; index < job_ids.size(); ++index) {
+            const std::unordered_map<std::string, FrameLocation>::iterator iter = app->index.find(job_ids[index]);
+            if (iter == app->index.end()) {
+                continue;
+            }
+
+            // Tombstones are dead on arrival; they only need to outlive the frames they shadow.
+            FrameLocation tombstone;
+            if (!AppendLocked(*app, BuildTombstone(job_ids[index]), false, tombstone, error_message)) {
+                break;
+            }
+            appended = true;
+            MarkDeadLocked(*app, iter->second);
+            app->index.erase(iter);
+        }
+
+        if (appended) {
+            app->active.Sync(error_message);
+        }
+    }
+
+    virtual void Maintain() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, std::unique_ptr<AppLog> >::iterator iter;
+        for (iter = apps_.begin(); iter != apps_.end(); ++iter) {
+            if (ShouldCompactLocked(*iter->second)) {
+                CompactLocked(*iter->second);
+            }
+        }
+    }
+
+    virtual bool WantsMaintenance() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, std::unique_ptr<AppLog> >::const_iterator iter;
+        for (iter = apps_.begin(); iter != apps_.end(); ++iter) {
+            if (ShouldCompactLocked(*iter->second)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    AppLog* OpenAppLocked(const std::string& app_id, std::string& error_message) {
+        const std::map<std::string, std::unique_ptr<AppLog> >::iterator found = apps_.find(app_id);
+        if (found != apps_.end()) {
+            return found->second.get();
+        }
+
+        std::unique_ptr<AppLog> app(new AppLog());
+        app->directory = JournalDirectory(repo_root_, path_templates_, app_id);
+        app->active_segment = 0;
+        if (!RecoverLocked(*app, error_message)) {
+            return NULL;
+        }
+
+        AppLog* raw = app.get();
+        apps_[app_id] = std::move(app);
+        return raw;
+    }
+
+    bool RecoverLocked(AppLog& app, std::string& error_message) {
+        std::error_code error;
+        fs::create_directories(app.directory, error);
+
+        const std::vector<unsigned int> segments = ListSegments(app.directory);
+
+        std::size_t position;
+        for (position = 0; position < segments.size(); ++position) {
+            const unsigned int segment = segments[position];
+            const fs::path path = SegmentPath(app.directory, segment);
+            std::string contents;
+            if (!ReadWholeFile(path, contents)) {
+                error_message = "failed to read job log segment: " + path.string();
+                return false;
+            }
+
+            SegmentUsage usage;
+            usage.bytes = 0;
+            usage.live_bytes = 0;
+            app.segments[segment] = usage;
+
+            const std::size_t offset = ScanFrames(contents, [&](std::size_t frame_offset, unsigned int length) {
+                FrameLocation location;
+                location.segment = segment;
+                location.offset = frame_offset;
+                location.length = length;
+                app.segments[segment].bytes += FrameBytes(location);
+                ReplayFrameLocked(app, contents.substr(frame_offset + kFrameHeaderBytes, length), location);
+            });
+
+            if (offset < contents.size()) {
+                if (position + 1 == segments.size()) {
+                    // Torn append from a crash; later appends must start on a frame boundary.
+                    fs::resize_file(path, offset, error);
+                } else {
+                    app.segments[segment].bytes += contents.size() - offset;
+                }
+            }
+        }
+
+        app.active_segment = segments.empty() ? 1 : segments.back();
+        if (!segments.empty() && app.segments[app.active_segment].bytes >= kSegmentMaxBytes) {
+            app.active_segment += 1;
+        }
+        if (app.segments.find(app.active_segment) == app.segments.end()) {
+            SegmentUsage usage;
+            usage.bytes = 0;
+            usage.live_bytes = 0;
+            app.segments[app.active_segment] = usage;
+        }
+        return app.active.Open(SegmentPath(app.directory, app.active_segment), error_message);
+    }
+
+    void ReplayFrameLocked(AppLog& app, const std::string& payload, const FrameLocation& location) {
+        nlohmann::json root;
+        try {
+            root = nlohmann::json::parse(payload);
+        } catch (const std::exception&) {
+            return;
+        }
+        if (!root.is_object() || !root.contains("jobId") || !root["jobId"].is_string()) {
+            return;
+        }
+
+        const std::string job_id = root["jobId"].get<std::string>();
+        if (root.value("removed", false)) {
+            const std::unordered_map<std::string, FrameLocation>::iterator iter = app.index.find(job_id);
+            if (iter != app.index.end()) {
+                MarkDeadLocked(app, iter->second);
+                app.index.erase(iter);
+            }
+            return;
+        }
+        IndexLocked(app, job_id, location);
+    }
+
+    void IndexLocked(AppLog& app, const std::string& job_id, const FrameLocation& location) {
+        const std::unordered_map<std::string, FrameLocation>::iterator iter = app.index.find(job_id);
+        if (iter != app.index.end()) {
+            MarkDeadLocked(app, iter->second);
+            iter->second = location;
+        } else {
+            app.index[job_id] = location;
+        }
+        app.segments[location.segment].live_bytes += FrameBytes(location);
+    }
+
+    void MarkDeadLocked(AppLog& app, const FrameLocation& location) {
+        const std::map<unsigned int, SegmentUsage>::iterator iter = app.segments.find(location.segment);
+        if (iter != app.segments.end()) {
+            iter->second.live_bytes -= FrameBytes(location);
+        }
+    }
+
+    bool AppendLocked(
+        AppLog& app,
+        const std::string& payload,
+        bool durable,
+        FrameLocation& location_out,
+        std::string& error_message) {
+        const std::string frame = BuildFrame(payload);
+        if (app.active.Size() > 0 && app.active.Size() + frame.size() > kSegmentMaxBytes) {
+            if (!app.active.Sync(error_message)) {
+                return false;
+            }
+            app.active.Close();
+            app.active_segment += 1;
+            SegmentUsage usage;
+            usage.bytes = 0;
+            usage.live_bytes = 0;
+            app.segments[app.active_segment] = usage;
+            if (!app.active.Open(SegmentPath(app.directory, app.active_segment), error_message)) {
+                return false;
+            }
+        }
+
+        location_out.segment = app.active_segment;
+        location_out.offset = app.active.Size();
+        location_out.length = static_cast<unsigned int>(payload.size());
+        if (!app.active.Append(frame, durable, error_message)) {
+            return false;
+        }
+        app.segments[app.active_segment].bytes += frame.size();
+        return true;
+    }
+
+    bool ReadPayloadLocked(
+        const AppLog& app,
+        const FrameLocation& location,
+        std::string& payload_out,
+        std::string& error_message) {
+        const fs::path path = SegmentPath(app.directory, location.segment);
+        std::ifstream input(path.string().c_str(), std::ios::in | std::ios::binary);
+        if (!input.is_open()) {
+            error_message = "failed to open job log segment: " + path.string();
+            return false;
+        }
+
+        payload_out.resize(location.length);
+        input.seekg(static_cast<std::streamoff>(location.offset + kFrameHeaderBytes));
+        if (location.length > 0 && !input.read(&payload_out[0], static_cast<std::streamsize>(location.length))) {
+            error_message = "failed to read job log segment: " + path.string();
+            return false;
+        }
+        return true;
+    }
+
+    bool ShouldCompactLocked(const AppLog& app) const {
+        unsigned long long total_bytes = 0;
+        unsigned long long live_bytes = 0;
+        std::map<unsigned int, SegmentUsage>::const_iterator iter;
+        for (iter = app.segments.begin(); iter != app.segments.end(); ++iter) {
+            total_bytes += iter->second.bytes;
+            live_bytes += iter->second.live_bytes;
+        }
+        return total_bytes >= kCompactionMinBytes && live_bytes * 2 < total_bytes;
+    }
+
+    // Copies live frames into a fresh segment, then drops every older segment. A crash
+    // before the old segments are removed replays duplicates of identical records.
+    void CompactLocked(AppLog& app) {
+        std::string error_message;
+        const unsigned int target_segment = app.active_segment + 1;
+        const fs::path target_path = SegmentPath(app.directory, target_segment);
+
+        Platform::AppendOnlyFile target;
+        if (!target.Open(target_path, error_message)) {
+            return;
+        }
+
+        std::unordered_map<std::string, FrameLocation> compacted;
+        bool ok = true;
+        std::unordered_map<std::string, FrameLocation>::const_iterator iter;
+        for (iter = app.index.begin(); ok && iter != app.index.end(); ++iter) {
+            std::string payload;
+            FrameLocation location;
+            location.segment = target_segment;
+            location.offset = target.Size();
+            location.length = iter->second.length;
+            ok = ReadPayloadLocked(app, iter->second, payload, error_message) &&
+                target.Append(BuildFrame(payload), false, error_message);
+            compacted[iter->first] = location;
+        }
+        ok = ok && target.Sync(error_message);
+        const unsigned long long target_bytes = target.Size();
+        target.Close();
+
+        std::error_code error;
+        if (!ok) {
+            fs::remove(target_path, error);
+            return;
+        }
+
+        app.active.Close();
+        std::map<unsigned int, SegmentUsage>::const_iterator segment;
+        for (segment = app.segments.begin(); segment != app.segments.end(); ++segment) {
+            fs::remove(SegmentPath(app.directory, segment->first), error);
+        }
+
+        SegmentUsage usage;
+        usage.bytes = target_bytes;
+        usage.live_bytes = target_bytes;
+        app.segments.clear();
+        app.segments[target_segment] = usage;
+        app.index.swap(compacted);
+        app.active_segment = target_segment;
+        app.active.Open(target_path, error_message);
+    }
+
+    fs::path repo_root_;
+    Common::PathTemplateSet path_templates_;
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<AppLog> > apps_;
+};
+
+}  // namespace
+
+std::unique_ptr<ActionJobBackend> CreateLogActionJobBackend(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates) {
+    return std::unique_ptr<ActionJobBackend>(new LogActionJobBackend(repo_root, path_templates));
+}
+
+bool ExportActionJobLog(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    std::size_t& exported_out,
+    std::string& error_message) {
+    exported_out = 0;
+    const fs::path directory = JournalDirectory(repo_root, path_templates, app_id);
+
+    // A host may be appending to or compacting the same journal, so this replay never
+    // truncates or creates anything: it stops at the first torn frame of each segment and
+    // starts over if compaction removes a segment mid-scan.
+    const int kMaxScanAttempts = 3;
+    std::map<std::string, std::string> payloads;
+    bool complete = false;
+    int attempt;
+    for (attempt = 0; attempt < kMaxScanAttempts && !complete; ++attempt) {
+        payloads.clear();
+        complete = true;
+        const std::vector<unsigned int> segments = ListSegments(directory);
+        std::size_t position;
+        for (position = 0; complete && position < segments.size(); ++position) {
+            std::string contents;
+            if (!ReadWholeFile(SegmentPath(directory, segments[position]), contents)) {
+                complete = false;
+                break;
+            }
+            ScanFrames(contents, [&](std::size_t frame_offset, unsigned int length) {
+                const std::string payload = contents.substr(frame_offset + kFrameHeaderBytes, length);
+                nlohmann::json root;
+                try {
+                    root = nlohmann::json::parse(payload);
+                } catch (const std::exception&) {
+                    return;
+                }
+                if (!root.is_object() || !root.contains("jobId") || !root["jobId"].is_string()) {
+                    return;
+                }
+                const std::string job_id = root["jobId"].get<std::string>();
+                if (root.value("removed", false)) {
+                    payloads.erase(job_id);
+                } else {
+                    payloads[job_id] = payload;
+                }
+            });
+        }
+    }
+    if (!complete) {
+        error_message = "job log segments kept changing during export: " + directory.string();
+        return false;
+    }
+
+    std::map<std::string, std::string>::const_iterator iter;
+    for (iter = payloads.begin(); iter != payloads.end(); ++iter) {
+        ActionJobRecord record;
+        if (!ParseActionJobRecord(iter->second, record, error_message) ||
+            !WriteActionJobRecord(repo_root, path_templates, app_id, record, error_message)) {
+            error_message = "failed to export job " + iter->first + ": " + error_message;
+            return false;
+        }
+        exported_out += 1;
+    }
+    return true;
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
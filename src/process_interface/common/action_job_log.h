@@ -0,0 +1,36 @@
+#ifndef PROCESS_INTERFACE_COMMON_ACTION_JOB_LOG_H
+#define PROCESS_INTERFACE_COMMON_ACTION_JOB_LOG_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "../../common/fs_compat.h"
+#include "../../common/path_templates.h"
+#include "action_job_backend.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+// Log-structured job store: per-app append-only segments under <job dir>/journal/.
+// Each frame is a 4-byte little-endian payload length, a 4-byte CRC-32 of the payload,
+// then the record JSON (or a {"jobId":..,"removed":true} tombstone). Segments are
+// replayed on first use, a torn tail in the newest segment is truncated, and
+// segments are compacted once superseded frames outweigh live ones.
+std::unique_ptr<ActionJobBackend> CreateLogActionJobBackend(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates);
+
+// Writes the latest record of every logged job in the legacy per-job JSON layout. Reads
+// the journal without modifying it, so it is safe while a host is using the same log.
+bool ExportActionJobLog(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    std::size_t& exported_out,
+    std::string& error_message);
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_ACTION_JOB_LOG_H
@@ -0,0 +1,280 @@
+#include "action_job_output.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+namespace ProcessInterface {
+namespace Common {
+
+namespace {
+
+// fseek takes a long, which is 32-bit on Windows; spill files can grow past 2 GiB.
+bool SeekFile(FILE* file, unsigned long long offset) {
+#ifdef _WIN32
+    if (offset > static_cast<unsigned long long>(std::numeric_limits<__int64>::max())) {
+        return false;
+    }
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    if (offset > static_cast<unsigned long long>(std::numeric_limits<off_t>::max())) {
+        return false;
+    }
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+bool ReadFileRange(
+    FILE* file,
+    unsigned long long offset,
+    std::size_t size,
+    std::string& data_out) {
+    if (!SeekFile(file, offset)) {
+        return false;
+    }
+
+    data_out.resize(size);
+    const std::size_t got = size > 0 ? std::fread(&data_out[0], 1, size, file) : 0;
+    data_out.resize(got);
+    return got == size;
+}
+
+}  // namespace
+
+ActionJobOutput::ActionJobOutput(const fs::path& spill_path, std::size_t ring_capacity)
+    : spill_path_(spill_path),
+      ring_(ring_capacity > 0 ? ring_capacity : 1),
+      ring_head_(0),
+      ring_used_(0),
+      total_bytes_(0),
+      spilled_(false),
+      spill_failed_(false),
+      spill_file_(NULL) {}
+
+ActionJobOutput::~ActionJobOutput() {
+    Close();
+}
+
+void ActionJobOutput::SetChunkListener(const ChunkListener& listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = listener;
+}
+
+void ActionJobOutput::Append(const char* data, std::size_t size) {
+    if (data == NULL || size == 0) {
+        return;
+    }
+
+    unsigned long long chunk_offset = 0;
+    ChunkListener listener;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!spilled_ && !spill_failed_ && total_bytes_ + size > ring_.size()) {
+            StartSpillLocked();
+        }
+
+        if (spill_file_ != NULL) {
+            if (std::fwrite(data, 1, size, spill_file_) != size || std::fflush(spill_file_) != 0) {
+                spill_failed_ = true;
+            }
+        }
+
+        WriteRingLocked(data, size);
+        chunk_offset = total_bytes_;
+        total_bytes_ += size;
+        listener = listener_;
+    }
+
+    if (listener) {
+        listener(chunk_offset, data, size);
+    }
+}
+
+void ActionJobOutput::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (spill_file_ != NULL) {
+        std::fclose(spill_file_);
+        spill_file_ = NULL;
+    }
+}
+
+unsigned long long ActionJobOutput::TotalBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_bytes_;
+}
+
+bool ActionJobOutput::Spilled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spilled_;
+}
+
+std::string ActionJobOutput::Tail() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string tail;
+    CopyRingLocked(0, ring_used_, tail);
+    return tail;
+}
+
+bool ActionJobOutput::Read(
+    unsigned long long offset,
+    std::size_t max_bytes,
+    std::string& data_out,
+    std::string& error_message) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_out.clear();
+    if (offset >= total_bytes_ || max_bytes == 0) {
+        return true;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(
+        std::min<unsigned long long>(max_bytes, total_bytes_ - offset));
+    const unsigned long long ring_start = total_bytes_ - ring_used_;
+    if (offset >= ring_start) {
+        CopyRingLocked(static_cast<std::size_t>(offset - ring_start), size, data_out);
+        return true;
+    }
+
+    if (!spilled_ || spill_failed_) {
+        error_message = "output before offset " + std::to_string(ring_start) + " is no longer available";
+        return false;
+    }
+
+    FILE* file = std::fopen(spill_path_.string().c_str(), "rb");
+    if (file == NULL) {
+        error_message = "failed to open job output file: " + spill_path_.string();
+        return false;
+    }
+    const bool ok = ReadFileRange(file, offset, size, data_out);
+    std::fclose(file);
+    if (!ok) {
+        error_message = "failed to read job output file: " + spill_path_.string();
+        return false;
+    }
+    return true;
+}
+
+void ActionJobOutput::StartSpillLocked() {
+    std::error_code ec;
+    fs::create_directories(spill_path_.parent_path(), ec);
+
+    spill_file_ = std::fopen(spill_path_.string().c_str(), "wb");
+    if (spill_file_ == NULL) {
+        spill_failed_ = true;
+        return;
+    }
+
+    // The ring still holds the whole stream at this point, so the file starts at offset 0.
+    std::string existing;
+    CopyRingLocked(0, ring_used_, existing);
+    if (!existing.empty() && std::fwrite(existing.data(), 1, existing.size(), spill_file_) != existing.size()) {
+        spill_failed_ = true;
+    }
+    spilled_ = true;
+}
+
+void ActionJobOutput::WriteRingLocked(const char* data, std::size_t size) {
+    const std::size_t capacity = ring_.size();
+    if (size >= capacity) {
+        std::memcpy(&ring_[0], data + (size - capacity), capacity);
+        ring_head_ = 0;
+        ring_used_ = capacity;
+        return;
+    }
+
+    std::size_t write_index = (ring_head_ + ring_used_) % capacity;
+    const std::size_t first = std::min(size, capacity - write_index);
+    std::memcpy(&ring_[write_index], data, first);
+    if (first < size) {
+        std::memcpy(&ring_[0], data + first, size - first);
+    }
+
+    if (ring_used_ + size > capacity) {
+        ring_head_ = (ring_head_ + (ring_used_ + size - capacity)) % capacity;
+        ring_used_ = capacity;
+    } else {
+        ring_used_ += size;
+    }
+}
+
+void ActionJobOutput::CopyRingLocked(std::size_t ring_offset, std::size_t size, std::string& data_out) const {
+    data_out.clear();
+    if (ring_offset >= ring_used_) {
+        return;
+    }
+
+    const std::size_t capacity = ring_.size();
+    const std::size_t count = std::min(size, ring_used_ - ring_offset);
+    const std::size_t start = (ring_head_ + ring_offset) % capacity;
+    const std::size_t first = std::min(count, capacity - start);
+
+    data_out.reserve(count);
+    data_out.append(&ring_[start], first);
+    if (first < count) {
+        data_out.append(&ring_[0], count - first);
+    }
+}
+
+void ActionJobOutputRegistry::Register(const std::string& job_id, const std::shared_ptr<ActionJobOutput>& output) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    outputs_[job_id] = output;
+}
+
+void ActionJobOutputRegistry::Remove(const std::string& job_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    outputs_.erase(job_id);
+}
+
+std::shared_ptr<ActionJobOutput> ActionJobOutputRegistry::Find(const std::string& job_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::map<std::string, std::shared_ptr<ActionJobOutput> >::const_iterator iter = outputs_.find(job_id);
+    if (iter == outputs_.end()) {
+        return std::shared_ptr<ActionJobOutput>();
+    }
+    return iter->second;
+}
+
+bool ReadActionJobOutputFile(
+    const fs::path& spill_path,
+    unsigned long long offset,
+    std::size_t max_bytes,
+    std::string& data_out,
+    unsigned long long& total_bytes_out,
+    std::string& error_message) {
+    data_out.clear();
+
+    std::error_code ec;
+    const std::uintmax_t file_size = fs::file_size(spill_path, ec);
+    if (ec) {
+        error_message = "job output file not found: " + spill_path.string();
+        return false;
+    }
+
+    total_bytes_out = static_cast<unsigned long long>(file_size);
+    if (offset >= total_bytes_out || max_bytes == 0) {
+        return true;
+    }
+
+    FILE* file = std::fopen(spill_path.string().c_str(), "rb");
+    if (file == NULL) {
+        error_message = "failed to open job output file: " + spill_path.string();
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(
+        std::min<unsigned long long>(max_bytes, total_bytes_out - offset));
+    const bool ok = ReadFileRange(file, offset, size, data_out);
+    std::fclose(file);
+    if (!ok) {
+        error_message = "failed to read job output file: " + spill_path.string();
+        return false;
+    }
+    return true;
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
@@ -0,0 +1,87 @@
+#ifndef PROCESS_INTERFACE_COMMON_ACTION_JOB_OUTPUT_H
+#define PROCESS_INTERFACE_COMMON_ACTION_JOB_OUTPUT_H
+
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../../common/fs_compat.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+// Bounded capture of one job's combined output.
+// The most recent ring_capacity bytes stay in memory. Once the stream outgrows the ring,
+// the whole stream is written to an append-only spill file so older offsets stay readable.
+class ActionJobOutput {
+public:
+    typedef std::function<void(unsigned long long, const char*, std::size_t)> ChunkListener;
+
+    ActionJobOutput(const fs::path& spill_path, std::size_t ring_capacity);
+    ~ActionJobOutput();
+
+    ActionJobOutput(const ActionJobOutput&) = delete;
+    ActionJobOutput& operator=(const ActionJobOutput&) = delete;
+
+    // Called outside the capture lock with the absolute offset of each appended chunk.
+    void SetChunkListener(const ChunkListener& listener);
+
+    void Append(const char* data, std::size_t size);
+    void Close();
+
+    unsigned long long TotalBytes() const;
+    bool Spilled() const;
+    std::string Tail() const;
+    bool Read(
+        unsigned long long offset,
+        std::size_t max_bytes,
+        std::string& data_out,
+        std::string& error_message) const;
+
+private:
+    void StartSpillLocked();
+    void WriteRingLocked(const char* data, std::size_t size);
+    void CopyRingLocked(std::size_t ring_offset, std::size_t size, std::string& data_out) const;
+
+    const fs::path spill_path_;
+    std::vector<char> ring_;
+    std::size_t ring_head_;
+    std::size_t ring_used_;
+    unsigned long long total_bytes_;
+    bool spilled_;
+    bool spill_failed_;
+    FILE* spill_file_;
+    ChunkListener listener_;
+    mutable std::mutex mutex_;
+};
+
+// Output captures of jobs that are still running, keyed by job id.
+class ActionJobOutputRegistry {
+public:
+    void Register(const std::string& job_id, const std::shared_ptr<ActionJobOutput>& output);
+    void Remove(const std::string& job_id);
+    std::shared_ptr<ActionJobOutput> Find(const std::string& job_id) const;
+
+private:
+    std::map<std::string, std::shared_ptr<ActionJobOutput> > outputs_;
+    mutable std::mutex mutex_;
+};
+
+// Reads a finished job's spill file; total_bytes_out is the file size.
+bool ReadActionJobOutputFile(
+    const fs::path& spill_path,
+    unsigned long long offset,
+    std::size_t max_bytes,
+    std::string& data_out,
+    unsigned long long& total_bytes_out,
+    std::string& error_message);
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_ACTION_JOB_OUTPUT_H
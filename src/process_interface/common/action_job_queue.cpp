@@ -0,0 +1,142 @@
+#include "action_job_queue.h"
+
+#include <exception>
+
+namespace ProcessInterface {
+namespace Common {
+
+ActionJobQueue::ActionJobQueue(std::size_t worker_count)
+    : worker_count_(worker_count > 0 ? worker_count : 1),
+      stopping_(false) {}
+
+ActionJobQueue::~ActionJobQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        pending_.clear();
+
+        std::map<std::string, RunningJob>::iterator iter;
+        for (iter = running_.begin(); iter != running_.end(); ++iter) {
+            iter->second.control->cancel_requested.store(true);
+        }
+    }
+    wake_.notify_all();
+
+    std::size_t index;
+    for (index = 0; index < workers_.size(); ++index) {
+        if (workers_[index].joinable()) {
+            workers_[index].join();
+        }
+    }
+}
+
+bool ActionJobQueue::Submit(
+    const std::string& app_id,
+    const std::string& job_id,
+    const JobBody& body,
+    const FailureHandler& on_failure,
+    std::string& error_message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            error_message = "action job queue is stopping";
+            return false;
+        }
+
+        try {
+            EnsureWorkersLocked();
+        } catch (const std::exception& ex) {
+            error_message = std::string("failed to start action workers: ") + ex.what();
+            return false;
+        }
+
+        PendingJob job;
+        job.app_id = app_id;
+        job.job_id = job_id;
+        job.body = body;
+        job.on_failure = on_failure;
+        pending_.push_back(job);
+    }
+    wake_.notify_one();
+    return true;
+}
+
+ActionJobCancelOutcome ActionJobQueue::Cancel(
+    const std::string& app_id,
+    const std::string& job_id,
+    const std::string& requested_at) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::deque<PendingJob>::iterator pending_iter;
+    for (pending_iter = pending_.begin(); pending_iter != pending_.end(); ++pending_iter) {
+        if (pending_iter->job_id == job_id && pending_iter->app_id == app_id) {
+            pending_.erase(pending_iter);
+            return ActionJobCancelOutcome::kRemovedQueued;
+        }
+    }
+
+    const std::map<std::string, RunningJob>::iterator running_iter = running_.find(job_id);
+    if (running_iter == running_.end() || running_iter->second.app_id != app_id) {
+        return ActionJobCancelOutcome::kNotActive;
+    }
+
+    ActionJobControl& control = *running_iter->second.control;
+    if (!control.cancel_requested.load()) {
+        control.cancel_requested_at = requested_at;
+        control.cancel_requested.store(true);
+    }
+    return ActionJobCancelOutcome::kSignaledRunning;
+}
+
+void ActionJobQueue::EnsureWorkersLocked() {
+    while (workers_.size() < worker_count_) {
+        workers_.push_back(std::thread(&ActionJobQueue::WorkerLoop, this));
+    }
+}
+
+void ActionJobQueue::WorkerLoop() {
+    while (true) {
+        PendingJob job;
+        std::shared_ptr<ActionJobControl> control = std::make_shared<ActionJobControl>();
+        control->cancel_requested.store(false);
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+            if (stopping_) {
+                return;
+            }
+
+            job = pending_.front();
+            pending_.pop_front();
+
+            // Registered under the same lock as the pop so Cancel always finds the job somewhere.
+            RunningJob running;
+            running.app_id = job.app_id;
+            running.control = control;
+            running_[job.job_id] = running;
+        }
+
+        std::string failure;
+        try {
+            job.body(*control);
+        } catch (const std::exception& ex) {
+            failure = std::string("action job failed: ") + ex.what();
+        } catch (...) {
+            failure = "action job failed";
+        }
+        if (!failure.empty() && job.on_failure) {
+            try {
+                job.on_failure(failure);
+            } catch (...) {
+                // The handler is the last chance to end the job; the worker must survive it.
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.erase(job.job_id);
+    }
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
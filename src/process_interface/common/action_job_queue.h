@@ -0,0 +1,81 @@
+#ifndef PROCESS_INTERFACE_COMMON_ACTION_JOB_QUEUE_H
+#define PROCESS_INTERFACE_COMMON_ACTION_JOB_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ProcessInterface {
+namespace Common {
+
+// Cancellation state shared between the queue and the running job body.
+// cancel_requested_at is written before cancel_requested is set.
+struct ActionJobControl {
+    std::atomic<bool> cancel_requested;
+    std::string cancel_requested_at;
+};
+
+enum class ActionJobCancelOutcome {
+    kNotActive,
+    kRemovedQueued,
+    kSignaledRunning,
+};
+
+// Fixed-size worker pool that runs action jobs off the request thread.
+class ActionJobQueue {
+public:
+    typedef std::function<void(const ActionJobControl&)> JobBody;
+    // Called on the worker with a description when body throws, so the job still ends.
+    typedef std::function<void(const std::string&)> FailureHandler;
+
+    explicit ActionJobQueue(std::size_t worker_count);
+    ~ActionJobQueue();
+
+    ActionJobQueue(const ActionJobQueue&) = delete;
+    ActionJobQueue& operator=(const ActionJobQueue&) = delete;
+
+    bool Submit(
+        const std::string& app_id,
+        const std::string& job_id,
+        const JobBody& body,
+        const FailureHandler& on_failure,
+        std::string& error_message);
+    ActionJobCancelOutcome Cancel(const std::string& app_id, const std::string& job_id, const std::string& requested_at);
+
+private:
+    struct PendingJob {
+        std::string app_id;
+        std::string job_id;
+        JobBody body;
+        FailureHandler on_failure;
+    };
+
+    struct RunningJob {
+        std::string app_id;
+        std::shared_ptr<ActionJobControl> control;
+    };
+
+    void EnsureWorkersLocked();
+    void WorkerLoop();
+
+    std::size_t worker_count_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<PendingJob> pending_;
+    std::map<std::string, RunningJob> running_;
+    std::vector<std::thread> workers_;
+    bool stopping_;
+};
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_ACTION_JOB_QUEUE_H
@@ -0,0 +1,460 @@
+#include "action_job_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <system_error>
+#include <utility>
+
+#include "../../common/time_utils.h"
+#include "action_job_log.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+namespace {
+
+const std::size_t kJobRecordCacheEntries = 256;
+const int kPruneIntervalSeconds = 60;
+
+std::string MakeCacheKey(const std::string& app_id, const std::string& job_id) {
+    return app_id + '\n' + job_id;
+}
+
+// Job ids look like job-<epochMs>-<counter>; anything else sorts as oldest.
+long long ParseJobIdEpochMs(const std::string& job_id) {
+    if (job_id.compare(0, 4, "job-") != 0) {
+        return -1;
+    }
+    char* end = NULL;
+    const long long value = std::strtoll(job_id.c_str() + 4, &end, 10);
+    if (end == job_id.c_str() + 4 || *end != '-') {
+        return -1;
+    }
+    return value;
+}
+
+unsigned long long FileSizeOrZero(const fs::path& path) {
+    std::error_code error;
+    const std::uintmax_t size = fs::file_size(path, error);
+    return error ? 0 : static_cast<unsigned long long>(size);
+}
+
+// Falls back to the recorded acceptance time for ids not minted by GenerateJobId.
+long long AcceptedEpochMs(const ActionJobSummary& summary) {
+    long long epoch_ms = ParseJobIdEpochMs(summary.job_id);
+    if (epoch_ms < 0 && !ParseUtcIso8601(summary.accepted_at, epoch_ms)) {
+        epoch_ms = -1;
+    }
+    return epoch_ms;
+}
+
+// Cursors are "<acceptedEpochMs>:<jobId>" of the last job on the previous page.
+std::string FormatListCursor(long long epoch_ms, const std::string& job_id) {
+    return std::to_string(epoch_ms) + ":" + job_id;
+}
+
+bool ParseListCursor(const std::string& cursor, long long& epoch_ms_out, std::string& job_id_out) {
+    const std::string::size_type separator = cursor.find(':');
+    if (separator == std::string::npos || separator == 0 || separator + 1 >= cursor.size()) {
+        return false;
+    }
+    char* end = NULL;
+    const std::string epoch_text = cursor.substr(0, separator);
+    const long long epoch_ms = std::strtoll(epoch_text.c_str(), &end, 10);
+    if (*end != '\0') {
+        return false;
+    }
+    epoch_ms_out = epoch_ms;
+    job_id_out = cursor.substr(separator + 1);
+    return true;
+}
+
+unsigned long long SpilledOutputBytes(const ActionJobRecord& record) {
+    return record.stdout_truncated ? record.stdout_bytes : 0;
+}
+
+bool HasRetentionLimit(const ActionJobRetentionPolicy& policy) {
+    return policy.max_count > 0 || policy.max_age_seconds > 0 || policy.max_bytes > 0;
+}
+
+}  // namespace
+
+bool ActionJobStore::OrderKeyLess::operator()(const OrderKey& left, const OrderKey& right) const {
+    if (left.first != right.first) {
+        return left.first < right.first;
+    }
+    if (left.second.size() != right.second.size()) {
+        return left.second.size() < right.second.size();
+    }
+    return left.second < right.second;
+}
+
+ActionJobStoreOptions DefaultActionJobStoreOptions() {
+    ActionJobStoreOptions options;
+    options.backend = ActionJobBackendKind::kFiles;
+    options.default_retention.max_count = 0;
+    options.default_retention.max_age_seconds = 0;
+    options.default_retention.max_bytes = 0;
+    return options;
+}
+
+ActionJobStore::ActionJobStore(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const ActionJobStoreOptions& options)
+    : repo_root_(repo_root),
+      path_templates_(path_templates),
+      options_(options),
+      backend_(options.backend == ActionJobBackendKind::kLog
+          ? CreateLogActionJobBackend(repo_root, path_templates)
+          : CreateFileActionJobBackend(repo_root, path_templates)),
+      prune_requested_(false),
+      stopping_(false) {
+    try {
+        pruner_ = std::thread(&ActionJobStore::PrunerLoop, this);
+    } catch (const std::exception&) {
+        // Without the background thread jobs are still served; only pruning is skipped.
+    }
+}
+
+ActionJobStore::~ActionJobStore() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (pruner_.joinable()) {
+        pruner_.join();
+    }
+}
+
+bool ActionJobStore::Write(const std::string& app_id, const ActionJobRecord& record, std::string& error_message) {
+    unsigned long long bytes = 0;
+    if (!backend_->Write(app_id, record, bytes, error_message)) {
+        return false;
+    }
+    bytes += SpilledOutputBytes(record);
+    const bool wants_maintenance = backend_->WantsMaintenance();
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CachePutLocked(MakeCacheKey(app_id, record.job_id), record);
+        UpdateIndexLocked(app_id, record, bytes);
+        if (!prune_requested_ && (wants_maintenance || ExceedsRetentionLocked(app_id, indexes_[app_id]))) {
+            prune_requested_ = true;
+            wake = true;
+        }
+    }
+    if (wake) {
+        wake_.notify_one();
+    }
+    return true;
+}
+
+bool ActionJobStore::Read(
+    const std::string& app_id,
+    const std::string& job_id,
+    ActionJobRecord& record_out,
+    std::string& error_message) {
+    const std::string key = MakeCacheKey(app_id, job_id);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::unordered_map<std::string, CacheEntry>::iterator iter = cache_.find(key);
+        if (iter != cache_.end()) {
+            lru_.splice(lru_.begin(), lru_, iter->second.lru_position);
+            record_out = iter->second.record;
+            return true;
+        }
+    }
+
+    ActionJobRecord record;
+    if (!backend_->Read(app_id, job_id, record, error_message)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CachePutLocked(key, record);
+    }
+    record_out = record;
+    return true;
+}
+
+bool ActionJobStore::List(
+    const std::string& app_id,
+    const ActionJobListQuery& query,
+    std::vector<ActionJobSummary>& jobs_out,
+    std::string& next_cursor_out,
+    std::string& error_message) {
+    jobs_out.clear();
+    next_cursor_out.clear();
+
+    OrderKey cursor_key;
+    const bool has_cursor = !query.cursor.empty();
+    if (has_cursor && !ParseListCursor(query.cursor, cursor_key.first, cursor_key.second)) {
+        error_message = "bad cursor: not a cursor returned by action.job.list";
+        return false;
+    }
+
+    bool loaded = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::map<std::string, AppIndex>::const_iterator found = indexes_.find(app_id);
+        loaded = found != indexes_.end() && found->second.loaded;
+    }
+    if (!loaded) {
+        LoadAppIndex(app_id);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const AppIndex& index = indexes_[app_id];
+    std::set<OrderKey, OrderKeyLess>::const_iterator iter =
+        has_cursor ? index.order.lower_bound(cursor_key) : index.order.end();
+    while (iter != index.order.begin()) {
+        --iter;
+        if (query.until_epoch_ms >= 0 && iter->first >= query.until_epoch_ms) {
+            continue;
+        }
+        if (query.since_epoch_ms >= 0 && iter->first < query.since_epoch_ms) {
+            break;
+        }
+
+        const std::unordered_map<std::string, IndexEntry>::const_iterator entry = index.entries.find(iter->second);
+        const ActionJobSummary& summary = entry->second.summary;
+        if ((!query.action_name.empty() && summary.action_name != query.action_name) ||
+            (!query.state.empty() && summary.state != query.state)) {
+            continue;
+        }
+
+        // A further match exists, so the page ends on the previous job.
+        if (jobs_out.size() >= query.limit) {
+            const ActionJobSummary& last = jobs_out.back();
+            next_cursor_out = FormatListCursor(index.entries.find(last.job_id)->second.accepted_epoch_ms, last.job_id);
+            break;
+        }
+        jobs_out.push_back(summary);
+    }
+    return true;
+}
+
+std::size_t ActionJobStore::Prune() {
+    std::vector<std::string> app_ids;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, AppIndex>::const_iterator iter;
+        for (iter = indexes_.begin(); iter != indexes_.end(); ++iter) {
+            app_ids.push_back(iter->first);
+        }
+    }
+
+    std::size_t removed = 0;
+    std::size_t index;
+    for (index = 0; index < app_ids.size(); ++index) {
+        removed += PruneApp(app_ids[index]);
+    }
+    return removed;
+}
+
+ActionJobRetentionPolicy ActionJobStore::RetentionFor(const std::string& app_id) const {
+    const std::map<std::string, ActionJobRetentionPolicy>::const_iterator iter = options_.app_retention.find(app_id);
+    return iter != options_.app_retention.end() ? iter->second : options_.default_retention;
+}
+
+bool ActionJobStore::ExceedsRetentionLocked(const std::string& app_id, const AppIndex& index) const {
+    const ActionJobRetentionPolicy policy = RetentionFor(app_id);
+    return (policy.max_count > 0 && index.entries.size() > policy.max_count) ||
+        (policy.max_bytes > 0 && index.total_bytes > policy.max_bytes);
+}
+
+void ActionJobStore::LoadAppIndex(const std::string& app_id) {
+    // The backend scan runs unlocked so a large backlog does not stall requests.
+    std::map<std::string, unsigned long long> stored;
+    backend_->List(app_id, stored);
+
+    std::unordered_map<std::string, IndexEntry> scanned;
+    std::map<std::string, unsigned long long>::const_iterator stored_iter;
+    for (stored_iter = stored.begin(); stored_iter != stored.end(); ++stored_iter) {
+        // One read per stored job, once per app, so listing never has to touch records.
+        ActionJobRecord record;
+        std::string read_error;
+        IndexEntry entry;
+        if (backend_->Read(app_id, stored_iter->first, record, read_error)) {
+            entry.summary = SummarizeActionJobRecord(record);
+        } else {
+            entry.summary.job_id = stored_iter->first;
+        }
+        entry.accepted_epoch_ms = AcceptedEpochMs(entry.summary);
+        entry.bytes = stored_iter->second +
+            FileSizeOrZero(ResolveActionJobOutputPath(repo_root_, path_templates_, app_id, stored_iter->first));
+        entry.active = false;
+        scanned[stored_iter->first] = entry;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    AppIndex& index = indexes_[app_id];
+    std::unordered_map<std::string, IndexEntry>::const_iterator iter;
+    for (iter = scanned.begin(); iter != scanned.end(); ++iter) {
+        // Entries written while the scan ran are newer than what was on disk.
+        if (index.entries.find(iter->first) == index.entries.end()) {
+            index.entries[iter->first] = iter->second;
+            index.order.insert(OrderKey(iter->second.accepted_epoch_ms, iter->first));
+            index.total_bytes += iter->second.bytes;
+        }
+    }
+    index.loaded = true;
+}
+
+void ActionJobStore::UpdateIndexLocked(
+    const std::string& app_id,
+    const ActionJobRecord& record,
+    unsigned long long bytes) {
+    AppIndex& index = indexes_[app_id];
+    const std::unordered_map<std::string, IndexEntry>::iterator iter = index.entries.find(record.job_id);
+    if (iter != index.entries.end()) {
+        index.total_bytes -= iter->second.bytes;
+        iter->second.bytes = bytes;
+        iter->second.active = !IsTerminalJobState(record.state);
+        iter->second.summary = SummarizeActionJobRecord(record);
+    } else {
+        IndexEntry entry;
+        entry.summary = SummarizeActionJobRecord(record);
+        entry.accepted_epoch_ms = AcceptedEpochMs(entry.summary);
+        if (entry.accepted_epoch_ms < 0) {
+            entry.accepted_epoch_ms = CurrentEpochMs();
+        }
+        entry.bytes = bytes;
+        entry.active = !IsTerminalJobState(record.state);
+        index.entries[record.job_id] = entry;
+        index.order.insert(OrderKey(entry.accepted_epoch_ms, record.job_id));
+    }
+    index.total_bytes += bytes;
+}
+
+std::size_t ActionJobStore::PruneApp(const std::string& app_id) {
+    const ActionJobRetentionPolicy policy = RetentionFor(app_id);
+    if (!HasRetentionLimit(policy)) {
+        return 0;
+    }
+
+    std::vector<std::string> victims;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::map<std::string, AppIndex>::iterator index_iter = indexes_.find(app_id);
+        if (index_iter == indexes_.end()) {
+            return 0;
+        }
+        AppIndex& index = index_iter->second;
+
+        const long long age_cutoff_ms = CurrentEpochMs() - policy.max_age_seconds * 1000LL;
+        std::size_t remaining_count = index.entries.size();
+        unsigned long long remaining_bytes = index.total_bytes;
+        std::set<OrderKey, OrderKeyLess>::iterator iter = index.order.begin();
+        while (iter != index.order.end()) {
+            const bool over_count = policy.max_count > 0 && remaining_count > policy.max_count;
+            const bool over_bytes = policy.max_bytes > 0 && remaining_bytes > policy.max_bytes;
+            const bool too_old = policy.max_age_seconds > 0 && iter->first < age_cutoff_ms;
+            // The order is oldest first, so the first survivor ends the sweep.
+            if (!over_count && !over_bytes && !too_old) {
+                break;
+            }
+
+            const std::string job_id = iter->second;
+            const std::unordered_map<std::string, IndexEntry>::iterator victim = index.entries.find(job_id);
+            if (victim->second.active) {
+                ++iter;
+                continue;
+            }
+            remaining_count -= 1;
+            remaining_bytes -= victim->second.bytes;
+            index.total_bytes -= victim->second.bytes;
+            index.entries.erase(victim);
+            iter = index.order.erase(iter);
+            CacheEraseLocked(MakeCacheKey(app_id, job_id));
+            victims.push_back(job_id);
+        }
+    }
+
+    backend_->Remove(app_id, victims);
+    std::size_t index;
+    for (index = 0; index < victims.size(); ++index) {
+        std::error_code error;
+        fs::remove(ResolveActionJobOutputPath(repo_root_, path_templates_, app_id, victims[index]), error);
+    }
+    return victims.size();
+}
+
+void ActionJobStore::CachePutLocked(const std::string& key, const ActionJobRecord& record) {
+    const std::unordered_map<std::string, CacheEntry>::iterator iter = cache_.find(key);
+    if (iter != cache_.end()) {
+        iter->second.record = record;
+        lru_.splice(lru_.begin(), lru_, iter->second.lru_position);
+        return;
+    }
+
+    lru_.push_front(key);
+    CacheEntry entry;
+    entry.record = record;
+    entry.lru_position = lru_.begin();
+    cache_[key] = entry;
+
+    while (cache_.size() > kJobRecordCacheEntries) {
+        cache_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+void ActionJobStore::CacheEraseLocked(const std::string& key) {
+    const std::unordered_map<std::string, CacheEntry>::iterator iter = cache_.find(key);
+    if (iter != cache_.end()) {
+        lru_.erase(iter->second.lru_position);
+        cache_.erase(iter);
+    }
+}
+
+void ActionJobStore::PrunerLoop() {
+    std::size_t index;
+    for (index = 0; index < options_.app_ids.size(); ++index) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+        }
+        LoadAppIndex(options_.app_ids[index]);
+    }
+
+    while (true) {
+        Prune();
+        backend_->Maintain();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait_for(lock, std::chrono::seconds(kPruneIntervalSeconds), [this]() {
+            return stopping_ || prune_requested_;
+        });
+        if (stopping_) {
+            return;
+        }
+        prune_requested_ = false;
+
+        // Apps first touched after startup are indexed before their first prune.
+        std::vector<std::string> unloaded;
+        std::map<std::string, AppIndex>::const_iterator iter;
+        for (iter = indexes_.begin(); iter != indexes_.end(); ++iter) {
+            if (!iter->second.loaded) {
+                unloaded.push_back(iter->first);
+            }
+        }
+        lock.unlock();
+
+        for (index = 0; index < unloaded.size(); ++index) {
+            LoadAppIndex(unloaded[index]);
+        }
+    }
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
@@ -0,0 +1,138 @@
+#ifndef PROCESS_INTERFACE_COMMON_ACTION_JOB_STORE_H
+#define PROCESS_INTERFACE_COMMON_ACTION_JOB_STORE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../common/fs_compat.h"
+#include "../../common/path_templates.h"
+#include "action_job_backend.h"
+#include "action_jobs.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+// Zero disables a limit.
+struct ActionJobRetentionPolicy {
+    std::size_t max_count;
+    long long max_age_seconds;
+    unsigned long long max_bytes;
+};
+
+struct ActionJobStoreOptions {
+    ActionJobBackendKind backend;
+    // Apps indexed and pruned in the background from startup.
+    std::vector<std::string> app_ids;
+    ActionJobRetentionPolicy default_retention;
+    std::map<std::string, ActionJobRetentionPolicy> app_retention;
+};
+
+ActionJobStoreOptions DefaultActionJobStoreOptions();
+
+struct ActionJobListQuery {
+    // Empty strings match every job.
+    std::string action_name;
+    std::string state;
+    // Acceptance time window [since, until); -1 leaves that side open.
+    long long since_epoch_ms;
+    long long until_epoch_ms;
+    // nextCursor of the previous page; empty starts at the newest job.
+    std::string cursor;
+    std::size_t limit;
+};
+
+// Write-through front for action job records: an LRU cache of recent records serves
+// action.job.get without touching disk, and a per-app index of every stored job
+// drives retention pruning. This host is assumed to be the only writer of its job store.
+class ActionJobStore {
+public:
+    ActionJobStore(
+        const fs::path& repo_root,
+        const Common::PathTemplateSet& path_templates,
+        const ActionJobStoreOptions& options);
+    ~ActionJobStore();
+
+    ActionJobStore(const ActionJobStore&) = delete;
+    ActionJobStore& operator=(const ActionJobStore&) = delete;
+
+    bool Write(const std::string& app_id, const ActionJobRecord& record, std::string& error_message);
+    bool Read(const std::string& app_id, const std::string& job_id, ActionJobRecord& record_out, std::string& error_message);
+
+    // Newest first, answered from the in-memory index without reading any record.
+    bool List(
+        const std::string& app_id,
+        const ActionJobListQuery& query,
+        std::vector<ActionJobSummary>& jobs_out,
+        std::string& next_cursor_out,
+        std::string& error_message);
+
+    // Applies the retention policy of every indexed app; returns the number of jobs removed.
+    std::size_t Prune();
+
+private:
+    // Acceptance time in epoch ms plus job id.
+    typedef std::pair<long long, std::string> OrderKey;
+
+    // Oldest first; same-millisecond ids fall back to their counter suffix (shorter is smaller).
+    struct OrderKeyLess {
+        bool operator()(const OrderKey& left, const OrderKey& right) const;
+    };
+
+    struct IndexEntry {
+        long long accepted_epoch_ms;
+        unsigned long long bytes;
+        // Written by this host and not terminal yet; never pruned.
+        bool active;
+        ActionJobSummary summary;
+    };
+
+    struct AppIndex {
+        bool loaded;
+        std::unordered_map<std::string, IndexEntry> entries;
+        std::set<OrderKey, OrderKeyLess> order;
+        unsigned long long total_bytes;
+    };
+
+    struct CacheEntry {
+        ActionJobRecord record;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    ActionJobRetentionPolicy RetentionFor(const std::string& app_id) const;
+    bool ExceedsRetentionLocked(const std::string& app_id, const AppIndex& index) const;
+    void LoadAppIndex(const std::string& app_id);
+    void UpdateIndexLocked(const std::string& app_id, const ActionJobRecord& record, unsigned long long bytes);
+    std::size_t PruneApp(const std::string& app_id);
+    void CachePutLocked(const std::string& key, const ActionJobRecord& record);
+    void CacheEraseLocked(const std::string& key);
+    void PrunerLoop();
+
+    fs::path repo_root_;
+    Common::PathTemplateSet path_templates_;
+    ActionJobStoreOptions options_;
+    std::unique_ptr<ActionJobBackend> backend_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::map<std::string, AppIndex> indexes_;
+    std::list<std::string> lru_;
+    std::unordered_map<std::string, CacheEntry> cache_;
+    bool prune_requested_;
+    bool stopping_;
+    std::thread pruner_;
+};
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_ACTION_JOB_STORE_H
@@ -34,6 +34,22 @@ nlohmann::json ParseObjectOrDefault(const std::string& text) {
 
 }  // namespace
 
+bool IsTerminalJobState(const std::string& state) {
+    return state == "succeeded" || state == "failed" || state == "timeout" || state == "canceled";
+}
+
+ActionJobSummary SummarizeActionJobRecord(const ActionJobRecord& record) {
+    ActionJobSummary summary;
+    summary.job_id = record.job_id;
+    summary.action_name = record.action_name;
+    summary.state = record.state;
+    summary.accepted_at = record.accepted_at;
+    summary.started_at = record.started_at;
+    summary.finished_at = record.finished_at;
+    summary.error_code = record.has_error ? record.error_code : std::string();
+    return summary;
+}
+
 std::string GenerateJobId() {
     const unsigned long long counter = ++g_job_counter;
     const long long epoch_ms = CurrentEpochMs();
@@ -56,21 +72,36 @@ fs::path ResolveActionJobPath(
     return Common::RenderTemplatePath(path_templates.action_job_path, path_args);
 }
 
-bool WriteActionJobRecord(
+fs::path ResolveActionJobOutputPath(
     const fs::path& repo_root,
     const Common::PathTemplateSet& path_templates,
     const std::string& app_id,
-    const ActionJobRecord& record,
-    std::string& error_message) {
+    const std::string& job_id) {
+    fs::path path = ResolveActionJobPath(repo_root, path_templates, app_id, job_id);
+    path.replace_extension(".stdout.log");
+    return path;
+}
+
+std::string SerializeActionJobRecord(const ActionJobRecord& record) {
     nlohmann::json root;
     root["jobId"] = record.job_id;
+    root["actionName"] = record.action_name;
     root["state"] = record.state;
     root["acceptedAt"] = record.accepted_at;
     root["startedAt"] = record.started_at;
     root["finishedAt"] = record.finished_at;
+    root["canceledAt"] = record.canceled_at;
     root["result"] = ParseObjectOrDefault(record.result_json);
     root["stdout"] = record.stdout_text;
+    root["stdoutBytes"] = record.stdout_bytes;
+    root["stdoutTruncated"] = record.stdout_truncated;
     root["stderr"] = record.stderr_text;
+    if (!record.source_job_id.empty()) {
+        root["sourceJobId"] = record.source_job_id;
+    }
+    if (!record.payload_scan_error.empty()) {
+        root["payloadScanError"] = record.payload_scan_error;
+    }
 
     if (record.has_error) {
         nlohmann::json error;
@@ -82,25 +113,11 @@ bool WriteActionJobRecord(
         root["error"] = nullptr;
     }
 
-    const fs::path path = ResolveActionJobPath(repo_root, path_templates, app_id, record.job_id);
-    return ProcessInterface::Platform::AtomicReplaceFile(path, root.dump(), error_message);
+    // Output tails can start mid UTF-8 sequence; replace invalid bytes instead of failing the write.
+    return root.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
 }
 
-bool ReadActionJobRecord(
-    const fs::path& repo_root,
-    const Common::PathTemplateSet& path_templates,
-    const std::string& app_id,
-    const std::string& job_id,
-    ActionJobRecord& record_out,
-    std::string& error_message) {
-    const fs::path path = ResolveActionJobPath(repo_root, path_templates, app_id, job_id);
-
-    std::string text;
-    if (!ReadTextFile(path, text)) {
-        error_message = "job not found";
-        return false;
-    }
-
+bool ParseActionJobRecord(const std::string& text, ActionJobRecord& record_out, std::string& error_message) {
     nlohmann::json root;
     try {
         root = nlohmann::json::parse(text);
@@ -116,12 +133,18 @@ bool ReadActionJobRecord(
 
     ActionJobRecord record;
     record.job_id = root.value("jobId", std::string());
+    record.action_name = root.value("actionName", std::string());
     record.state = root.value("state", std::string());
     record.accepted_at = root.value("acceptedAt", std::string());
     record.started_at = root.value("startedAt", std::string());
     record.finished_at = root.value("finishedAt", std::string());
+    record.canceled_at = root.value("canceledAt", std::string());
     record.stdout_text = root.value("stdout", std::string());
+    record.stdout_bytes = root.value("stdoutBytes", static_cast<unsigned long long>(record.stdout_text.size()));
+    record.stdout_truncated = root.value("stdoutTruncated", false);
     record.stderr_text = root.value("stderr", std::string());
+    record.source_job_id = root.value("sourceJobId", std::string());
+    record.payload_scan_error = root.value("payloadScanError", std::string());
 
     if (root.contains("result") && root["result"].is_object()) {
         record.result_json = root["result"].dump();
@@ -148,5 +171,33 @@ bool ReadActionJobRecord(
     return true;
 }
 
+bool WriteActionJobRecord(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    const ActionJobRecord& record,
+    std::string& error_message) {
+    const fs::path path = ResolveActionJobPath(repo_root, path_templates, app_id, record.job_id);
+    return ProcessInterface::Platform::AtomicReplaceFile(path, SerializeActionJobRecord(record), error_message);
+}
+
+bool ReadActionJobRecord(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    const std::string& job_id,
+    ActionJobRecord& record_out,
+    std::string& error_message) {
+    const fs::path path = ResolveActionJobPath(repo_root, path_templates, app_id, job_id);
+
+    std::string text;
+    if (!ReadTextFile(path, text)) {
+        error_message = "job not found";
+        return false;
+    }
+
+    return ParseActionJobRecord(text, record_out, error_message);
+}
+
 }  // namespace Common
 }  // namespace ProcessInterface
@@ -11,24 +11,57 @@ namespace Common {
 
 struct ActionJobRecord {
     std::string job_id;
+    std::string action_name;
     std::string state;
     std::string accepted_at;
     std::string started_at;
     std::string finished_at;
+    std::string canceled_at;
     std::string result_json;
+    // Last output bytes only when stdout_truncated is set; the full stream is in the output file.
     std::string stdout_text;
+    unsigned long long stdout_bytes;
+    bool stdout_truncated;
     std::string stderr_text;
     bool has_error;
     std::string error_code;
     std::string error_message;
+    // Job whose run produced this outcome when it came from the action result cache or an
+    // identical in-flight run; empty when the job ran itself.
+    std::string source_job_id;
+    // Set when the result payload was looked for in the output tail only; see ActionRunResult.
+    std::string payload_scan_error;
 };
 
+// Listing view of a record: everything except result and output.
+struct ActionJobSummary {
+    std::string job_id;
+    std::string action_name;
+    std::string state;
+    std::string accepted_at;
+    std::string started_at;
+    std::string finished_at;
+    std::string error_code;
+};
+
+bool IsTerminalJobState(const std::string& state);
+ActionJobSummary SummarizeActionJobRecord(const ActionJobRecord& record);
+
 std::string GenerateJobId();
 fs::path ResolveActionJobPath(
     const fs::path& repo_root,
     const Common::PathTemplateSet& path_templates,
     const std::string& app_id,
     const std::string& job_id);
+fs::path ResolveActionJobOutputPath(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    const std::string& job_id);
+
+// Single-line JSON form shared by the per-job files and the job log.
+std::string SerializeActionJobRecord(const ActionJobRecord& record);
+bool ParseActionJobRecord(const std::string& text, ActionJobRecord& record_out, std::string& error_message);
 
 bool WriteActionJobRecord(
     const fs::path& repo_root,
@@ -27,10 +27,13 @@ std::string BuildConfigSetFallbackPayload(
     return response.dump();
 }
 
-std::string BuildActionInvokeAcceptedResponse(const std::string& job_id, const std::string& accepted_at) {
+std::string BuildActionInvokeAcceptedResponse(
+    const std::string& job_id,
+    const std::string& state,
+    const std::string& accepted_at) {
     nlohmann::json response;
     response["jobId"] = job_id;
-    response["state"] = "queued";
+    response["state"] = state;
     response["acceptedAt"] = accepted_at;
     return response.dump();
 }
@@ -38,10 +41,16 @@ std::string BuildActionInvokeAcceptedResponse(const std::string& job_id, const s
 std::string BuildActionJobResponse(const ActionJobRecord& record) {
     nlohmann::json response;
     response["jobId"] = record.job_id;
+    if (!record.action_name.empty()) {
+        response["actionName"] = record.action_name;
+    }
     response["state"] = record.state;
     response["acceptedAt"] = record.accepted_at;
     response["startedAt"] = record.started_at;
     response["finishedAt"] = record.finished_at;
+    if (!record.canceled_at.empty()) {
+        response["canceledAt"] = record.canceled_at;
+    }
 
     try {
         response["result"] = nlohmann::json::parse(record.result_json.empty() ? "{}" : record.result_json);
@@ -50,7 +59,15 @@ std::string BuildActionJobResponse(const ActionJobRecord& record) {
     }
 
     response["stdout"] = record.stdout_text;
+    response["stdoutBytes"] = record.stdout_bytes;
+    response["stdoutTruncated"] = record.stdout_truncated;
     response["stderr"] = record.stderr_text;
+    if (!record.source_job_id.empty()) {
+        response["sourceJobId"] = record.source_job_id;
+    }
+    if (!record.payload_scan_error.empty()) {
+        response["payloadScanError"] = record.payload_scan_error;
+    }
 
     if (record.has_error) {
         nlohmann::json error;
@@ -62,8 +79,88 @@ std::string BuildActionJobResponse(const ActionJobRecord& record) {
         response["error"] = nullptr;
     }
 
+    return response.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+std::string BuildActionJobListResponse(const std::vector<ActionJobSummary>& jobs, const std::string& next_cursor) {
+    nlohmann::json items = nlohmann::json::array();
+    std::size_t index;
+    for (index = 0; index < jobs.size(); ++index) {
+        const ActionJobSummary& summary = jobs[index];
+        nlohmann::json item;
+        item["jobId"] = summary.job_id;
+        item["actionName"] = summary.action_name;
+        item["state"] = summary.state;
+        item["acceptedAt"] = summary.accepted_at;
+        item["startedAt"] = summary.started_at;
+        item["finishedAt"] = summary.finished_at;
+        if (summary.error_code.empty()) {
+            item["error"] = nullptr;
+        } else {
+            item["error"] = nlohmann::json::object();
+            item["error"]["code"] = summary.error_code;
+        }
+        items.push_back(item);
+    }
+
+    nlohmann::json response;
+    response["jobs"] = items;
+    if (next_cursor.empty()) {
+        response["nextCursor"] = nullptr;
+    } else {
+        response["nextCursor"] = next_cursor;
+    }
     return response.dump();
 }
 
+std::string BuildActionJobCancelResponse(
+    const std::string& job_id,
+    const std::string& state,
+    bool canceled,
+    const std::string& requested_at) {
+    nlohmann::json response;
+    response["jobId"] = job_id;
+    response["state"] = state;
+    response["canceled"] = canceled;
+    response["cancelRequestedAt"] = requested_at;
+    return response.dump();
+}
+
+std::string BuildActionJobOutputResponse(
+    const std::string& job_id,
+    const std::string& state,
+    unsigned long long offset,
+    const std::string& data,
+    unsigned long long total_bytes) {
+    const unsigned long long next_offset = offset + data.size();
+
+    nlohmann::json response;
+    response["jobId"] = job_id;
+    response["state"] = state;
+    response["offset"] = offset;
+    response["nextOffset"] = next_offset;
+    response["totalBytes"] = total_bytes;
+    response["data"] = data;
+    response["complete"] = IsTerminalJobState(state) && next_offset >= total_bytes;
+    return response.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+std::string BuildActionJobOutputEvent(
+    const std::string& app_id,
+    const std::string& job_id,
+    unsigned long long offset,
+    const std::string& data) {
+    nlohmann::json params;
+    params["appId"] = app_id;
+    params["jobId"] = job_id;
+    params["offset"] = offset;
+    params["data"] = data;
+
+    nlohmann::json event;
+    event["event"] = "action.job.output";
+    event["params"] = params;
+    return event.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
 }  // namespace Common
 }  // namespace ProcessInterface
@@ -2,6 +2,7 @@
 #define PROCESS_INTERFACE_COMMON_ACTION_RESPONSE_H
 
 #include <string>
+#include <vector>
 
 #include "action_jobs.h"
 
@@ -14,8 +15,29 @@ std::string BuildConfigSetFallbackPayload(
     int rc,
     const std::string& stdout_text);
 
-std::string BuildActionInvokeAcceptedResponse(const std::string& job_id, const std::string& accepted_at);
+// state is "queued", or the terminal state of a job answered from the action result cache.
+std::string BuildActionInvokeAcceptedResponse(
+    const std::string& job_id,
+    const std::string& state,
+    const std::string& accepted_at);
 std::string BuildActionJobResponse(const ActionJobRecord& record);
+std::string BuildActionJobListResponse(const std::vector<ActionJobSummary>& jobs, const std::string& next_cursor);
+std::string BuildActionJobCancelResponse(
+    const std::string& job_id,
+    const std::string& state,
+    bool canceled,
+    const std::string& requested_at);
+std::string BuildActionJobOutputResponse(
+    const std::string& job_id,
+    const std::string& state,
+    unsigned long long offset,
+    const std::string& data,
+    unsigned long long total_bytes);
+std::string BuildActionJobOutputEvent(
+    const std::string& app_id,
+    const std::string& job_id,
+    unsigned long long offset,
+    const std::string& data);
 
 }  // namespace Common
 }  // namespace ProcessInterface
@@ -0,0 +1,165 @@
+#include "action_result_cache.h"
+
+#include <utility>
+
+namespace ProcessInterface {
+namespace Common {
+
+ActionResultCache::ActionResultCache(std::size_t max_entries) : max_entries_(max_entries) {}
+
+ActionAdmission ActionResultCache::Admit(
+    const std::string& key,
+    const std::shared_ptr<const void>& generation,
+    const ActionJobRecord& queued_record,
+    const ActionFlightLauncher& launcher,
+    ActionJobRecord& cached_out) {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const std::map<std::string, CachedResult>::iterator cached = results_.find(key);
+    if (cached != results_.end()) {
+        if (now < cached->second.expires_at) {
+            cached_out = cached->second.record;
+            return ActionAdmission::kCached;
+        }
+        results_.erase(cached);
+    }
+
+    const std::map<std::string, Flight>::iterator flight = flights_.find(key);
+    if (flight != flights_.end()) {
+        flight->second.waiters.push_back(queued_record);
+        flight_keys_[queued_record.job_id] = key;
+        return ActionAdmission::kJoined;
+    }
+
+    Flight started;
+    started.leader_job_id = queued_record.job_id;
+    started.generation = generation;
+    started.launcher = launcher;
+    flights_[key] = started;
+    flight_keys_[queued_record.job_id] = key;
+    return ActionAdmission::kLeader;
+}
+
+bool ActionResultCache::Complete(
+    const std::string& leader_job_id,
+    const ActionJobRecord& terminal_record,
+    double ttl_seconds,
+    std::vector<ActionJobRecord>& waiters_out) {
+    waiters_out.clear();
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const std::map<std::string, std::string>::iterator key_iter = flight_keys_.find(leader_job_id);
+    if (key_iter == flight_keys_.end()) {
+        return false;
+    }
+    const std::string key = key_iter->second;
+    const std::map<std::string, Flight>::iterator flight = flights_.find(key);
+    if (flight == flights_.end() || flight->second.leader_job_id != leader_job_id) {
+        return false;
+    }
+
+    waiters_out.swap(flight->second.waiters);
+    std::size_t index;
+    for (index = 0; index < waiters_out.size(); ++index) {
+        flight_keys_.erase(waiters_out[index].job_id);
+    }
+    flight_keys_.erase(leader_job_id);
+    const std::shared_ptr<const void> generation = flight->second.generation;
+    flights_.erase(flight);
+
+    if (terminal_record.state == "succeeded" && !terminal_record.stdout_truncated && ttl_seconds > 0.0) {
+        PruneLocked(now);
+        CachedResult result;
+        result.generation = generation;
+        result.record = terminal_record;
+        result.expires_at = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(ttl_seconds));
+        results_[key] = result;
+    }
+    return true;
+}
+
+bool ActionResultCache::HandOff(
+    const std::string& leader_job_id,
+    ActionJobRecord& next_leader_out,
+    ActionFlightLauncher& launcher_out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::map<std::string, std::string>::iterator key_iter = flight_keys_.find(leader_job_id);
+    if (key_iter == flight_keys_.end()) {
+        return false;
+    }
+    const std::map<std::string, Flight>::iterator flight = flights_.find(key_iter->second);
+    if (flight == flights_.end() || flight->second.leader_job_id != leader_job_id) {
+        return false;
+    }
+
+    flight_keys_.erase(key_iter);
+    if (flight->second.waiters.empty()) {
+        flights_.erase(flight);
+        return false;
+    }
+
+    next_leader_out = flight->second.waiters.front();
+    flight->second.waiters.erase(flight->second.waiters.begin());
+    flight->second.leader_job_id = next_leader_out.job_id;
+    launcher_out = flight->second.launcher;
+    return true;
+}
+
+bool ActionResultCache::DetachWaiter(const std::string& job_id, ActionJobRecord& waiter_out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::map<std::string, std::string>::iterator key_iter = flight_keys_.find(job_id);
+    if (key_iter == flight_keys_.end()) {
+        return false;
+    }
+    const std::map<std::string, Flight>::iterator flight = flights_.find(key_iter->second);
+    if (flight == flights_.end() || flight->second.leader_job_id == job_id) {
+        return false;
+    }
+
+    std::vector<ActionJobRecord>& waiters = flight->second.waiters;
+    std::size_t index;
+    for (index = 0; index < waiters.size(); ++index) {
+        if (waiters[index].job_id == job_id) {
+            waiter_out = waiters[index];
+            waiters.erase(waiters.begin() + static_cast<std::ptrdiff_t>(index));
+            flight_keys_.erase(key_iter);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ActionResultCache::PruneLocked(std::chrono::steady_clock::time_point now) {
+    std::map<std::string, CachedResult>::iterator iter = results_.begin();
+    while (iter != results_.end()) {
+        if (now >= iter->second.expires_at) {
+            iter = results_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    while (results_.size() >= max_entries_ && !results_.empty()) {
+        std::map<std::string, CachedResult>::iterator oldest = results_.begin();
+        for (iter = results_.begin(); iter != results_.end(); ++iter) {
+            if (iter->second.expires_at < oldest->second.expires_at) {
+                oldest = iter;
+            }
+        }
+        results_.erase(oldest);
+    }
+}
+
+ActionJobRecord CloneActionJobResult(const ActionJobRecord& source, const ActionJobRecord& target) {
+    ActionJobRecord clone = source;
+    clone.job_id = target.job_id;
+    clone.accepted_at = target.accepted_at;
+    clone.source_job_id = source.source_job_id.empty() ? source.job_id : source.source_job_id;
+    return clone;
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
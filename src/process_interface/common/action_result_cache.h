@@ -0,0 +1,97 @@
+#ifndef PROCESS_INTERFACE_COMMON_ACTION_RESULT_CACHE_H
+#define PROCESS_INTERFACE_COMMON_ACTION_RESULT_CACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "action_jobs.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+enum class ActionAdmission {
+    // A fresh terminal record was found; the caller clones it instead of running.
+    kCached,
+    // An identical run is in flight; the caller's job is resolved when it ends.
+    kJoined,
+    // The caller's job runs and must end with Complete.
+    kLeader,
+};
+
+// Starts a run of a flight's invocation for the given job record, which then leads the flight.
+typedef std::function<void(const ActionJobRecord&)> ActionFlightLauncher;
+
+// Terminal results of catalog actions marked "cacheable", keyed by app, action name and
+// rendered args, plus single-flight collapsing of identical invocations.
+class ActionResultCache {
+public:
+    explicit ActionResultCache(std::size_t max_entries);
+
+    // key must identify the compiled catalog (e.g. by address); generation is that catalog
+    // and is held by the flight and the cached result so the address stays unique.
+    // queued_record is the caller's new job record, kept as a waiter on kJoined. launcher is
+    // kept by a flight the caller leads and is used by HandOff.
+    ActionAdmission Admit(
+        const std::string& key,
+        const std::shared_ptr<const void>& generation,
+        const ActionJobRecord& queued_record,
+        const ActionFlightLauncher& launcher,
+        ActionJobRecord& cached_out);
+
+    // Ends the flight led by leader_job_id. Succeeded results with untruncated output are
+    // kept for ttl_seconds. Returns false when the job was not a flight leader.
+    bool Complete(
+        const std::string& leader_job_id,
+        const ActionJobRecord& terminal_record,
+        double ttl_seconds,
+        std::vector<ActionJobRecord>& waiters_out);
+
+    // Makes the first waiter the leader of the flight led by leader_job_id, e.g. when the
+    // leader was canceled, and returns it with the flight's launcher. Returns false, ending
+    // the flight, when no job is waiting or the job was not a flight leader.
+    bool HandOff(
+        const std::string& leader_job_id,
+        ActionJobRecord& next_leader_out,
+        ActionFlightLauncher& launcher_out);
+
+    // Detaches a waiting job, e.g. on cancel. Returns false when the job is not waiting.
+    bool DetachWaiter(const std::string& job_id, ActionJobRecord& waiter_out);
+
+private:
+    struct CachedResult {
+        std::shared_ptr<const void> generation;
+        ActionJobRecord record;
+        std::chrono::steady_clock::time_point expires_at;
+    };
+
+    struct Flight {
+        std::string leader_job_id;
+        std::shared_ptr<const void> generation;
+        ActionFlightLauncher launcher;
+        std::vector<ActionJobRecord> waiters;
+    };
+
+    void PruneLocked(std::chrono::steady_clock::time_point now);
+
+    std::size_t max_entries_;
+    std::mutex mutex_;
+    std::map<std::string, CachedResult> results_;
+    std::map<std::string, Flight> flights_;
+    // Leader and waiter job id -> flight key.
+    std::map<std::string, std::string> flight_keys_;
+};
+
+// Copies the outcome of a finished run onto another job of the same action, keeping that
+// job's id and acceptance time.
+ActionJobRecord CloneActionJobResult(const ActionJobRecord& source, const ActionJobRecord& target);
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_ACTION_RESULT_CACHE_H
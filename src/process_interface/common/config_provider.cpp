@@ -0,0 +1,528 @@
+#include "config_provider.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <system_error>
+
+#include "../../common/file_cache.h"
+#include "../../common/file_io.h"
+#include "../../platform/file_replace.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+namespace {
+
+bool IsKnownType(const std::string& type) {
+    return type == "string" || type == "integer" || type == "number" || type == "boolean" || type == "any";
+}
+
+std::string EscapePointerToken(const std::string& token) {
+    std::string escaped;
+    std::size_t index;
+    for (index = 0; index < token.size(); ++index) {
+        if (token[index] == '~') {
+            escaped += "~0";
+        } else if (token[index] == '/') {
+            escaped += "~1";
+        } else {
+            escaped.push_back(token[index]);
+        }
+    }
+    return escaped;
+}
+
+// "db.port" maps to "/db/port" when a key does not name its own pointer.
+std::string DefaultPointerForKey(const std::string& key) {
+    std::string pointer;
+    std::size_t start = 0;
+    while (start <= key.size()) {
+        const std::size_t dot = key.find('.', start);
+        const std::size_t end = dot == std::string::npos ? key.size() : dot;
+        pointer += "/" + EscapePointerToken(key.substr(start, end - start));
+        if (dot == std::string::npos) {
+            break;
+        }
+        start = dot + 1;
+    }
+    return pointer;
+}
+
+// Text from the wire is taken literally for strings and decoded as JSON for other types.
+bool CoerceValue(const ConfigKeySpec& key_spec, const std::string& text, nlohmann::json& value_out, std::string& reason) {
+    if (key_spec.type == "string") {
+        value_out = text;
+        return true;
+    }
+
+    nlohmann::json decoded;
+    try {
+        decoded = nlohmann::json::parse(text);
+    } catch (const std::exception&) {
+        if (key_spec.type == "any") {
+            value_out = text;
+            return true;
+        }
+        reason = "expected " + key_spec.type;
+        return false;
+    }
+
+    if (key_spec.type == "integer" && !decoded.is_number_integer()) {
+        reason = "expected integer";
+        return false;
+    }
+    if (key_spec.type == "number" && !decoded.is_number()) {
+        reason = "expected number";
+        return false;
+    }
+    if (key_spec.type == "boolean" && !decoded.is_boolean()) {
+        reason = "expected boolean";
+        return false;
+    }
+    value_out = decoded;
+    return true;
+}
+
+std::string FormatBound(double bound) {
+    if (bound == static_cast<double>(static_cast<long long>(bound))) {
+        return std::to_string(static_cast<long long>(bound));
+    }
+    return nlohmann::json(bound).dump();
+}
+
+bool ValidateValue(const ConfigKeySpec& key_spec, const nlohmann::json& value, std::string& reason) {
+    if (key_spec.type == "string" && !value.is_string()) {
+        reason = "expected string";
+        return false;
+    }
+    if (key_spec.type == "integer" && !value.is_number_integer()) {
+        reason = "expected integer";
+        return false;
+    }
+    if (key_spec.type == "number" && !value.is_number()) {
+        reason = "expected number";
+        return false;
+    }
+    if (key_spec.type == "boolean" && !value.is_boolean()) {
+        reason = "expected boolean";
+        return false;
+    }
+
+    if (value.is_number()) {
+        const double number = value.get<double>();
+        if (key_spec.has_minimum && number < key_spec.minimum) {
+            reason = "below minimum " + FormatBound(key_spec.minimum);
+            return false;
+        }
+        if (key_spec.has_maximum && number > key_spec.maximum) {
+            reason = "above maximum " + FormatBound(key_spec.maximum);
+            return false;
+        }
+    }
+
+    if (!key_spec.allowed_values.empty() &&
+        std::find(key_spec.allowed_values.begin(), key_spec.allowed_values.end(), value) == key_spec.allowed_values.end()) {
+        reason = "not one of " + nlohmann::json(key_spec.allowed_values).dump();
+        return false;
+    }
+    return true;
+}
+
+// Missing files read as an empty document so the first config.set can create them. A file
+// that exists but cannot be read is an error, so it is never replaced by the new keys alone.
+bool ReadConfigDocument(
+    const fs::path& path,
+    nlohmann::json& document_out,
+    std::shared_ptr<const std::string>& text_out,
+    bool& exists_out,
+    std::string& error_message) {
+    unsigned long long version = 0;
+    exists_out = true;
+    if (!SharedFileContentCache().ReadText(path, text_out, version)) {
+        std::error_code status_error;
+        const fs::file_status status = fs::status(path, status_error);
+        if (status.type() == fs::file_type::not_found) {
+            exists_out = false;
+            document_out = nlohmann::json::object();
+            return true;
+        }
+        error_message = "failed to read config file: " + path.string();
+        if (status_error) {
+            error_message += ": " + status_error.message();
+        } else if (status.type() == fs::file_type::directory) {
+            error_message += ": is a directory";
+        }
+        return false;
+    }
+
+    try {
+        document_out = nlohmann::json::parse(*text_out);
+    } catch (const std::exception&) {
+        error_message = "config file is not valid JSON: " + path.string();
+        return false;
+    }
+    if (!document_out.is_object()) {
+        error_message = "config file must hold a JSON object: " + path.string();
+        return false;
+    }
+    return true;
+}
+
+bool LookupValue(const nlohmann::json& document, const nlohmann::json::json_pointer& pointer, nlohmann::json& value_out) {
+    try {
+        if (!document.contains(pointer)) {
+            return false;
+        }
+        value_out = document.at(pointer);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+nlohmann::json ReadSnapshotPid(const fs::path& status_snapshot_path) {
+    std::string text;
+    if (!ReadTextFile(status_snapshot_path, text)) {
+        return nlohmann::json();
+    }
+    try {
+        const nlohmann::json envelope = nlohmann::json::parse(text);
+        if (envelope.is_object() && envelope.contains("payload") && envelope["payload"].is_object() &&
+            envelope["payload"].contains("pid") && envelope["payload"]["pid"].is_number_integer()) {
+            return envelope["payload"]["pid"];
+        }
+    } catch (const std::exception&) {
+    }
+    return nlohmann::json();
+}
+
+}  // namespace
+
+const ConfigKeySpec* ConfigProviderSpec::FindKey(const std::string& key) const {
+    std::size_t low = 0;
+    std::size_t high = keys.size();
+    while (low < high) {
+        const std::size_t middle = low + (high - low) / 2;
+        if (keys[middle].key < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low < keys.size() && keys[low].key == key) {
+        return &keys[low];
+    }
+    return NULL;
+}
+
+bool ParseConfigProviderSpec(
+    const nlohmann::json& provider_json,
+    const fs::path& repo_root,
+    const std::string& app_id,
+    ConfigProviderSpec& spec_out,
+    std::string& error_message) {
+    spec_out = ConfigProviderSpec();
+    if (!provider_json.is_object()) {
+        error_message = "configProvider must be an object";
+        return false;
+    }
+    if (!provider_json.contains("files") || !provider_json["files"].is_object() || provider_json["files"].empty()) {
+        error_message = "configProvider.files must map file ids to paths";
+        return false;
+    }
+    if (!provider_json.contains("keys") || !provider_json["keys"].is_object()) {
+        error_message = "configProvider.keys must be an object";
+        return false;
+    }
+
+    const PathTemplateArgs path_args = {
+        repo_root.string(),
+        app_id,
+        std::string(),
+    };
+    std::map<std::string, std::size_t> file_index_by_id;
+    nlohmann::json::const_iterator file_iter;
+    for (file_iter = provider_json["files"].begin(); file_iter != provider_json["files"].end(); ++file_iter) {
+        if (!file_iter.value().is_string() || file_iter.value().get<std::string>().empty()) {
+            error_message = "configProvider.files." + file_iter.key() + " must be a path";
+            return false;
+        }
+        ConfigFileSpec file;
+        file.id = file_iter.key();
+        file.path = RenderTemplatePath(file_iter.value().get<std::string>(), path_args);
+        if (file.path.is_relative()) {
+            file.path = repo_root / file.path;
+        }
+        file_index_by_id[file.id] = spec_out.files.size();
+        spec_out.files.push_back(file);
+    }
+
+    bool default_restart = false;
+    if (provider_json.contains("restartRequired") && provider_json["restartRequired"].is_boolean()) {
+        default_restart = provider_json["restartRequired"].get<bool>();
+    }
+
+    nlohmann::json::const_iterator key_iter;
+    for (key_iter = provider_json["keys"].begin(); key_iter != provider_json["keys"].end(); ++key_iter) {
+        const std::string prefix = "configProvider.keys." + key_iter.key();
+        const nlohmann::json& item = key_iter.value();
+        if (key_iter.key().empty() || !item.is_object()) {
+            error_message = prefix + " must be an object";
+            return false;
+        }
+
+        ConfigKeySpec key_spec;
+        key_spec.key = key_iter.key();
+
+        if (item.contains("file")) {
+            if (!item["file"].is_string() || file_index_by_id.find(item["file"].get<std::string>()) == file_index_by_id.end()) {
+                error_message = prefix + ".file must name an entry of configProvider.files";
+                return false;
+            }
+            key_spec.file_index = file_index_by_id[item["file"].get<std::string>()];
+        } else if (spec_out.files.size() == 1) {
+            key_spec.file_index = 0;
+        } else {
+            error_message = prefix + ".file is required when several files are declared";
+            return false;
+        }
+
+        std::string pointer_text = DefaultPointerForKey(key_spec.key);
+        if (item.contains("pointer")) {
+            if (!item["pointer"].is_string() || item["pointer"].get<std::string>().empty()) {
+                error_message = prefix + ".pointer must be a non-empty JSON pointer";
+                return false;
+            }
+            pointer_text = item["pointer"].get<std::string>();
+        }
+        try {
+            key_spec.pointer = nlohmann::json::json_pointer(pointer_text);
+        } catch (const std::exception&) {
+            error_message = prefix + ".pointer is not a valid JSON pointer";
+            return false;
+        }
+
+        key_spec.type = "any";
+        if (item.contains("type")) {
+            if (!item["type"].is_string() || !IsKnownType(item["type"].get<std::string>())) {
+                error_message = prefix + ".type must be string, integer, number, boolean or any";
+                return false;
+            }
+            key_spec.type = item["type"].get<std::string>();
+        }
+
+        if (item.contains("enum")) {
+            if (!item["enum"].is_array() || item["enum"].empty()) {
+                error_message = prefix + ".enum must be a non-empty array";
+                return false;
+            }
+            key_spec.allowed_values.assign(item["enum"].begin(), item["enum"].end());
+        }
+
+        key_spec.has_minimum = item.contains("minimum") && item["minimum"].is_number();
+        key_spec.minimum = key_spec.has_minimum ? item["minimum"].get<double>() : 0.0;
+        key_spec.has_maximum = item.contains("maximum") && item["maximum"].is_number();
+        key_spec.maximum = key_spec.has_maximum ? item["maximum"].get<double>() : 0.0;
+
+        key_spec.has_default = item.contains("default");
+        if (key_spec.has_default) {
+            key_spec.default_value = item["default"];
+        }
+
+        key_spec.restart_required = default_restart;
+        if (item.contains("restartRequired") && item["restartRequired"].is_boolean()) {
+            key_spec.restart_required = item["restartRequired"].get<bool>();
+        }
+
+        spec_out.keys.push_back(key_spec);
+    }
+
+    // nlohmann objects iterate in key order, so keys are already sorted for FindKey.
+    return true;
+}
+
+std::string BuildNativeConfigGetPayload(const fs::path& repo_root, const ConfigProviderSpec& spec) {
+    nlohmann::json response;
+    response["repoRoot"] = repo_root.string();
+    response["errors"] = nlohmann::json::array();
+    response["entries"] = nlohmann::json::array();
+    response["paths"] = nlohmann::json::array();
+    response["configTree"] = nlohmann::json::object();
+
+    std::vector<nlohmann::json> documents(spec.files.size());
+    std::vector<bool> readable(spec.files.size(), false);
+    std::size_t index;
+    for (index = 0; index < spec.files.size(); ++index) {
+        std::shared_ptr<const std::string> text;
+        bool exists = false;
+        std::string error_message;
+        readable[index] = ReadConfigDocument(spec.files[index].path, documents[index], text, exists, error_message);
+        if (!readable[index]) {
+            response["errors"].push_back(error_message);
+        }
+
+        nlohmann::json path_item;
+        path_item["id"] = spec.files[index].id;
+        path_item["path"] = spec.files[index].path.string();
+        path_item["exists"] = exists;
+        response["paths"].push_back(path_item);
+        response["configTree"][spec.files[index].id] = readable[index] ? documents[index] : nlohmann::json();
+    }
+
+    for (index = 0; index < spec.keys.size(); ++index) {
+        const ConfigKeySpec& key_spec = spec.keys[index];
+        nlohmann::json entry;
+        entry["key"] = key_spec.key;
+        entry["file"] = spec.files[key_spec.file_index].id;
+        entry["type"] = key_spec.type;
+        entry["restartRequired"] = key_spec.restart_required;
+
+        nlohmann::json value;
+        bool is_set = false;
+        if (readable[key_spec.file_index]) {
+            is_set = LookupValue(documents[key_spec.file_index], key_spec.pointer, value);
+            std::string reason;
+            if (is_set && !ValidateValue(key_spec, value, reason)) {
+                response["errors"].push_back(key_spec.key + ": " + reason);
+            }
+            if (!is_set && !key_spec.has_default) {
+                response["errors"].push_back(key_spec.key + ": missing");
+            }
+        }
+        if (!is_set && key_spec.has_default) {
+            value = key_spec.default_value;
+        }
+        entry["value"] = value;
+        entry["isDefault"] = !is_set;
+        if (key_spec.has_default) {
+            entry["default"] = key_spec.default_value;
+        }
+        if (!key_spec.allowed_values.empty()) {
+            entry["enum"] = key_spec.allowed_values;
+        }
+        response["entries"].push_back(entry);
+    }
+
+    response["valid"] = response["errors"].empty();
+    return response.dump();
+}
+
+bool ApplyNativeConfigSet(
+    const ConfigProviderSpec& spec,
+    const std::vector<std::pair<std::string, std::string> >& values,
+    const std::string& values_param,
+    const fs::path& status_snapshot_path,
+    nlohmann::json& response_out,
+    std::string& error_message) {
+    std::vector<nlohmann::json> documents(spec.files.size());
+    std::vector<std::shared_ptr<const std::string> > original_text(spec.files.size());
+    std::vector<bool> loaded(spec.files.size(), false);
+    std::vector<bool> existed(spec.files.size(), false);
+    std::vector<bool> dirty(spec.files.size(), false);
+    std::vector<std::string> changed_keys;
+    std::vector<std::string> restart_keys;
+    nlohmann::json applied_values = nlohmann::json::object();
+    std::size_t first_file_index = spec.files.size();
+
+    std::size_t index;
+    for (index = 0; index < values.size(); ++index) {
+        const ConfigKeySpec* key_spec = spec.FindKey(values[index].first);
+        if (key_spec == NULL) {
+            error_message = "bad " + values_param + ": unknown config key: " + values[index].first;
+            return false;
+        }
+
+        nlohmann::json value;
+        std::string reason;
+        if (!CoerceValue(*key_spec, values[index].second, value, reason) || !ValidateValue(*key_spec, value, reason)) {
+            error_message = "config invalid: " + key_spec->key + ": " + reason;
+            return false;
+        }
+
+        applied_values[key_spec->key] = value;
+
+        const std::size_t file_index = key_spec->file_index;
+        if (first_file_index == spec.files.size()) {
+            first_file_index = file_index;
+        }
+        if (!loaded[file_index]) {
+            bool exists = false;
+            if (!ReadConfigDocument(
+                    spec.files[file_index].path, documents[file_index], original_text[file_index], exists, error_message)) {
+                error_message = "config invalid: " + key_spec->key + ": " + error_message;
+                return false;
+            }
+            loaded[file_index] = true;
+            existed[file_index] = exists;
+        }
+
+        nlohmann::json current;
+        if (LookupValue(documents[file_index], key_spec->pointer, current) && current == value) {
+            continue;
+        }
+        try {
+            documents[file_index][key_spec->pointer] = value;
+        } catch (const std::exception&) {
+            error_message = "config invalid: " + key_spec->key + ": pointer crosses a non-object value";
+            return false;
+        }
+        dirty[file_index] = true;
+        if (std::find(changed_keys.begin(), changed_keys.end(), key_spec->key) == changed_keys.end()) {
+            changed_keys.push_back(key_spec->key);
+            if (key_spec->restart_required) {
+                restart_keys.push_back(key_spec->key);
+            }
+        }
+    }
+
+    // Every file is rendered before the first replace; a failed replace restores the files
+    // already written so a batch lands completely or not at all.
+    std::vector<std::size_t> written;
+    nlohmann::json files = nlohmann::json::array();
+    for (index = 0; index < spec.files.size(); ++index) {
+        if (!dirty[index]) {
+            continue;
+        }
+        std::error_code create_error;
+        fs::create_directories(spec.files[index].path.parent_path(), create_error);
+        if (!Platform::AtomicReplaceFile(spec.files[index].path, documents[index].dump(2) + "\n", error_message)) {
+            std::size_t undo;
+            for (undo = 0; undo < written.size(); ++undo) {
+                const std::size_t file_index = written[undo];
+                std::string undo_error;
+                if (existed[file_index]) {
+                    Platform::AtomicReplaceFile(spec.files[file_index].path, *original_text[file_index], undo_error);
+                } else {
+                    std::error_code remove_error;
+                    fs::remove(spec.files[file_index].path, remove_error);
+                }
+            }
+            return false;
+        }
+        written.push_back(index);
+        files.push_back(spec.files[index].path.string());
+    }
+
+    response_out = nlohmann::json::object();
+    response_out["changed"] = !changed_keys.empty();
+    response_out["changedKeys"] = changed_keys;
+    response_out["values"] = applied_values;
+    response_out["filePath"] = first_file_index < spec.files.size() ? spec.files[first_file_index].path.string() : std::string();
+    response_out["files"] = files;
+    response_out["restartRequired"] = !restart_keys.empty();
+    response_out["restartKeys"] = restart_keys;
+    response_out["pidAtSet"] = ReadSnapshotPid(status_snapshot_path);
+    if (changed_keys.empty()) {
+        response_out["message"] = "no changes";
+    } else if (changed_keys.size() == 1) {
+        response_out["message"] = "updated " + changed_keys[0];
+    } else {
+        response_out["message"] = "updated " + std::to_string(changed_keys.size()) + " keys in " +
+            std::to_string(files.size()) + (files.size() == 1 ? " file" : " files");
+    }
+    return true;
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
@@ -0,0 +1,72 @@
+#ifndef PROCESS_INTERFACE_COMMON_CONFIG_PROVIDER_H
+#define PROCESS_INTERFACE_COMMON_CONFIG_PROVIDER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../../external/nlohmann/json.hpp"
+#include "../../common/fs_compat.h"
+#include "../../common/path_templates.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+struct ConfigFileSpec {
+    std::string id;
+    fs::path path;
+};
+
+struct ConfigKeySpec {
+    std::string key;
+    // Index into ConfigProviderSpec::files.
+    std::size_t file_index;
+    nlohmann::json::json_pointer pointer;
+    // "string", "integer", "number", "boolean" or "any".
+    std::string type;
+    std::vector<nlohmann::json> allowed_values;
+    bool has_minimum;
+    double minimum;
+    bool has_maximum;
+    double maximum;
+    bool has_default;
+    nlohmann::json default_value;
+    bool restart_required;
+};
+
+// Declarative "configProvider" block of an action catalog: config.get and config.set are
+// served from plain JSON files by the host instead of the config_show/config_set_key actions.
+struct ConfigProviderSpec {
+    std::vector<ConfigFileSpec> files;
+    // Sorted by key.
+    std::vector<ConfigKeySpec> keys;
+
+    const ConfigKeySpec* FindKey(const std::string& key) const;
+};
+
+bool ParseConfigProviderSpec(
+    const nlohmann::json& provider_json,
+    const fs::path& repo_root,
+    const std::string& app_id,
+    ConfigProviderSpec& spec_out,
+    std::string& error_message);
+
+// Builds the contract config.get shape; unreadable files and schema violations are reported
+// through valid/errors rather than failing the call.
+std::string BuildNativeConfigGetPayload(const fs::path& repo_root, const ConfigProviderSpec& spec);
+
+// Validates every value, then patches each touched file with one atomic replace. Nothing is
+// written when any value is rejected. Errors are "bad <param>: <reason>" for unknown keys and
+// "config invalid: <key>: <reason>" for schema violations.
+bool ApplyNativeConfigSet(
+    const ConfigProviderSpec& spec,
+    const std::vector<std::pair<std::string, std::string> >& values,
+    const std::string& values_param,
+    const fs::path& status_snapshot_path,
+    nlohmann::json& response_out,
+    std::string& error_message);
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_CONFIG_PROVIDER_H
@@ -0,0 +1,89 @@
+#include "config_response_cache.h"
+
+#include <memory>
+
+#include "../../common/file_cache.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+ConfigDependencyState CaptureConfigDependency(const fs::path& path) {
+    ConfigDependencyState state;
+    state.path = path;
+    std::shared_ptr<const std::string> text;
+    state.version = 0;
+    state.exists = SharedFileContentCache().ReadText(path, text, state.version);
+    return state;
+}
+
+bool ConfigResponseCache::Find(
+    const std::string& app_id,
+    const std::shared_ptr<const void>& generation,
+    std::string& payload_out,
+    long long& age_ms_out) {
+    std::vector<ConfigDependencyState> dependencies;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::map<std::string, Entry>::const_iterator iter = entries_.find(app_id);
+        if (iter == entries_.end()) {
+            return false;
+        }
+        if (iter->second.generation != generation) {
+            entries_.erase(app_id);
+            return false;
+        }
+        dependencies = iter->second.dependencies;
+    }
+
+    // File checks run unlocked; they hit the file cache and only read files that changed.
+    std::size_t index;
+    for (index = 0; index < dependencies.size(); ++index) {
+        const ConfigDependencyState current = CaptureConfigDependency(dependencies[index].path);
+        if (current.exists != dependencies[index].exists || current.version != dependencies[index].version ||
+            (current.exists && current.version == 0)) {
+            Invalidate(app_id);
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::map<std::string, Entry>::const_iterator iter = entries_.find(app_id);
+    if (iter == entries_.end() || iter->second.generation != generation) {
+        return false;
+    }
+    payload_out = iter->second.payload;
+    age_ms_out = static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - iter->second.stored_at).count());
+    return true;
+}
+
+void ConfigResponseCache::Store(
+    const std::string& app_id,
+    const std::shared_ptr<const void>& generation,
+    const std::string& payload,
+    const std::vector<ConfigDependencyState>& dependencies) {
+    std::size_t index;
+    for (index = 0; index < dependencies.size(); ++index) {
+        if (dependencies[index].exists && dependencies[index].version == 0) {
+            // Too large or changing while read; it cannot be validated cheaply.
+            return;
+        }
+    }
+
+    Entry entry;
+    entry.generation = generation;
+    entry.payload = payload;
+    entry.stored_at = std::chrono::steady_clock::now();
+    entry.dependencies = dependencies;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[app_id] = entry;
+}
+
+void ConfigResponseCache::Invalidate(const std::string& app_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(app_id);
+}
+
+}  // namespace Common
+}  // namespace ProcessInterface
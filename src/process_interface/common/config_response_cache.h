@@ -0,0 +1,59 @@
+#ifndef PROCESS_INTERFACE_COMMON_CONFIG_RESPONSE_CACHE_H
+#define PROCESS_INTERFACE_COMMON_CONFIG_RESPONSE_CACHE_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../../common/fs_compat.h"
+
+namespace ProcessInterface {
+namespace Common {
+
+// What a config file looked like when a response was computed. version comes from the
+// shared file cache and is 0 when the file exists but could not be cached.
+struct ConfigDependencyState {
+    fs::path path;
+    bool exists;
+    unsigned long long version;
+};
+
+ConfigDependencyState CaptureConfigDependency(const fs::path& path);
+
+// Compact config.get responses of script-backed apps, reused until one of the files they
+// depend on changes, the catalog is recompiled, or a config.set runs for the app.
+class ConfigResponseCache {
+public:
+    // generation is the compiled catalog the response came from; holding it keeps a
+    // recompiled catalog from reusing its address.
+    bool Find(
+        const std::string& app_id,
+        const std::shared_ptr<const void>& generation,
+        std::string& payload_out,
+        long long& age_ms_out);
+    void Store(
+        const std::string& app_id,
+        const std::shared_ptr<const void>& generation,
+        const std::string& payload,
+        const std::vector<ConfigDependencyState>& dependencies);
+    void Invalidate(const std::string& app_id);
+
+private:
+    struct Entry {
+        std::shared_ptr<const void> generation;
+        std::string payload;
+        std::chrono::steady_clock::time_point stored_at;
+        std::vector<ConfigDependencyState> dependencies;
+    };
+
+    std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+};
+
+}  // namespace Common
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_COMMON_CONFIG_RESPONSE_CACHE_H
@@ -1,17 +1,122 @@
 #include "control_script_runner.h"
 
+#include <algorithm>
+#include <cstdint>
+
 #include "../../../external/nlohmann/json.hpp"
 #include "../../common/time_utils.h"
 #include "action_catalog.h"
 #include "action_executor.h"
 #include "action_jobs.h"
 #include "action_response.h"
+#include "action_result_cache.h"
+#include "config_provider.h"
+#include "config_response_cache.h"
 
 namespace ProcessInterface {
 namespace Common {
 
 namespace {
 
+const std::size_t kActionWorkerCount = 4;
+const std::size_t kJobOutputRingBytes = 64 * 1024;
+const std::size_t kJobOutputDefaultReadBytes = 64 * 1024;
+const std::size_t kJobOutputMaxReadBytes = 1024 * 1024;
+const std::size_t kJobListDefaultLimit = 50;
+const std::size_t kJobListMaxLimit = 500;
+const std::size_t kActionResultCacheEntries = 256;
+
+struct QueuedActionJob {
+    fs::path repo_root;
+    Common::PathTemplateSet path_templates;
+    std::string app_id;
+    std::shared_ptr<const ActionCatalog> catalog;
+    std::string action_name;
+    std::map<std::string, std::string> args_map;
+    double timeout_seconds;
+    ActionJobRecord record;
+    std::shared_ptr<ActionJobQueue> job_queue;
+    std::shared_ptr<ActionJobStore> job_store;
+    std::shared_ptr<ActionJobOutputRegistry> output_registry;
+    std::shared_ptr<Platform::PythonWorkerPool> python_workers;
+    ActionEventSink event_sink;
+    // Set when the action is cacheable and this job leads the flight for flight_key.
+    std::shared_ptr<ActionResultCache> result_cache;
+    double cache_ttl_seconds;
+};
+
+// Identifies a cacheable invocation: app, compiled catalog, action, effective timeout and the
+// rendered args.
+std::string BuildActionFlightKey(
+    const std::string& app_id,
+    const ActionCatalog& catalog,
+    const ActionDefinition& action,
+    const std::map<std::string, std::string>& args_map,
+    double timeout_seconds) {
+    // A timed-out run is only a valid outcome for callers that allowed the same time.
+    const double effective_timeout_seconds = timeout_seconds > 0.0 ? timeout_seconds : action.timeout_seconds;
+    const std::string prefix = app_id + "\n" + std::to_string(reinterpret_cast<std::uintptr_t>(&catalog)) + "\n" +
+        action.name + "\n" + nlohmann::json(effective_timeout_seconds).dump() + "\n";
+
+    // Native actions receive every arg, not just the cmd placeholders.
+    if (action.native) {
+        return prefix + nlohmann::json(args_map).dump();
+    }
+
+    nlohmann::json rendered_args = nlohmann::json::array();
+    std::size_t index;
+    for (index = 0; index < action.required_args.size(); ++index) {
+        const std::map<std::string, std::string>::const_iterator arg = args_map.find(action.required_args[index]);
+        if (arg == args_map.end()) {
+            rendered_args.push_back(nullptr);
+        } else {
+            rendered_args.push_back(arg->second);
+        }
+    }
+    return prefix + rendered_args.dump();
+}
+
+// Ends the flight led by leader_record and gives every attached job the same outcome. A
+// canceled leader says nothing about the invocation, so the first attached job runs it instead.
+void ResolveActionFlight(
+    ActionResultCache& result_cache,
+    ActionJobStore& job_store,
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    const ActionJobRecord& leader_record,
+    double cache_ttl_seconds) {
+    if (leader_record.state == "canceled") {
+        ActionJobRecord next_leader;
+        ActionFlightLauncher launcher;
+        if (result_cache.HandOff(leader_record.job_id, next_leader, launcher) && launcher) {
+            launcher(next_leader);
+        }
+        return;
+    }
+
+    std::vector<ActionJobRecord> waiters;
+    if (!result_cache.Complete(leader_record.job_id, leader_record, cache_ttl_seconds, waiters)) {
+        return;
+    }
+
+    std::size_t index;
+    for (index = 0; index < waiters.size(); ++index) {
+        const ActionJobRecord clone = CloneActionJobResult(leader_record, waiters[index]);
+        if (clone.stdout_truncated) {
+            // Spilled output is read by job id, so each attached job gets its own copy.
+            std::error_code copy_error;
+            fs::copy_file(
+                ResolveActionJobOutputPath(repo_root, path_templates, app_id, leader_record.job_id),
+                ResolveActionJobOutputPath(repo_root, path_templates, app_id, clone.job_id),
+                fs::copy_options::overwrite_existing,
+                copy_error);
+        }
+        std::string error_message;
+        job_store.Write(app_id, clone, error_message);
+    }
+}
+
 bool IsObjectJsonText(const std::string& text) {
     try {
         const nlohmann::json value = nlohmann::json::parse(text);
@@ -32,18 +137,228 @@ std::string CompactObjectJsonOrDefault(const std::string& text) {
     return std::string("{}");
 }
 
+// Gathers file paths from a config_show "paths" value: strings, lists of strings, objects of
+// strings, or objects with a "path" member.
+void CollectConfigPathStrings(const nlohmann::json& value, std::vector<std::string>& paths_out) {
+    const std::size_t kMaxDerivedDependencies = 64;
+    if (paths_out.size() >= kMaxDerivedDependencies) {
+        return;
+    }
+    if (value.is_string()) {
+        if (!value.get<std::string>().empty()) {
+            paths_out.push_back(value.get<std::string>());
+        }
+        return;
+    }
+    if (value.is_array() || value.is_object()) {
+        nlohmann::json::const_iterator iter;
+        for (iter = value.begin(); iter != value.end(); ++iter) {
+            CollectConfigPathStrings(iter.value(), paths_out);
+        }
+    }
+}
+
+// Adds "_debug":{"cached":...,"ageMs":...} to a compact config.get object.
+std::string WithConfigCacheDebug(const std::string& payload, bool cached, long long age_ms) {
+    const std::string debug = std::string("\"_debug\":{\"cached\":") + (cached ? "true" : "false") +
+        ",\"ageMs\":" + std::to_string(age_ms) + "}";
+    if (payload.size() < 2 || payload[0] != '{') {
+        return payload;
+    }
+    return "{" + debug + (payload == "{}" ? std::string() : ",") + payload.substr(1);
+}
+
 bool IsPublicActionName(const std::string& action_name) {
     // Internal control-plane helpers are invoked through dedicated RPC methods.
     return action_name != "config_show" && action_name != "config_set_key";
 }
 
+void ApplyActionRunResult(
+    const ActionRunResult& action_result,
+    const ActionJobControl& control,
+    ActionJobRecord& record) {
+    record.result_json = CompactObjectJsonOrDefault(action_result.payload_json);
+    record.stdout_text = action_result.stdout_text;
+    record.stderr_text = action_result.stderr_text;
+    record.payload_scan_error = action_result.payload_scan_error;
+
+    if (action_result.ok) {
+        record.state = "succeeded";
+        record.has_error = false;
+        record.error_code.clear();
+        record.error_message.clear();
+    } else if (action_result.canceled || action_result.error_code == "action_canceled") {
+        record.state = "canceled";
+        record.canceled_at = control.cancel_requested_at.empty() ? record.finished_at : control.cancel_requested_at;
+        record.has_error = true;
+        record.error_code = "E_ACTION_CANCELED";
+        record.error_message = action_result.error_message.empty() ? "action canceled" : action_result.error_message;
+    } else if (action_result.timed_out || action_result.error_code == "action_timeout") {
+        record.state = "timeout";
+        record.has_error = true;
+        record.error_code = "E_ACTION_TIMEOUT";
+        record.error_message = action_result.error_message.empty() ? "action timed out" : action_result.error_message;
+    } else {
+        record.state = "failed";
+        record.has_error = true;
+        record.error_code = action_result.error_code.empty() ? "E_ACTION_FAILED" : action_result.error_code;
+        record.error_message = action_result.error_message.empty() ? "action failed" : action_result.error_message;
+    }
+}
+
+void RunQueuedActionJob(const QueuedActionJob& job, const ActionJobControl& control) {
+    ActionJobRecord record = job.record;
+    std::string error_message;
+
+    // A cancel that arrives after the queued record is written but before the job is submitted
+    // finds nothing in the queue and records the cancel itself; the job must not run then.
+    ActionJobRecord stored;
+    if (job.job_store->Read(job.app_id, record.job_id, stored, error_message) && IsTerminalJobState(stored.state)) {
+        if (job.result_cache) {
+            ResolveActionFlight(
+                *job.result_cache, *job.job_store, job.repo_root, job.path_templates, job.app_id, stored, 0.0);
+        }
+        return;
+    }
+
+    record.state = "running";
+    record.started_at = CurrentUtcIso8601();
+    job.job_store->Write(job.app_id, record, error_message);
+
+    const std::shared_ptr<ActionJobOutput> output = std::make_shared<ActionJobOutput>(
+        ResolveActionJobOutputPath(job.repo_root, job.path_templates, job.app_id, record.job_id),
+        kJobOutputRingBytes);
+    if (job.event_sink) {
+        const ActionEventSink event_sink = job.event_sink;
+        const std::string app_id = job.app_id;
+        const std::string job_id = record.job_id;
+        output->SetChunkListener([event_sink, app_id, job_id](unsigned long long offset, const char* data, std::size_t size) {
+            event_sink("action.job.output", BuildActionJobOutputEvent(app_id, job_id, offset, std::string(data, size)));
+        });
+    }
+    job.output_registry->Register(record.job_id, output);
+
+    ActionRunResult action_result;
+    if (!ExecuteCatalogAction(
+            *job.catalog,
+            job.python_workers.get(),
+            job.action_name,
+            job.args_map,
+            job.timeout_seconds,
+            &control.cancel_requested,
+            output.get(),
+            action_result,
+            error_message)) {
+        action_result.ok = false;
+        action_result.timed_out = false;
+        action_result.canceled = false;
+        action_result.payload_json = "{}";
+        action_result.error_code = "E_ACTION_FAILED";
+        action_result.error_message = error_message.empty() ? "action failed" : error_message;
+    }
+
+    record.finished_at = CurrentUtcIso8601();
+    ApplyActionRunResult(action_result, control, record);
+    record.stdout_bytes = output->TotalBytes();
+    record.stdout_truncated = output->Spilled();
+    job.job_store->Write(job.app_id, record, error_message);
+
+    // Dropped only after the terminal record is on disk so output readers never see a gap.
+    job.output_registry->Remove(record.job_id);
+
+    if (job.result_cache) {
+        ResolveActionFlight(
+            *job.result_cache, *job.job_store, job.repo_root, job.path_templates, job.app_id, record, job.cache_ttl_seconds);
+    }
+}
+
+// Ends a job whose body threw: drops its live output, records it as failed and resolves its
+// flight, so neither the job nor attached jobs stay "running".
+void FailQueuedActionJob(const QueuedActionJob& job, const std::string& reason) {
+    job.output_registry->Remove(job.record.job_id);
+
+    ActionJobRecord failed = job.record;
+    std::string error_message;
+    ActionJobRecord stored;
+    if (job.job_store->Read(job.app_id, failed.job_id, stored, error_message)) {
+        failed = stored;
+    }
+    // A body that threw after its terminal record was written keeps that outcome.
+    if (!IsTerminalJobState(failed.state)) {
+        failed.state = "failed";
+        failed.finished_at = CurrentUtcIso8601();
+        failed.has_error = true;
+        failed.error_code = "E_ACTION_FAILED";
+        failed.error_message = reason;
+        job.job_store->Write(job.app_id, failed, error_message);
+    }
+
+    if (job.result_cache) {
+        ResolveActionFlight(*job.result_cache, *job.job_store, job.repo_root, job.path_templates, job.app_id, failed, 0.0);
+    }
+}
+
+bool SubmitQueuedActionJob(const QueuedActionJob& job, std::string& error_message) {
+    const ActionJobQueue::JobBody body = [job](const ActionJobControl& control) {
+        RunQueuedActionJob(job, control);
+    };
+    const ActionJobQueue::FailureHandler on_failure = [job](const std::string& reason) {
+        FailQueuedActionJob(job, reason);
+    };
+    return job.job_queue->Submit(job.app_id, job.record.job_id, body, on_failure, error_message);
+}
+
+// Ends the flight led by job.record when that job never got queued, so attached jobs are not
+// stranded.
+void AbandonActionFlight(const QueuedActionJob& job, const std::string& reason) {
+    if (!job.result_cache) {
+        return;
+    }
+    ActionJobRecord failed = job.record;
+    failed.state = "failed";
+    failed.finished_at = CurrentUtcIso8601();
+    failed.has_error = true;
+    failed.error_code = "E_ACTION_FAILED";
+    failed.error_message = reason;
+    ResolveActionFlight(*job.result_cache, *job.job_store, job.repo_root, job.path_templates, job.app_id, failed, 0.0);
+}
+
+// Runs a job that took over a flight from a canceled leader.
+void LaunchActionFlightLeader(const QueuedActionJob& job_template, const ActionJobRecord& next_leader) {
+    QueuedActionJob job = job_template;
+    job.record = next_leader;
+    std::string error_message;
+    if (!SubmitQueuedActionJob(job, error_message)) {
+        ActionJobRecord failed = next_leader;
+        failed.state = "failed";
+        failed.finished_at = CurrentUtcIso8601();
+        failed.has_error = true;
+        failed.error_code = "E_ACTION_FAILED";
+        failed.error_message = error_message;
+        std::string write_error;
+        job.job_store->Write(job.app_id, failed, write_error);
+        AbandonActionFlight(job, error_message);
+    }
+}
+
 }  // namespace
 
 ControlScriptRunner::ControlScriptRunner(
     const std::string& repo_root,
-    const Common::PathTemplateSet& path_templates)
+    const Common::PathTemplateSet& path_templates,
+    const ActionJobStoreOptions& job_store_options)
     : repo_root_(repo_root),
-      path_templates_(path_templates) {}
+      path_templates_(path_templates),
+      job_queue_(std::make_shared<ActionJobQueue>(kActionWorkerCount)),
+      job_store_(std::make_shared<ActionJobStore>(fs::path(repo_root), path_templates, job_store_options)),
+      output_registry_(std::make_shared<ActionJobOutputRegistry>()),
+      python_workers_(std::make_shared<Platform::PythonWorkerPool>(Platform::DefaultPythonWorkerPoolOptions())),
+      config_cache_(std::make_shared<ConfigResponseCache>()),
+      result_cache_(std::make_shared<ActionResultCache>(kActionResultCacheEntries)) {}
+
+void ControlScriptRunner::SetEventSink(const ActionEventSink& event_sink) {
+    event_sink_ = event_sink;
+}
 
 bool ControlScriptRunner::ParseArgsObject(
     const std::string& args_json,
@@ -85,14 +400,8 @@ bool ControlScriptRunner::RunConfigGet(
     const std::string& app_id,
     std::string& json_payload,
     std::string& error_message) const {
-    std::vector<ActionDefinition> actions;
-    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, actions, error_message)) {
-        return false;
-    }
-
-    ActionRunResult action_result;
-    std::map<std::string, std::string> args;
-    if (!ExecuteCatalogAction(repo_root_, actions, "config_show", args, 0.0, action_result, error_message)) {
+    std::shared_ptr<const ActionCatalog> catalog;
+    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, catalog, error_message)) {
         return false;
     }
 
@@ -107,6 +416,39 @@ bool ControlScriptRunner::RunConfigGet(
         return fallback.dump();
     };
 
+    if (catalog->config_provider) {
+        json_payload = BuildNativeConfigGetPayload(repo_root_, *catalog->config_provider);
+        return true;
+    }
+    if (!catalog->config_provider_error.empty()) {
+        json_payload = build_fallback(catalog->config_provider_error);
+        return true;
+    }
+
+    const std::shared_ptr<const void> generation = catalog;
+    std::string cached_payload;
+    long long cached_age_ms = 0;
+    if (config_cache_->Find(app_id, generation, cached_payload, cached_age_ms)) {
+        json_payload = WithConfigCacheDebug(cached_payload, true, cached_age_ms);
+        return true;
+    }
+
+    // Declared dependencies are captured before the run so an edit racing it is seen next time.
+    std::vector<ConfigDependencyState> dependencies;
+    const ActionDefinition* show_action = catalog->Find("config_show");
+    if (show_action != NULL) {
+        std::size_t index;
+        for (index = 0; index < show_action->depends_on.size(); ++index) {
+            dependencies.push_back(CaptureConfigDependency(show_action->depends_on[index]));
+        }
+    }
+
+    ActionRunResult action_result;
+    std::map<std::string, std::string> args;
+    if (!ExecuteCatalogAction(*catalog, python_workers_.get(), "config_show", args, 0.0, NULL, NULL, action_result, error_message)) {
+        return false;
+    }
+
     if (!action_result.ok) {
         json_payload = build_fallback(action_result.error_message.empty() ? "config.get failed" : action_result.error_message);
         error_message.clear();
@@ -119,7 +461,28 @@ bool ControlScriptRunner::RunConfigGet(
         return true;
     }
 
-    json_payload = CompactObjectJsonOrDefault(action_result.payload_json);
+    const nlohmann::json payload = nlohmann::json::parse(action_result.payload_json);
+    if (show_action != NULL && show_action->depends_on.empty() && payload.contains("paths")) {
+        std::vector<std::string> path_texts;
+        CollectConfigPathStrings(payload["paths"], path_texts);
+        std::size_t index;
+        for (index = 0; index < path_texts.size(); ++index) {
+            fs::path dependency(path_texts[index]);
+            if (dependency.is_relative()) {
+                dependency = repo_root_ / dependency;
+            }
+            std::error_code status_error;
+            if (fs::is_regular_file(dependency, status_error)) {
+                dependencies.push_back(CaptureConfigDependency(dependency));
+            }
+        }
+    }
+
+    json_payload = payload.dump();
+    if (!dependencies.empty()) {
+        config_cache_->Store(app_id, generation, json_payload, dependencies);
+    }
+    json_payload = WithConfigCacheDebug(json_payload, false, 0);
     return true;
 }
 
@@ -129,17 +492,155 @@ bool ControlScriptRunner::RunConfigSet(
     const std::string& value,
     std::string& json_payload,
     std::string& error_message) const {
-    std::vector<ActionDefinition> actions;
-    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, actions, error_message)) {
+    std::shared_ptr<const ActionCatalog> catalog;
+    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, catalog, error_message)) {
+        return false;
+    }
+
+    if (catalog->config_provider || !catalog->config_provider_error.empty()) {
+        if (!catalog->config_provider) {
+            error_message = "config invalid: " + catalog->config_provider_error;
+            return false;
+        }
+        std::vector<std::pair<std::string, std::string> > values;
+        values.push_back(std::make_pair(key, value));
+        nlohmann::json response;
+        if (!ApplyNativeConfigSet(
+                *catalog->config_provider,
+                values,
+                "key",
+                ResolveStatusSnapshotPath(app_id),
+                response,
+                error_message)) {
+            return false;
+        }
+        response["key"] = key;
+        response["value"] = response["values"][key];
+        response.erase("values");
+        json_payload = response.dump();
+        return true;
+    }
+
+    return RunConfigSetAction(*catalog, app_id, key, value, json_payload, error_message);
+}
+
+bool ControlScriptRunner::RunConfigSetMany(
+    const std::string& app_id,
+    const std::string& values_json,
+    std::string& json_payload,
+    std::string& error_message) const {
+    nlohmann::json values_object;
+    try {
+        values_object = nlohmann::json::parse(values_json.empty() ? "{}" : values_json);
+    } catch (const std::exception&) {
+        values_object = nlohmann::json();
+    }
+    if (!values_object.is_object() || values_object.empty()) {
+        error_message = "bad values: must be a non-empty object of key/value pairs";
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::string> > values;
+    nlohmann::json::const_iterator iter;
+    for (iter = values_object.begin(); iter != values_object.end(); ++iter) {
+        values.push_back(std::make_pair(
+            iter.key(),
+            iter.value().is_string() ? iter.value().get<std::string>() : iter.value().dump()));
+    }
+
+    std::shared_ptr<const ActionCatalog> catalog;
+    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, catalog, error_message)) {
         return false;
     }
 
+    if (catalog->config_provider) {
+        nlohmann::json response;
+        if (!ApplyNativeConfigSet(
+                *catalog->config_provider,
+                values,
+                "values",
+                ResolveStatusSnapshotPath(app_id),
+                response,
+                error_message)) {
+            return false;
+        }
+        json_payload = response.dump();
+        return true;
+    }
+    if (!catalog->config_provider_error.empty()) {
+        error_message = "config invalid: " + catalog->config_provider_error;
+        return false;
+    }
+
+    // Script-backed apps get one config_set_key run per key, in key order; the batch stops
+    // at the first key the script rejects and is not atomic.
+    nlohmann::json response;
+    response["changed"] = false;
+    response["changedKeys"] = nlohmann::json::array();
+    response["filePath"] = "";
+    response["restartRequired"] = false;
+    response["restartKeys"] = nlohmann::json::array();
+    response["pidAtSet"] = nullptr;
+    response["results"] = nlohmann::json::object();
+
+    std::size_t index;
+    for (index = 0; index < values.size(); ++index) {
+        std::string key_payload;
+        if (!RunConfigSetAction(*catalog, app_id, values[index].first, values[index].second, key_payload, error_message)) {
+            return false;
+        }
+
+        const nlohmann::json key_result = nlohmann::json::parse(key_payload, NULL, false);
+        response["results"][values[index].first] = key_result.is_object() ? key_result : nlohmann::json::object();
+        if (!key_result.is_object()) {
+            continue;
+        }
+        if (key_result.contains("changed") && key_result["changed"].is_boolean() && key_result["changed"].get<bool>()) {
+            response["changed"] = true;
+            response["changedKeys"].push_back(values[index].first);
+        }
+        if (key_result.contains("restartRequired") && key_result["restartRequired"].is_boolean() &&
+            key_result["restartRequired"].get<bool>()) {
+            response["restartRequired"] = true;
+            response["restartKeys"].push_back(values[index].first);
+        }
+        if (response["filePath"] == "" && key_result.contains("filePath") && key_result["filePath"].is_string()) {
+            response["filePath"] = key_result["filePath"];
+        }
+        if (response["pidAtSet"].is_null() && key_result.contains("pidAtSet")) {
+            response["pidAtSet"] = key_result["pidAtSet"];
+        }
+        if (key_result.contains("ok") && key_result["ok"].is_boolean() && !key_result["ok"].get<bool>()) {
+            response["message"] = "config_set_key failed for " + values[index].first;
+            json_payload = response.dump();
+            return true;
+        }
+    }
+
+    response["message"] = "updated " + std::to_string(response["changedKeys"].size()) + " of " +
+        std::to_string(values.size()) + " keys";
+    json_payload = response.dump();
+    return true;
+}
+
+bool ControlScriptRunner::RunConfigSetAction(
+    const ActionCatalog& catalog,
+    const std::string& app_id,
+    const std::string& key,
+    const std::string& value,
+    std::string& json_payload,
+    std::string& error_message) const {
     ActionRunResult action_result;
     std::map<std::string, std::string> args;
     args["key"] = key;
     args["value"] = value;
 
-    if (!ExecuteCatalogAction(repo_root_, actions, "config_set_key", args, 0.0, action_result, error_message)) {
+    const bool ran = ExecuteCatalogAction(
+        catalog, python_workers_.get(), "config_set_key", args, 0.0, NULL, NULL, action_result, error_message);
+    // The script may have written files config_show does not declare; drop the cached view
+    // even when the set reports failure.
+    config_cache_->Invalidate(app_id);
+    if (!ran) {
         return false;
     }
 
@@ -160,15 +661,25 @@ bool ControlScriptRunner::RunConfigSet(
     return true;
 }
 
+fs::path ControlScriptRunner::ResolveStatusSnapshotPath(const std::string& app_id) const {
+    const Common::PathTemplateArgs path_args = {
+        repo_root_.string(),
+        app_id,
+        std::string(),
+    };
+    return Common::RenderTemplatePath(path_templates_.status_snapshot_path, path_args);
+}
+
 bool ControlScriptRunner::RunActionList(
     const std::string& app_id,
     std::string& json_payload,
     std::string& error_message) const {
-    std::vector<ActionDefinition> actions;
-    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, actions, error_message)) {
+    std::shared_ptr<const ActionCatalog> catalog;
+    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, catalog, error_message)) {
         return false;
     }
 
+    const std::vector<ActionDefinition>& actions = catalog->actions;
     nlohmann::json response;
     response["actions"] = nlohmann::json::array();
 
@@ -206,8 +717,8 @@ bool ControlScriptRunner::RunActionInvoke(
     double timeout_seconds,
     std::string& json_payload,
     std::string& error_message) const {
-    std::vector<ActionDefinition> actions;
-    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, actions, error_message)) {
+    std::shared_ptr<const ActionCatalog> catalog;
+    if (!LoadActionCatalog(repo_root_, path_templates_, app_id, catalog, error_message)) {
         return false;
     }
 
@@ -219,42 +730,77 @@ bool ControlScriptRunner::RunActionInvoke(
 
     const std::string accepted_at = CurrentUtcIso8601();
 
-    ActionRunResult action_result;
-    if (!ExecuteCatalogAction(repo_root_, actions, action_name, args_map, timeout_seconds, action_result, error_message)) {
-        return false;
-    }
-
     ActionJobRecord record;
     record.job_id = GenerateJobId();
+    record.action_name = action_name;
+    record.state = "queued";
     record.accepted_at = accepted_at;
-    record.started_at = accepted_at;
-    record.finished_at = CurrentUtcIso8601();
-    record.result_json = CompactObjectJsonOrDefault(action_result.payload_json);
-    record.stdout_text = action_result.stdout_text;
-    record.stderr_text = action_result.stderr_text;
+    record.result_json = "{}";
+    record.stdout_bytes = 0;
+    record.stdout_truncated = false;
+    record.has_error = false;
+
+    const ActionDefinition* action = catalog->Find(action_name);
+    const bool cacheable = action != NULL && action->cacheable;
+
+    QueuedActionJob job;
+    job.repo_root = repo_root_;
+    job.path_templates = path_templates_;
+    job.app_id = app_id;
+    job.catalog = catalog;
+    job.action_name = action_name;
+    job.args_map = args_map;
+    job.timeout_seconds = timeout_seconds;
+    job.record = record;
+    job.job_queue = job_queue_;
+    job.job_store = job_store_;
+    job.output_registry = output_registry_;
+    job.python_workers = python_workers_;
+    job.event_sink = event_sink_;
+    if (cacheable) {
+        job.result_cache = result_cache_;
+    }
+    job.cache_ttl_seconds = cacheable ? action->cache_ttl_seconds : 0.0;
+
+    if (cacheable) {
+        const ActionFlightLauncher launcher = [job](const ActionJobRecord& next_leader) {
+            LaunchActionFlightLeader(job, next_leader);
+        };
+        ActionJobRecord cached;
+        const ActionAdmission admission = result_cache_->Admit(
+            BuildActionFlightKey(app_id, *catalog, *action, args_map, timeout_seconds), catalog, record, launcher, cached);
+        if (admission == ActionAdmission::kCached) {
+            ActionJobRecord clone = CloneActionJobResult(cached, record);
+            clone.started_at = accepted_at;
+            clone.finished_at = accepted_at;
+            if (!job_store_->Write(app_id, clone, error_message)) {
+                return false;
+            }
+            json_payload = BuildActionInvokeAcceptedResponse(clone.job_id, clone.state, accepted_at);
+            error_message.clear();
+            return true;
+        }
+        if (admission == ActionAdmission::kJoined) {
+            if (!job_store_->Write(app_id, record, error_message)) {
+                return false;
+            }
+            json_payload = BuildActionInvokeAcceptedResponse(record.job_id, record.state, accepted_at);
+            error_message.clear();
+            return true;
+        }
+    }
 
-    if (action_result.ok) {
-        record.state = "succeeded";
-        record.has_error = false;
-        record.error_code.clear();
-        record.error_message.clear();
-    } else if (action_result.timed_out || action_result.error_code == "action_timeout") {
-        record.state = "timeout";
-        record.has_error = true;
-        record.error_code = "E_ACTION_TIMEOUT";
-        record.error_message = action_result.error_message.empty() ? "action timed out" : action_result.error_message;
-    } else {
-        record.state = "failed";
-        record.has_error = true;
-        record.error_code = action_result.error_code.empty() ? "E_ACTION_FAILED" : action_result.error_code;
-        record.error_message = action_result.error_message.empty() ? "action failed" : action_result.error_message;
+    if (!job_store_->Write(app_id, record, error_message)) {
+        AbandonActionFlight(job, error_message);
+        return false;
     }
 
-    if (!WriteActionJobRecord(repo_root_, path_templates_, app_id, record, error_message)) {
+    if (!SubmitQueuedActionJob(job, error_message)) {
+        AbandonActionFlight(job, error_message);
         return false;
     }
 
-    json_payload = BuildActionInvokeAcceptedResponse(record.job_id, accepted_at);
+    json_payload = BuildActionInvokeAcceptedResponse(record.job_id, record.state, accepted_at);
     error_message.clear();
     return true;
 }
@@ -265,7 +811,7 @@ bool ControlScriptRunner::RunActionJobGet(
     std::string& json_payload,
     std::string& error_message) const {
     ActionJobRecord record;
-    if (!ReadActionJobRecord(repo_root_, path_templates_, app_id, job_id, record, error_message)) {
+    if (!job_store_->Read(app_id, job_id, record, error_message)) {
         return false;
     }
 
@@ -274,10 +820,167 @@ bool ControlScriptRunner::RunActionJobGet(
     return true;
 }
 
+bool ControlScriptRunner::RunActionJobCancel(
+    const std::string& app_id,
+    const std::string& job_id,
+    std::string& json_payload,
+    std::string& error_message) const {
+    ActionJobRecord record;
+    if (!job_store_->Read(app_id, job_id, record, error_message)) {
+        return false;
+    }
+
+    const std::string requested_at = CurrentUtcIso8601();
+    if (IsTerminalJobState(record.state)) {
+        json_payload = BuildActionJobCancelResponse(record.job_id, record.state, false, requested_at);
+        error_message.clear();
+        return true;
+    }
+
+    // A job attached to an identical in-flight run is detached; the shared run keeps going.
+    ActionJobRecord waiter;
+    if (result_cache_->DetachWaiter(job_id, waiter)) {
+        waiter.state = "canceled";
+        waiter.finished_at = requested_at;
+        waiter.canceled_at = requested_at;
+        waiter.has_error = true;
+        waiter.error_code = "E_ACTION_CANCELED";
+        waiter.error_message = "action canceled before start";
+        if (!job_store_->Write(app_id, waiter, error_message)) {
+            return false;
+        }
+        json_payload = BuildActionJobCancelResponse(waiter.job_id, waiter.state, true, requested_at);
+        error_message.clear();
+        return true;
+    }
+
+    const ActionJobCancelOutcome outcome = job_queue_->Cancel(app_id, job_id, requested_at);
+    if (outcome == ActionJobCancelOutcome::kSignaledRunning) {
+        // The worker records the terminal canceled state once the process group is gone.
+        json_payload = BuildActionJobCancelResponse(record.job_id, "running", true, requested_at);
+        error_message.clear();
+        return true;
+    }
+
+    if (outcome == ActionJobCancelOutcome::kNotActive) {
+        // The job may have finished between the read and the cancel; recheck before overriding it.
+        if (job_store_->Read(app_id, job_id, record, error_message) &&
+            IsTerminalJobState(record.state)) {
+            json_payload = BuildActionJobCancelResponse(record.job_id, record.state, false, requested_at);
+            error_message.clear();
+            return true;
+        }
+    }
+
+    // Either removed before start, or orphaned by a previous host instance.
+    record.state = "canceled";
+    record.finished_at = requested_at;
+    record.canceled_at = requested_at;
+    record.has_error = true;
+    record.error_code = "E_ACTION_CANCELED";
+    record.error_message = outcome == ActionJobCancelOutcome::kRemovedQueued
+        ? "action canceled before start"
+        : "action canceled; job was not active in this host";
+
+    if (!job_store_->Write(app_id, record, error_message)) {
+        return false;
+    }
+    if (outcome == ActionJobCancelOutcome::kRemovedQueued) {
+        // A cacheable job canceled before start may lead a flight; an attached job takes it over.
+        ResolveActionFlight(*result_cache_, *job_store_, repo_root_, path_templates_, app_id, record, 0.0);
+    }
+
+    json_payload = BuildActionJobCancelResponse(record.job_id, record.state, true, requested_at);
+    error_message.clear();
+    return true;
+}
+
+bool ControlScriptRunner::RunActionJobOutput(
+    const std::string& app_id,
+    const std::string& job_id,
+    unsigned long long offset,
+    std::size_t max_bytes,
+    std::string& json_payload,
+    std::string& error_message) const {
+    // Looked up before the record: a job that finishes in between then still has its terminal
+    // record on disk, since the runner drops live output only after writing it.
+    const std::shared_ptr<ActionJobOutput> live_output = output_registry_->Find(job_id);
+    ActionJobRecord record;
+    if (!job_store_->Read(app_id, job_id, record, error_message)) {
+        return false;
+    }
+
+    const std::size_t read_bytes = max_bytes == 0
+        ? kJobOutputDefaultReadBytes
+        : std::min(max_bytes, kJobOutputMaxReadBytes);
+
+    std::string data;
+    unsigned long long total_bytes = 0;
+    if (live_output) {
+        if (!live_output->Read(offset, read_bytes, data, error_message)) {
+            return false;
+        }
+        total_bytes = live_output->TotalBytes();
+    } else if (record.stdout_truncated) {
+        const fs::path output_path = ResolveActionJobOutputPath(repo_root_, path_templates_, app_id, job_id);
+        if (!ReadActionJobOutputFile(output_path, offset, read_bytes, data, total_bytes, error_message)) {
+            return false;
+        }
+    } else {
+        total_bytes = record.stdout_text.size();
+        if (offset < total_bytes) {
+            data = record.stdout_text.substr(static_cast<std::size_t>(offset), read_bytes);
+        }
+    }
+
+    json_payload = BuildActionJobOutputResponse(record.job_id, record.state, offset, data, total_bytes);
+    error_message.clear();
+    return true;
+}
+
+bool ControlScriptRunner::RunActionJobList(
+    const std::string& app_id,
+    const std::string& action_name,
+    const std::string& state,
+    const std::string& since,
+    const std::string& until,
+    const std::string& cursor,
+    std::size_t limit,
+    std::string& json_payload,
+    std::string& error_message) const {
+    ActionJobListQuery query;
+    query.action_name = action_name;
+    query.state = state;
+    query.since_epoch_ms = -1;
+    query.until_epoch_ms = -1;
+    query.cursor = cursor;
+    query.limit = limit == 0 ? kJobListDefaultLimit : std::min(limit, kJobListMaxLimit);
+
+    if (!since.empty() && !ParseUtcIso8601(since, query.since_epoch_ms)) {
+        error_message = "bad since: expected UTC ISO-8601 timestamp";
+        return false;
+    }
+    if (!until.empty() && !ParseUtcIso8601(until, query.until_epoch_ms)) {
+        error_message = "bad until: expected UTC ISO-8601 timestamp";
+        return false;
+    }
+
+    std::vector<ActionJobSummary> jobs;
+    std::string next_cursor;
+    if (!job_store_->List(app_id, query, jobs, next_cursor, error_message)) {
+        return false;
+    }
+
+    json_payload = BuildActionJobListResponse(jobs, next_cursor);
+    error_message.clear();
+    return true;
+}
+
 ControlScriptRunner CreateControlScriptRunner(
     const std::string& repo_root,
-    const Common::PathTemplateSet& path_templates) {
-    return ControlScriptRunner(repo_root, path_templates);
+    const Common::PathTemplateSet& path_templates,
+    const ActionJobStoreOptions& job_store_options) {
+    return ControlScriptRunner(repo_root, path_templates, job_store_options);
 }
 
 }  // namespace Common
@@ -1,19 +1,37 @@
 #ifndef PROCESS_INTERFACE_COMMON_CONTROL_SCRIPT_RUNNER_H
 #define PROCESS_INTERFACE_COMMON_CONTROL_SCRIPT_RUNNER_H
 
+#include <cstddef>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "../../common/fs_compat.h"
 #include "../../common/path_templates.h"
+#include "../../platform/python_worker_pool.h"
+#include "action_catalog.h"
+#include "action_job_output.h"
+#include "action_job_queue.h"
+#include "action_job_store.h"
+#include "action_result_cache.h"
+#include "config_response_cache.h"
 
 namespace ProcessInterface {
 namespace Common {
 
+// Receives event name and single-line event JSON (e.g. action.job.output chunks) from worker threads.
+typedef std::function<void(const std::string&, const std::string&)> ActionEventSink;
+
 class ControlScriptRunner {
 public:
-    ControlScriptRunner(const std::string& repo_root, const Common::PathTemplateSet& path_templates);
+    ControlScriptRunner(
+        const std::string& repo_root,
+        const Common::PathTemplateSet& path_templates,
+        const ActionJobStoreOptions& job_store_options);
+
+    void SetEventSink(const ActionEventSink& event_sink);
 
     bool RunConfigGet(const std::string& app_id, std::string& json_payload, std::string& error_message) const;
     bool RunConfigSet(
@@ -22,6 +40,13 @@ public:
         const std::string& value,
         std::string& json_payload,
         std::string& error_message) const;
+    // values_json is an object of key -> value; a native config provider applies it in one
+    // atomic write, script-backed apps run config_set_key once per key.
+    bool RunConfigSetMany(
+        const std::string& app_id,
+        const std::string& values_json,
+        std::string& json_payload,
+        std::string& error_message) const;
     bool RunActionList(const std::string& app_id, std::string& json_payload, std::string& error_message) const;
     bool RunActionInvoke(
         const std::string& app_id,
@@ -35,20 +60,60 @@ public:
         const std::string& job_id,
         std::string& json_payload,
         std::string& error_message) const;
+    bool RunActionJobOutput(
+        const std::string& app_id,
+        const std::string& job_id,
+        unsigned long long offset,
+        std::size_t max_bytes,
+        std::string& json_payload,
+        std::string& error_message) const;
+    // since/until are optional UTC ISO-8601 timestamps; limit 0 selects the default page size.
+    bool RunActionJobList(
+        const std::string& app_id,
+        const std::string& action_name,
+        const std::string& state,
+        const std::string& since,
+        const std::string& until,
+        const std::string& cursor,
+        std::size_t limit,
+        std::string& json_payload,
+        std::string& error_message) const;
+    bool RunActionJobCancel(
+        const std::string& app_id,
+        const std::string& job_id,
+        std::string& json_payload,
+        std::string& error_message) const;
 
 private:
     bool ParseArgsObject(
         const std::string& args_json,
         std::map<std::string, std::string>& args_out,
         std::string& error_message) const;
+    bool RunConfigSetAction(
+        const ActionCatalog& catalog,
+        const std::string& app_id,
+        const std::string& key,
+        const std::string& value,
+        std::string& json_payload,
+        std::string& error_message) const;
+    fs::path ResolveStatusSnapshotPath(const std::string& app_id) const;
 
     fs::path repo_root_;
     Common::PathTemplateSet path_templates_;
+    // Shared by copies of the runner so every handler sees the same in-flight jobs.
+    std::shared_ptr<ActionJobQueue> job_queue_;
+    std::shared_ptr<ActionJobStore> job_store_;
+    std::shared_ptr<ActionJobOutputRegistry> output_registry_;
+    std::shared_ptr<Platform::PythonWorkerPool> python_workers_;
+    std::shared_ptr<ConfigResponseCache> config_cache_;
+    std::shared_ptr<ActionResultCache> result_cache_;
+    ActionEventSink event_sink_;
 };
 
 ControlScriptRunner CreateControlScriptRunner(
     const std::string& repo_root,
-    const Common::PathTemplateSet& path_templates);
+    const Common::PathTemplateSet& path_templates,
+    const ActionJobStoreOptions& job_store_options);
 
 }  // namespace Common
 }  // namespace ProcessInterface
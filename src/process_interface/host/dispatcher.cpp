@@ -18,6 +18,9 @@ const char* kUnsupportedApp = "E_UNSUPPORTED_APP";
 const char* kUnsupportedMethod = "E_UNSUPPORTED_METHOD";
 const char* kInternal = "E_INTERNAL";
 const char* kNotFound = "E_NOT_FOUND";
+const char* kConfigInvalid = "E_CONFIG_INVALID";
+
+const int kMaxStatusDeadlineMs = 600000;
 
 enum class ParamKey {
     kAppId,
@@ -53,6 +56,32 @@ RouteResult MakeError(
     return result;
 }
 
+// Runner reports invalid params as "bad <param>: <reason>" and rejected config values as
+// "config invalid: <key>: <reason>".
+bool MapRunnerParamError(const std::string& error_message, RouteResult& result_out) {
+    if (error_message.find("bad ") == 0 && error_message.find(':') != std::string::npos) {
+        const std::string::size_type separator = error_message.find(':');
+        const std::string param = error_message.substr(4, separator - 4);
+        result_out = MakeError(
+            kBadArg,
+            "params." + param + error_message.substr(separator),
+            "{\"param\":\"" + gpi::JsonEscape(param) + "\"}");
+        return true;
+    }
+
+    const std::string config_prefix = "config invalid: ";
+    if (error_message.find(config_prefix) == 0) {
+        const std::string detail = error_message.substr(config_prefix.size());
+        const std::string::size_type separator = detail.find(": ");
+        result_out = MakeError(
+            kConfigInvalid,
+            detail,
+            separator == std::string::npos ? "{}" : "{\"key\":\"" + gpi::JsonEscape(detail.substr(0, separator)) + "\"}");
+        return true;
+    }
+    return false;
+}
+
 bool IsAllowedApp(const HostContext& context, const std::string& app_id) {
     std::size_t index = 0;
     for (index = 0; index < context.allowed_app_ids.size(); ++index) {
@@ -107,8 +136,19 @@ RouteResult HandlePing(const gpi::WireRequest&, const HostContext&) {
 }
 
 RouteResult HandleStatusGet(const gpi::WireRequest& request, const HostContext& context) {
+    int deadline_ms = context.status_deadline_ms;
+    if (request.deadline_ms > 0) {
+        deadline_ms = request.deadline_ms > static_cast<unsigned long long>(kMaxStatusDeadlineMs)
+                          ? kMaxStatusDeadlineMs
+                          : static_cast<int>(request.deadline_ms);
+    }
+    // A field subset is a partial payload, which must not replace the published snapshot.
     const ProcessInterface::Status::StatusResult status_result =
-        ProcessInterface::Status::CollectAndPublishStatus(context.repo_root, request.app_id, context.path_templates);
+        request.has_fields
+            ? ProcessInterface::Status::CollectStatusFields(
+                  context.repo_root, request.app_id, context.path_templates, deadline_ms, request.fields)
+            : ProcessInterface::Status::CollectAndPublishStatus(
+                  context.repo_root, request.app_id, context.path_templates, deadline_ms);
     if (!status_result.ok) {
         return MakeError(
             ProcessInterface::Status::ToIpcErrorCode(status_result.error_code),
@@ -131,11 +171,28 @@ RouteResult HandleConfigSet(const gpi::WireRequest& request, const HostContext&
     std::string response_json;
     std::string error_message;
     if (!context.control_runner.RunConfigSet(request.app_id, request.key, request.value, response_json, error_message)) {
+        RouteResult mapped;
+        if (MapRunnerParamError(error_message, mapped)) {
+            return mapped;
+        }
         return MakeError(kInternal, error_message.empty() ? "config.set failed" : error_message, "{}");
     }
     return MakeOk(response_json);
 }
 
+RouteResult HandleConfigSetMany(const gpi::WireRequest& request, const HostContext& context) {
+    std::string response_json;
+    std::string error_message;
+    if (!context.control_runner.RunConfigSetMany(request.app_id, request.values_json, response_json, error_message)) {
+        RouteResult mapped;
+        if (MapRunnerParamError(error_message, mapped)) {
+            return mapped;
+        }
+        return MakeError(kInternal, error_message.empty() ? "config.setMany failed" : error_message, "{}");
+    }
+    return MakeOk(response_json);
+}
+
 RouteResult HandleActionList(const gpi::WireRequest& request, const HostContext& context) {
     std::string response_json;
     std::string error_message;
@@ -175,6 +232,58 @@ RouteResult HandleActionJobGet(const gpi::WireRequest& request, const HostContex
     return MakeOk(response_json);
 }
 
+RouteResult HandleActionJobCancel(const gpi::WireRequest& request, const HostContext& context) {
+    std::string response_json;
+    std::string error_message;
+    if (!context.control_runner.RunActionJobCancel(request.app_id, request.job_id, response_json, error_message)) {
+        if (error_message == "job not found") {
+            return MakeError(kNotFound, "job not found", "{\"jobId\":\"" + gpi::JsonEscape(request.job_id) + "\"}");
+        }
+        return MakeError(kInternal, error_message.empty() ? "action.job.cancel failed" : error_message, "{}");
+    }
+    return MakeOk(response_json);
+}
+
+RouteResult HandleActionJobOutput(const gpi::WireRequest& request, const HostContext& context) {
+    std::string response_json;
+    std::string error_message;
+    if (!context.control_runner.RunActionJobOutput(
+            request.app_id,
+            request.job_id,
+            request.offset,
+            request.max_bytes,
+            response_json,
+            error_message)) {
+        if (error_message == "job not found") {
+            return MakeError(kNotFound, "job not found", "{\"jobId\":\"" + gpi::JsonEscape(request.job_id) + "\"}");
+        }
+        return MakeError(kInternal, error_message.empty() ? "action.job.output failed" : error_message, "{}");
+    }
+    return MakeOk(response_json);
+}
+
+RouteResult HandleActionJobList(const gpi::WireRequest& request, const HostContext& context) {
+    std::string response_json;
+    std::string error_message;
+    if (!context.control_runner.RunActionJobList(
+            request.app_id,
+            request.action_name,
+            request.state,
+            request.since,
+            request.until,
+            request.cursor,
+            request.limit,
+            response_json,
+            error_message)) {
+        RouteResult mapped;
+        if (MapRunnerParamError(error_message, mapped)) {
+            return mapped;
+        }
+        return MakeError(kInternal, error_message.empty() ? "action.job.list failed" : error_message, "{}");
+    }
+    return MakeOk(response_json);
+}
+
 const MethodSpec kMethodSpecs[] = {
     {"ping", {}, &HandlePing},
     {"status.get", {ParamKey::kAppId}, &HandleStatusGet},
@@ -183,6 +292,10 @@ const MethodSpec kMethodSpecs[] = {
     {"action.list", {ParamKey::kAppId}, &HandleActionList},
     {"action.invoke", {ParamKey::kAppId, ParamKey::kActionName}, &HandleActionInvoke},
     {"action.job.get", {ParamKey::kAppId, ParamKey::kJobId}, &HandleActionJobGet},
+    {"action.job.cancel", {ParamKey::kAppId, ParamKey::kJobId}, &HandleActionJobCancel},
+    {"action.job.output", {ParamKey::kAppId, ParamKey::kJobId}, &HandleActionJobOutput},
+    {"action.job.list", {ParamKey::kAppId}, &HandleActionJobList},
+    {"config.setMany", {ParamKey::kAppId}, &HandleConfigSetMany},
 };
 
 const std::unordered_map<std::string, MethodSpec> kMethodMap = {
@@ -193,6 +306,10 @@ const std::unordered_map<std::string, MethodSpec> kMethodMap = {
     {"action.list", kMethodSpecs[4]},
     {"action.invoke", kMethodSpecs[5]},
     {"action.job.get", kMethodSpecs[6]},
+    {"action.job.cancel", kMethodSpecs[7]},
+    {"action.job.output", kMethodSpecs[8]},
+    {"action.job.list", kMethodSpecs[9]},
+    {"config.setMany", kMethodSpecs[10]},
 };
 
 }  // namespace
@@ -16,6 +16,8 @@ struct HostContext {
     std::vector<std::string> allowed_app_ids;
     Common::PathTemplateSet path_templates;
     Common::ControlScriptRunner control_runner;
+    // Profile "statusDeadlineMs"; status.get params.deadlineMs overrides it. 0 means none.
+    int status_deadline_ms;
 };
 
 struct RouteResult {
@@ -1,5 +1,8 @@
 #include "api.h"
 
+#include <sstream>
+
+#include "../common/file_cache.h"
 #include "context.h"
 #include "debug.h"
 #include "probes.h"
@@ -14,9 +17,18 @@ StatusResult CollectAndPublishStatus(
     const fs::path& repo_root,
     const std::string& app_id,
     const Common::PathTemplateSet& path_templates) {
+    return CollectAndPublishStatus(repo_root, app_id, path_templates, 0);
+}
+
+StatusResult CollectAndPublishStatus(
+    const fs::path& repo_root,
+    const std::string& app_id,
+    const Common::PathTemplateSet& path_templates,
+    int deadline_ms) {
     StatusResult result;
     result.ok = false;
     result.error_code = StatusErrorCode::kCollectFailed;
+    result.payload_unchanged = false;
 
     StatusSpec spec;
     std::string error_message;
@@ -32,16 +44,19 @@ StatusResult CollectAndPublishStatus(
     context.repo_root = repo_root;
     PlatformStatusProbes probes;
     context.probes = &probes;
+    context.deadline_ms = deadline_ms > 0 ? deadline_ms : 0;
 
     std::string payload_json;
-    rc = ExecuteStatusSpec(spec, context, payload_json, error_message);
+    StatusChangeSet changes;
+    rc = ExecuteStatusSpec(spec, context, payload_json, changes, error_message);
     if (rc != StatusErrorCode::kNone) {
         result.error_code = rc;
         result.error_message = error_message;
         return result;
     }
 
-    rc = WriteSnapshotEnvelope(repo_root, path_templates, app_id, payload_json, error_message);
+    rc = WriteSnapshotEnvelope(
+        repo_root, path_templates, app_id, payload_json, SnapshotPayloadSource::kStatusEngine, error_message);
     if (rc != StatusErrorCode::kNone) {
         result.error_code = rc;
         result.error_message = error_message;
@@ -49,7 +64,64 @@ StatusResult CollectAndPublishStatus(
     }
 
     if (DebugEnabled()) {
-        DebugLog("status snapshot written for appId=" + app_id);
+        std::ostringstream changes_stream;
+        changes_stream << "status snapshot written for appId=" << app_id
+                       << " evaluatedOps=" << changes.evaluated_operations << "/" << spec.operations.size()
+                       << " changedFields=" << changes.fields.size();
+        DebugLog(changes_stream.str());
+        const Common::FileCacheStats cache_stats = Common::SharedFileContentCache().Stats();
+        std::ostringstream stats_stream;
+        stats_stream << "file cache hits=" << cache_stats.hits
+                     << " misses=" << cache_stats.misses
+                     << " invalidations=" << cache_stats.invalidations
+                     << " evictions=" << cache_stats.evictions
+                     << " entries=" << cache_stats.entries
+                     << " bytes=" << cache_stats.bytes
+                     << " inotify=" << (cache_stats.inotify ? "yes" : "no");
+        DebugLog(stats_stream.str());
+    }
+
+    result.ok = true;
+    result.error_code = StatusErrorCode::kNone;
+    result.payload_json = payload_json;
+    result.payload_unchanged = changes.unchanged;
+    result.changed_fields.swap(changes.fields);
+    return result;
+}
+
+StatusResult CollectStatusFields(
+    const fs::path& repo_root,
+    const std::string& app_id,
+    const Common::PathTemplateSet& path_templates,
+    int deadline_ms,
+    const std::vector<std::string>& fields) {
+    StatusResult result;
+    result.ok = false;
+    result.error_code = StatusErrorCode::kCollectFailed;
+    result.payload_unchanged = false;
+
+    StatusSpec spec;
+    std::string error_message;
+    StatusErrorCode rc = LoadStatusSpec(repo_root, path_templates, app_id, spec, error_message);
+    if (rc != StatusErrorCode::kNone) {
+        result.error_code = rc;
+        result.error_message = error_message;
+        return result;
+    }
+
+    StatusContext context;
+    context.app_id = app_id;
+    context.repo_root = repo_root;
+    PlatformStatusProbes probes;
+    context.probes = &probes;
+    context.deadline_ms = deadline_ms > 0 ? deadline_ms : 0;
+
+    std::string payload_json;
+    rc = ExecuteStatusSpecFields(spec, context, fields, payload_json, error_message);
+    if (rc != StatusErrorCode::kNone) {
+        result.error_code = rc;
+        result.error_message = error_message;
+        return result;
     }
 
     result.ok = true;
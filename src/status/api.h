@@ -3,6 +3,7 @@
 
 #include "fs.h"
 #include <string>
+#include <vector>
 
 #include "../common/path_templates.h"
 #include "error_map.h"
@@ -15,6 +16,10 @@ struct StatusResult {
     StatusErrorCode error_code;
     std::string payload_json;
     std::string error_message;
+    // Against the previous collection for the app (see StatusChangeSet): whether the payload is
+    // the same, and which top-level fields differ, for publishing deltas.
+    bool payload_unchanged;
+    std::vector<std::string> changed_fields;
 };
 
 StatusResult CollectAndPublishStatus(
@@ -22,6 +27,23 @@ StatusResult CollectAndPublishStatus(
     const std::string& app_id,
     const Common::PathTemplateSet& path_templates);
 
+// deadline_ms > 0 bounds the time spent on probe ops: probes that miss it report their last
+// known value and are listed under "_meta" in the payload (see probe_scheduler.h).
+StatusResult CollectAndPublishStatus(
+    const fs::path& repo_root,
+    const std::string& app_id,
+    const Common::PathTemplateSet& path_templates,
+    int deadline_ms);
+
+// Evaluates only what fields need (see ExecuteStatusSpecFields) and leaves the snapshot
+// alone, which always holds a complete payload. changed_fields is not filled in.
+StatusResult CollectStatusFields(
+    const fs::path& repo_root,
+    const std::string& app_id,
+    const Common::PathTemplateSet& path_templates,
+    int deadline_ms,
+    const std::vector<std::string>& fields);
+
 }  // namespace Status
 }  // namespace ProcessInterface
 
@@ -13,6 +13,8 @@ struct StatusContext {
     std::string app_id;
     fs::path repo_root;
     const IStatusProbes* probes;
+    // Overall budget for probe ops in milliseconds; 0 evaluates every op inline without one.
+    int deadline_ms;
 };
 
 }  // namespace Status
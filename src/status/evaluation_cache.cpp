@@ -0,0 +1,50 @@
+#include "evaluation_cache.h"
+
+namespace ProcessInterface {
+namespace Status {
+
+namespace {
+
+const std::size_t kSharedEvaluationCacheMaxEntries = 256;
+
+}  // namespace
+
+StatusEvaluationCache::StatusEvaluationCache(std::size_t max_entries)
+    : max_entries_(max_entries == 0 ? 1 : max_entries),
+      next_sequence_(0) {}
+
+std::shared_ptr<const StatusEvaluationState> StatusEvaluationCache::Find(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::map<std::string, Entry>::const_iterator found = entries_.find(key);
+    if (found == entries_.end()) {
+        return std::shared_ptr<const StatusEvaluationState>();
+    }
+    return found->second.state;
+}
+
+void StatusEvaluationCache::Store(const std::string& key, const std::shared_ptr<const StatusEvaluationState>& state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[key];
+    entry.state = state;
+    entry.stored_sequence = ++next_sequence_;
+
+    // Apps are few; dropping the least recently evaluated one only costs it a full evaluation.
+    while (entries_.size() > max_entries_) {
+        std::map<std::string, Entry>::iterator oldest = entries_.begin();
+        std::map<std::string, Entry>::iterator iter;
+        for (iter = entries_.begin(); iter != entries_.end(); ++iter) {
+            if (iter->second.stored_sequence < oldest->second.stored_sequence) {
+                oldest = iter;
+            }
+        }
+        entries_.erase(oldest);
+    }
+}
+
+StatusEvaluationCache& SharedStatusEvaluationCache() {
+    static StatusEvaluationCache cache(kSharedEvaluationCacheMaxEntries);
+    return cache;
+}
+
+}  // namespace Status
+}  // namespace ProcessInterface
@@ -0,0 +1,58 @@
+#ifndef PROCESS_INTERFACE_STATUS_EVALUATION_CACHE_H
+#define PROCESS_INTERFACE_STATUS_EVALUATION_CACHE_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../../external/nlohmann/json.hpp"
+
+namespace ProcessInterface {
+namespace Status {
+
+// What the last evaluation of one spec version produced, by operation index.
+struct StatusEvaluationState {
+    unsigned long long spec_version;
+    std::vector<std::shared_ptr<const nlohmann::json> > values;
+    // OperationInputStamp of each file op when it was evaluated; empty for other ops.
+    std::vector<std::string> stamps;
+    // "_meta" as built for the payload; null for evaluations without a deadline.
+    nlohmann::json meta;
+    nlohmann::json payload;
+    std::string payload_json;
+};
+
+// Keeps the last StatusEvaluationState per app so ExecuteStatusSpec can carry over every
+// operation whose inputs did not change. States are immutable once stored; concurrent
+// evaluations of one app each start from the state they found and the last to finish wins.
+class StatusEvaluationCache {
+public:
+    explicit StatusEvaluationCache(std::size_t max_entries);
+
+    StatusEvaluationCache(const StatusEvaluationCache&) = delete;
+    StatusEvaluationCache& operator=(const StatusEvaluationCache&) = delete;
+
+    std::shared_ptr<const StatusEvaluationState> Find(const std::string& key) const;
+    void Store(const std::string& key, const std::shared_ptr<const StatusEvaluationState>& state);
+
+private:
+    struct Entry {
+        std::shared_ptr<const StatusEvaluationState> state;
+        unsigned long long stored_sequence;
+    };
+
+    std::size_t max_entries_;
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+    unsigned long long next_sequence_;
+};
+
+StatusEvaluationCache& SharedStatusEvaluationCache();
+
+}  // namespace Status
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_STATUS_EVALUATION_CACHE_H
@@ -0,0 +1,319 @@
+#include "json_projection.h"
+
+#include <utility>
+
+namespace ProcessInterface {
+namespace Status {
+
+namespace {
+
+enum class PathMatch {
+    kNone,
+    kPrefix,
+    kExact,
+};
+
+class ProjectionSax {
+public:
+    explicit ProjectionSax(const std::vector<JsonPointer>& pointers)
+        : pointers_(pointers),
+          skip_depth_(0),
+          capturing_(false),
+          root_seen_(false),
+          root_container_(false),
+          result_(nlohmann::json::object()) {}
+
+    bool null() {
+        return Value(nlohmann::json(nullptr));
+    }
+    bool boolean(bool value) {
+        return Value(nlohmann::json(value));
+    }
+    bool number_integer(nlohmann::json::number_integer_t value) {
+        return Value(nlohmann::json(value));
+    }
+    bool number_unsigned(nlohmann::json::number_unsigned_t value) {
+        return Value(nlohmann::json(value));
+    }
+    bool number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t& text) {
+        (void)text;
+        return Value(nlohmann::json(value));
+    }
+    bool string(nlohmann::json::string_t& value) {
+        return Value(nlohmann::json(std::move(value)));
+    }
+    bool binary(nlohmann::json::binary_t& value) {
+        return Value(nlohmann::json::binary(std::move(value)));
+    }
+    bool start_object(std::size_t size) {
+        (void)size;
+        return StartContainer(false);
+    }
+    bool key(nlohmann::json::string_t& key) {
+        if (skip_depth_ > 0) {
+            return true;
+        }
+        if (capturing_) {
+            capture_key_.swap(key);
+        } else {
+            frames_.back().key.swap(key);
+        }
+        return true;
+    }
+    bool end_object() {
+        return EndContainer();
+    }
+    bool start_array(std::size_t size) {
+        (void)size;
+        return StartContainer(true);
+    }
+    bool end_array() {
+        return EndContainer();
+    }
+    bool parse_error(std::size_t position, const std::string& token, const nlohmann::json::exception& error) {
+        (void)position;
+        (void)token;
+        (void)error;
+        return false;
+    }
+
+    bool RootIsContainer() const {
+        return root_container_;
+    }
+
+    nlohmann::json& Result() {
+        return result_;
+    }
+
+private:
+    // A container on the way to at least one selected value.
+    struct Frame {
+        bool array;
+        std::size_t index;
+        std::string key;
+    };
+
+    // Whether pointer starts with the path of the current value.
+    bool PointerReachesCurrentPath(const JsonPointer& pointer) const {
+        if (pointer.tokens.size() < frames_.size()) {
+            return false;
+        }
+        std::size_t depth;
+        for (depth = 0; depth < frames_.size(); ++depth) {
+            const Frame& frame = frames_[depth];
+            if (frame.array ? pointer.tokens[depth] != std::to_string(frame.index) : pointer.tokens[depth] != frame.key) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    PathMatch MatchCurrentPath() const {
+        PathMatch best = PathMatch::kNone;
+        std::size_t pointer_index;
+        for (pointer_index = 0; pointer_index < pointers_.size(); ++pointer_index) {
+            const JsonPointer& pointer = pointers_[pointer_index];
+            if (!PointerReachesCurrentPath(pointer)) {
+                continue;
+            }
+            if (pointer.tokens.size() == frames_.size()) {
+                return PathMatch::kExact;
+            }
+            best = PathMatch::kPrefix;
+        }
+        return best;
+    }
+
+    // Records the value selected at the current path for every pointer that ends there or
+    // inside it (a pointer nested in another one's subtree is never visited on its own).
+    void Store(const nlohmann::json& value) {
+        std::size_t pointer_index;
+        for (pointer_index = 0; pointer_index < pointers_.size(); ++pointer_index) {
+            const JsonPointer& pointer = pointers_[pointer_index];
+            if (!PointerReachesCurrentPath(pointer)) {
+                continue;
+            }
+            const nlohmann::json* node = &value;
+            std::size_t depth;
+            for (depth = frames_.size(); depth < pointer.tokens.size() && node != NULL; ++depth) {
+                const std::string& token = pointer.tokens[depth];
+                if (node->is_object()) {
+                    const nlohmann::json::const_iterator found = node->find(token);
+                    node = found == node->end() ? NULL : &*found;
+                } else if (node->is_array() && !token.empty() &&
+                           token.find_first_not_of("0123456789") == std::string::npos &&
+                           (token == "0" || token[0] != '0') && token.size() < 10 &&
+                           std::stoul(token) < node->size()) {
+                    node = &(*node)[std::stoul(token)];
+                } else {
+                    node = NULL;
+                }
+            }
+            if (node != NULL) {
+                result_[pointer.text] = *node;
+            }
+        }
+    }
+
+    void AddToCapture(nlohmann::json value, bool container) {
+        nlohmann::json* parent = capture_stack_.back();
+        nlohmann::json* added = NULL;
+        if (parent->is_array()) {
+            parent->push_back(std::move(value));
+            added = &parent->back();
+        } else {
+            added = &(*parent)[capture_key_];
+            *added = std::move(value);
+        }
+        if (container) {
+            capture_stack_.push_back(added);
+        }
+    }
+
+    void NextElement() {
+        if (!frames_.empty() && frames_.back().array) {
+            ++frames_.back().index;
+        }
+    }
+
+    bool Value(nlohmann::json value) {
+        if (skip_depth_ > 0) {
+            return true;
+        }
+        if (capturing_) {
+            AddToCapture(std::move(value), false);
+            return true;
+        }
+        if (!root_seen_) {
+            // Scalar document: nothing to project.
+            root_seen_ = true;
+            return true;
+        }
+        if (MatchCurrentPath() == PathMatch::kExact) {
+            Store(value);
+        }
+        NextElement();
+        return true;
+    }
+
+    bool StartContainer(bool array) {
+        if (skip_depth_ > 0) {
+            ++skip_depth_;
+            return true;
+        }
+        if (capturing_) {
+            AddToCapture(array ? nlohmann::json::array() : nlohmann::json::object(), true);
+            return true;
+        }
+        if (!root_seen_) {
+            root_seen_ = true;
+            root_container_ = true;
+        }
+
+        const PathMatch match = MatchCurrentPath();
+        if (match == PathMatch::kExact) {
+            capturing_ = true;
+            captured_ = array ? nlohmann::json::array() : nlohmann::json::object();
+            capture_stack_.assign(1, &captured_);
+        } else if (match == PathMatch::kPrefix) {
+            Frame frame;
+            frame.array = array;
+            frame.index = 0;
+            frames_.push_back(frame);
+        } else {
+            skip_depth_ = 1;
+        }
+        return true;
+    }
+
+    bool EndContainer() {
+        if (skip_depth_ > 0) {
+            --skip_depth_;
+            if (skip_depth_ == 0) {
+                NextElement();
+            }
+            return true;
+        }
+        if (capturing_) {
+            capture_stack_.pop_back();
+            if (capture_stack_.empty()) {
+                capturing_ = false;
+                Store(captured_);
+                captured_ = nlohmann::json();
+                NextElement();
+            }
+            return true;
+        }
+        frames_.pop_back();
+        NextElement();
+        return true;
+    }
+
+    const std::vector<JsonPointer>& pointers_;
+    std::vector<Frame> frames_;
+    int skip_depth_;
+    bool capturing_;
+    nlohmann::json captured_;
+    std::vector<nlohmann::json*> capture_stack_;
+    std::string capture_key_;
+    bool root_seen_;
+    bool root_container_;
+    nlohmann::json result_;
+};
+
+}  // namespace
+
+bool ParseJsonPointers(
+    const std::vector<std::string>& pointer_texts,
+    std::vector<JsonPointer>& pointers_out,
+    std::string& error_message) {
+    pointers_out.clear();
+    std::size_t index;
+    for (index = 0; index < pointer_texts.size(); ++index) {
+        const std::string& text = pointer_texts[index];
+        if (!text.empty() && text[0] != '/') {
+            error_message = "json pointer must start with '/': " + text;
+            return false;
+        }
+
+        JsonPointer pointer;
+        pointer.text = text;
+        std::size_t position = 0;
+        while (position < text.size()) {
+            const std::size_t next = text.find('/', position + 1);
+            const std::string raw = text.substr(position + 1, next == std::string::npos ? std::string::npos : next - position - 1);
+            std::string token;
+            std::size_t offset;
+            for (offset = 0; offset < raw.size(); ++offset) {
+                if (raw[offset] != '~') {
+                    token.push_back(raw[offset]);
+                } else if (offset + 1 < raw.size() && (raw[offset + 1] == '0' || raw[offset + 1] == '1')) {
+                    token.push_back(raw[offset + 1] == '0' ? '~' : '/');
+                    ++offset;
+                } else {
+                    error_message = "json pointer has invalid escape: " + text;
+                    return false;
+                }
+            }
+            pointer.tokens.push_back(token);
+            position = next == std::string::npos ? text.size() : next;
+        }
+        pointers_out.push_back(pointer);
+    }
+    return true;
+}
+
+bool ProjectJsonText(
+    const std::string& text,
+    const std::vector<JsonPointer>& pointers,
+    nlohmann::json& projection_out) {
+    ProjectionSax handler(pointers);
+    if (!nlohmann::json::sax_parse(text, &handler) || !handler.RootIsContainer()) {
+        return false;
+    }
+    projection_out = std::move(handler.Result());
+    return true;
+}
+
+}  // namespace Status
+}  // namespace ProcessInterface
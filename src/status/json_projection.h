@@ -0,0 +1,35 @@
+#ifndef PROCESS_INTERFACE_STATUS_JSON_PROJECTION_H
+#define PROCESS_INTERFACE_STATUS_JSON_PROJECTION_H
+
+#include <string>
+#include <vector>
+
+#include "../../external/nlohmann/json.hpp"
+
+namespace ProcessInterface {
+namespace Status {
+
+// An RFC 6901 pointer as written and split into unescaped reference tokens; "" is the whole
+// document.
+struct JsonPointer {
+    std::string text;
+    std::vector<std::string> tokens;
+};
+
+bool ParseJsonPointers(
+    const std::vector<std::string>& pointer_texts,
+    std::vector<JsonPointer>& pointers_out,
+    std::string& error_message);
+
+// Parses text with a SAX pass and builds only the subtrees the pointers select; everything
+// else is skipped without being stored. projection_out is an object keyed by pointer text;
+// pointers that select nothing are left out. False when text is not a JSON object or array.
+bool ProjectJsonText(
+    const std::string& text,
+    const std::vector<JsonPointer>& pointers,
+    nlohmann::json& projection_out);
+
+}  // namespace Status
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_STATUS_JSON_PROJECTION_H
@@ -0,0 +1,59 @@
+#ifndef PROCESS_INTERFACE_STATUS_PROBE_PLUGIN_ABI_H
+#define PROCESS_INTERFACE_STATUS_PROBE_PLUGIN_ABI_H
+
+/*
+ * C ABI for status probe plugins, used by the status spec op "plugin:<name>:args...".
+ * A plugin is a shared library listed under "statusPlugins" in the host profile. At startup
+ * the host calls its init export once:
+ *
+ *     int gpi_status_probe_init(unsigned int host_abi_version, const char* config_json,
+ *                               gpi_status_probe* probe_out);
+ *
+ * config_json is the profile entry's "config" value ("null" when absent). init returns 0
+ * and fills probe_out, or non-zero to fail host startup. The plugin owns any state it keeps
+ * (open sockets, mapped files, its own caches) behind probe_out->state.
+ *
+ * evaluate is called once per op per status evaluation, never concurrently for one plugin.
+ * It reports a JSON value through result->set_json (the last call wins; no call yields
+ * null) and returns 0, or returns non-zero after result->set_error to fail the evaluation.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPI_STATUS_PROBE_ABI_VERSION 1u
+#define GPI_STATUS_PROBE_INIT_SYMBOL "gpi_status_probe_init"
+
+typedef struct gpi_status_probe_result {
+    void* context;
+    void (*set_json)(void* context, const char* json, size_t size);
+    void (*set_error)(void* context, const char* message, size_t size);
+} gpi_status_probe_result;
+
+typedef struct gpi_status_probe {
+    /* Set by the plugin to the GPI_STATUS_PROBE_ABI_VERSION it was built against. */
+    unsigned int abi_version;
+    void* state;
+    /* args are the op's ":"-separated arguments after the plugin name, untrimmed. */
+    int (*evaluate)(
+        void* state,
+        const char* app_id,
+        const char* repo_root,
+        const char* const* args,
+        size_t arg_count,
+        const gpi_status_probe_result* result);
+} gpi_status_probe;
+
+typedef int (*gpi_status_probe_init_fn)(
+    unsigned int host_abi_version,
+    const char* config_json,
+    gpi_status_probe* probe_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROCESS_INTERFACE_STATUS_PROBE_PLUGIN_ABI_H */
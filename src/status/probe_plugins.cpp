@@ -0,0 +1,154 @@
+#include "probe_plugins.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "../platform/native_library.h"
+#include "probe_plugin_abi.h"
+
+namespace ProcessInterface {
+namespace Status {
+
+namespace {
+
+struct LoadedProbePlugin {
+    gpi_status_probe probe;
+    // Probes are not required to be thread-safe.
+    std::mutex call_mutex;
+};
+
+struct ProbeCall {
+    bool has_json;
+    std::string json_text;
+    std::string error_text;
+};
+
+void ProbeSetJson(void* context, const char* json, size_t size) {
+    ProbeCall* call = static_cast<ProbeCall*>(context);
+    call->has_json = json != NULL;
+    call->json_text.assign(json != NULL ? json : "", json != NULL ? size : 0);
+}
+
+void ProbeSetError(void* context, const char* message, size_t size) {
+    static_cast<ProbeCall*>(context)->error_text.assign(message != NULL ? message : "", message != NULL ? size : 0);
+}
+
+std::mutex g_plugins_mutex;
+std::map<std::string, std::shared_ptr<LoadedProbePlugin> > g_plugins;
+
+std::shared_ptr<LoadedProbePlugin> FindPlugin(const std::string& name) {
+    std::lock_guard<std::mutex> lock(g_plugins_mutex);
+    const std::map<std::string, std::shared_ptr<LoadedProbePlugin> >::const_iterator iter = g_plugins.find(name);
+    return iter == g_plugins.end() ? std::shared_ptr<LoadedProbePlugin>() : iter->second;
+}
+
+}  // namespace
+
+bool RegisterStatusProbePlugin(const StatusProbePluginSpec& spec, std::string& error_message) {
+    if (spec.name.empty()) {
+        error_message = "status plugin name is empty";
+        return false;
+    }
+    if (FindPlugin(spec.name)) {
+        error_message = "status plugin registered twice: " + spec.name;
+        return false;
+    }
+
+    void* handle = NULL;
+    if (!ProcessInterface::Platform::LoadNativeLibrary(spec.library_path, handle, error_message)) {
+        error_message = "status plugin " + spec.name + ": " + error_message;
+        return false;
+    }
+    const std::string init_symbol = spec.init_symbol.empty() ? std::string(GPI_STATUS_PROBE_INIT_SYMBOL) : spec.init_symbol;
+    const gpi_status_probe_init_fn init_fn =
+        reinterpret_cast<gpi_status_probe_init_fn>(ProcessInterface::Platform::FindNativeSymbol(handle, init_symbol));
+    if (init_fn == NULL) {
+        error_message = "status plugin " + spec.name + ": symbol not found: " + init_symbol;
+        return false;
+    }
+
+    const std::shared_ptr<LoadedProbePlugin> plugin = std::make_shared<LoadedProbePlugin>();
+    plugin->probe.abi_version = 0;
+    plugin->probe.state = NULL;
+    plugin->probe.evaluate = NULL;
+    const std::string config_json = spec.config_json.empty() ? std::string("null") : spec.config_json;
+    const int rc = init_fn(GPI_STATUS_PROBE_ABI_VERSION, config_json.c_str(), &plugin->probe);
+    if (rc != 0) {
+        error_message = "status plugin " + spec.name + ": init failed with " + std::to_string(rc);
+        return false;
+    }
+    if (plugin->probe.abi_version != GPI_STATUS_PROBE_ABI_VERSION) {
+        error_message = "status plugin " + spec.name + ": ABI version " + std::to_string(plugin->probe.abi_version) +
+            " is not supported (host is " + std::to_string(GPI_STATUS_PROBE_ABI_VERSION) + ")";
+        return false;
+    }
+    if (plugin->probe.evaluate == NULL) {
+        error_message = "status plugin " + spec.name + ": init did not set evaluate";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_plugins_mutex);
+    g_plugins[spec.name] = plugin;
+    return true;
+}
+
+StatusErrorCode EvaluateStatusProbePlugin(
+    const std::string& name,
+    const std::vector<std::string>& args,
+    const StatusContext& context,
+    nlohmann::json& out_json,
+    std::string& error_message) {
+    const std::shared_ptr<LoadedProbePlugin> plugin = FindPlugin(name);
+    if (!plugin) {
+        error_message = "status plugin is not registered: " + name;
+        return StatusErrorCode::kSpecInvalid;
+    }
+
+    std::vector<const char*> arg_pointers;
+    std::size_t index;
+    for (index = 0; index < args.size(); ++index) {
+        arg_pointers.push_back(args[index].c_str());
+    }
+    arg_pointers.push_back(NULL);
+    const std::string repo_root = context.repo_root.string();
+
+    ProbeCall call;
+    call.has_json = false;
+    gpi_status_probe_result result;
+    result.context = &call;
+    result.set_json = ProbeSetJson;
+    result.set_error = ProbeSetError;
+
+    int rc = 0;
+    {
+        std::lock_guard<std::mutex> lock(plugin->call_mutex);
+        rc = plugin->probe.evaluate(
+            plugin->probe.state,
+            context.app_id.c_str(),
+            repo_root.c_str(),
+            arg_pointers.data(),
+            args.size(),
+            &result);
+    }
+    if (rc != 0) {
+        error_message = "status plugin " + name + " failed: " +
+            (call.error_text.empty() ? "returned " + std::to_string(rc) : call.error_text);
+        return StatusErrorCode::kCollectFailed;
+    }
+
+    if (!call.has_json) {
+        out_json = nullptr;
+        return StatusErrorCode::kNone;
+    }
+    try {
+        out_json = nlohmann::json::parse(call.json_text);
+    } catch (const std::exception&) {
+        error_message = "status plugin " + name + " returned invalid JSON";
+        return StatusErrorCode::kCollectFailed;
+    }
+    return StatusErrorCode::kNone;
+}
+
+}  // namespace Status
+}  // namespace ProcessInterface
@@ -0,0 +1,40 @@
+#ifndef PROCESS_INTERFACE_STATUS_PROBE_PLUGINS_H
+#define PROCESS_INTERFACE_STATUS_PROBE_PLUGINS_H
+
+#include <string>
+#include <vector>
+
+#include "../../external/nlohmann/json.hpp"
+#include "context.h"
+#include "error_map.h"
+#include "fs.h"
+
+namespace ProcessInterface {
+namespace Status {
+
+struct StatusProbePluginSpec {
+    // Referenced as "plugin:<name>:..." from status specs.
+    std::string name;
+    fs::path library_path;
+    // Init export; GPI_STATUS_PROBE_INIT_SYMBOL unless the profile names another.
+    std::string init_symbol;
+    std::string config_json;
+};
+
+// Loads the library and runs its init export; called at host startup before requests are
+// served. Names must be unique.
+bool RegisterStatusProbePlugin(const StatusProbePluginSpec& spec, std::string& error_message);
+
+// Calls the named probe with the op arguments that follow the name. An unknown name is
+// kSpecInvalid; a probe returning non-zero or reporting malformed JSON is kCollectFailed.
+StatusErrorCode EvaluateStatusProbePlugin(
+    const std::string& name,
+    const std::vector<std::string>& args,
+    const StatusContext& context,
+    nlohmann::json& out_json,
+    std::string& error_message);
+
+}  // namespace Status
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_STATUS_PROBE_PLUGINS_H
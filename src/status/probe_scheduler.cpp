@@ -0,0 +1,269 @@
+#include "probe_scheduler.h"
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#include "../common/text.h"
+#include "debug.h"
+#include "probes.h"
+#include "status_operation_registry.h"
+
+namespace ProcessInterface {
+namespace Status {
+
+namespace {
+
+const int kFailureThreshold = 3;
+const long long kBaseBackoffMs = 1000;
+const long long kMaxBackoffMs = 60000;
+// Probes no evaluation asked for in this long are forgotten (specs were edited, apps removed).
+const long long kIdleEntryMs = 10 * 60 * 1000;
+
+long long MillisecondsBetween(
+    const std::chrono::steady_clock::time_point from,
+    const std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+// Batch order: local /proc and socket lookups first, then port probes after one prefetch,
+// then plugins, whose cost is unknown, so a slow probe delays as few others as possible.
+int ProbePhase(const std::string& op_name) {
+    if (op_name == "port_listening" || op_name == "port_check") {
+        return 1;
+    }
+    if (op_name == "plugin") {
+        return 2;
+    }
+    return 0;
+}
+
+std::string ProbeKey(const std::string& app_id, const ParsedOperation& operation) {
+    return app_id + "\n" + operation.field_name + "\n" + operation.op_name + ":" +
+           ProcessInterface::Common::Join(operation.args, 0, ":");
+}
+
+}  // namespace
+
+bool IsProbeOperation(const std::string& op_name) {
+    return op_name == "process_running" || op_name == "port_listening" || op_name == "port_check" ||
+           op_name == "port_owner" || op_name == "process_stats" || op_name == "plugin";
+}
+
+struct StatusProbeScheduler::State {
+    struct Entry {
+        Entry()
+            : in_flight(false),
+              runs_completed(0),
+              has_value(false),
+              last_failed(false),
+              last_error_code(StatusErrorCode::kNone),
+              consecutive_failures(0) {}
+
+        bool in_flight;
+        unsigned long long runs_completed;
+        bool has_value;
+        nlohmann::json value;
+        std::chrono::steady_clock::time_point produced_at;
+        bool last_failed;
+        StatusErrorCode last_error_code;
+        std::string last_error_message;
+        int consecutive_failures;
+        std::chrono::steady_clock::time_point open_until;
+        std::chrono::steady_clock::time_point last_requested;
+    };
+
+    std::mutex mutex;
+    std::condition_variable completed;
+    std::map<std::string, Entry> entries;
+};
+
+StatusProbeScheduler::StatusProbeScheduler()
+    : state_(std::make_shared<State>()) {}
+
+void StatusProbeScheduler::Evaluate(
+    const std::vector<ParsedOperation>& probes,
+    const StatusContext& context,
+    const std::chrono::steady_clock::time_point deadline,
+    std::vector<ScheduledProbeOutcome>& outcomes_out) {
+    outcomes_out.assign(probes.size(), ScheduledProbeOutcome());
+
+    std::vector<std::string> keys(probes.size());
+    // Run count each probe has to reach to count as fresh; 0 when it is not waited for.
+    std::vector<unsigned long long> awaited(probes.size(), 0);
+    std::vector<bool> start(probes.size(), false);
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    std::map<std::string, State::Entry>::iterator prune = state_->entries.begin();
+    while (prune != state_->entries.end()) {
+        if (!prune->second.in_flight && MillisecondsBetween(prune->second.last_requested, now) > kIdleEntryMs) {
+            prune = state_->entries.erase(prune);
+        } else {
+            ++prune;
+        }
+    }
+
+    std::size_t index;
+    for (index = 0; index < probes.size(); ++index) {
+        keys[index] = ProbeKey(context.app_id, probes[index]);
+        State::Entry& entry = state_->entries[keys[index]];
+        entry.last_requested = now;
+        if (entry.in_flight) {
+            awaited[index] = entry.runs_completed + 1;
+        } else if (entry.consecutive_failures >= kFailureThreshold && now < entry.open_until) {
+            awaited[index] = 0;
+        } else {
+            entry.in_flight = true;
+            awaited[index] = entry.runs_completed + 1;
+            start[index] = true;
+        }
+    }
+    lock.unlock();
+
+    // Everything this call starts runs as one batch on one background thread, sharing a
+    // PlatformStatusProbes so the listen table, socket owners and /proc stats are read once
+    // and port probes are prefetched together.
+    std::vector<std::string> batch_keys;
+    std::vector<ParsedOperation> batch;
+    int phase;
+    for (phase = 0; phase <= 2; ++phase) {
+        for (index = 0; index < probes.size(); ++index) {
+            if (start[index] && ProbePhase(probes[index].op_name) == phase) {
+                batch_keys.push_back(keys[index]);
+                batch.push_back(probes[index]);
+            }
+        }
+    }
+
+    if (!batch.empty()) {
+        const std::shared_ptr<State> state = state_;
+        const std::string app_id = context.app_id;
+        const fs::path repo_root = context.repo_root;
+        const std::function<void()> run = [state, batch_keys, batch, app_id, repo_root, deadline]() {
+            PlatformStatusProbes run_probes;
+            StatusContext run_context;
+            run_context.app_id = app_id;
+            run_context.repo_root = repo_root;
+            run_context.probes = &run_probes;
+            run_context.deadline_ms = 0;
+
+            bool prefetched = false;
+            std::chrono::steady_clock::time_point prefetch_started;
+            std::size_t batch_index;
+            for (batch_index = 0; batch_index < batch.size(); ++batch_index) {
+                const ParsedOperation& operation = batch[batch_index];
+                std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+                if (ProbePhase(operation.op_name) == 1) {
+                    // The prefetch answers every port probe, so each one is charged from its start.
+                    if (!prefetched) {
+                        prefetched = true;
+                        prefetch_started = started;
+                        PrefetchPortProbes(batch, run_context);
+                    }
+                    started = prefetch_started;
+                }
+                nlohmann::json value;
+                std::string error_message;
+                const StatusErrorCode rc = EvaluateOperation(operation, run_context, value, error_message);
+
+                std::lock_guard<std::mutex> run_lock(state->mutex);
+                const std::chrono::steady_clock::time_point finished = std::chrono::steady_clock::now();
+                State::Entry& entry = state->entries[batch_keys[batch_index]];
+                entry.in_flight = false;
+                ++entry.runs_completed;
+                entry.last_failed = rc != StatusErrorCode::kNone;
+                entry.last_error_code = rc;
+                entry.last_error_message = error_message;
+                if (rc == StatusErrorCode::kNone) {
+                    entry.has_value = true;
+                    entry.value = value;
+                    entry.produced_at = finished;
+                }
+                // Only the probe whose own run crossed the deadline overran it; the ones queued
+                // behind it in the batch did not.
+                if (rc != StatusErrorCode::kNone || (started <= deadline && finished > deadline)) {
+                    ++entry.consecutive_failures;
+                    if (entry.consecutive_failures >= kFailureThreshold) {
+                        long long backoff_ms = kBaseBackoffMs;
+                        int step;
+                        for (step = kFailureThreshold; step < entry.consecutive_failures && backoff_ms < kMaxBackoffMs; ++step) {
+                            backoff_ms *= 2;
+                        }
+                        if (backoff_ms > kMaxBackoffMs) {
+                            backoff_ms = kMaxBackoffMs;
+                        }
+                        entry.open_until = finished + std::chrono::milliseconds(backoff_ms);
+                        DebugLog("status probe circuit open field=" + operation.field_name + " failures=" +
+                                 std::to_string(entry.consecutive_failures) + " backoffMs=" + std::to_string(backoff_ms));
+                    }
+                } else {
+                    entry.consecutive_failures = 0;
+                }
+                state->completed.notify_all();
+            }
+        };
+
+        try {
+            std::thread runner(run);
+            runner.detach();
+        } catch (const std::system_error& error) {
+            std::lock_guard<std::mutex> run_lock(state_->mutex);
+            std::size_t batch_index;
+            for (batch_index = 0; batch_index < batch_keys.size(); ++batch_index) {
+                State::Entry& entry = state_->entries[batch_keys[batch_index]];
+                entry.in_flight = false;
+                ++entry.runs_completed;
+                entry.last_failed = true;
+                entry.last_error_code = StatusErrorCode::kCollectFailed;
+                entry.last_error_message = std::string("failed to start probe thread: ") + error.what();
+            }
+        }
+    }
+
+    lock.lock();
+    state_->completed.wait_until(lock, deadline, [this, &keys, &awaited]() {
+        std::size_t wait_index;
+        for (wait_index = 0; wait_index < keys.size(); ++wait_index) {
+            if (awaited[wait_index] != 0 && state_->entries[keys[wait_index]].runs_completed < awaited[wait_index]) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    const std::chrono::steady_clock::time_point answered = std::chrono::steady_clock::now();
+    for (index = 0; index < probes.size(); ++index) {
+        const State::Entry& entry = state_->entries[keys[index]];
+        ScheduledProbeOutcome& outcome = outcomes_out[index];
+        outcome.fresh = awaited[index] != 0 && entry.runs_completed >= awaited[index];
+        outcome.error_code = StatusErrorCode::kNone;
+        outcome.value = entry.has_value ? entry.value : nlohmann::json(nullptr);
+        outcome.age_ms = entry.has_value ? MillisecondsBetween(entry.produced_at, answered) : -1;
+        outcome.retry_in_ms = 0;
+
+        if (outcome.fresh && entry.last_failed) {
+            outcome.error_code = entry.last_error_code;
+            outcome.error_message = entry.last_error_message;
+            outcome.stale_reason = "error";
+        } else if (!outcome.fresh && awaited[index] == 0) {
+            outcome.stale_reason = "circuit_open";
+            outcome.error_message = entry.last_error_message;
+            outcome.retry_in_ms = MillisecondsBetween(answered, entry.open_until);
+        } else if (!outcome.fresh) {
+            outcome.stale_reason = "deadline";
+        }
+    }
+}
+
+StatusProbeScheduler& SharedStatusProbeScheduler() {
+    static StatusProbeScheduler scheduler;
+    return scheduler;
+}
+
+}  // namespace Status
+}  // namespace ProcessInterface
@@ -0,0 +1,71 @@
+#ifndef PROCESS_INTERFACE_STATUS_PROBE_SCHEDULER_H
+#define PROCESS_INTERFACE_STATUS_PROBE_SCHEDULER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../external/nlohmann/json.hpp"
+#include "context.h"
+#include "error_map.h"
+#include "status_expression_parser.h"
+
+namespace ProcessInterface {
+namespace Status {
+
+// Ops that read live system state (processes, ports, plugins) and may be slow or fail. They
+// take only literal arguments, never other fields, so they can run ahead of the spec order.
+bool IsProbeOperation(const std::string& op_name);
+
+struct ScheduledProbeOutcome {
+    // Evaluated during this call; value (or error_code/error_message) is current.
+    bool fresh;
+    StatusErrorCode error_code;
+    std::string error_message;
+    // Current value when fresh and successful, else the last value the probe produced
+    // (null when it never succeeded).
+    nlohmann::json value;
+    // When not fresh or failed: "deadline", "error" or "circuit_open".
+    std::string stale_reason;
+    // Age of value in milliseconds; -1 when there is none.
+    long long age_ms;
+    // While the circuit is open: time until the probe runs again.
+    long long retry_in_ms;
+};
+
+// Runs the probe ops of status evaluations in the background, at most one run per probe
+// (app, field and op text) at a time, and keeps each probe's last value.
+//
+// Evaluate starts the given probes that are not already running as one batch on a single
+// background thread, joins the runs already in flight for the others, and waits
+// until all of them finished or the deadline passed. A probe that misses the deadline keeps
+// running and its value is stored for the next evaluation, which is served the last known
+// value in the meantime. A probe that fails kFailureThreshold times in a row (an error, or a
+// run that overran the deadline it started under) has its circuit opened: it is not run
+// for kBaseBackoffMs, doubling per further failure up to kMaxBackoffMs, and its last value
+// is served. A batch shares one PlatformStatusProbes and prefetches its port probes.
+class StatusProbeScheduler {
+public:
+    StatusProbeScheduler();
+
+    StatusProbeScheduler(const StatusProbeScheduler&) = delete;
+    StatusProbeScheduler& operator=(const StatusProbeScheduler&) = delete;
+
+    void Evaluate(
+        const std::vector<ParsedOperation>& probes,
+        const StatusContext& context,
+        std::chrono::steady_clock::time_point deadline,
+        std::vector<ScheduledProbeOutcome>& outcomes_out);
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+StatusProbeScheduler& SharedStatusProbeScheduler();
+
+}  // namespace Status
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_STATUS_PROBE_SCHEDULER_H
@@ -1,11 +1,40 @@
 #include "probes.h"
 
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "../platform/port_probe.h"
 #include "../platform/process_probe.h"
+#include "debug.h"
 
 namespace ProcessInterface {
 namespace Status {
 
+namespace {
+
+std::string PortProbeKey(const std::string& host, int port, int timeout_ms) {
+    return host + "\n" + std::to_string(port) + "\n" + std::to_string(timeout_ms);
+}
+
+void LogPortProbeFailure(
+    const std::string& host,
+    int port,
+    const ProcessInterface::Platform::PortProbeResult& result) {
+    if (result.listening || !DebugEnabled()) {
+        return;
+    }
+    DebugLog("port probe " + host + ":" + std::to_string(port) + " " + result.error_stage + " " +
+             result.error_code + ": " + result.error_message);
+}
+
+}  // namespace
+
+PlatformStatusProbes::PlatformStatusProbes()
+    : listen_table_attempted_(false),
+      socket_owners_built_(false) {}
+
 ProcessProbeResult PlatformStatusProbes::QueryProcessByName(const std::string& process_name) const {
     const ProcessInterface::Platform::ProcessQueryResult query_result =
         ProcessInterface::Platform::QueryProcessByName(process_name);
@@ -18,7 +47,199 @@ ProcessProbeResult PlatformStatusProbes::QueryProcessByName(const std::string& p
 }
 
 bool PlatformStatusProbes::CheckPortListening(const std::string& host, int port, int timeout_ms) const {
-    return ProcessInterface::Platform::CheckPortListening(host, port, timeout_ms);
+    return CheckPort(host, port, timeout_ms).listening;
+}
+
+PortCheckResult PlatformStatusProbes::CheckPort(const std::string& host, int port, int timeout_ms) const {
+    PortCheckResult result;
+    result.listening = false;
+
+    bool listening = false;
+    if (IsLocalPortProbe(host, port, listening)) {
+        result.listening = listening;
+        if (!listening) {
+            result.error_stage = "connect";
+            result.error_code = "refused";
+            result.error_message = "no listener in the kernel listen table";
+        }
+        return result;
+    }
+
+    const std::string key = PortProbeKey(host, port, timeout_ms);
+    std::map<std::string, ProcessInterface::Platform::PortProbeResult>::const_iterator probed =
+        remote_port_results_.find(key);
+    if (probed == remote_port_results_.end()) {
+        std::vector<ProcessInterface::Platform::PortProbeTarget> targets(1);
+        targets[0].host = host;
+        targets[0].port = port;
+        targets[0].timeout_ms = timeout_ms;
+        std::vector<ProcessInterface::Platform::PortProbeResult> results;
+        ProcessInterface::Platform::CheckPortsListening(targets, results);
+        probed = remote_port_results_.insert(std::make_pair(key, results[0])).first;
+        LogPortProbeFailure(host, port, results[0]);
+    }
+
+    result.listening = probed->second.listening;
+    result.error_stage = probed->second.error_stage;
+    result.error_code = probed->second.error_code;
+    result.error_message = probed->second.error_message;
+    return result;
+}
+
+void PlatformStatusProbes::PrefetchPortListening(const std::vector<PortProbeRequest>& requests) const {
+    std::vector<ProcessInterface::Platform::PortProbeTarget> targets;
+    std::vector<std::string> keys;
+    std::size_t index;
+    for (index = 0; index < requests.size(); ++index) {
+        const PortProbeRequest& request = requests[index];
+        bool listening = false;
+        if (IsLocalPortProbe(request.host, request.port, listening)) {
+            continue;
+        }
+        const std::string key = PortProbeKey(request.host, request.port, request.timeout_ms);
+        if (remote_port_results_.count(key) != 0 || std::find(keys.begin(), keys.end(), key) != keys.end()) {
+            continue;
+        }
+        ProcessInterface::Platform::PortProbeTarget target;
+        target.host = request.host;
+        target.port = request.port;
+        target.timeout_ms = request.timeout_ms;
+        targets.push_back(target);
+        keys.push_back(key);
+    }
+    if (targets.empty()) {
+        return;
+    }
+
+    std::vector<ProcessInterface::Platform::PortProbeResult> results;
+    ProcessInterface::Platform::CheckPortsListening(targets, results);
+    for (index = 0; index < keys.size(); ++index) {
+        remote_port_results_[keys[index]] = results[index];
+        LogPortProbeFailure(targets[index].host, targets[index].port, results[index]);
+    }
+    DebugLog("port probes batched targets=" + std::to_string(targets.size()));
+}
+
+bool PlatformStatusProbes::IsLocalPortProbe(const std::string& host, int port, bool& listening_out) const {
+    const ProcessInterface::Platform::ListenTable* table = LocalListenTable();
+    std::vector<ProcessInterface::Platform::ListeningSocket> listeners;
+    if (table == NULL || !table->FindLocalListeners(host, port, listeners)) {
+        return false;
+    }
+    listening_out = !listeners.empty();
+    return true;
+}
+
+bool PlatformStatusProbes::FindPortOwner(
+    const std::string& host,
+    int port,
+    PortOwnerProbeResult& result_out,
+    std::string& error_message) const {
+    result_out.listening = false;
+    result_out.pid = 0;
+    result_out.comm.clear();
+
+    const ProcessInterface::Platform::ListenTable* table = LocalListenTable();
+    if (table == NULL) {
+        error_message = "port owner lookup is not available on this platform";
+        return false;
+    }
+    std::vector<ProcessInterface::Platform::ListeningSocket> listeners;
+    if (!table->FindLocalListeners(host, port, listeners)) {
+        error_message = "port owner lookup requires localhost or a local address: " + host;
+        return false;
+    }
+    if (listeners.empty()) {
+        return true;
+    }
+    result_out.listening = true;
+
+    if (!socket_owners_built_) {
+        socket_owners_built_ = true;
+        // Indexed for every listener at once so later port_owner ops reuse the same walk.
+        std::set<unsigned long long> inodes;
+        std::size_t index;
+        for (index = 0; index < table->Sockets().size(); ++index) {
+            inodes.insert(table->Sockets()[index].inode);
+        }
+        (void)ProcessInterface::Platform::BuildSocketOwnerIndex(inodes, socket_owners_);
+        DebugLog("socket owner index built inodes=" + std::to_string(inodes.size()) +
+                 " owned=" + std::to_string(socket_owners_.size()));
+    }
+
+    std::size_t index;
+    for (index = 0; index < listeners.size(); ++index) {
+        const std::map<unsigned long long, ProcessInterface::Platform::SocketOwner>::const_iterator owner =
+            socket_owners_.find(listeners[index].inode);
+        if (owner != socket_owners_.end() && (result_out.pid == 0 || owner->second.pid < result_out.pid)) {
+            result_out.pid = owner->second.pid;
+            result_out.comm = owner->second.comm;
+        }
+    }
+    return true;
+}
+
+bool PlatformStatusProbes::QueryProcessStats(
+    const std::string& process_name,
+    bool include_tree,
+    ProcessStatsProbeResult& result_out,
+    std::string& error_message) const {
+    result_out.running = false;
+    result_out.pids.clear();
+    result_out.cpu_percent = -1.0;
+    result_out.rss_bytes = 0;
+    result_out.threads = 0;
+    result_out.fds = 0;
+
+#if !defined(__linux__)
+    (void)process_name;
+    (void)include_tree;
+    error_message = "process stats are not available on this platform";
+    return false;
+#else
+    const ProcessInterface::Platform::ProcessQueryResult query_result =
+        ProcessInterface::Platform::QueryProcessByName(process_name);
+    if (!query_result.running) {
+        return true;
+    }
+    const std::vector<int> pids =
+        include_tree ? process_stats_.WithDescendants(query_result.pids) : query_result.pids;
+
+    std::size_t index;
+    for (index = 0; index < pids.size(); ++index) {
+        ProcessInterface::Platform::ProcessStatsSample sample;
+        if (!process_stats_.Sample(pids[index], sample)) {
+            continue;
+        }
+        result_out.pids.push_back(sample.pid);
+        result_out.rss_bytes += sample.rss_bytes;
+        result_out.threads += sample.threads;
+        if (sample.fds < 0 || result_out.fds < 0) {
+            result_out.fds = -1;
+        } else {
+            result_out.fds += sample.fds;
+        }
+        if (sample.cpu_percent >= 0.0) {
+            result_out.cpu_percent = (result_out.cpu_percent < 0.0 ? 0.0 : result_out.cpu_percent) + sample.cpu_percent;
+        }
+    }
+    result_out.running = !result_out.pids.empty();
+    if (!result_out.running) {
+        result_out.fds = 0;
+    }
+    (void)error_message;
+    return true;
+#endif
+}
+
+const ProcessInterface::Platform::ListenTable* PlatformStatusProbes::LocalListenTable() const {
+    if (!listen_table_attempted_) {
+        listen_table_attempted_ = true;
+        if (listen_table_.Load()) {
+            DebugLog("listen table loaded sockets=" + std::to_string(listen_table_.Sockets().size()));
+        }
+    }
+    return listen_table_.Loaded() ? &listen_table_ : NULL;
 }
 
 }  // namespace Status
@@ -1,9 +1,15 @@
 #ifndef PROCESS_INTERFACE_STATUS_PROBES_H
 #define PROCESS_INTERFACE_STATUS_PROBES_H
 
+#include <map>
 #include <string>
 #include <vector>
 
+#include "../platform/listen_table.h"
+#include "../platform/port_probe.h"
+#include "../platform/process_stats.h"
+#include "../platform/socket_owners.h"
+
 namespace ProcessInterface {
 namespace Status {
 
@@ -13,18 +19,113 @@ struct ProcessProbeResult {
     std::vector<int> pids;
 };
 
+// Totals over the matched processes; fds is -1 when some process's fd table is unreadable
+// and cpu_percent is -1 when no process has a previous sample yet.
+struct ProcessStatsProbeResult {
+    bool running;
+    std::vector<int> pids;
+    double cpu_percent;
+    unsigned long long rss_bytes;
+    int threads;
+    int fds;
+};
+
+struct PortOwnerProbeResult {
+    bool listening;
+    // 0 and empty when nothing listens or the owner's fds cannot be read.
+    int pid;
+    std::string comm;
+};
+
+struct PortProbeRequest {
+    std::string host;
+    int port;
+    int timeout_ms;
+};
+
+// Outcome of one port probe with the reason it failed; see Platform::PortProbeResult for the
+// stage and code values. The error fields are empty when listening is true.
+struct PortCheckResult {
+    bool listening;
+    std::string error_stage;
+    std::string error_code;
+    std::string error_message;
+};
+
 class IStatusProbes {
 public:
     virtual ~IStatusProbes() {}
 
     virtual ProcessProbeResult QueryProcessByName(const std::string& process_name) const = 0;
     virtual bool CheckPortListening(const std::string& host, int port, int timeout_ms) const = 0;
+    virtual PortCheckResult CheckPort(const std::string& host, int port, int timeout_ms) const {
+        PortCheckResult result;
+        result.listening = CheckPortListening(host, port, timeout_ms);
+        return result;
+    }
+    // Called with every port probe of a spec before evaluation so implementations can run
+    // them together; CheckPortListening still answers each one.
+    virtual void PrefetchPortListening(const std::vector<PortProbeRequest>& requests) const {
+        (void)requests;
+    }
+    // Only hosts naming this machine can be answered; false with error_message otherwise.
+    virtual bool FindPortOwner(
+        const std::string& host,
+        int port,
+        PortOwnerProbeResult& result_out,
+        std::string& error_message) const = 0;
+    // Processes named process_name, plus all their descendants when include_tree is set.
+    virtual bool QueryProcessStats(
+        const std::string& process_name,
+        bool include_tree,
+        ProcessStatsProbeResult& result_out,
+        std::string& error_message) const {
+        (void)process_name;
+        (void)include_tree;
+        result_out = ProcessStatsProbeResult();
+        error_message = "process stats are not available";
+        return false;
+    }
 };
 
+// One instance per status evaluation: the kernel listen table is read on the first local
+// port probe, the socket owner index on the first port_owner probe and /proc stats on the
+// first process_stats probe, and all are reused by the rest, so it must not outlive the
+// evaluation.
 class PlatformStatusProbes : public IStatusProbes {
 public:
+    PlatformStatusProbes();
+
     virtual ProcessProbeResult QueryProcessByName(const std::string& process_name) const;
+    // Local hosts are answered from the listen table without connecting to the target;
+    // remote hosts, or hosts without a readable table, get a TCP connect.
     virtual bool CheckPortListening(const std::string& host, int port, int timeout_ms) const;
+    virtual PortCheckResult CheckPort(const std::string& host, int port, int timeout_ms) const;
+    // Connects to all remote targets in one batch (Platform::CheckPortsListening) and keeps
+    // the answers for CheckPortListening.
+    virtual void PrefetchPortListening(const std::vector<PortProbeRequest>& requests) const;
+    virtual bool FindPortOwner(
+        const std::string& host,
+        int port,
+        PortOwnerProbeResult& result_out,
+        std::string& error_message) const;
+    virtual bool QueryProcessStats(
+        const std::string& process_name,
+        bool include_tree,
+        ProcessStatsProbeResult& result_out,
+        std::string& error_message) const;
+
+private:
+    const ProcessInterface::Platform::ListenTable* LocalListenTable() const;
+    bool IsLocalPortProbe(const std::string& host, int port, bool& listening_out) const;
+
+    mutable bool listen_table_attempted_;
+    mutable ProcessInterface::Platform::ListenTable listen_table_;
+    mutable bool socket_owners_built_;
+    mutable std::map<unsigned long long, ProcessInterface::Platform::SocketOwner> socket_owners_;
+    // Connect results of this evaluation keyed by PortProbeKey.
+    mutable std::map<std::string, ProcessInterface::Platform::PortProbeResult> remote_port_results_;
+    mutable ProcessInterface::Platform::ProcessStatsSnapshot process_stats_;
 };
 
 }  // namespace Status
@@ -1,12 +1,22 @@
 #include "spec_loader.h"
 
+#include <map>
+#include <memory>
+
 #include "../../external/nlohmann/json.hpp"
-#include "../common/file_io.h"
+#include "../common/file_cache.h"
 #include "paths.h"
 
 namespace ProcessInterface {
 namespace Status {
 
+namespace {
+
+// Charged to the file cache for a compiled spec: op lines plus their expression trees.
+const std::size_t kCompiledSpecBytesPerTextByte = 4;
+
+}  // namespace
+
 StatusErrorCode LoadStatusSpec(
     const fs::path& repo_root,
     const Common::PathTemplateSet& path_templates,
@@ -15,15 +25,26 @@ StatusErrorCode LoadStatusSpec(
     std::string& error_message) {
     const fs::path spec_path = ResolveSpecPath(repo_root, path_templates, app_id);
 
-    std::string spec_text;
-    if (!ProcessInterface::Common::ReadTextFile(spec_path, spec_text)) {
+    Common::FileContentCache& file_cache = Common::SharedFileContentCache();
+    std::shared_ptr<const std::string> spec_text;
+    unsigned long long spec_version = 0;
+    if (!file_cache.ReadText(spec_path, spec_text, spec_version)) {
         error_message = "status spec file not found: " + spec_path.string();
         return StatusErrorCode::kSpecMissing;
     }
 
+    // The same spec file may be shared by several app ids; the parsed spec embeds the id.
+    const std::string derived_kind = "status_spec:" + app_id;
+    const std::shared_ptr<const StatusSpec> cached_spec =
+        std::static_pointer_cast<const StatusSpec>(file_cache.FindDerived(spec_path, derived_kind, spec_version));
+    if (cached_spec) {
+        spec_out = *cached_spec;
+        return StatusErrorCode::kNone;
+    }
+
     nlohmann::json root;
     try {
-        root = nlohmann::json::parse(spec_text);
+        root = nlohmann::json::parse(*spec_text);
     } catch (const std::exception&) {
         error_message = "status spec is not valid JSON: " + spec_path.string();
         return StatusErrorCode::kSpecInvalid;
@@ -36,6 +57,7 @@ StatusErrorCode LoadStatusSpec(
 
     StatusSpec spec;
     spec.app_id = app_id;
+    spec.version = spec_version;
 
     if (root.contains("appId") && root["appId"].is_string()) {
         spec.app_id = root["appId"].get<std::string>();
@@ -64,17 +86,20 @@ StatusErrorCode LoadStatusSpec(
     spec.operations.clear();
     const nlohmann::json& operations = root["operations"];
 
+    // Field references resolve to the latest earlier operation with that name.
+    std::map<std::string, std::size_t> defined_fields;
     std::size_t index;
     for (index = 0; index < operations.size(); ++index) {
         const nlohmann::json& op = operations[index];
         if (op.is_string()) {
-            ParsedOperation parsed;
+            CompiledOperation compiled;
             std::string parse_error;
-            if (!ParseStatusExpressionLine(op.get<std::string>(), parsed, parse_error)) {
+            if (!CompileStatusOperationLine(op.get<std::string>(), defined_fields, compiled, parse_error)) {
                 error_message = "status spec operation parse failed: " + parse_error;
                 return StatusErrorCode::kSpecInvalid;
             }
-            spec.operations.push_back(parsed);
+            defined_fields[compiled.field_name] = spec.operations.size();
+            spec.operations.push_back(compiled);
         }
     }
 
@@ -83,6 +108,12 @@ StatusErrorCode LoadStatusSpec(
         return StatusErrorCode::kSpecInvalid;
     }
 
+    file_cache.StoreDerived(
+        spec_path,
+        derived_kind,
+        spec_version,
+        std::make_shared<const StatusSpec>(spec),
+        spec_text->size() * kCompiledSpecBytesPerTextByte);
     spec_out = spec;
     return StatusErrorCode::kNone;
 }
@@ -7,7 +7,7 @@
 
 #include "../common/path_templates.h"
 #include "error_map.h"
-#include "status_expression_parser.h"
+#include "status_expression.h"
 
 namespace ProcessInterface {
 namespace Status {
@@ -19,7 +19,10 @@ struct StatusSpec {
     std::string pid_field;
     std::string host_running_field;
     std::string host_pid_field;
-    std::vector<ParsedOperation> operations;
+    // Compiled once per spec version; a field reference holds the index of the operation it reads.
+    std::vector<CompiledOperation> operations;
+    // Changes whenever the spec file does; 0 when the spec text could not be cached.
+    unsigned long long version;
 };
 
 StatusErrorCode LoadStatusSpec(
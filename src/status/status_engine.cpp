@@ -1,11 +1,19 @@
 #include "status_engine.h"
 
+#include <algorithm>
+#include <chrono>
 #include <map>
+#include <memory>
+#include <set>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "../../external/nlohmann/json.hpp"
-#include "../common/text.h"
 #include "debug.h"
+#include "evaluation_cache.h"
+#include "probe_scheduler.h"
+#include "status_expression.h"
 #include "status_operation_registry.h"
 
 namespace ProcessInterface {
@@ -13,88 +21,245 @@ namespace Status {
 
 namespace {
 
-nlohmann::json FieldOrDefault(
-    const std::map<std::string, nlohmann::json>& values,
-    const std::string& key,
-    const nlohmann::json& default_value) {
-    const std::map<std::string, nlohmann::json>::const_iterator iter = values.find(key);
-    if (iter == values.end()) {
-        return default_value;
+// Value of the last operation named field, or null when no operation sets it.
+nlohmann::json FieldValue(
+    const StatusSpec& spec,
+    const std::vector<StatusValuePtr>& values,
+    const std::string& field) {
+    std::size_t index = spec.operations.size();
+    while (index > 0) {
+        --index;
+        if (spec.operations[index].field_name == field) {
+            return values[index] ? *values[index] : nlohmann::json();
+        }
     }
-    return iter->second;
+    return nlohmann::json();
 }
 
-bool ParseBoolText(const std::string& text, bool default_value) {
-    const std::string trimmed = ProcessInterface::Common::TrimCopy(text);
-    if (trimmed == "true" || trimmed == "TRUE" || trimmed == "1") {
-        return true;
+nlohmann::json BuildStaleJson(const ScheduledProbeOutcome& outcome) {
+    nlohmann::json stale = nlohmann::json::object();
+    stale["reason"] = outcome.stale_reason;
+    stale["ageMs"] = outcome.age_ms >= 0 ? nlohmann::json(outcome.age_ms) : nlohmann::json(nullptr);
+    if (!outcome.error_message.empty()) {
+        stale["error"] = outcome.error_message;
     }
-    if (trimmed == "false" || trimmed == "FALSE" || trimmed == "0") {
-        return false;
+    if (outcome.stale_reason == "circuit_open") {
+        stale["retryInMs"] = outcome.retry_in_ms > 0 ? outcome.retry_in_ms : 0;
     }
-    return default_value;
+    return stale;
 }
 
-bool JsonToBool(const nlohmann::json& value, bool default_value) {
-    if (value.is_boolean()) {
-        return value.get<bool>();
-    }
-    if (value.is_number_integer()) {
-        return value.get<int>() != 0;
-    }
-    if (value.is_string()) {
-        return ParseBoolText(value.get<std::string>(), default_value);
-    }
-    return default_value;
+// Operations a partial evaluation runs, and the spec fields its payload carries.
+struct StatusFieldSelection {
+    std::vector<bool> operations;
+    std::set<std::string> fields;
+};
+
+bool Selected(const StatusFieldSelection* selection, std::size_t index) {
+    return selection == NULL || selection->operations[index];
 }
 
-bool JsonToInt(const nlohmann::json& value, int& out_value) {
-    if (value.is_number_integer()) {
-        out_value = value.get<int>();
-        return true;
-    }
-    if (value.is_string()) {
-        std::istringstream parser(ProcessInterface::Common::TrimCopy(value.get<std::string>()));
-        parser >> out_value;
-        return parser && parser.eof();
+// Index of the last operation setting field, whose value is the one the payload shows.
+bool LastOperationFor(const StatusSpec& spec, const std::string& field, std::size_t& index_out) {
+    std::size_t index = spec.operations.size();
+    while (index > 0) {
+        --index;
+        if (spec.operations[index].field_name == field) {
+            index_out = index;
+            return true;
+        }
     }
     return false;
 }
 
-}  // namespace
+void SelectStatusFields(
+    const StatusSpec& spec,
+    const std::vector<std::string>& fields,
+    StatusFieldSelection& selection_out) {
+    selection_out.operations.assign(spec.operations.size(), false);
+    selection_out.fields.clear();
 
-StatusErrorCode ExecuteStatusSpec(
+    std::vector<std::string> roots(fields);
+    roots.push_back(spec.running_field);
+    roots.push_back(spec.pid_field);
+    roots.push_back(spec.host_running_field);
+    roots.push_back(spec.host_pid_field);
+
+    std::vector<std::size_t> pending;
+    std::size_t index;
+    for (index = 0; index < roots.size(); ++index) {
+        std::size_t operation_index = 0;
+        if (!LastOperationFor(spec, roots[index], operation_index)) {
+            continue;
+        }
+        if (index < fields.size()) {
+            selection_out.fields.insert(roots[index]);
+        }
+        pending.push_back(operation_index);
+    }
+
+    // Inputs always precede the operation reading them, so this walks the graph backwards.
+    while (!pending.empty()) {
+        const std::size_t operation_index = pending.back();
+        pending.pop_back();
+        if (selection_out.operations[operation_index]) {
+            continue;
+        }
+        selection_out.operations[operation_index] = true;
+        const std::vector<std::size_t>& inputs = spec.operations[operation_index].inputs;
+        pending.insert(pending.end(), inputs.begin(), inputs.end());
+    }
+}
+
+// selection is NULL for a full evaluation. Partial ones reuse the previous full evaluation's
+// values where their inputs are unchanged but are not stored for the next one.
+StatusErrorCode ExecuteSelected(
     const StatusSpec& spec,
     const StatusContext& context,
+    const StatusFieldSelection* selection,
     std::string& payload_json,
+    StatusChangeSet& changes_out,
     std::string& error_message) {
-    std::map<std::string, nlohmann::json> values;
-    nlohmann::json payload_fields = nlohmann::json::object();
+    const std::size_t operation_count = spec.operations.size();
+    std::vector<StatusValuePtr> values(operation_count);
+    std::vector<std::string> stamps(operation_count);
+    std::vector<bool> changed(operation_count, true);
+    changes_out.unchanged = false;
+    changes_out.fields.clear();
+    changes_out.evaluated_operations = 0;
+
+    // The previous evaluation of this spec version: file ops whose stamp is unchanged and
+    // computed ops none of whose inputs changed keep their value from it.
+    StatusEvaluationCache& evaluation_cache = SharedStatusEvaluationCache();
+    const std::string state_key = context.repo_root.string() + "\n" + spec.app_id;
+    std::shared_ptr<const StatusEvaluationState> previous;
+    if (spec.version != 0) {
+        previous = evaluation_cache.Find(state_key);
+        if (previous && (previous->spec_version != spec.version || previous->values.size() != operation_count)) {
+            previous.reset();
+        }
+    }
 
+    // With a deadline, probe ops run up front on the shared scheduler and the rest are
+    // evaluated in spec order against their (possibly stale) values.
+    const bool bounded = context.deadline_ms > 0;
+    std::vector<ScheduledProbeOutcome> scheduled;
+    std::map<std::size_t, std::size_t> scheduled_by_operation;
+    nlohmann::json stale_fields = nlohmann::json::object();
     std::size_t index = 0;
-    for (index = 0; index < spec.operations.size(); ++index) {
-        const ParsedOperation& operation = spec.operations[index];
-        nlohmann::json value_json;
-        const StatusErrorCode rc = EvaluateOperation(operation, values, context, value_json, error_message);
-        if (rc != StatusErrorCode::kNone) {
-            error_message = "operation " + operation.field_name + " failed: " + error_message;
-            return rc;
+    if (bounded) {
+        std::vector<ParsedOperation> probe_operations;
+        for (index = 0; index < spec.operations.size(); ++index) {
+            const ParsedOperation* source = CompiledSourceOperation(spec.operations[index]);
+            if (source != NULL && IsProbeOperation(source->op_name) && Selected(selection, index)) {
+                scheduled_by_operation[index] = probe_operations.size();
+                probe_operations.push_back(*source);
+            }
+        }
+        SharedStatusProbeScheduler().Evaluate(
+            probe_operations,
+            context,
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(context.deadline_ms),
+            scheduled);
+    } else {
+        std::vector<ParsedOperation> source_operations;
+        for (index = 0; index < spec.operations.size(); ++index) {
+            const ParsedOperation* source = CompiledSourceOperation(spec.operations[index]);
+            if (source != NULL && Selected(selection, index)) {
+                source_operations.push_back(*source);
+            }
         }
+        PrefetchPortProbes(source_operations, context);
+    }
+
+    for (index = 0; index < operation_count; ++index) {
+        if (!Selected(selection, index)) {
+            continue;
+        }
+        const CompiledOperation& operation = spec.operations[index];
+        bool reuse = false;
+        const std::map<std::size_t, std::size_t>::const_iterator scheduled_iter = scheduled_by_operation.find(index);
+        if (scheduled_iter != scheduled_by_operation.end()) {
+            const ScheduledProbeOutcome& outcome = scheduled[scheduled_iter->second];
+            if (outcome.error_code == StatusErrorCode::kSpecInvalid) {
+                error_message = "operation " + operation.field_name + " failed: " + outcome.error_message;
+                return outcome.error_code;
+            }
+            values[index] = std::make_shared<const nlohmann::json>(outcome.value);
+            if (!outcome.stale_reason.empty()) {
+                stale_fields[operation.field_name] = BuildStaleJson(outcome);
+            }
+        } else {
+            const ParsedOperation* source = CompiledSourceOperation(operation);
+            if (source != NULL) {
+                // Taken before the read, so a write racing it is seen next time.
+                const bool stamped = OperationInputStamp(*source, context, stamps[index]);
+                reuse = previous && stamped && stamps[index] == previous->stamps[index];
+            } else if (previous) {
+                reuse = true;
+                std::size_t input;
+                for (input = 0; input < operation.inputs.size() && reuse; ++input) {
+                    reuse = !changed[operation.inputs[input]];
+                }
+            }
+
+            if (reuse) {
+                values[index] = previous->values[index];
+            } else {
+                ++changes_out.evaluated_operations;
+                nlohmann::json value_json;
+                const StatusErrorCode rc =
+                    EvaluateStatusExpression(*operation.expression, values, context, value_json, error_message);
+                if (rc != StatusErrorCode::kNone) {
+                    error_message = "operation " + operation.field_name + " failed: " + error_message;
+                    return rc;
+                }
+                values[index] = std::make_shared<const nlohmann::json>(std::move(value_json));
+            }
+        }
+
+        changed[index] = !reuse && (!previous || *values[index] != *previous->values[index]);
+    }
 
-        values[operation.field_name] = value_json;
-        if (!operation.field_name.empty() && operation.field_name[0] != '_') {
-            payload_fields[operation.field_name] = value_json;
+    nlohmann::json meta;
+    if (bounded) {
+        meta = nlohmann::json::object();
+        meta["deadlineMs"] = context.deadline_ms;
+        meta["stale"] = stale_fields;
+    }
+
+    bool any_changed = !previous || meta != previous->meta || selection != NULL;
+    for (index = 0; index < operation_count && !any_changed; ++index) {
+        any_changed = changed[index];
+    }
+    if (!any_changed) {
+        // Same values, same payload: hand out the bytes already built for it.
+        changes_out.unchanged = true;
+        payload_json = previous->payload_json;
+        return StatusErrorCode::kNone;
+    }
+
+    nlohmann::json payload_fields = nlohmann::json::object();
+    for (index = 0; index < operation_count; ++index) {
+        const std::string& field_name = spec.operations[index].field_name;
+        if (field_name.empty() || field_name[0] == '_') {
+            continue;
+        }
+        if (selection == NULL) {
+            payload_fields[field_name] = *values[index];
+        } else if (selection->fields.count(field_name) != 0 && values[index]) {
+            payload_fields[field_name] = *values[index];
         }
     }
 
-    const bool running = JsonToBool(FieldOrDefault(values, spec.running_field, false), false);
-    const bool host_running = JsonToBool(FieldOrDefault(values, spec.host_running_field, false), false);
+    const bool running = StatusTruthy(FieldValue(spec, values, spec.running_field));
+    const bool host_running = StatusTruthy(FieldValue(spec, values, spec.host_running_field));
 
     int pid = 0;
-    const bool has_pid = JsonToInt(FieldOrDefault(values, spec.pid_field, nullptr), pid);
+    const bool has_pid = StatusIntValue(FieldValue(spec, values, spec.pid_field), pid);
 
     int host_pid = 0;
-    const bool has_host_pid = JsonToInt(FieldOrDefault(values, spec.host_pid_field, nullptr), host_pid);
+    const bool has_host_pid = StatusIntValue(FieldValue(spec, values, spec.host_pid_field), host_pid);
 
     payload_fields["interfaceName"] = "generic-process-interface";
     payload_fields["interfaceVersion"] = 1;
@@ -106,9 +271,39 @@ StatusErrorCode ExecuteStatusSpec(
     payload_fields["hostPid"] = has_host_pid ? nlohmann::json(host_pid) : nlohmann::json(nullptr);
     payload_fields["bootId"] = (running && has_pid) ? (spec.app_id + ":" + std::to_string(pid)) : std::string();
     payload_fields["error"] = std::string();
+    if (bounded) {
+        payload_fields["_meta"] = meta;
+    }
 
     payload_json = payload_fields.dump();
 
+    nlohmann::json::const_iterator field_iter;
+    for (field_iter = payload_fields.begin(); field_iter != payload_fields.end(); ++field_iter) {
+        if (!previous || !previous->payload.contains(field_iter.key()) || previous->payload[field_iter.key()] != field_iter.value()) {
+            changes_out.fields.push_back(field_iter.key());
+        }
+    }
+    if (previous && selection == NULL) {
+        for (field_iter = previous->payload.begin(); field_iter != previous->payload.end(); ++field_iter) {
+            if (!payload_fields.contains(field_iter.key())) {
+                changes_out.fields.push_back(field_iter.key());
+            }
+        }
+    }
+    std::sort(changes_out.fields.begin(), changes_out.fields.end());
+    changes_out.unchanged = changes_out.fields.empty();
+
+    if (spec.version != 0 && selection == NULL) {
+        std::shared_ptr<StatusEvaluationState> state = std::make_shared<StatusEvaluationState>();
+        state->spec_version = spec.version;
+        state->values.swap(values);
+        state->stamps.swap(stamps);
+        state->meta = meta;
+        state->payload = payload_fields;
+        state->payload_json = payload_json;
+        evaluation_cache.Store(state_key, state);
+    }
+
     if (DebugEnabled()) {
         std::ostringstream keys_stream;
         keys_stream << "appId=" << spec.app_id << " payloadKeys=[";
@@ -130,5 +325,37 @@ StatusErrorCode ExecuteStatusSpec(
     return StatusErrorCode::kNone;
 }
 
+}  // namespace
+
+StatusErrorCode ExecuteStatusSpec(
+    const StatusSpec& spec,
+    const StatusContext& context,
+    std::string& payload_json,
+    std::string& error_message) {
+    StatusChangeSet changes;
+    return ExecuteSelected(spec, context, NULL, payload_json, changes, error_message);
+}
+
+StatusErrorCode ExecuteStatusSpec(
+    const StatusSpec& spec,
+    const StatusContext& context,
+    std::string& payload_json,
+    StatusChangeSet& changes_out,
+    std::string& error_message) {
+    return ExecuteSelected(spec, context, NULL, payload_json, changes_out, error_message);
+}
+
+StatusErrorCode ExecuteStatusSpecFields(
+    const StatusSpec& spec,
+    const StatusContext& context,
+    const std::vector<std::string>& fields,
+    std::string& payload_json,
+    std::string& error_message) {
+    StatusFieldSelection selection;
+    SelectStatusFields(spec, fields, selection);
+    StatusChangeSet changes;
+    return ExecuteSelected(spec, context, &selection, payload_json, changes, error_message);
+}
+
 }  // namespace Status
 }  // namespace ProcessInterface
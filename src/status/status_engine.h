@@ -1,7 +1,9 @@
 #ifndef PROCESS_INTERFACE_STATUS_STATUS_ENGINE_H
 #define PROCESS_INTERFACE_STATUS_STATUS_ENGINE_H
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "context.h"
 #include "error_map.h"
@@ -10,10 +12,42 @@
 namespace ProcessInterface {
 namespace Status {
 
+// How one evaluation's payload differs from the previous evaluation of the same spec version.
+struct StatusChangeSet {
+    // No payload field changed; payload_json is then the previous evaluation's bytes.
+    bool unchanged;
+    // Top-level payload fields that were added, removed or given a new value, sorted. Every
+    // field when there is no previous evaluation to compare with.
+    std::vector<std::string> fields;
+    // Operations actually evaluated; the rest kept their previous value.
+    std::size_t evaluated_operations;
+};
+
+StatusErrorCode ExecuteStatusSpec(
+    const StatusSpec& spec,
+    const StatusContext& context,
+    std::string& payload_json,
+    std::string& error_message);
+
+// Only operations whose inputs changed since the previous evaluation are evaluated: probe ops
+// always, file ops when their file's stamp changed, and computed ops when a field they read
+// changed. The previous payload and its bytes are reused when nothing changed.
 StatusErrorCode ExecuteStatusSpec(
     const StatusSpec& spec,
     const StatusContext& context,
     std::string& payload_json,
+    StatusChangeSet& changes_out,
+    std::string& error_message);
+
+// Evaluates only what fields and the contract fields (runningField, pidField, hostRunningField,
+// hostPidField) need: the last operation setting each of them and, transitively, every
+// operation those read. The payload has the contract fields plus the requested fields the
+// spec sets; other names are ignored. Nothing is kept for the next evaluation.
+StatusErrorCode ExecuteStatusSpecFields(
+    const StatusSpec& spec,
+    const StatusContext& context,
+    const std::vector<std::string>& fields,
+    std::string& payload_json,
     std::string& error_message);
 
 }  // namespace Status
@@ -0,0 +1,304 @@
+#include "status_expression.h"
+
+#include <sstream>
+
+#include "../common/text.h"
+#include "status_operation_registry.h"
+
+namespace ProcessInterface {
+namespace Status {
+
+namespace {
+
+bool ParseBoolText(const std::string& text, bool default_value) {
+    const std::string trimmed = ProcessInterface::Common::TrimCopy(text);
+    if (trimmed == "true" || trimmed == "TRUE" || trimmed == "1") {
+        return true;
+    }
+    if (trimmed == "false" || trimmed == "FALSE" || trimmed == "0") {
+        return false;
+    }
+    return default_value;
+}
+
+std::string InterpolatedText(const nlohmann::json& value) {
+    if (value.is_string()) {
+        return value.get<std::string>();
+    }
+    if (value.is_null()) {
+        return std::string();
+    }
+    return value.dump();
+}
+
+// Numbers compare by value and strings by bytes; anything else is unordered.
+bool Compare(const nlohmann::json& left, const nlohmann::json& right, int& order_out) {
+    if (left.is_number() && right.is_number()) {
+        if (left.is_number_float() || right.is_number_float()) {
+            const double left_value = left.get<double>();
+            const double right_value = right.get<double>();
+            order_out = left_value < right_value ? -1 : (right_value < left_value ? 1 : 0);
+        } else if (left.is_number_unsigned() && right.is_number_unsigned()) {
+            const unsigned long long left_value = left.get<unsigned long long>();
+            const unsigned long long right_value = right.get<unsigned long long>();
+            order_out = left_value < right_value ? -1 : (right_value < left_value ? 1 : 0);
+        } else {
+            const long long left_value = left.get<long long>();
+            const long long right_value = right.get<long long>();
+            order_out = left_value < right_value ? -1 : (right_value < left_value ? 1 : 0);
+        }
+        return true;
+    }
+    if (left.is_string() && right.is_string()) {
+        const int compared = left.get_ref<const std::string&>().compare(right.get_ref<const std::string&>());
+        order_out = compared < 0 ? -1 : (compared > 0 ? 1 : 0);
+        return true;
+    }
+    return false;
+}
+
+const nlohmann::json& NullValue() {
+    static const nlohmann::json null_value;
+    return null_value;
+}
+
+// Field references, and member or element accesses by a literal key on them, resolve to the
+// value in place instead of a copy of the (possibly large) container. False for any other
+// expression.
+bool ResolveInPlace(
+    const StatusExpression& expression,
+    const std::vector<StatusValuePtr>& values,
+    const nlohmann::json*& value_out) {
+    if (expression.kind == StatusExpressionKind::kField) {
+        value_out = expression.field_index < values.size() && values[expression.field_index]
+                        ? values[expression.field_index].get()
+                        : &NullValue();
+        return true;
+    }
+    if (expression.kind != StatusExpressionKind::kIndex ||
+        expression.operands[1]->kind != StatusExpressionKind::kLiteral) {
+        return false;
+    }
+
+    const nlohmann::json* container = NULL;
+    if (!ResolveInPlace(*expression.operands[0], values, container)) {
+        return false;
+    }
+    const nlohmann::json& key = expression.operands[1]->literal;
+    value_out = &NullValue();
+    if (container->is_object() && key.is_string()) {
+        const nlohmann::json::const_iterator found = container->find(key.get_ref<const std::string&>());
+        if (found != container->end()) {
+            value_out = &*found;
+        }
+    } else if (container->is_array() && key.is_number_integer()) {
+        const long long position = key.get<long long>();
+        if (position >= 0 && static_cast<unsigned long long>(position) < container->size()) {
+            value_out = &(*container)[static_cast<std::size_t>(position)];
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool StatusTruthy(const nlohmann::json& value) {
+    if (value.is_boolean()) {
+        return value.get<bool>();
+    }
+    if (value.is_number_integer()) {
+        return value.get<int>() != 0;
+    }
+    if (value.is_string()) {
+        return ParseBoolText(value.get<std::string>(), false);
+    }
+    return false;
+}
+
+bool StatusIntValue(const nlohmann::json& value, int& out_value) {
+    if (value.is_number_integer()) {
+        out_value = value.get<int>();
+        return true;
+    }
+    if (value.is_string()) {
+        const std::string trimmed = ProcessInterface::Common::TrimCopy(value.get<std::string>());
+        if (trimmed.empty()) {
+            return false;
+        }
+        std::istringstream parser(trimmed);
+        int parsed = 0;
+        parser >> parsed;
+        if (!parser || !parser.eof()) {
+            return false;
+        }
+        out_value = parsed;
+        return true;
+    }
+    return false;
+}
+
+const ParsedOperation* CompiledSourceOperation(const CompiledOperation& operation) {
+    if (!operation.expression || operation.expression->kind != StatusExpressionKind::kOperation) {
+        return NULL;
+    }
+    return &operation.expression->operation;
+}
+
+StatusErrorCode EvaluateStatusExpression(
+    const StatusExpression& expression,
+    const std::vector<StatusValuePtr>& values,
+    const StatusContext& context,
+    nlohmann::json& out_json,
+    std::string& error_message) {
+    const nlohmann::json* resolved = NULL;
+    if (ResolveInPlace(expression, values, resolved)) {
+        out_json = *resolved;
+        return StatusErrorCode::kNone;
+    }
+
+    switch (expression.kind) {
+        case StatusExpressionKind::kLiteral:
+            out_json = expression.literal;
+            return StatusErrorCode::kNone;
+
+        case StatusExpressionKind::kOperation:
+            return EvaluateOperation(expression.operation, context, out_json, error_message);
+
+        case StatusExpressionKind::kAnd:
+        case StatusExpressionKind::kOr:
+        case StatusExpressionKind::kCoalesce:
+        case StatusExpressionKind::kConditional: {
+            // Short-circuiting: the operand not taken is not evaluated.
+            nlohmann::json first;
+            StatusErrorCode rc = EvaluateStatusExpression(*expression.operands[0], values, context, first, error_message);
+            if (rc != StatusErrorCode::kNone) {
+                return rc;
+            }
+            std::size_t next = 1;
+            if (expression.kind == StatusExpressionKind::kAnd || expression.kind == StatusExpressionKind::kOr) {
+                const bool first_true = StatusTruthy(first);
+                if (first_true == (expression.kind == StatusExpressionKind::kOr)) {
+                    out_json = first_true;
+                    return StatusErrorCode::kNone;
+                }
+                nlohmann::json second;
+                rc = EvaluateStatusExpression(*expression.operands[1], values, context, second, error_message);
+                out_json = StatusTruthy(second);
+                return rc;
+            }
+            if (expression.kind == StatusExpressionKind::kCoalesce) {
+                if (!first.is_null()) {
+                    out_json = first;
+                    return StatusErrorCode::kNone;
+                }
+            } else {
+                next = StatusTruthy(first) ? 1 : 2;
+            }
+            return EvaluateStatusExpression(*expression.operands[next], values, context, out_json, error_message);
+        }
+
+        default:
+            break;
+    }
+
+    // Operands that resolve in place are read there; the rest are evaluated into storage.
+    std::vector<nlohmann::json> storage(expression.operands.size());
+    std::vector<const nlohmann::json*> operands(expression.operands.size(), NULL);
+    std::size_t index;
+    for (index = 0; index < expression.operands.size(); ++index) {
+        if (ResolveInPlace(*expression.operands[index], values, operands[index])) {
+            continue;
+        }
+        const StatusErrorCode rc =
+            EvaluateStatusExpression(*expression.operands[index], values, context, storage[index], error_message);
+        if (rc != StatusErrorCode::kNone) {
+            return rc;
+        }
+        operands[index] = &storage[index];
+    }
+
+    int order = 0;
+    switch (expression.kind) {
+        case StatusExpressionKind::kIndex: {
+            const nlohmann::json& container = *operands[0];
+            const nlohmann::json& key = *operands[1];
+            out_json = nullptr;
+            if (container.is_object() && key.is_string()) {
+                const nlohmann::json::const_iterator found = container.find(key.get_ref<const std::string&>());
+                if (found != container.end()) {
+                    out_json = *found;
+                }
+            } else if (container.is_array() && key.is_number_integer()) {
+                const long long position = key.get<long long>();
+                if (position >= 0 && static_cast<unsigned long long>(position) < container.size()) {
+                    out_json = container[static_cast<std::size_t>(position)];
+                }
+            }
+            break;
+        }
+        case StatusExpressionKind::kNot:
+            out_json = !StatusTruthy(*operands[0]);
+            break;
+        case StatusExpressionKind::kNegate:
+            if (operands[0]->is_number_float()) {
+                out_json = -operands[0]->get<double>();
+            } else if (operands[0]->is_number()) {
+                out_json = -operands[0]->get<long long>();
+            } else {
+                out_json = nullptr;
+            }
+            break;
+        case StatusExpressionKind::kEqual:
+            out_json = *operands[0] == *operands[1];
+            break;
+        case StatusExpressionKind::kNotEqual:
+            out_json = *operands[0] != *operands[1];
+            break;
+        case StatusExpressionKind::kLess:
+            out_json = Compare(*operands[0], *operands[1], order) && order < 0;
+            break;
+        case StatusExpressionKind::kLessEqual:
+            out_json = Compare(*operands[0], *operands[1], order) && order <= 0;
+            break;
+        case StatusExpressionKind::kGreater:
+            out_json = Compare(*operands[0], *operands[1], order) && order > 0;
+            break;
+        case StatusExpressionKind::kGreaterEqual:
+            out_json = Compare(*operands[0], *operands[1], order) && order >= 0;
+            break;
+        case StatusExpressionKind::kInterpolate: {
+            std::string text;
+            for (index = 0; index < operands.size(); ++index) {
+                text += InterpolatedText(*operands[index]);
+            }
+            out_json = text;
+            break;
+        }
+        case StatusExpressionKind::kCall: {
+            int parsed = 0;
+            switch (expression.builtin) {
+                case StatusBuiltin::kBool:
+                    out_json = StatusTruthy(*operands[0]);
+                    break;
+                case StatusBuiltin::kInt:
+                    out_json = StatusIntValue(*operands[0], parsed) ? nlohmann::json(parsed) : nlohmann::json(nullptr);
+                    break;
+                case StatusBuiltin::kHas:
+                    out_json = operands[0]->is_object() && operands[1]->is_string() &&
+                               operands[0]->contains(operands[1]->get_ref<const std::string&>());
+                    break;
+                case StatusBuiltin::kIsString:
+                    out_json = operands[0]->is_string();
+                    break;
+            }
+            break;
+        }
+        default:
+            error_message = "unsupported expression";
+            return StatusErrorCode::kSpecInvalid;
+    }
+    return StatusErrorCode::kNone;
+}
+
+}  // namespace Status
+}  // namespace ProcessInterface
@@ -0,0 +1,104 @@
+#ifndef PROCESS_INTERFACE_STATUS_STATUS_EXPRESSION_H
+#define PROCESS_INTERFACE_STATUS_STATUS_EXPRESSION_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../external/nlohmann/json.hpp"
+#include "context.h"
+#include "error_map.h"
+#include "status_expression_parser.h"
+
+namespace ProcessInterface {
+namespace Status {
+
+enum class StatusExpressionKind {
+    kLiteral,
+    // Value of an earlier operation.
+    kField,
+    // operands[0][operands[1]]: object member by string, array element by integer; else null.
+    kIndex,
+    kNot,
+    kNegate,
+    kAnd,
+    kOr,
+    // operands[0] unless it is null, else operands[1].
+    kCoalesce,
+    kEqual,
+    kNotEqual,
+    kLess,
+    kLessEqual,
+    kGreater,
+    kGreaterEqual,
+    // operands[0] ? operands[1] : operands[2]
+    kConditional,
+    // Concatenated text of all operands.
+    kInterpolate,
+    kCall,
+    // A source op (file, process, port, plugin ...) run through EvaluateOperation.
+    kOperation,
+};
+
+enum class StatusBuiltin {
+    // Truthiness as below.
+    kBool,
+    // Integer, or integer text, as an integer; else null.
+    kInt,
+    // Whether operands[0] is an object with member operands[1].
+    kHas,
+    kIsString,
+};
+
+const std::size_t kNoStatusField = static_cast<std::size_t>(-1);
+
+// Typed expression tree built once when a spec is loaded. Truthiness (!, &&, ||, ?:) is the
+// one runningField uses: true, non-zero integers and the strings true/TRUE/1.
+struct StatusExpression {
+    StatusExpressionKind kind;
+    // kLiteral
+    nlohmann::json literal;
+    // kField: the field name and the index of the operation whose value it reads.
+    std::string field_name;
+    std::size_t field_index;
+    // kCall
+    StatusBuiltin builtin;
+    std::vector<std::shared_ptr<const StatusExpression> > operands;
+    // kOperation
+    ParsedOperation operation;
+};
+
+typedef std::shared_ptr<const StatusExpression> StatusExpressionPtr;
+
+// Value of one operation, shared so a value that did not change is carried from one
+// evaluation to the next without being copied. A null pointer reads as JSON null.
+typedef std::shared_ptr<const nlohmann::json> StatusValuePtr;
+
+// One entry of a spec's operations array.
+struct CompiledOperation {
+    std::string field_name;
+    StatusExpressionPtr expression;
+    // Indexes of the earlier operations the expression reads, ascending and without duplicates.
+    std::vector<std::size_t> inputs;
+};
+
+// values holds the value of every operation evaluated so far, by operation index. Fails
+// only when a kOperation does.
+StatusErrorCode EvaluateStatusExpression(
+    const StatusExpression& expression,
+    const std::vector<StatusValuePtr>& values,
+    const StatusContext& context,
+    nlohmann::json& out_json,
+    std::string& error_message);
+
+// The source op an operation runs, or NULL when it is computed from other fields.
+const ParsedOperation* CompiledSourceOperation(const CompiledOperation& operation);
+
+bool StatusTruthy(const nlohmann::json& value);
+bool StatusIntValue(const nlohmann::json& value, int& out_value);
+
+}  // namespace Status
+}  // namespace ProcessInterface
+
+#endif  // PROCESS_INTERFACE_STATUS_STATUS_EXPRESSION_H
@@ -1,10 +1,662 @@
 #include "status_expression_parser.h"
 
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <utility>
+
+#include "../../external/nlohmann/json.hpp"
 #include "../common/text.h"
+#include "status_expression.h"
 
 namespace ProcessInterface {
 namespace Status {
 
+namespace {
+
+typedef std::shared_ptr<StatusExpression> MutableExpressionPtr;
+
+MutableExpressionPtr MakeExpression(StatusExpressionKind kind) {
+    MutableExpressionPtr expression = std::make_shared<StatusExpression>();
+    expression->kind = kind;
+    expression->field_index = kNoStatusField;
+    expression->builtin = StatusBuiltin::kBool;
+    return expression;
+}
+
+MutableExpressionPtr MakeLiteral(const nlohmann::json& value) {
+    MutableExpressionPtr expression = MakeExpression(StatusExpressionKind::kLiteral);
+    expression->literal = value;
+    return expression;
+}
+
+MutableExpressionPtr MakeNode(
+    StatusExpressionKind kind,
+    const StatusExpressionPtr& first,
+    const StatusExpressionPtr& second = StatusExpressionPtr(),
+    const StatusExpressionPtr& third = StatusExpressionPtr()) {
+    MutableExpressionPtr expression = MakeExpression(kind);
+    expression->operands.push_back(first);
+    if (second) {
+        expression->operands.push_back(second);
+    }
+    if (third) {
+        expression->operands.push_back(third);
+    }
+    return expression;
+}
+
+MutableExpressionPtr MakeCall(StatusBuiltin builtin, const StatusExpressionPtr& first,
+                              const StatusExpressionPtr& second = StatusExpressionPtr()) {
+    MutableExpressionPtr expression = MakeNode(StatusExpressionKind::kCall, first, second);
+    expression->builtin = builtin;
+    return expression;
+}
+
+// Fields not set by an earlier entry read as null, as they always did in the colon syntax.
+MutableExpressionPtr MakeLegacyField(const std::map<std::string, std::size_t>& defined_fields, const std::string& name) {
+    const std::string trimmed = ProcessInterface::Common::TrimCopy(name);
+    const std::map<std::string, std::size_t>::const_iterator found = defined_fields.find(trimmed);
+    if (found == defined_fields.end()) {
+        return MakeLiteral(nullptr);
+    }
+    MutableExpressionPtr expression = MakeExpression(StatusExpressionKind::kField);
+    expression->field_name = trimmed;
+    expression->field_index = found->second;
+    return expression;
+}
+
+bool TryParseJsonLiteral(const std::string& text, nlohmann::json& value_out) {
+    try {
+        value_out = nlohmann::json::parse(text);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool ParseBoolText(const std::string& text, bool default_value) {
+    const std::string trimmed = ProcessInterface::Common::TrimCopy(text);
+    if (trimmed == "true" || trimmed == "TRUE" || trimmed == "1") {
+        return true;
+    }
+    if (trimmed == "false" || trimmed == "FALSE" || trimmed == "0") {
+        return false;
+    }
+    return default_value;
+}
+
+// derive:<sub>:... as the expression it always computed.
+bool CompileDerive(
+    const std::vector<std::string>& args,
+    const std::map<std::string, std::size_t>& defined_fields,
+    MutableExpressionPtr& expression_out,
+    std::string& error_message) {
+    if (args.empty()) {
+        error_message = "derive requires sub-operation";
+        return false;
+    }
+
+    const std::string sub = ProcessInterface::Common::TrimCopy(args[0]);
+
+    if (sub == "copy") {
+        if (args.size() < 2) {
+            error_message = "derive copy requires source field";
+            return false;
+        }
+        expression_out = MakeLegacyField(defined_fields, args[1]);
+        return true;
+    }
+
+    if (sub == "bool_from_obj" || sub == "int_from_obj" || sub == "str_from_obj" || sub == "json_from_obj") {
+        if (args.size() < 3) {
+            error_message = "derive " + sub + " requires source and key";
+            return false;
+        }
+        const MutableExpressionPtr source = MakeLegacyField(defined_fields, args[1]);
+        const MutableExpressionPtr key = MakeLiteral(ProcessInterface::Common::TrimCopy(args[2]));
+        const MutableExpressionPtr member = MakeNode(StatusExpressionKind::kIndex, source, key);
+
+        if (sub == "bool_from_obj") {
+            const bool fallback = args.size() > 3 ? ParseBoolText(args[3], false) : false;
+            expression_out = MakeNode(
+                StatusExpressionKind::kConditional,
+                MakeCall(StatusBuiltin::kHas, source, key),
+                MakeCall(StatusBuiltin::kBool, member),
+                MakeLiteral(fallback));
+        } else if (sub == "int_from_obj") {
+            expression_out = MakeCall(StatusBuiltin::kInt, member);
+        } else if (sub == "str_from_obj") {
+            expression_out = MakeNode(
+                StatusExpressionKind::kConditional,
+                MakeCall(StatusBuiltin::kIsString, member),
+                member,
+                MakeLiteral(args.size() > 3 ? args[3] : std::string()));
+        } else {
+            nlohmann::json fallback;
+            if (args.size() <= 3 || !TryParseJsonLiteral(ProcessInterface::Common::TrimCopy(args[3]), fallback)) {
+                fallback = nullptr;
+            }
+            expression_out = MakeNode(
+                StatusExpressionKind::kConditional,
+                MakeCall(StatusBuiltin::kHas, source, key),
+                member,
+                MakeLiteral(fallback));
+        }
+        return true;
+    }
+
+    if (sub == "running_display") {
+        if (args.size() < 3) {
+            error_message = "derive running_display requires running and pid fields";
+            return false;
+        }
+        const MutableExpressionPtr pid = MakeCall(StatusBuiltin::kInt, MakeLegacyField(defined_fields, args[2]));
+        MutableExpressionPtr with_pid = MakeExpression(StatusExpressionKind::kInterpolate);
+        with_pid->operands.push_back(MakeLiteral("True (PID "));
+        with_pid->operands.push_back(pid);
+        with_pid->operands.push_back(MakeLiteral(")"));
+        expression_out = MakeNode(
+            StatusExpressionKind::kConditional,
+            MakeLegacyField(defined_fields, args[1]),
+            MakeNode(
+                StatusExpressionKind::kConditional,
+                MakeNode(StatusExpressionKind::kNotEqual, pid, MakeLiteral(nullptr)),
+                with_pid,
+                MakeLiteral("True")),
+            MakeLiteral("False"));
+        return true;
+    }
+
+    if (sub == "str_if_bool") {
+        if (args.size() < 4) {
+            error_message = "derive str_if_bool requires bool field and true/false text";
+            return false;
+        }
+        expression_out = MakeNode(
+            StatusExpressionKind::kConditional,
+            MakeLegacyField(defined_fields, args[1]),
+            MakeLiteral(args[2]),
+            MakeLiteral(args[3]));
+        return true;
+    }
+
+    if (sub == "pick_int") {
+        if (args.size() < 3) {
+            error_message = "derive pick_int requires primary and fallback fields";
+            return false;
+        }
+        expression_out = MakeNode(
+            StatusExpressionKind::kCoalesce,
+            MakeCall(StatusBuiltin::kInt, MakeLegacyField(defined_fields, args[1])),
+            MakeCall(StatusBuiltin::kInt, MakeLegacyField(defined_fields, args[2])));
+        return true;
+    }
+
+    if (sub == "or_bool") {
+        if (args.size() < 3) {
+            error_message = "derive or_bool requires two bool fields";
+            return false;
+        }
+        expression_out = MakeNode(
+            StatusExpressionKind::kOr,
+            MakeLegacyField(defined_fields, args[1]),
+            MakeLegacyField(defined_fields, args[2]));
+        return true;
+    }
+
+    error_message = "unsupported derive operation: " + sub;
+    return false;
+}
+
+bool CompileColonOperation(
+    const ParsedOperation& operation,
+    const std::map<std::string, std::size_t>& defined_fields,
+    MutableExpressionPtr& expression_out,
+    std::string& error_message) {
+    if (operation.op_name == "const") {
+        nlohmann::json literal;
+        if (!TryParseJsonLiteral(ProcessInterface::Common::TrimCopy(ProcessInterface::Common::Join(operation.args, 0, ":")), literal)) {
+            error_message = "const op requires JSON literal";
+            return false;
+        }
+        expression_out = MakeLiteral(literal);
+        return true;
+    }
+    if (operation.op_name == "const_str") {
+        expression_out = MakeLiteral(ProcessInterface::Common::Join(operation.args, 0, ":"));
+        return true;
+    }
+    if (operation.op_name == "derive") {
+        return CompileDerive(operation.args, defined_fields, expression_out, error_message);
+    }
+    expression_out = MakeExpression(StatusExpressionKind::kOperation);
+    expression_out->operation = operation;
+    return true;
+}
+
+// Recursive descent over the expression grammar, lowest precedence first:
+//   conditional := coalesce ("?" conditional ":" conditional)?
+//   coalesce    := or ("??" or)*
+//   or          := and ("||" and)*
+//   and         := equality ("&&" equality)*
+//   equality    := comparison (("==" | "!=") comparison)*
+//   comparison  := unary (("<" | "<=" | ">" | ">=") unary)*
+//   unary       := ("!" | "-") unary | postfix
+//   postfix     := primary ("." name | "[" conditional "]")*
+//   primary     := literal | string | name | name "(" arguments ")" | "(" conditional ")"
+class ExpressionParser {
+public:
+    ExpressionParser(const std::string& text, const std::map<std::string, std::size_t>& defined_fields)
+        : text_(text),
+          position_(0),
+          defined_fields_(defined_fields) {}
+
+    bool Parse(MutableExpressionPtr& expression_out, std::string& error_message) {
+        MutableExpressionPtr expression;
+        if (!ParseConditional(expression)) {
+            error_message = error_;
+            return false;
+        }
+        SkipSpace();
+        if (position_ < text_.size()) {
+            error_message = Unexpected();
+            return false;
+        }
+        expression_out = expression;
+        return true;
+    }
+
+private:
+    void SkipSpace() {
+        while (position_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[position_])) != 0) {
+            ++position_;
+        }
+    }
+
+    // Consumes token when it comes next (ignoring whitespace) and is not the start of a longer operator.
+    bool Match(const char* token) {
+        SkipSpace();
+        const std::string expected(token);
+        if (text_.compare(position_, expected.size(), expected) != 0) {
+            return false;
+        }
+        const std::size_t after = position_ + expected.size();
+        if (after < text_.size()) {
+            const char next = text_[after];
+            if ((expected == "?" && next == '?') || ((expected == "<" || expected == ">" || expected == "!") && next == '=')) {
+                return false;
+            }
+        }
+        position_ = after;
+        return true;
+    }
+
+    bool Fail(const std::string& message) {
+        if (error_.empty()) {
+            error_ = message + " at column " + std::to_string(position_ + 1);
+        }
+        return false;
+    }
+
+    std::string Unexpected() {
+        if (position_ >= text_.size()) {
+            return "unexpected end of expression";
+        }
+        return std::string("unexpected '") + text_[position_] + "' at column " + std::to_string(position_ + 1);
+    }
+
+    bool Expect(const char* token) {
+        if (Match(token)) {
+            return true;
+        }
+        if (error_.empty()) {
+            error_ = "expected '" + std::string(token) + "', " + Unexpected();
+        }
+        return false;
+    }
+
+    bool ParseConditional(MutableExpressionPtr& out) {
+        MutableExpressionPtr condition;
+        if (!ParseCoalesce(condition)) {
+            return false;
+        }
+        if (!Match("?")) {
+            out = condition;
+            return true;
+        }
+        MutableExpressionPtr when_true;
+        MutableExpressionPtr when_false;
+        if (!ParseConditional(when_true) || !Expect(":") || !ParseConditional(when_false)) {
+            return false;
+        }
+        out = MakeNode(StatusExpressionKind::kConditional, condition, when_true, when_false);
+        return true;
+    }
+
+    bool ParseCoalesce(MutableExpressionPtr& out) {
+        if (!ParseOr(out)) {
+            return false;
+        }
+        while (Match("??")) {
+            MutableExpressionPtr right;
+            if (!ParseOr(right)) {
+                return false;
+            }
+            out = MakeNode(StatusExpressionKind::kCoalesce, out, right);
+        }
+        return true;
+    }
+
+    bool ParseOr(MutableExpressionPtr& out) {
+        if (!ParseAnd(out)) {
+            return false;
+        }
+        while (Match("||")) {
+            MutableExpressionPtr right;
+            if (!ParseAnd(right)) {
+                return false;
+            }
+            out = MakeNode(StatusExpressionKind::kOr, out, right);
+        }
+        return true;
+    }
+
+    bool ParseAnd(MutableExpressionPtr& out) {
+        if (!ParseEquality(out)) {
+            return false;
+        }
+        while (Match("&&")) {
+            MutableExpressionPtr right;
+            if (!ParseEquality(right)) {
+                return false;
+            }
+            out = MakeNode(StatusExpressionKind::kAnd, out, right);
+        }
+        return true;
+    }
+
+    bool ParseEquality(MutableExpressionPtr& out) {
+        if (!ParseComparison(out)) {
+            return false;
+        }
+        for (;;) {
+            StatusExpressionKind kind;
+            if (Match("==")) {
+                kind = StatusExpressionKind::kEqual;
+            } else if (Match("!=")) {
+                kind = StatusExpressionKind::kNotEqual;
+            } else {
+                return true;
+            }
+            MutableExpressionPtr right;
+            if (!ParseComparison(right)) {
+                return false;
+            }
+            out = MakeNode(kind, out, right);
+        }
+    }
+
+    bool ParseComparison(MutableExpressionPtr& out) {
+        if (!ParseUnary(out)) {
+            return false;
+        }
+        for (;;) {
+            StatusExpressionKind kind;
+            if (Match("<=")) {
+                kind = StatusExpressionKind::kLessEqual;
+            } else if (Match(">=")) {
+                kind = StatusExpressionKind::kGreaterEqual;
+            } else if (Match("<")) {
+                kind = StatusExpressionKind::kLess;
+            } else if (Match(">")) {
+                kind = StatusExpressionKind::kGreater;
+            } else {
+                return true;
+            }
+            MutableExpressionPtr right;
+            if (!ParseUnary(right)) {
+                return false;
+            }
+            out = MakeNode(kind, out, right);
+        }
+    }
+
+    bool ParseUnary(MutableExpressionPtr& out) {
+        StatusExpressionKind kind;
+        if (Match("!")) {
+            kind = StatusExpressionKind::kNot;
+        } else if (Match("-")) {
+            kind = StatusExpressionKind::kNegate;
+        } else {
+            return ParsePostfix(out);
+        }
+        MutableExpressionPtr operand;
+        if (!ParseUnary(operand)) {
+            return false;
+        }
+        out = MakeNode(kind, operand);
+        return true;
+    }
+
+    bool ParsePostfix(MutableExpressionPtr& out) {
+        if (!ParsePrimary(out)) {
+            return false;
+        }
+        for (;;) {
+            if (Match(".")) {
+                SkipSpace();
+                std::string name;
+                if (!ParseName(name)) {
+                    return Fail("expected member name after '.'");
+                }
+                out = MakeNode(StatusExpressionKind::kIndex, out, MakeLiteral(name));
+            } else if (Match("[")) {
+                MutableExpressionPtr index;
+                if (!ParseConditional(index) || !Expect("]")) {
+                    return false;
+                }
+                out = MakeNode(StatusExpressionKind::kIndex, out, index);
+            } else {
+                return true;
+            }
+        }
+    }
+
+    bool ParseName(std::string& name_out) {
+        const std::size_t start = position_;
+        while (position_ < text_.size() &&
+               (std::isalnum(static_cast<unsigned char>(text_[position_])) != 0 || text_[position_] == '_')) {
+            if (position_ == start && std::isdigit(static_cast<unsigned char>(text_[position_])) != 0) {
+                break;
+            }
+            ++position_;
+        }
+        name_out = text_.substr(start, position_ - start);
+        return !name_out.empty();
+    }
+
+    bool ParsePrimary(MutableExpressionPtr& out) {
+        SkipSpace();
+        if (position_ >= text_.size()) {
+            return Fail("unexpected end of expression");
+        }
+        const char next = text_[position_];
+        if (Match("(")) {
+            return ParseConditional(out) && Expect(")");
+        }
+        if (next == '"' || next == '\'') {
+            ++position_;
+            return ParseString(next, out);
+        }
+        if (std::isdigit(static_cast<unsigned char>(next)) != 0) {
+            return ParseNumber(out);
+        }
+
+        std::string name;
+        if (!ParseName(name)) {
+            error_ = Unexpected();
+            return false;
+        }
+        if (name == "true" || name == "false") {
+            out = MakeLiteral(name == "true");
+            return true;
+        }
+        if (name == "null") {
+            out = MakeLiteral(nullptr);
+            return true;
+        }
+        if (Match("(")) {
+            return ParseCall(name, out);
+        }
+
+        const std::map<std::string, std::size_t>::const_iterator found = defined_fields_.find(name);
+        if (found == defined_fields_.end()) {
+            position_ -= name.size();
+            return Fail("unknown field '" + name + "'");
+        }
+        out = MakeExpression(StatusExpressionKind::kField);
+        out->field_name = name;
+        out->field_index = found->second;
+        return true;
+    }
+
+    bool ParseCall(const std::string& name, MutableExpressionPtr& out) {
+        std::size_t arity = 1;
+        out = MakeExpression(StatusExpressionKind::kCall);
+        if (name == "bool") {
+            out->builtin = StatusBuiltin::kBool;
+        } else if (name == "int") {
+            out->builtin = StatusBuiltin::kInt;
+        } else if (name == "has") {
+            out->builtin = StatusBuiltin::kHas;
+            arity = 2;
+        } else if (name == "is_string") {
+            out->builtin = StatusBuiltin::kIsString;
+        } else {
+            return Fail("unknown function '" + name + "'");
+        }
+
+        if (!Match(")")) {
+            do {
+                MutableExpressionPtr argument;
+                if (!ParseConditional(argument)) {
+                    return false;
+                }
+                out->operands.push_back(argument);
+            } while (Match(","));
+            if (!Expect(")")) {
+                return false;
+            }
+        }
+        if (out->operands.size() != arity) {
+            return Fail(name + "() takes " + std::to_string(arity) + " argument" + (arity == 1 ? "" : "s"));
+        }
+        return true;
+    }
+
+    bool ParseNumber(MutableExpressionPtr& out) {
+        const std::size_t start = position_;
+        while (position_ < text_.size() &&
+               (std::isdigit(static_cast<unsigned char>(text_[position_])) != 0 || text_[position_] == '.' ||
+                text_[position_] == 'e' || text_[position_] == 'E' ||
+                ((text_[position_] == '+' || text_[position_] == '-') &&
+                 (text_[position_ - 1] == 'e' || text_[position_ - 1] == 'E')))) {
+            ++position_;
+        }
+        nlohmann::json number;
+        if (!TryParseJsonLiteral(text_.substr(start, position_ - start), number) || !number.is_number()) {
+            position_ = start;
+            return Fail("invalid number");
+        }
+        out = MakeLiteral(number);
+        return true;
+    }
+
+    // After the opening quote. Double-quoted strings interpolate ${expression}.
+    bool ParseString(char quote, MutableExpressionPtr& out) {
+        MutableExpressionPtr parts = MakeExpression(StatusExpressionKind::kInterpolate);
+        std::string literal;
+        for (;;) {
+            if (position_ >= text_.size()) {
+                return Fail("unterminated string");
+            }
+            const char current = text_[position_++];
+            if (current == quote) {
+                break;
+            }
+            if (current == '\\') {
+                if (position_ >= text_.size()) {
+                    return Fail("unterminated string");
+                }
+                const char escaped = text_[position_++];
+                switch (escaped) {
+                    case 'n':
+                        literal.push_back('\n');
+                        break;
+                    case 't':
+                        literal.push_back('\t');
+                        break;
+                    case 'r':
+                        literal.push_back('\r');
+                        break;
+                    case '"':
+                    case '\'':
+                    case '\\':
+                    case '$':
+                        literal.push_back(escaped);
+                        break;
+                    default:
+                        --position_;
+                        return Fail(std::string("invalid escape '\\") + escaped + "'");
+                }
+                continue;
+            }
+            if (quote == '"' && current == '$' && position_ < text_.size() && text_[position_] == '{') {
+                ++position_;
+                if (!literal.empty()) {
+                    parts->operands.push_back(MakeLiteral(literal));
+                    literal.clear();
+                }
+                MutableExpressionPtr embedded;
+                if (!ParseConditional(embedded) || !Expect("}")) {
+                    return false;
+                }
+                parts->operands.push_back(embedded);
+                continue;
+            }
+            literal.push_back(current);
+        }
+
+        if (parts->operands.empty()) {
+            out = MakeLiteral(literal);
+            return true;
+        }
+        if (!literal.empty()) {
+            parts->operands.push_back(MakeLiteral(literal));
+        }
+        out = parts;
+        return true;
+    }
+
+    const std::string text_;
+    std::size_t position_;
+    const std::map<std::string, std::size_t>& defined_fields_;
+    std::string error_;
+};
+
+void CollectFieldInputs(const StatusExpression& expression, std::vector<std::size_t>& inputs_out) {
+    if (expression.kind == StatusExpressionKind::kField) {
+        inputs_out.push_back(expression.field_index);
+    }
+    std::size_t index;
+    for (index = 0; index < expression.operands.size(); ++index) {
+        CollectFieldInputs(*expression.operands[index], inputs_out);
+    }
+}
+
+}  // namespace
+
 bool ParseStatusExpressionLine(
     const std::string& line,
     ParsedOperation& operation_out,
@@ -50,5 +702,48 @@ bool ParseStatusExpressionLine(
     return true;
 }
 
+bool CompileStatusOperationLine(
+    const std::string& line,
+    const std::map<std::string, std::size_t>& defined_fields,
+    CompiledOperation& operation_out,
+    std::string& error_message) {
+    const std::string trimmed_line = ProcessInterface::Common::TrimCopy(line);
+    const std::size_t equal_index = trimmed_line.find('=');
+
+    MutableExpressionPtr expression;
+    if (equal_index != std::string::npos && equal_index > 0 && trimmed_line[equal_index - 1] == ':') {
+        const std::string field_name = ProcessInterface::Common::TrimCopy(trimmed_line.substr(0, equal_index - 1));
+        if (field_name.empty()) {
+            error_message = "operation field is empty";
+            return false;
+        }
+        ExpressionParser parser(trimmed_line.substr(equal_index + 1), defined_fields);
+        std::string parse_error;
+        if (!parser.Parse(expression, parse_error)) {
+            error_message = field_name + ": " + parse_error;
+            return false;
+        }
+        operation_out.field_name = field_name;
+    } else {
+        ParsedOperation parsed;
+        if (!ParseStatusExpressionLine(line, parsed, error_message)) {
+            return false;
+        }
+        std::string compile_error;
+        if (!CompileColonOperation(parsed, defined_fields, expression, compile_error)) {
+            error_message = parsed.field_name + ": " + compile_error;
+            return false;
+        }
+        operation_out.field_name = parsed.field_name;
+    }
+
+    operation_out.expression = expression;
+    operation_out.inputs.clear();
+    CollectFieldInputs(*expression, operation_out.inputs);
+    std::sort(operation_out.inputs.begin(), operation_out.inputs.end());
+    operation_out.inputs.erase(std::unique(operation_out.inputs.begin(), operation_out.inputs.end()), operation_out.inputs.end());
+    return true;
+}
+
 }  // namespace Status
 }  // namespace ProcessInterface
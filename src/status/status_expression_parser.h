@@ -1,6 +1,8 @@
 #ifndef PROCESS_INTERFACE_STATUS_EXPRESSION_PARSER_H
 #define PROCESS_INTERFACE_STATUS_EXPRESSION_PARSER_H
 
+#include <cstddef>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -13,11 +15,28 @@ struct ParsedOperation {
     std::vector<std::string> args;
 };
 
+struct CompiledOperation;
+
+// Splits a colon-syntax line (name=op:arg:...) into its parts.
 bool ParseStatusExpressionLine(
     const std::string& line,
     ParsedOperation& operation_out,
     std::string& error_message);
 
+// Compiles one entry of a spec's operations array, in either syntax, to an expression tree:
+//   name=op:arg:...     const, const_str and derive sub-ops become the equivalent expression;
+//                       every other op becomes a kOperation leaf.
+//   name := expression  field references, JSON literals, "text ${expr}" interpolation,
+//                       'raw text', ! && || == != < <= > >= ?? ?: a.b a[i] and the builtins
+//                       bool(x), int(x), has(obj, key), is_string(x).
+// defined_fields maps every field set by an earlier entry to the index of the latest entry
+// setting it; expressions may only reference those.
+bool CompileStatusOperationLine(
+    const std::string& line,
+    const std::map<std::string, std::size_t>& defined_fields,
+    CompiledOperation& operation_out,
+    std::string& error_message);
+
 }  // namespace Status
 }  // namespace ProcessInterface
 
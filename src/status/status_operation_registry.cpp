@@ -1,19 +1,57 @@
 #include "status_operation_registry.h"
 
+#include <cmath>
+#include <functional>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "../common/file_cache.h"
 #include "../common/file_io.h"
+#include "../common/file_tail.h"
 #include "../common/text.h"
 #include "debug.h"
+#include "json_projection.h"
+#include "probe_plugins.h"
 
 namespace ProcessInterface {
 namespace Status {
 
 namespace {
 
+const int kDefaultTailLines = 10;
+const int kMaxTailLines = 1000;
+// Per-member cost of an object on top of its value: the map node and the key string.
+const std::size_t kJsonMemberOverheadBytes = 32 + sizeof(std::string);
+
+// Heap footprint of a parsed document, charged to the file cache for file_json values.
+std::size_t EstimateJsonBytes(const nlohmann::json& root) {
+    std::size_t bytes = 0;
+    std::vector<const nlohmann::json*> pending(1, &root);
+    while (!pending.empty()) {
+        const nlohmann::json& value = *pending.back();
+        pending.pop_back();
+        bytes += sizeof(nlohmann::json);
+        if (value.is_string()) {
+            bytes += value.get_ref<const std::string&>().size();
+        } else if (value.is_object()) {
+            nlohmann::json::const_iterator iter;
+            for (iter = value.begin(); iter != value.end(); ++iter) {
+                bytes += kJsonMemberOverheadBytes + iter.key().size();
+                pending.push_back(&iter.value());
+            }
+        } else if (value.is_array()) {
+            std::size_t index;
+            for (index = 0; index < value.size(); ++index) {
+                pending.push_back(&value[index]);
+            }
+        }
+    }
+    return bytes;
+}
+
 bool ParseIntText(const std::string& text, int& out_value) {
     const std::string trimmed = ProcessInterface::Common::TrimCopy(text);
     if (trimmed.empty()) {
@@ -31,17 +69,6 @@ bool ParseIntText(const std::string& text, int& out_value) {
     return true;
 }
 
-bool ParseBoolText(const std::string& text, bool default_value) {
-    const std::string trimmed = ProcessInterface::Common::TrimCopy(text);
-    if (trimmed == "true" || trimmed == "TRUE" || trimmed == "1") {
-        return true;
-    }
-    if (trimmed == "false" || trimmed == "FALSE" || trimmed == "0") {
-        return false;
-    }
-    return default_value;
-}
-
 bool TryParseJsonLiteral(const std::string& text, nlohmann::json& value_out) {
     try {
         value_out = nlohmann::json::parse(text);
@@ -51,39 +78,29 @@ bool TryParseJsonLiteral(const std::string& text, nlohmann::json& value_out) {
     }
 }
 
-nlohmann::json FieldOrDefault(
-    const std::map<std::string, nlohmann::json>& values,
-    const std::string& key,
-    const nlohmann::json& default_value) {
-    const std::map<std::string, nlohmann::json>::const_iterator iter = values.find(key);
-    if (iter == values.end()) {
-        return default_value;
+// port_listening / port_check:<host>:<port>[:<timeout_ms>]
+bool ParsePortProbeArgs(
+    const std::string& op_name,
+    const std::vector<std::string>& args,
+    PortProbeRequest& request_out,
+    std::string& error_message) {
+    if (args.size() < 2) {
+        error_message = op_name + " requires host and port";
+        return false;
     }
-    return iter->second;
-}
 
-bool JsonToBool(const nlohmann::json& value, bool default_value) {
-    if (value.is_boolean()) {
-        return value.get<bool>();
-    }
-    if (value.is_number_integer()) {
-        return value.get<int>() != 0;
-    }
-    if (value.is_string()) {
-        return ParseBoolText(value.get<std::string>(), default_value);
+    request_out.host = ProcessInterface::Common::TrimCopy(args[0]);
+    request_out.port = 0;
+    if (!ParseIntText(args[1], request_out.port)) {
+        error_message = op_name + " invalid port";
+        return false;
     }
-    return default_value;
-}
 
-bool JsonToInt(const nlohmann::json& value, int& out_value) {
-    if (value.is_number_integer()) {
-        out_value = value.get<int>();
-        return true;
+    request_out.timeout_ms = 250;
+    if (args.size() > 2) {
+        ParseIntText(args[2], request_out.timeout_ms);
     }
-    if (value.is_string()) {
-        return ParseIntText(value.get<std::string>(), out_value);
-    }
-    return false;
+    return true;
 }
 
 nlohmann::json BuildProcessProbeJson(const ProcessProbeResult& probe) {
@@ -102,29 +119,64 @@ nlohmann::json BuildProcessProbeJson(const ProcessProbeResult& probe) {
 
 }  // namespace
 
+void PrefetchPortProbes(const std::vector<ParsedOperation>& operations, const StatusContext& context) {
+    if (context.probes == NULL) {
+        return;
+    }
+
+    std::vector<PortProbeRequest> requests;
+    std::size_t index;
+    for (index = 0; index < operations.size(); ++index) {
+        const std::string& op_name = operations[index].op_name;
+        if (op_name != "port_listening" && op_name != "port_check") {
+            continue;
+        }
+        PortProbeRequest request;
+        std::string ignored_error;
+        if (ParsePortProbeArgs(op_name, operations[index].args, request, ignored_error)) {
+            requests.push_back(request);
+        }
+    }
+
+    if (!requests.empty()) {
+        context.probes->PrefetchPortListening(requests);
+    }
+}
+
+bool OperationInputStamp(const ParsedOperation& operation, const StatusContext& context, std::string& stamp_out) {
+    const std::string& op_name = operation.op_name;
+    if (op_name != "file_json" && op_name != "file_exists" && op_name != "file_tail" && op_name != "jsonl_last") {
+        return false;
+    }
+    if (operation.args.empty() || ProcessInterface::Common::TrimCopy(operation.args[0]).empty()) {
+        return false;
+    }
+
+    const fs::path path = context.repo_root / ProcessInterface::Common::TrimCopy(operation.args[0]);
+    ProcessInterface::Common::FileStamp stamp;
+    if (!ProcessInterface::Common::StatFileStamp(path, stamp)) {
+        // Stays "missing" until the file is created.
+        stamp_out = "missing";
+        return true;
+    }
+    if (stamp.recent) {
+        return false;
+    }
+
+    std::ostringstream stamp_stream;
+    stamp_stream << stamp.mtime_ns << ':' << stamp.size << ':' << stamp.inode << ':' << stamp.device;
+    stamp_out = stamp_stream.str();
+    return true;
+}
+
 StatusErrorCode EvaluateOperation(
     const ParsedOperation& operation,
-    const std::map<std::string, nlohmann::json>& values,
     const StatusContext& context,
     nlohmann::json& out_json,
     std::string& error_message) {
     const std::string op_name = operation.op_name;
     const std::vector<std::string>& args = operation.args;
 
-    if (op_name == "const") {
-        const std::string literal = ProcessInterface::Common::TrimCopy(ProcessInterface::Common::Join(args, 0, ":"));
-        if (!TryParseJsonLiteral(literal, out_json)) {
-            error_message = "const op requires JSON literal";
-            return StatusErrorCode::kSpecInvalid;
-        }
-        return StatusErrorCode::kNone;
-    }
-
-    if (op_name == "const_str") {
-        out_json = ProcessInterface::Common::Join(args, 0, ":");
-        return StatusErrorCode::kNone;
-    }
-
     if (op_name == "file_json") {
         if (args.empty()) {
             error_message = "file_json requires path argument";
@@ -133,28 +185,64 @@ StatusErrorCode EvaluateOperation(
 
         const fs::path path = context.repo_root / ProcessInterface::Common::TrimCopy(args[0]);
 
+        // file_json:<path>[:</pointer>,</pointer>...][:<default>]; a JSON default never starts with '/'.
+        std::size_t default_index = 1;
+        std::string pointer_list;
+        std::vector<JsonPointer> pointers;
+        if (args.size() > 1 && ProcessInterface::Common::TrimCopy(args[1]).compare(0, 1, "/") == 0) {
+            pointer_list = ProcessInterface::Common::TrimCopy(args[1]);
+            std::vector<std::string> pointer_texts = ProcessInterface::Common::Split(pointer_list, ',');
+            std::size_t index;
+            for (index = 0; index < pointer_texts.size(); ++index) {
+                pointer_texts[index] = ProcessInterface::Common::TrimCopy(pointer_texts[index]);
+            }
+            if (!ParseJsonPointers(pointer_texts, pointers, error_message)) {
+                error_message = "file_json " + error_message;
+                return StatusErrorCode::kSpecInvalid;
+            }
+            default_index = 2;
+        }
+
         nlohmann::json default_json = nlohmann::json::object();
-        if (args.size() > 1) {
-            const std::string raw_default = ProcessInterface::Common::TrimCopy(ProcessInterface::Common::Join(args, 1, ":"));
+        if (args.size() > default_index) {
+            const std::string raw_default =
+                ProcessInterface::Common::TrimCopy(ProcessInterface::Common::Join(args, default_index, ":"));
             if (!raw_default.empty()) {
                 TryParseJsonLiteral(raw_default, default_json);
             }
         }
 
-        std::string text;
-        if (!ProcessInterface::Common::ReadTextFile(path, text)) {
+        ProcessInterface::Common::FileContentCache& file_cache = ProcessInterface::Common::SharedFileContentCache();
+        std::shared_ptr<const std::string> text;
+        unsigned long long version = 0;
+        if (!file_cache.ReadText(path, text, version)) {
             out_json = default_json;
             DebugLog("file_json missing path=" + path.string());
             return StatusErrorCode::kNone;
         }
 
-        nlohmann::json parsed;
-        if (TryParseJsonLiteral(ProcessInterface::Common::TrimCopy(text), parsed) && (parsed.is_object() || parsed.is_array())) {
-            out_json = parsed;
-            return StatusErrorCode::kNone;
+        // Unusable content is cached as a discarded value so it is not re-parsed either. Each
+        // pointer list caches its own projection; the full document is never built for one.
+        const std::string derived_kind = pointers.empty() ? std::string("file_json") : "file_json:" + pointer_list;
+        std::shared_ptr<const nlohmann::json> parsed =
+            std::static_pointer_cast<const nlohmann::json>(file_cache.FindDerived(path, derived_kind, version));
+        if (!parsed) {
+            nlohmann::json value;
+            bool usable = false;
+            if (pointers.empty()) {
+                usable = TryParseJsonLiteral(ProcessInterface::Common::TrimCopy(*text), value) &&
+                         (value.is_object() || value.is_array());
+            } else {
+                usable = ProjectJsonText(*text, pointers, value);
+            }
+            if (!usable) {
+                value = nlohmann::json(nlohmann::json::value_t::discarded);
+            }
+            parsed = std::make_shared<const nlohmann::json>(value);
+            file_cache.StoreDerived(path, derived_kind, version, parsed, EstimateJsonBytes(*parsed));
         }
 
-        out_json = default_json;
+        out_json = parsed->is_discarded() ? default_json : *parsed;
         return StatusErrorCode::kNone;
     }
 
@@ -168,6 +256,59 @@ StatusErrorCode EvaluateOperation(
         return StatusErrorCode::kNone;
     }
 
+    if (op_name == "file_tail") {
+        if (args.empty() || ProcessInterface::Common::TrimCopy(args[0]).empty()) {
+            error_message = "file_tail requires path argument";
+            return StatusErrorCode::kSpecInvalid;
+        }
+        int max_lines = kDefaultTailLines;
+        if (args.size() > 1 && (!ParseIntText(args[1], max_lines) || max_lines <= 0 || max_lines > kMaxTailLines)) {
+            error_message = "file_tail line count must be between 1 and " + std::to_string(kMaxTailLines);
+            return StatusErrorCode::kSpecInvalid;
+        }
+
+        const fs::path path = context.repo_root / ProcessInterface::Common::TrimCopy(args[0]);
+        std::vector<std::string> lines;
+        out_json = nlohmann::json::array();
+        if (!ProcessInterface::Common::SharedFileTailCache().TailLines(path, static_cast<std::size_t>(max_lines), lines)) {
+            DebugLog("file_tail unreadable path=" + path.string());
+            return StatusErrorCode::kNone;
+        }
+        std::size_t index;
+        for (index = 0; index < lines.size(); ++index) {
+            out_json.push_back(lines[index]);
+        }
+        return StatusErrorCode::kNone;
+    }
+
+    if (op_name == "jsonl_last") {
+        if (args.empty() || ProcessInterface::Common::TrimCopy(args[0]).empty()) {
+            error_message = "jsonl_last requires path argument";
+            return StatusErrorCode::kSpecInvalid;
+        }
+        const std::string filter_key = args.size() > 1 ? ProcessInterface::Common::TrimCopy(args[1]) : std::string();
+
+        // Only object records count, so a record still being written (an unclosed object) is skipped.
+        const std::function<bool(const std::string&)> accept = [&filter_key](const std::string& line) {
+            nlohmann::json record;
+            return TryParseJsonLiteral(ProcessInterface::Common::TrimCopy(line), record) && record.is_object() &&
+                   (filter_key.empty() || record.contains(filter_key));
+        };
+        const fs::path path = context.repo_root / ProcessInterface::Common::TrimCopy(args[0]);
+        std::string line;
+        bool found = false;
+        out_json = nullptr;
+        if (!ProcessInterface::Common::SharedFileTailCache().LastMatchingLine(
+                path, "jsonl_last:" + filter_key, accept, line, found)) {
+            DebugLog("jsonl_last unreadable path=" + path.string());
+            return StatusErrorCode::kNone;
+        }
+        if (found) {
+            TryParseJsonLiteral(ProcessInterface::Common::TrimCopy(line), out_json);
+        }
+        return StatusErrorCode::kNone;
+    }
+
     if (op_name == "process_running") {
         if (args.empty()) {
             error_message = "process_running requires process name";
@@ -183,8 +324,8 @@ StatusErrorCode EvaluateOperation(
     }
 
     if (op_name == "port_listening") {
-        if (args.size() < 2) {
-            error_message = "port_listening requires host and port";
+        PortProbeRequest request;
+        if (!ParsePortProbeArgs(op_name, args, request, error_message)) {
             return StatusErrorCode::kSpecInvalid;
         }
         if (context.probes == NULL) {
@@ -192,185 +333,113 @@ StatusErrorCode EvaluateOperation(
             return StatusErrorCode::kCollectFailed;
         }
 
-        int port = 0;
-        if (!ParseIntText(args[1], port)) {
-            error_message = "port_listening invalid port";
+        out_json = context.probes->CheckPortListening(request.host, request.port, request.timeout_ms);
+        return StatusErrorCode::kNone;
+    }
+
+    if (op_name == "port_check") {
+        PortProbeRequest request;
+        if (!ParsePortProbeArgs(op_name, args, request, error_message)) {
             return StatusErrorCode::kSpecInvalid;
         }
-
-        int timeout_ms = 250;
-        if (args.size() > 2) {
-            ParseIntText(args[2], timeout_ms);
+        if (context.probes == NULL) {
+            error_message = "status probes are not available";
+            return StatusErrorCode::kCollectFailed;
         }
 
-        out_json = context.probes->CheckPortListening(ProcessInterface::Common::TrimCopy(args[0]), port, timeout_ms);
+        const PortCheckResult check = context.probes->CheckPort(request.host, request.port, request.timeout_ms);
+        out_json = nlohmann::json::object();
+        out_json["listening"] = check.listening;
+        if (check.listening || check.error_code.empty()) {
+            out_json["error"] = nullptr;
+        } else {
+            nlohmann::json error_json = nlohmann::json::object();
+            error_json["stage"] = check.error_stage;
+            error_json["code"] = check.error_code;
+            error_json["message"] = check.error_message;
+            out_json["error"] = error_json;
+        }
         return StatusErrorCode::kNone;
     }
 
-    if (op_name == "derive") {
-        if (args.empty()) {
-            error_message = "derive requires sub-operation";
+    if (op_name == "port_owner") {
+        if (args.size() < 2) {
+            error_message = "port_owner requires host and port";
             return StatusErrorCode::kSpecInvalid;
         }
-
-        const std::string sub = ProcessInterface::Common::TrimCopy(args[0]);
-
-        if (sub == "copy") {
-            if (args.size() < 2) {
-                error_message = "derive copy requires source field";
-                return StatusErrorCode::kSpecInvalid;
-            }
-            out_json = FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), nullptr);
-            return StatusErrorCode::kNone;
+        if (context.probes == NULL) {
+            error_message = "status probes are not available";
+            return StatusErrorCode::kCollectFailed;
         }
 
-        if (sub == "bool_from_obj") {
-            if (args.size() < 3) {
-                error_message = "derive bool_from_obj requires source and key";
-                return StatusErrorCode::kSpecInvalid;
-            }
-
-            const nlohmann::json source = FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), nlohmann::json::object());
-            const std::string key = ProcessInterface::Common::TrimCopy(args[2]);
-
-            bool value = false;
-            if (source.is_object() && source.contains(key)) {
-                value = JsonToBool(source[key], false);
-            } else if (args.size() > 3) {
-                value = ParseBoolText(args[3], false);
-            }
-
-            out_json = value;
-            return StatusErrorCode::kNone;
+        int port = 0;
+        if (!ParseIntText(args[1], port) || port <= 0 || port > 65535) {
+            error_message = "port_owner invalid port";
+            return StatusErrorCode::kSpecInvalid;
         }
 
-        if (sub == "int_from_obj") {
-            if (args.size() < 3) {
-                error_message = "derive int_from_obj requires source and key";
-                return StatusErrorCode::kSpecInvalid;
-            }
-
-            const nlohmann::json source = FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), nlohmann::json::object());
-            const std::string key = ProcessInterface::Common::TrimCopy(args[2]);
-
-            int parsed = 0;
-            if (source.is_object() && source.contains(key) && JsonToInt(source[key], parsed)) {
-                out_json = parsed;
-            } else {
-                out_json = nullptr;
-            }
-            return StatusErrorCode::kNone;
+        PortOwnerProbeResult owner;
+        if (!context.probes->FindPortOwner(ProcessInterface::Common::TrimCopy(args[0]), port, owner, error_message)) {
+            return StatusErrorCode::kCollectFailed;
         }
+        out_json = nlohmann::json::object();
+        out_json["listening"] = owner.listening;
+        out_json["pid"] = owner.pid > 0 ? nlohmann::json(owner.pid) : nlohmann::json(nullptr);
+        out_json["comm"] = owner.pid > 0 ? nlohmann::json(owner.comm) : nlohmann::json(nullptr);
+        return StatusErrorCode::kNone;
+    }
 
-        if (sub == "str_from_obj") {
-            if (args.size() < 3) {
-                error_message = "derive str_from_obj requires source and key";
-                return StatusErrorCode::kSpecInvalid;
-            }
-
-            const nlohmann::json source = FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), nlohmann::json::object());
-            const std::string key = ProcessInterface::Common::TrimCopy(args[2]);
-            const std::string default_value = args.size() > 3 ? args[3] : std::string();
-
-            if (source.is_object() && source.contains(key) && source[key].is_string()) {
-                out_json = source[key].get<std::string>();
-            } else {
-                out_json = default_value;
-            }
-            return StatusErrorCode::kNone;
+    if (op_name == "process_stats") {
+        if (args.empty() || ProcessInterface::Common::TrimCopy(args[0]).empty()) {
+            error_message = "process_stats requires process name";
+            return StatusErrorCode::kSpecInvalid;
         }
-
-        if (sub == "json_from_obj") {
-            if (args.size() < 3) {
-                error_message = "derive json_from_obj requires source and key";
+        bool include_tree = false;
+        if (args.size() >= 2) {
+            const std::string scope = ProcessInterface::Common::TrimCopy(args[1]);
+            if (scope == "tree") {
+                include_tree = true;
+            } else if (scope != "self") {
+                error_message = "process_stats scope must be self or tree";
                 return StatusErrorCode::kSpecInvalid;
             }
-
-            const nlohmann::json source = FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), nlohmann::json::object());
-            const std::string key = ProcessInterface::Common::TrimCopy(args[2]);
-
-            if (source.is_object() && source.contains(key)) {
-                out_json = source[key];
-            } else if (args.size() > 3) {
-                nlohmann::json fallback;
-                if (TryParseJsonLiteral(ProcessInterface::Common::TrimCopy(args[3]), fallback)) {
-                    out_json = fallback;
-                } else {
-                    out_json = nullptr;
-                }
-            } else {
-                out_json = nullptr;
-            }
-            return StatusErrorCode::kNone;
         }
-
-        if (sub == "running_display") {
-            if (args.size() < 3) {
-                error_message = "derive running_display requires running and pid fields";
-                return StatusErrorCode::kSpecInvalid;
-            }
-
-            const bool running = JsonToBool(FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), false), false);
-            int pid = 0;
-            const bool has_pid = JsonToInt(FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[2]), nullptr), pid);
-
-            if (running && has_pid) {
-                out_json = std::string("True (PID ") + std::to_string(pid) + ")";
-            } else if (running) {
-                out_json = "True";
-            } else {
-                out_json = "False";
-            }
-            return StatusErrorCode::kNone;
+        if (context.probes == NULL) {
+            error_message = "status probes are not available";
+            return StatusErrorCode::kCollectFailed;
         }
 
-        if (sub == "str_if_bool") {
-            if (args.size() < 4) {
-                error_message = "derive str_if_bool requires bool field and true/false text";
-                return StatusErrorCode::kSpecInvalid;
-            }
-
-            const bool value = JsonToBool(FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), false), false);
-            out_json = value ? args[2] : args[3];
-            return StatusErrorCode::kNone;
+        ProcessStatsProbeResult stats;
+        if (!context.probes->QueryProcessStats(
+                ProcessInterface::Common::TrimCopy(args[0]), include_tree, stats, error_message)) {
+            return StatusErrorCode::kCollectFailed;
         }
-
-        if (sub == "pick_int") {
-            if (args.size() < 3) {
-                error_message = "derive pick_int requires primary and fallback fields";
-                return StatusErrorCode::kSpecInvalid;
-            }
-
-            int primary = 0;
-            if (JsonToInt(FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), nullptr), primary)) {
-                out_json = primary;
-                return StatusErrorCode::kNone;
-            }
-
-            int fallback = 0;
-            if (JsonToInt(FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[2]), nullptr), fallback)) {
-                out_json = fallback;
-                return StatusErrorCode::kNone;
-            }
-
-            out_json = nullptr;
-            return StatusErrorCode::kNone;
+        nlohmann::json pids = nlohmann::json::array();
+        std::size_t index;
+        for (index = 0; index < stats.pids.size(); ++index) {
+            pids.push_back(stats.pids[index]);
         }
+        out_json = nlohmann::json::object();
+        out_json["running"] = stats.running;
+        out_json["pids"] = pids;
+        out_json["processCount"] = stats.pids.size();
+        out_json["cpuPercent"] = stats.cpu_percent >= 0.0
+                                     ? nlohmann::json(std::floor(stats.cpu_percent * 10.0 + 0.5) / 10.0)
+                                     : nlohmann::json(nullptr);
+        out_json["rssBytes"] = stats.rss_bytes;
+        out_json["threads"] = stats.threads;
+        out_json["fds"] = stats.fds >= 0 ? nlohmann::json(stats.fds) : nlohmann::json(nullptr);
+        return StatusErrorCode::kNone;
+    }
 
-        if (sub == "or_bool") {
-            if (args.size() < 3) {
-                error_message = "derive or_bool requires two bool fields";
-                return StatusErrorCode::kSpecInvalid;
-            }
-
-            const bool left = JsonToBool(FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[1]), false), false);
-            const bool right = JsonToBool(FieldOrDefault(values, ProcessInterface::Common::TrimCopy(args[2]), false), false);
-            out_json = left || right;
-            return StatusErrorCode::kNone;
+    if (op_name == "plugin") {
+        if (args.empty() || ProcessInterface::Common::TrimCopy(args[0]).empty()) {
+            error_message = "plugin requires plugin name";
+            return StatusErrorCode::kSpecInvalid;
         }
-
-        error_message = "unsupported derive operation: " + sub;
-        return StatusErrorCode::kSpecInvalid;
+        const std::vector<std::string> plugin_args(args.begin() + 1, args.end());
+        return EvaluateStatusProbePlugin(
+            ProcessInterface::Common::TrimCopy(args[0]), plugin_args, context, out_json, error_message);
     }
 
     error_message = "unsupported operation: " + op_name;
@@ -1,8 +1,8 @@
 #ifndef PROCESS_INTERFACE_STATUS_OPERATION_REGISTRY_H
 #define PROCESS_INTERFACE_STATUS_OPERATION_REGISTRY_H
 
-#include <map>
 #include <string>
+#include <vector>
 
 #include "../../external/nlohmann/json.hpp"
 #include "context.h"
@@ -12,9 +12,17 @@
 namespace ProcessInterface {
 namespace Status {
 
+// Hands every port_listening and port_check probe of operations to context.probes in one batch before
+// evaluation, so their connects overlap instead of running one after another.
+void PrefetchPortProbes(const std::vector<ParsedOperation>& operations, const StatusContext& context);
+
+// Describes the file a file_json, file_exists, file_tail or jsonl_last op reads, so an unchanged
+// stamp lets the caller keep the op's previous value. False for every other op, and for files
+// written too recently for their stamp to be trusted; those must be evaluated each time.
+bool OperationInputStamp(const ParsedOperation& operation, const StatusContext& context, std::string& stamp_out);
+
 StatusErrorCode EvaluateOperation(
     const ParsedOperation& operation,
-    const std::map<std::string, nlohmann::json>& values,
     const StatusContext& context,
     nlohmann::json& out_json,
     std::string& error_message);
@@ -8,33 +8,53 @@
 namespace ProcessInterface {
 namespace Status {
 
+namespace {
+
+std::string JsonStringText(const std::string& text) {
+    return nlohmann::json(text).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+}  // namespace
+
 StatusErrorCode WriteSnapshotEnvelope(
     const fs::path& repo_root,
     const Common::PathTemplateSet& path_templates,
     const std::string& app_id,
     const std::string& payload_json,
     std::string& error_message) {
-    nlohmann::json payload;
-    try {
-        payload = nlohmann::json::parse(payload_json.empty() ? "{}" : payload_json);
-    } catch (const std::exception&) {
-        error_message = "snapshot payload must be JSON object";
-        return StatusErrorCode::kSnapshotWriteFailed;
-    }
+    return WriteSnapshotEnvelope(
+        repo_root, path_templates, app_id, payload_json, SnapshotPayloadSource::kUnchecked, error_message);
+}
 
-    if (!payload.is_object()) {
+StatusErrorCode WriteSnapshotEnvelope(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    const std::string& payload_json,
+    SnapshotPayloadSource payload_source,
+    std::string& error_message) {
+    const std::string::size_type first = payload_json.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && payload_source == SnapshotPayloadSource::kUnchecked &&
+        (payload_json[first] != '{' || !nlohmann::json::accept(payload_json))) {
         error_message = "snapshot payload must be JSON object";
         return StatusErrorCode::kSnapshotWriteFailed;
     }
 
-    nlohmann::json envelope;
-    envelope["appId"] = app_id;
-    envelope["generatedAt"] = ProcessInterface::Common::CurrentUtcIso8601();
-    envelope["generatedAtEpochMs"] = ProcessInterface::Common::CurrentEpochMs();
-    envelope["payload"] = payload;
+    // The payload text is embedded as is rather than parsed into the envelope and dumped again.
+    std::string envelope_text = "{\"appId\":" + JsonStringText(app_id);
+    envelope_text += ",\"generatedAt\":" + JsonStringText(ProcessInterface::Common::CurrentUtcIso8601());
+    envelope_text += ",\"generatedAtEpochMs\":" + std::to_string(ProcessInterface::Common::CurrentEpochMs());
+    envelope_text += ",\"payload\":";
+    if (first == std::string::npos) {
+        envelope_text += "{}";
+    } else {
+        const std::string::size_type last = payload_json.find_last_not_of(" \t\r\n");
+        envelope_text.append(payload_json, first, last - first + 1);
+    }
+    envelope_text += "}";
 
     const fs::path snapshot_path = ResolveSnapshotPath(repo_root, path_templates, app_id);
-    if (!ProcessInterface::Platform::AtomicReplaceFile(snapshot_path, envelope.dump(), error_message)) {
+    if (!ProcessInterface::Platform::AtomicReplaceFile(snapshot_path, envelope_text, error_message)) {
         return StatusErrorCode::kSnapshotWriteFailed;
     }
 
@@ -10,11 +10,27 @@
 namespace ProcessInterface {
 namespace Status {
 
+enum class SnapshotPayloadSource {
+    // Any text; rejected unless it is a single JSON object.
+    kUnchecked,
+    // Serialized by ExecuteStatusSpec, which always yields a JSON object; embedded without
+    // being validated again.
+    kStatusEngine,
+};
+
+StatusErrorCode WriteSnapshotEnvelope(
+    const fs::path& repo_root,
+    const Common::PathTemplateSet& path_templates,
+    const std::string& app_id,
+    const std::string& payload_json,
+    std::string& error_message);
+
 StatusErrorCode WriteSnapshotEnvelope(
     const fs::path& repo_root,
     const Common::PathTemplateSet& path_templates,
     const std::string& app_id,
     const std::string& payload_json,
+    SnapshotPayloadSource payload_source,
     std::string& error_message);
 
 }  // namespace Status
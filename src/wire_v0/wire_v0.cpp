@@ -46,6 +46,11 @@ bool ParseRequestLine(const std::string& request_line, WireRequest& request, std
     request = WireRequest();
     request.args_json = "{}";
     request.timeout_seconds = 0.0;
+    request.offset = 0;
+    request.max_bytes = 0;
+    request.limit = 0;
+    request.deadline_ms = 0;
+    request.has_fields = false;
 
     if (root.contains("id") && root["id"].is_string()) {
         request.request_id = root["id"].get<std::string>();
@@ -82,6 +87,14 @@ bool ParseRequestLine(const std::string& request_line, WireRequest& request, std
         }
     }
 
+    if (params.contains("values")) {
+        if (!params["values"].is_object()) {
+            error_message = "params.values must be a JSON object";
+            return false;
+        }
+        request.values_json = params["values"].dump();
+    }
+
     if (params.contains("actionName") && params["actionName"].is_string()) {
         request.action_name = params["actionName"].get<std::string>();
     }
@@ -105,6 +118,71 @@ bool ParseRequestLine(const std::string& request_line, WireRequest& request, std
         }
     }
 
+    if (params.contains("offset")) {
+        if (!params["offset"].is_number_unsigned()) {
+            error_message = "params.offset must be a non-negative integer";
+            return false;
+        }
+        request.offset = params["offset"].get<unsigned long long>();
+    }
+
+    if (params.contains("maxBytes")) {
+        if (!params["maxBytes"].is_number_unsigned()) {
+            error_message = "params.maxBytes must be a non-negative integer";
+            return false;
+        }
+        request.max_bytes = params["maxBytes"].get<std::size_t>();
+    }
+
+    if (params.contains("state") && params["state"].is_string()) {
+        request.state = params["state"].get<std::string>();
+    }
+
+    if (params.contains("since") && params["since"].is_string()) {
+        request.since = params["since"].get<std::string>();
+    }
+
+    if (params.contains("until") && params["until"].is_string()) {
+        request.until = params["until"].get<std::string>();
+    }
+
+    if (params.contains("cursor") && params["cursor"].is_string()) {
+        request.cursor = params["cursor"].get<std::string>();
+    }
+
+    if (params.contains("limit")) {
+        if (!params["limit"].is_number_unsigned()) {
+            error_message = "params.limit must be a non-negative integer";
+            return false;
+        }
+        request.limit = params["limit"].get<std::size_t>();
+    }
+
+    if (params.contains("deadlineMs")) {
+        if (!params["deadlineMs"].is_number_unsigned()) {
+            error_message = "params.deadlineMs must be a non-negative integer";
+            return false;
+        }
+        request.deadline_ms = params["deadlineMs"].get<unsigned long long>();
+    }
+
+    if (params.contains("fields")) {
+        const nlohmann::json& fields = params["fields"];
+        if (!fields.is_array()) {
+            error_message = "params.fields must be an array of strings";
+            return false;
+        }
+        std::size_t index;
+        for (index = 0; index < fields.size(); ++index) {
+            if (!fields[index].is_string()) {
+                error_message = "params.fields must be an array of strings";
+                return false;
+            }
+            request.fields.push_back(fields[index].get<std::string>());
+        }
+        request.has_fields = true;
+    }
+
     return true;
 }
 
@@ -1,7 +1,9 @@
 #ifndef GPI_WIRE_V0_H
 #define GPI_WIRE_V0_H
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace gpi {
 
@@ -13,8 +15,20 @@ struct WireRequest {
     std::string value;
     std::string action_name;
     std::string args_json;
+    std::string values_json;
     std::string job_id;
     double timeout_seconds;
+    unsigned long long offset;
+    std::size_t max_bytes;
+    std::string state;
+    std::string since;
+    std::string until;
+    std::string cursor;
+    std::size_t limit;
+    unsigned long long deadline_ms;
+    // status.get: params.fields was given (fields may still be empty).
+    bool has_fields;
+    std::vector<std::string> fields;
 };
 
 std::string JsonEscape(const std::string& value);
@@ -4,6 +4,9 @@
 from __future__ import annotations
 
 import json
+import os
+import shutil
+import signal
 import socket
 import subprocess
 import sys
@@ -61,6 +64,16 @@ class HostContractTests(unittest.TestCase):
         self.assertIsInstance(response, dict, msg=str(payload))
         return response
 
+    def _wait_job_terminal(self, endpoint: str, app_id: str, job_id: str, timeout_seconds: float = 15.0) -> dict[str, Any]:
+        deadline = time.time() + timeout_seconds
+        job_payload: dict[str, Any] = {}
+        while time.time() < deadline:
+            job_payload = self._request(endpoint, "action.job.get", {"appId": app_id, "jobId": job_id})
+            if job_payload.get("state") not in ("queued", "running"):
+                return job_payload
+            time.sleep(0.1)
+        self.fail(f"job did not finish: {job_payload}")
+
     def _wait_ready(self, endpoint: str) -> None:
         deadline = time.time() + 8.0
         while time.time() < deadline:
@@ -95,6 +108,17 @@ class HostContractTests(unittest.TestCase):
             "print(json.dumps({'echo':'ok'}))\n",
             encoding="utf-8",
         )
+        (repo_path / "run_sleep.py").write_text(
+            "import time\n"
+            "time.sleep(30)\n",
+            encoding="utf-8",
+        )
+        (repo_path / "run_big_output.py").write_text(
+            "import sys\n"
+            "for index in range(20000):\n"
+            "    sys.stdout.write('line %06d\\n' % index)\n",
+            encoding="utf-8",
+        )
         (repo_path / "run_fail_exit7.py").write_text(
             "import sys\n"
             "print('stdout-line')\n"
@@ -143,12 +167,24 @@ class HostContractTests(unittest.TestCase):
                     "cmd": [sys.executable, "run_fail_exit7.py"],
                     "args": [],
                 },
+                {
+                    "name": "run_sleep",
+                    "label": "Run Sleep",
+                    "cmd": [sys.executable, "run_sleep.py"],
+                    "args": [],
+                },
+                {
+                    "name": "run_big_output",
+                    "label": "Run Big Output",
+                    "cmd": [sys.executable, "run_big_output.py"],
+                    "args": [],
+                },
             ]
         }
         (actions_dir / f"{app_id}.actions.json").write_text(json.dumps(actions, indent=2) + "\n", encoding="utf-8")
 
-    def _write_profile(self, profile_path: Path, app_id: str) -> None:
-        profile = {
+    def _write_profile(self, profile_path: Path, app_id: str, extra: dict[str, Any] | None = None) -> None:
+        profile: dict[str, Any] = {
             "allowedApps": [app_id],
             "ipc": {"backend": "zmq", "endpoint": "tcp://127.0.0.1:57001"},
             "paths": {
@@ -158,6 +194,8 @@ class HostContractTests(unittest.TestCase):
                 "actionJob": "{repoRoot}/runtime/custom-jobs/{appId}/{jobId}.json",
             },
         }
+        if extra:
+            profile.update(extra)
         profile_path.write_text(json.dumps(profile, indent=2) + "\n", encoding="utf-8")
 
     def _stop_host(self, host: subprocess.Popen[str]) -> None:
@@ -240,11 +278,17 @@ class HostContractTests(unittest.TestCase):
             finally:
                 self._stop_host(host)
 
-    def test_action_job_roundtrip_and_template_paths(self) -> None:
+    def test_status_get_sees_rewritten_input_files(self) -> None:
         with tempfile.TemporaryDirectory() as tmp_dir:
             repo_path = Path(tmp_dir)
             app_id = "bridge"
             self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].append("settings=file_json:settings.json:{}")
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            settings_path = repo_path / "settings.json"
+            settings_path.write_text('{"mode": "a"}', encoding="utf-8")
             profile_path = repo_path / "host.profile.json"
             self._write_profile(profile_path, app_id)
 
@@ -258,29 +302,105 @@ class HostContractTests(unittest.TestCase):
             try:
                 self._wait_ready(endpoint)
 
-                self._request(endpoint, "status.get", {"appId": app_id})
-                snapshot_path = repo_path / "runtime" / "custom-status" / f"{app_id}.json"
-                self.assertTrue(snapshot_path.exists(), msg=f"missing snapshot path: {snapshot_path}")
+                for _ in range(2):
+                    status = self._request(endpoint, "status.get", {"appId": app_id})
+                    self.assertEqual(status.get("settings"), {"mode": "a"})
 
-                invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "run_echo", "args": {}})
-                job_id = str(invoke_payload.get("jobId") or "")
-                self.assertTrue(job_id)
+                # Replaced by rename, the way atomic writers update it.
+                staged_path = repo_path / "settings.json.tmp"
+                staged_path.write_text('{"mode": "b"}', encoding="utf-8")
+                staged_path.replace(settings_path)
+                spec["appTitle"] = "Bridge App Renamed"
+                spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
 
-                job_payload = self._request(endpoint, "action.job.get", {"appId": app_id, "jobId": job_id})
-                self.assertEqual(job_payload.get("jobId"), job_id)
-                self.assertEqual(job_payload.get("state"), "succeeded")
-                self.assertIsInstance(job_payload.get("result"), dict)
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(status.get("settings"), {"mode": "b"})
+                self.assertEqual(status.get("appTitle"), "Bridge App Renamed")
+            finally:
+                self._stop_host(host)
 
-                job_file = repo_path / "runtime" / "custom-jobs" / app_id / f"{job_id}.json"
-                self.assertTrue(job_file.exists(), msg=f"missing action job path: {job_file}")
+    def test_file_tail_and_jsonl_last_follow_appends_and_rotation(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].extend(
+                [
+                    "tail=file_tail:app.log:2",
+                    "last=jsonl_last:events.jsonl",
+                    "lastError=jsonl_last:events.jsonl:error",
+                    "missing=jsonl_last:missing.jsonl",
+                ]
+            )
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            log_path = repo_path / "app.log"
+            log_path.write_text("".join(f"line {index}\n" for index in range(50000)), encoding="utf-8")
+            events_path = repo_path / "events.jsonl"
+            events_path.write_text('{"n": 1, "error": "boom"}\n{"n": 2}\n', encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(status.get("tail"), ["line 49998", "line 49999"])
+                self.assertEqual(status.get("last"), {"n": 2})
+                self.assertEqual(status.get("lastError"), {"n": 1, "error": "boom"})
+                self.assertIsNone(status.get("missing"))
+
+                # Appended with a record still being written.
+                with log_path.open("a", encoding="utf-8") as handle:
+                    handle.write("appended\n")
+                with events_path.open("a", encoding="utf-8") as handle:
+                    handle.write('{"n": 3, "error": "late"}\n{"n": 4')
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(status.get("tail"), ["line 49999", "appended"])
+                self.assertEqual(status.get("last"), {"n": 3, "error": "late"})
+                self.assertEqual(status.get("lastError"), {"n": 3, "error": "late"})
+
+                # Rotated: the old file is renamed and a new one started.
+                log_path.replace(repo_path / "app.log.1")
+                log_path.write_text("fresh\n", encoding="utf-8")
+                events_path.write_text('{"n": 5}\n', encoding="utf-8")
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(status.get("tail"), ["fresh"])
+                self.assertEqual(status.get("last"), {"n": 5})
+                self.assertIsNone(status.get("lastError"))
             finally:
                 self._stop_host(host)
 
-    def test_action_job_nonzero_exit_has_combined_stdout_and_empty_stderr(self) -> None:
+    def test_file_json_pointers_project_requested_subtrees(self) -> None:
         with tempfile.TemporaryDirectory() as tmp_dir:
             repo_path = Path(tmp_dir)
             app_id = "bridge"
             self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].extend(
+                [
+                    "state=file_json:state.json:/mode,/workers/1/name,/a~1b,/limits,/missing",
+                    "mode=derive:json_from_obj:state:/mode",
+                    "absent=file_json:absent.json:/mode:{\"fallback\":true}",
+                ]
+            )
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            state = {
+                "mode": "active",
+                "a/b": 3,
+                "workers": [{"name": "w0", "log": ["x"] * 100}, {"name": "w1", "log": []}],
+                "limits": {"cpu": 2, "memory": "1g"},
+                "history": [{"entry": index} for index in range(1000)],
+            }
+            (repo_path / "state.json").write_text(json.dumps(state), encoding="utf-8")
             profile_path = repo_path / "host.profile.json"
             self._write_profile(profile_path, app_id)
 
@@ -293,23 +413,1253 @@ class HostContractTests(unittest.TestCase):
             )
             try:
                 self._wait_ready(endpoint)
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(
+                    status.get("state"),
+                    {"/mode": "active", "/workers/1/name": "w1", "/a~1b": 3, "/limits": {"cpu": 2, "memory": "1g"}},
+                )
+                self.assertEqual(status.get("mode"), "active")
+                self.assertEqual(status.get("absent"), {"fallback": True})
+            finally:
+                self._stop_host(host)
 
-                invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "run_fail_exit7", "args": {}})
-                job_id = str(invoke_payload.get("jobId") or "")
-                self.assertTrue(job_id)
+    def test_status_expressions_compute_fields_alongside_colon_ops(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].extend(
+                [
+                    "_state=file_json:state.json:{}",
+                    "legacyPid=derive:int_from_obj:_state:pid",
+                    "url := _state.endpoint ?? 'http://localhost:8080/'",
+                    "label := bool(_state.up) ? \"up (PID ${legacyPid}) at ${url}\" : 'down'",
+                    "busy := _state.workers[1] >= 4 && !(_state.mode == 'idle')",
+                ]
+            )
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            (repo_path / "state.json").write_text(json.dumps({"up": "true", "pid": "77", "workers": [1, 4], "mode": "run"}), encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
 
-                job_payload = self._request(endpoint, "action.job.get", {"appId": app_id, "jobId": job_id})
-                self.assertEqual(job_payload.get("state"), "failed")
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(status.get("legacyPid"), 77)
+                self.assertEqual(status.get("url"), "http://localhost:8080/")
+                self.assertEqual(status.get("label"), "up (PID 77) at http://localhost:8080/")
+                self.assertTrue(status.get("busy"))
+                self.assertNotIn("_state", status)
 
-                stdout_text = str(job_payload.get("stdout") or "")
-                stderr_text = str(job_payload.get("stderr") or "")
+                spec["operations"].append("broken := undefinedField || true")
+                spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+                failed = self._request_raw(endpoint, "status.get", {"appId": app_id})
+                self.assertFalse(failed.get("ok"))
+                self.assertEqual(failed["error"]["code"], "E_INTERNAL")
+                self.assertIn("unknown field 'undefinedField'", failed["error"]["message"])
+            finally:
+                self._stop_host(host)
 
-                self.assertIn("stdout-line", stdout_text)
-                self.assertIn("stderr-line", stdout_text)
-                self.assertEqual("", stderr_text)
+    def test_status_get_recomputes_only_after_inputs_change(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].extend(
+                [
+                    "_state=file_json:state.json:{}",
+                    "phase := _state.phase ?? 'none'",
+                    "summary := \"${phase}/${_state.count}\"",
+                ]
+            )
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            state_path = repo_path / "state.json"
+            state_path.write_text(json.dumps({"phase": "a", "count": 1}), encoding="utf-8")
+            settled = time.time() - 60
+            os.utime(state_path, (settled, settled))
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+                first = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(first.get("summary"), "a/1")
+                self.assertEqual(self._request(endpoint, "status.get", {"appId": app_id}), first)
+
+                # Same size and rewritten right away: the fresh mtime must not be trusted.
+                state_path.write_text(json.dumps({"phase": "b", "count": 2}), encoding="utf-8")
+                self.assertEqual(self._request(endpoint, "status.get", {"appId": app_id}).get("summary"), "b/2")
+
+                state_path.write_text(json.dumps({"count": 3}), encoding="utf-8")
+                os.utime(state_path, (settled + 1, settled + 1))
+                updated = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(updated.get("phase"), "none")
+                self.assertEqual(updated.get("summary"), "none/3")
+
+                state_path.unlink()
+                removed = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(removed.get("summary"), "none/")
+                snapshot = json.loads((repo_path / "runtime" / "custom-status" / f"{app_id}.json").read_text(encoding="utf-8"))
+                self.assertEqual(snapshot["payload"], removed)
+            finally:
+                self._stop_host(host)
+
+    def test_status_get_fields_evaluates_only_requested_subset(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].extend(
+                [
+                    "_state=file_json:state.json:{}",
+                    "mode := _state.mode ?? 'unknown'",
+                    "headline := \"mode ${mode}\"",
+                    "broken=plugin:not_registered",
+                ]
+            )
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            (repo_path / "state.json").write_text(json.dumps({"mode": "active"}), encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+            snapshot_path = repo_path / "runtime" / "custom-status" / f"{app_id}.json"
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+                # The unregistered plugin op is outside the closure, so it is never run.
+                partial = self._request(endpoint, "status.get", {"appId": app_id, "fields": ["headline", "noSuchField"]})
+                self.assertEqual(partial.get("headline"), "mode active")
+                self.assertNotIn("mode", partial)
+                self.assertNotIn("broken", partial)
+                self.assertNotIn("noSuchField", partial)
+                for key in ("interfaceName", "interfaceVersion", "appId", "appTitle", "running", "pid", "hostRunning", "hostPid", "bootId", "error"):
+                    self.assertIn(key, partial)
+                self.assertFalse(snapshot_path.exists())
+
+                rejected = self._request_raw(endpoint, "status.get", {"appId": app_id, "fields": "headline"})
+                self.assertFalse(rejected.get("ok"))
+                self.assertEqual(rejected["error"]["code"], "E_BAD_ARG")
+
+                full = self._request_raw(endpoint, "status.get", {"appId": app_id})
+                self.assertFalse(full.get("ok"))
+                self.assertIn("not_registered", full["error"]["message"])
+            finally:
+                self._stop_host(host)
+
+    def test_process_running_tracks_start_and_exit(self) -> None:
+        sleep_path = shutil.which("sleep")
+        if sys.platform.startswith("win") or sleep_path is None:
+            self.skipTest("process tracking test needs a POSIX sleep binary")
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            # The process name comes from the name it was executed under.
+            probe_binary = repo_path / "gpi-probe-test"
+            probe_binary.symlink_to(sleep_path)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].append("probe=process_running:GPI-Probe-Test")
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+
+            def wait_probe(running: bool) -> dict[str, Any]:
+                deadline = time.time() + 5.0
+                while True:
+                    probe = self._request(endpoint, "status.get", {"appId": app_id}).get("probe") or {}
+                    if probe.get("running") == running or time.time() > deadline:
+                        return probe
+                    time.sleep(0.05)
+
+            child = None
+            try:
+                self._wait_ready(endpoint)
+                self.assertEqual(wait_probe(False), {"running": False, "pid": None, "pids": []})
+
+                child = subprocess.Popen([str(probe_binary), "30"])
+                started = wait_probe(True)
+                self.assertEqual(started.get("pid"), child.pid)
+                self.assertEqual(started.get("pids"), [child.pid])
+
+                child.kill()
+                child.wait(timeout=5.0)
+                self.assertFalse(wait_probe(False).get("running"))
+            finally:
+                if child is not None and child.poll() is None:
+                    child.kill()
+                    child.wait(timeout=5.0)
+                self._stop_host(host)
+
+    def test_local_port_listening_does_not_connect(self) -> None:
+        if not sys.platform.startswith("linux"):
+            self.skipTest("listen table fast path is Linux-only")
+        listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        listener.bind(("127.0.0.1", 0))
+        listener.listen(4)
+        listener.setblocking(False)
+        port = listener.getsockname()[1]
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].extend(
+                [
+                    f"loopback=port_listening:127.0.0.1:{port}",
+                    f"named=port_listening:localhost:{port}",
+                    f"other=port_listening:127.0.0.2:{port}",
+                ]
+            )
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertTrue(status.get("loopback"))
+                self.assertTrue(status.get("named"))
+                self.assertFalse(status.get("other"))
+                # Answered from the kernel listen table, so nothing reached the accept queue.
+                with self.assertRaises(BlockingIOError):
+                    listener.accept()
+
+                listener.close()
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertFalse(status.get("loopback"))
+            finally:
+                listener.close()
+                self._stop_host(host)
+
+    def test_port_owner_reports_listening_pid(self) -> None:
+        if not sys.platform.startswith("linux"):
+            self.skipTest("port_owner is Linux-only")
+        owner = subprocess.Popen(
+            [
+                sys.executable,
+                "-c",
+                "import socket, time\n"
+                "s = socket.socket()\n"
+                "s.bind(('127.0.0.1', 0))\n"
+                "s.listen()\n"
+                "print(s.getsockname()[1], flush=True)\n"
+                "time.sleep(30)\n",
+            ],
+            stdout=subprocess.PIPE,
+            text=True,
+        )
+        try:
+            port = int(owner.stdout.readline())
+            with tempfile.TemporaryDirectory() as tmp_dir:
+                repo_path = Path(tmp_dir)
+                app_id = "bridge"
+                self._write_fixture_repo(repo_path, app_id)
+                spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+                spec = json.loads(spec_path.read_text(encoding="utf-8"))
+                spec["operations"].extend(
+                    [
+                        f"owner=port_owner:127.0.0.1:{port}",
+                        "nobody=port_owner:localhost:1",
+                    ]
+                )
+                spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+                profile_path = repo_path / "host.profile.json"
+                self._write_profile(profile_path, app_id)
+
+                endpoint = _pick_endpoint()
+                host = subprocess.Popen(
+                    [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                    stdout=subprocess.PIPE,
+                    stderr=subprocess.PIPE,
+                    text=True,
+                )
+                try:
+                    self._wait_ready(endpoint)
+                    status = self._request(endpoint, "status.get", {"appId": app_id})
+                    self.assertEqual(status.get("owner", {}).get("listening"), True)
+                    self.assertEqual(status.get("owner", {}).get("pid"), owner.pid)
+                    self.assertTrue(status.get("owner", {}).get("comm"))
+                    self.assertEqual(status.get("nobody"), {"listening": False, "pid": None, "comm": None})
+                finally:
+                    self._stop_host(host)
+        finally:
+            owner.kill()
+            owner.wait(timeout=5.0)
+
+    def test_process_stats_reports_tree_usage_with_cpu_delta(self) -> None:
+        if not sys.platform.startswith("linux"):
+            self.skipTest("process_stats is Linux-only")
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            process_name = "gpi-stats-test"
+            exe_path = repo_path / process_name
+            exe_path.symlink_to(sys.executable)
+            busy = subprocess.Popen(
+                [
+                    str(exe_path),
+                    "-c",
+                    "import subprocess\n"
+                    "child = subprocess.Popen(['sleep', '30'])\n"
+                    "print(child.pid, flush=True)\n"
+                    "while True: pass\n",
+                ],
+                stdout=subprocess.PIPE,
+                text=True,
+            )
+            sleeper_pid = int(busy.stdout.readline())
+            try:
+                app_id = "bridge"
+                self._write_fixture_repo(repo_path, app_id)
+                spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+                spec = json.loads(spec_path.read_text(encoding="utf-8"))
+                spec["operations"].extend(
+                    [
+                        f"self=process_stats:{process_name}",
+                        f"tree=process_stats:{process_name}:tree",
+                        "absent=process_stats:gpi-no-such-process",
+                    ]
+                )
+                spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+                profile_path = repo_path / "host.profile.json"
+                self._write_profile(profile_path, app_id)
+
+                endpoint = _pick_endpoint()
+                host = subprocess.Popen(
+                    [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                    stdout=subprocess.PIPE,
+                    stderr=subprocess.PIPE,
+                    text=True,
+                )
+                try:
+                    self._wait_ready(endpoint)
+                    time.sleep(0.3)
+                    first = self._request(endpoint, "status.get", {"appId": app_id})
+                    self.assertEqual(first.get("self", {}).get("pids"), [busy.pid])
+                    self.assertIsNone(first.get("self", {}).get("cpuPercent"))
+                    self.assertGreater(first.get("self", {}).get("rssBytes", 0), 0)
+                    self.assertGreaterEqual(first.get("self", {}).get("threads", 0), 1)
+                    self.assertEqual(first.get("tree", {}).get("processCount"), 2)
+                    self.assertEqual(first.get("tree", {}).get("pids"), sorted([busy.pid, sleeper_pid]))
+                    self.assertEqual(first.get("absent", {}).get("running"), False)
+
+                    time.sleep(0.5)
+                    second = self._request(endpoint, "status.get", {"appId": app_id})
+                    self.assertGreater(second.get("self", {}).get("cpuPercent") or 0, 20.0)
+                finally:
+                    self._stop_host(host)
+            finally:
+                busy.kill()
+                busy.wait(timeout=5.0)
+                os.kill(sleeper_pid, signal.SIGKILL)
+
+    def test_remote_port_probes_share_one_deadline(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            # TEST-NET-1 addresses: unroutable, so each connect either fails or times out.
+            spec["operations"].extend(f"remote{index}=port_listening:192.0.2.{index + 1}:80:700" for index in range(6))
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+                started = time.monotonic()
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                elapsed = time.monotonic() - started
+                for index in range(6):
+                    self.assertFalse(status.get(f"remote{index}"))
+                # Serial probing would take up to 6 x 700 ms.
+                self.assertLess(elapsed, 2.0)
+            finally:
+                self._stop_host(host)
+
+    def test_port_check_reports_resolve_and_connect_failures(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].extend(
+                [
+                    "unresolved=port_check:gpi-no-such-host.invalid:80:500",
+                    "closed=port_check:127.0.0.1:1",
+                ]
+            )
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+                started = time.monotonic()
+                status = self._request(endpoint, "status.get", {"appId": app_id})
+                # Resolution is bounded by the probe timeout however slow the resolver is.
+                self.assertLess(time.monotonic() - started, 2.0)
+
+                unresolved = status.get("unresolved") or {}
+                self.assertFalse(unresolved.get("listening"))
+                self.assertEqual(unresolved.get("error", {}).get("stage"), "resolve")
+                self.assertIn(unresolved.get("error", {}).get("code"), ("not_found", "temporary_failure", "timeout"))
+                self.assertTrue(unresolved.get("error", {}).get("message"))
+
+                closed = status.get("closed") or {}
+                self.assertFalse(closed.get("listening"))
+                self.assertEqual(closed.get("error", {}).get("stage"), "connect")
+                self.assertEqual(closed.get("error", {}).get("code"), "refused")
+            finally:
+                self._stop_host(host)
+
+    def test_status_get_deadline_serves_stale_probes_with_meta(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].extend(
+                [
+                    # TEST-NET-1 address with a long timeout: slower than the deadline unless
+                    # the network rejects it outright.
+                    "remote=port_listening:192.0.2.1:80:3000",
+                    "failing=port_owner:192.0.2.1:80",
+                ]
+            )
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+                started = time.monotonic()
+                status = self._request(endpoint, "status.get", {"appId": app_id, "deadlineMs": 150})
+                self.assertLess(time.monotonic() - started, 1.5)
+
+                meta = status.get("_meta") or {}
+                self.assertEqual(meta.get("deadlineMs"), 150)
+                stale = meta.get("stale") or {}
+                # Probe errors are reported as stale fields instead of failing the request.
+                self.assertEqual(stale.get("failing", {}).get("reason"), "error")
+                self.assertIsNone(status.get("failing"))
+                if "remote" in stale:
+                    self.assertEqual(stale["remote"].get("reason"), "deadline")
+                    self.assertIsNone(stale["remote"].get("ageMs"))
+                    self.assertIsNone(status.get("remote"))
             finally:
                 self._stop_host(host)
 
+    def test_status_plugin_op_reads_probe_registered_at_startup(self) -> None:
+        compiler = shutil.which("cc")
+        if sys.platform.startswith("win") or compiler is None:
+            self.skipTest("status plugin test needs a C compiler on a POSIX host")
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            (repo_path / "probe.c").write_text(
+                "#include <stdio.h>\n"
+                "#include <string.h>\n"
+                '#include "probe_plugin_abi.h"\n'
+                "static int calls;\n"
+                "static int evaluate(void* state, const char* app_id, const char* repo_root, const char* const* args,\n"
+                "                    size_t arg_count, const gpi_status_probe_result* result) {\n"
+                "    char buf[256];\n"
+                "    (void)state; (void)repo_root;\n"
+                '    if (arg_count > 0 && strcmp(args[0], "fail") == 0) { result->set_error(result->context, "down", 4); return 1; }\n'
+                '    int n = snprintf(buf, sizeof buf, "{\\"app\\":\\"%s\\",\\"arg\\":\\"%s\\",\\"calls\\":%d}",\n'
+                '                     app_id, arg_count > 0 ? args[0] : "", ++calls);\n'
+                "    result->set_json(result->context, buf, (size_t)n);\n"
+                "    return 0;\n"
+                "}\n"
+                "int gpi_status_probe_init(unsigned int version, const char* config_json, gpi_status_probe* probe) {\n"
+                '    if (version != GPI_STATUS_PROBE_ABI_VERSION || strstr(config_json, "ready") == NULL) { return 1; }\n'
+                "    probe->abi_version = GPI_STATUS_PROBE_ABI_VERSION;\n"
+                "    probe->state = NULL;\n"
+                "    probe->evaluate = evaluate;\n"
+                "    return 0;\n"
+                "}\n",
+                encoding="utf-8",
+            )
+            compiled = subprocess.run(
+                [compiler, "-shared", "-fPIC", "-I", str(self.repo_root / "src" / "status"), "-o", "probe.so", "probe.c"],
+                cwd=repo_path,
+                capture_output=True,
+                text=True,
+            )
+            self.assertEqual(compiled.returncode, 0, msg=compiled.stderr)
+            spec_path = repo_path / "config" / "process-interface" / "status" / f"{app_id}.status.json"
+            spec = json.loads(spec_path.read_text(encoding="utf-8"))
+            spec["operations"].append("queue=plugin:queue:depth")
+            spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(
+                profile_path,
+                app_id,
+                {"statusPlugins": [{"name": "queue", "library": "probe.so", "config": {"mode": "ready"}}]},
+            )
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                first = self._request(endpoint, "status.get", {"appId": app_id})
+                second = self._request(endpoint, "status.get", {"appId": app_id})
+                self.assertEqual(first.get("queue"), {"app": app_id, "arg": "depth", "calls": 1})
+                self.assertEqual(second.get("queue", {}).get("calls"), 2)
+
+                spec["operations"][-1] = "queue=plugin:queue:fail"
+                spec_path.write_text(json.dumps(spec) + "\n", encoding="utf-8")
+                failed = self._request_raw(endpoint, "status.get", {"appId": app_id})
+                self.assertFalse(failed.get("ok"))
+                self.assertIn("status plugin queue failed: down", str(failed.get("error")))
+            finally:
+                self._stop_host(host)
+
+            self._write_profile(
+                profile_path,
+                app_id,
+                {"statusPlugins": [{"name": "queue", "library": "probe.so", "config": {"mode": "off"}}]},
+            )
+            rejected = subprocess.run(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", _pick_endpoint()],
+                capture_output=True,
+                text=True,
+                timeout=10.0,
+            )
+            self.assertEqual(rejected.returncode, 2)
+            self.assertIn("init failed", rejected.stderr)
+
+    def test_action_job_roundtrip_and_template_paths(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                self._request(endpoint, "status.get", {"appId": app_id})
+                snapshot_path = repo_path / "runtime" / "custom-status" / f"{app_id}.json"
+                self.assertTrue(snapshot_path.exists(), msg=f"missing snapshot path: {snapshot_path}")
+
+                invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "run_echo", "args": {}})
+                job_id = str(invoke_payload.get("jobId") or "")
+                self.assertTrue(job_id)
+
+                job_payload = self._wait_job_terminal(endpoint, app_id, job_id)
+                self.assertEqual(job_payload.get("jobId"), job_id)
+                self.assertEqual(job_payload.get("state"), "succeeded")
+                self.assertIsInstance(job_payload.get("result"), dict)
+
+                job_file = repo_path / "runtime" / "custom-jobs" / app_id / f"{job_id}.json"
+                self.assertTrue(job_file.exists(), msg=f"missing action job path: {job_file}")
+            finally:
+                self._stop_host(host)
+
+    def test_action_command_template_and_script_fallback(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            (repo_path / "scripts").mkdir()
+            (repo_path / "scripts" / "greet.py").write_text(
+                "import json\n"
+                "import sys\n"
+                "print(json.dumps({'argv': sys.argv[1:]}))\n",
+                encoding="utf-8",
+            )
+            catalog_path = repo_path / "config" / "actions" / f"{app_id}.actions.json"
+            catalog = json.loads(catalog_path.read_text(encoding="utf-8"))
+            catalog["actions"].append(
+                {
+                    "name": "greet",
+                    "label": "Greet",
+                    "cmd": [sys.executable, "greet", "--name={ name }", "{{literal}"],
+                    "args": [{"name": "name", "type": "string"}],
+                }
+            )
+            catalog_path.write_text(json.dumps(catalog, indent=2) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "greet", "args": {"name": "ada", "literal": "x"}})
+                job_payload = self._wait_job_terminal(endpoint, app_id, str(invoke_payload.get("jobId") or ""))
+                self.assertEqual(job_payload.get("state"), "succeeded", msg=str(job_payload))
+                self.assertEqual(job_payload.get("result"), {"argv": ["--name=ada", "{x"]})
+
+                invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "greet", "args": {"literal": "x"}})
+                job_payload = self._wait_job_terminal(endpoint, app_id, str(invoke_payload.get("jobId") or ""))
+                self.assertEqual(job_payload.get("state"), "failed")
+                self.assertEqual((job_payload.get("error") or {}).get("code"), "missing_action_arg")
+            finally:
+                self._stop_host(host)
+
+    def test_python_worker_action_reuses_interpreter(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            (repo_path / "worker_probe.py").write_text(
+                "import json\n"
+                "import os\n"
+                "import sys\n"
+                "seen = os.environ.get('WORKER_PROBE_SEEN')\n"
+                "os.environ['WORKER_PROBE_SEEN'] = '1'\n"
+                "print(json.dumps({'pid': os.getpid(), 'seen': seen, 'argv': sys.argv[1:]}))\n"
+                "sys.exit(int(sys.argv[1]))\n",
+                encoding="utf-8",
+            )
+            (repo_path / "worker_ticks.py").write_text(
+                "import time\n"
+                "print('tick 1', flush=True)\n"
+                "time.sleep(1.5)\n"
+                "print('tick 2', flush=True)\n",
+                encoding="utf-8",
+            )
+            catalog_path = repo_path / "config" / "actions" / f"{app_id}.actions.json"
+            catalog = json.loads(catalog_path.read_text(encoding="utf-8"))
+            catalog["actions"].append(
+                {
+                    "name": "worker_probe",
+                    "label": "Worker Probe",
+                    "runner": "python-worker",
+                    "cmd": [sys.executable, "worker_probe.py", "{code}"],
+                    "args": [{"name": "code", "type": "string"}],
+                }
+            )
+            catalog["actions"].append(
+                {
+                    "name": "worker_ticks",
+                    "label": "Worker Ticks",
+                    "runner": "python-worker",
+                    "cmd": [sys.executable, "worker_ticks.py"],
+                }
+            )
+            catalog_path.write_text(json.dumps(catalog, indent=2) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                results = []
+                for code in ("0", "0", "3"):
+                    invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "worker_probe", "args": {"code": code}})
+                    results.append(self._wait_job_terminal(endpoint, app_id, str(invoke_payload.get("jobId") or "")))
+
+                self.assertEqual([job.get("state") for job in results], ["succeeded", "succeeded", "failed"])
+                first, second = results[0]["result"], results[1]["result"]
+                self.assertEqual(first.get("pid"), second.get("pid"))
+                self.assertIsNone(second.get("seen"))
+                self.assertEqual(second.get("argv"), ["0"])
+                self.assertIn('"argv": ["3"]', str(results[2].get("stdout") or ""))
+
+                ticks = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "worker_ticks", "args": {}})
+                ticks_job_id = str(ticks.get("jobId") or "")
+                deadline = time.time() + 5.0
+                live = {}
+                while time.time() < deadline:
+                    live = self._request(endpoint, "action.job.output", {"appId": app_id, "jobId": ticks_job_id})
+                    if live.get("data"):
+                        break
+                    time.sleep(0.1)
+                self.assertEqual(live.get("state"), "running", msg=str(live))
+                self.assertEqual(live.get("data"), "tick 1\n")
+                ticks_job = self._wait_job_terminal(endpoint, app_id, ticks_job_id)
+                self.assertEqual(ticks_job.get("stdout"), "tick 1\ntick 2\n")
+            finally:
+                self._stop_host(host)
+
+    def test_native_config_provider_sets_many_keys_atomically(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            app_config_path = repo_path / "app.json"
+            app_config_path.write_text(json.dumps({"transport": {"mode": "Com"}}), encoding="utf-8")
+            catalog_path = repo_path / "config" / "actions" / f"{app_id}.actions.json"
+            catalog = json.loads(catalog_path.read_text(encoding="utf-8"))
+            catalog["configProvider"] = {
+                "files": {"app": "app.json", "db": "{repoRoot}/{appId}.db.json"},
+                "keys": {
+                    "transportMode": {
+                        "file": "app",
+                        "pointer": "/transport/mode",
+                        "type": "string",
+                        "enum": ["Com", "Tcp"],
+                        "restartRequired": True,
+                    },
+                    "db.port": {"file": "db", "type": "integer", "minimum": 1, "maximum": 65535, "default": 5432},
+                },
+            }
+            catalog_path.write_text(json.dumps(catalog, indent=2) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                config_payload = self._request(endpoint, "config.get", {"appId": app_id})
+                self.assertTrue(config_payload.get("valid"), msg=str(config_payload))
+                values = {entry["key"]: entry["value"] for entry in config_payload.get("entries", [])}
+                self.assertEqual(values, {"db.port": 5432, "transportMode": "Com"})
+
+                rejected = self._request_raw(endpoint, "config.setMany", {"appId": app_id, "values": {"db.port": 8080, "transportMode": "Xyz"}})
+                self.assertFalse(rejected.get("ok"), msg=str(rejected))
+                self.assertEqual(rejected["error"]["code"], "E_CONFIG_INVALID")
+                self.assertFalse((repo_path / f"{app_id}.db.json").exists())
+
+                set_payload = self._request(endpoint, "config.setMany", {"appId": app_id, "values": {"db.port": 8080, "transportMode": "Tcp"}})
+                self.assertTrue(set_payload.get("changed"), msg=str(set_payload))
+                self.assertTrue(set_payload.get("restartRequired"))
+                self.assertEqual(set_payload.get("restartKeys"), ["transportMode"])
+                self.assertEqual(json.loads(app_config_path.read_text(encoding="utf-8")), {"transport": {"mode": "Tcp"}})
+                self.assertEqual(json.loads((repo_path / f"{app_id}.db.json").read_text(encoding="utf-8")), {"db": {"port": 8080}})
+
+                single_payload = self._request(endpoint, "config.set", {"appId": app_id, "key": "db.port", "value": "8080"})
+                self.assertFalse(single_payload.get("changed"), msg=str(single_payload))
+                self.assertEqual(single_payload.get("value"), 8080)
+
+                unknown = self._request_raw(endpoint, "config.set", {"appId": app_id, "key": "nope", "value": "1"})
+                self.assertEqual(unknown["error"]["code"], "E_BAD_ARG")
+            finally:
+                self._stop_host(host)
+
+    def test_config_get_reuses_script_response_until_dependency_changes(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            (repo_path / "settings.json").write_text(json.dumps({"mode": "Com"}), encoding="utf-8")
+            (repo_path / "config_show.py").write_text(
+                "import json\n"
+                "entries = json.load(open('settings.json'))\n"
+                "print(json.dumps({'repoRoot':'r','valid':True,'errors':[],'entries':entries,'paths':{'settings':'settings.json'},'configTree':{}}))\n",
+                encoding="utf-8",
+            )
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                first = self._request(endpoint, "config.get", {"appId": app_id})
+                self.assertEqual(first.get("_debug", {}).get("cached"), False, msg=str(first))
+                second = self._request(endpoint, "config.get", {"appId": app_id})
+                self.assertEqual(second.get("_debug", {}).get("cached"), True, msg=str(second))
+                self.assertEqual(second.get("entries"), {"mode": "Com"})
+
+                (repo_path / "settings.json").write_text(json.dumps({"mode": "Tcp"}), encoding="utf-8")
+                third = self._request(endpoint, "config.get", {"appId": app_id})
+                self.assertEqual(third.get("_debug", {}).get("cached"), False, msg=str(third))
+                self.assertEqual(third.get("entries"), {"mode": "Tcp"})
+
+                self._request(endpoint, "config.set", {"appId": app_id, "key": "mode", "value": "Com"})
+                fourth = self._request(endpoint, "config.get", {"appId": app_id})
+                self.assertEqual(fourth.get("_debug", {}).get("cached"), False, msg=str(fourth))
+            finally:
+                self._stop_host(host)
+
+    def test_cacheable_action_collapses_and_reuses_runs(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            (repo_path / "list_ports.py").write_text(
+                "import json\n"
+                "import os\n"
+                "import sys\n"
+                "import time\n"
+                "time.sleep(0.5)\n"
+                "print(json.dumps({'pid': os.getpid(), 'filter': sys.argv[1]}))\n",
+                encoding="utf-8",
+            )
+            catalog_path = repo_path / "config" / "actions" / f"{app_id}.actions.json"
+            catalog = json.loads(catalog_path.read_text(encoding="utf-8"))
+            catalog["actions"].append(
+                {
+                    "name": "list_ports",
+                    "label": "List Ports",
+                    "cacheable": True,
+                    "cacheTtlSeconds": 30,
+                    "cmd": [sys.executable, "list_ports.py", "{filter}"],
+                    "args": [{"name": "filter", "type": "string"}],
+                }
+            )
+            catalog_path.write_text(json.dumps(catalog, indent=2) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                invoke_params = {"appId": app_id, "actionName": "list_ports", "args": {"filter": "usb"}}
+                accepted = [self._request(endpoint, "action.invoke", invoke_params) for _ in range(3)]
+                jobs = [self._wait_job_terminal(endpoint, app_id, str(item.get("jobId") or "")) for item in accepted]
+                self.assertEqual([job.get("state") for job in jobs], ["succeeded"] * 3)
+                self.assertEqual(len({job["result"]["pid"] for job in jobs}), 1)
+                self.assertEqual(jobs[2].get("sourceJobId"), accepted[0].get("jobId"))
+
+                cached = self._request(endpoint, "action.invoke", invoke_params)
+                self.assertEqual(cached.get("state"), "succeeded", msg=str(cached))
+                cached_job = self._request(endpoint, "action.job.get", {"appId": app_id, "jobId": cached.get("jobId")})
+                self.assertEqual(cached_job["result"]["pid"], jobs[0]["result"]["pid"])
+
+                other = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "list_ports", "args": {"filter": "tty"}})
+                self.assertEqual(other.get("state"), "queued")
+                other_job = self._wait_job_terminal(endpoint, app_id, str(other.get("jobId") or ""))
+                self.assertNotEqual(other_job["result"]["pid"], jobs[0]["result"]["pid"])
+
+                lead_params = {"appId": app_id, "actionName": "list_ports", "args": {"filter": "pci"}}
+                leader = self._request(endpoint, "action.invoke", lead_params)
+                follower = self._request(endpoint, "action.invoke", lead_params)
+                self._request(endpoint, "action.job.cancel", {"appId": app_id, "jobId": leader.get("jobId")})
+                follower_job = self._wait_job_terminal(endpoint, app_id, str(follower.get("jobId") or ""))
+                self.assertEqual(follower_job.get("state"), "succeeded", msg=str(follower_job))
+                self.assertEqual(follower_job["result"]["filter"], "pci")
+            finally:
+                self._stop_host(host)
+
+    def test_native_action_calls_plugin_in_process_and_isolated(self) -> None:
+        compiler = shutil.which("cc")
+        if sys.platform.startswith("win") or compiler is None:
+            self.skipTest("native plugin test needs a C compiler on a POSIX host")
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            (repo_path / "plugin.c").write_text(
+                '#include <signal.h>\n'
+                '#include <stdio.h>\n'
+                '#include <unistd.h>\n'
+                '#include "native_action_abi.h"\n'
+                "unsigned int gpi_native_action_abi_version(void) { return GPI_NATIVE_ACTION_ABI_VERSION; }\n"
+                "int echo(const char* args, const gpi_native_action_host* host) {\n"
+                "    char buf[256];\n"
+                '    int n = snprintf(buf, sizeof buf, "{\\"args\\":%s,\\"pid\\":%d}", args, (int)getpid());\n'
+                '    host->write_output(host->context, "hello\\n", 6);\n'
+                "    host->set_result(host->context, buf, (size_t)n);\n"
+                "    return 0;\n"
+                "}\n"
+                "int spin(const char* args, const gpi_native_action_host* host) {\n"
+                "    (void)args;\n"
+                "    while (!host->should_stop(host->context)) { usleep(10000); }\n"
+                "    return 9;\n"
+                "}\n"
+                "int crash(const char* args, const gpi_native_action_host* host) {\n"
+                "    (void)args; (void)host; raise(SIGSEGV); return 0;\n"
+                "}\n",
+                encoding="utf-8",
+            )
+            compiled = subprocess.run(
+                [compiler, "-shared", "-fPIC", "-I", str(self.repo_root / "src" / "platform"), "-o", "plugin.so", "plugin.c"],
+                cwd=repo_path,
+                capture_output=True,
+                text=True,
+            )
+            self.assertEqual(compiled.returncode, 0, msg=compiled.stderr)
+            catalog_path = repo_path / "config" / "actions" / f"{app_id}.actions.json"
+            catalog = json.loads(catalog_path.read_text(encoding="utf-8"))
+            catalog["actions"].extend(
+                [
+                    {"name": "native_echo", "type": "native", "library": "plugin.so", "symbol": "echo"},
+                    {"name": "native_echo_forked", "type": "native", "library": "plugin.so", "symbol": "echo", "isolation": "fork"},
+                    {"name": "native_spin", "type": "native", "library": "plugin.so", "symbol": "spin", "timeoutSeconds": 1},
+                    {"name": "native_crash", "type": "native", "library": "plugin.so", "symbol": "crash", "isolation": "fork"},
+                ]
+            )
+            catalog_path.write_text(json.dumps(catalog, indent=2) + "\n", encoding="utf-8")
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                jobs = {}
+                for name in ("native_echo", "native_echo_forked", "native_spin", "native_crash"):
+                    invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": name, "args": {"mode": "x"}})
+                    jobs[name] = self._wait_job_terminal(endpoint, app_id, str(invoke_payload.get("jobId") or ""))
+
+                self.assertEqual(jobs["native_echo"].get("state"), "succeeded", msg=str(jobs["native_echo"]))
+                self.assertEqual(jobs["native_echo"]["result"], {"args": {"mode": "x"}, "pid": host.pid})
+                self.assertEqual(jobs["native_echo"].get("stdout"), "hello\n")
+                self.assertEqual(jobs["native_echo_forked"].get("state"), "succeeded")
+                self.assertNotEqual(jobs["native_echo_forked"]["result"]["pid"], host.pid)
+                self.assertEqual(jobs["native_spin"].get("state"), "timeout")
+                self.assertEqual(jobs["native_crash"].get("state"), "failed")
+                self.assertIn("signal", str(jobs["native_crash"].get("error")))
+                self.assertIsNone(host.poll())
+            finally:
+                self._stop_host(host)
+
+    def test_action_job_nonzero_exit_has_combined_stdout_and_empty_stderr(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "run_fail_exit7", "args": {}})
+                job_id = str(invoke_payload.get("jobId") or "")
+                self.assertTrue(job_id)
+
+                job_payload = self._wait_job_terminal(endpoint, app_id, job_id)
+                self.assertEqual(job_payload.get("state"), "failed")
+
+                stdout_text = str(job_payload.get("stdout") or "")
+                stderr_text = str(job_payload.get("stderr") or "")
+
+                self.assertIn("stdout-line", stdout_text)
+                self.assertIn("stderr-line", stdout_text)
+                self.assertEqual("", stderr_text)
+            finally:
+                self._stop_host(host)
+
+    def test_action_job_cancel_terminates_running_job(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "run_sleep", "args": {}})
+                job_id = str(invoke_payload.get("jobId") or "")
+                self.assertTrue(job_id)
+
+                cancel_payload = self._request(endpoint, "action.job.cancel", {"appId": app_id, "jobId": job_id})
+                self.assertTrue(cancel_payload.get("canceled"))
+
+                job_payload = self._wait_job_terminal(endpoint, app_id, job_id, timeout_seconds=10.0)
+                self.assertEqual(job_payload.get("state"), "canceled")
+                self.assertTrue(job_payload.get("canceledAt"))
+                self.assertEqual((job_payload.get("error") or {}).get("code"), "E_ACTION_CANCELED")
+
+                missing = self._request_raw(endpoint, "action.job.cancel", {"appId": app_id, "jobId": "job-does-not-exist"})
+                self.assertFalse(bool(missing.get("ok", False)))
+                self.assertEqual((missing.get("error") or {}).get("code"), "E_NOT_FOUND")
+            finally:
+                self._stop_host(host)
+
+    def test_action_job_output_pages_spilled_stdout(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "run_big_output", "args": {}})
+                job_id = str(invoke_payload.get("jobId") or "")
+                self.assertTrue(job_id)
+
+                job_payload = self._wait_job_terminal(endpoint, app_id, job_id)
+                self.assertEqual(job_payload.get("state"), "succeeded")
+                expected = "".join("line %06d\n" % index for index in range(20000))
+                self.assertEqual(job_payload.get("stdoutBytes"), len(expected))
+                self.assertTrue(job_payload.get("stdoutTruncated"))
+                self.assertTrue(expected.endswith(str(job_payload.get("stdout") or "")))
+
+                collected = ""
+                offset = 0
+                for _ in range(100):
+                    page = self._request(endpoint, "action.job.output", {"appId": app_id, "jobId": job_id, "offset": offset, "maxBytes": 50000})
+                    self.assertEqual(page.get("offset"), offset)
+                    collected += str(page.get("data") or "")
+                    offset = int(page.get("nextOffset") or 0)
+                    if page.get("complete"):
+                        break
+                self.assertEqual(collected, expected)
+            finally:
+                self._stop_host(host)
+
+    def test_action_job_retention_prunes_oldest_jobs(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id, {"actionJobRetention": {"apps": {app_id: {"maxCount": 2}}}})
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                job_ids = []
+                for _ in range(4):
+                    invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "run_echo", "args": {}})
+                    job_ids.append(str(invoke_payload.get("jobId") or ""))
+                    self._wait_job_terminal(endpoint, app_id, job_ids[-1])
+
+                jobs_dir = repo_path / "runtime" / "custom-jobs" / app_id
+                deadline = time.time() + 5.0
+                while time.time() < deadline and len(list(jobs_dir.glob("*.json"))) > 2:
+                    time.sleep(0.05)
+                self.assertEqual(sorted(path.stem for path in jobs_dir.glob("*.json")), sorted(job_ids[2:]))
+
+                pruned = self._request_raw(endpoint, "action.job.get", {"appId": app_id, "jobId": job_ids[0]})
+                self.assertEqual((pruned.get("error") or {}).get("code"), "E_NOT_FOUND")
+                latest = self._request(endpoint, "action.job.get", {"appId": app_id, "jobId": job_ids[-1]})
+                self.assertEqual(latest.get("state"), "succeeded")
+            finally:
+                self._stop_host(host)
+
+    def test_action_job_list_filters_and_pages(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+
+            endpoint = _pick_endpoint()
+            host = subprocess.Popen(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                self._wait_ready(endpoint)
+
+                job_ids = []
+                for action_name in ("run_echo", "run_fail_exit7", "run_echo"):
+                    invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": action_name, "args": {}})
+                    job_ids.append(str(invoke_payload.get("jobId") or ""))
+                    self._wait_job_terminal(endpoint, app_id, job_ids[-1])
+
+                failed = self._request(endpoint, "action.job.list", {"appId": app_id, "state": "failed"})
+                self.assertEqual([job.get("jobId") for job in failed.get("jobs", [])], [job_ids[1]])
+                self.assertEqual(failed["jobs"][0].get("actionName"), "run_fail_exit7")
+                self.assertNotIn("stdout", failed["jobs"][0])
+                self.assertIsNone(failed.get("nextCursor"))
+
+                first_page = self._request(endpoint, "action.job.list", {"appId": app_id, "actionName": "run_echo", "limit": 1})
+                self.assertEqual([job.get("jobId") for job in first_page.get("jobs", [])], [job_ids[2]])
+                second_page = self._request(
+                    endpoint,
+                    "action.job.list",
+                    {"appId": app_id, "actionName": "run_echo", "limit": 1, "cursor": first_page.get("nextCursor")},
+                )
+                self.assertEqual([job.get("jobId") for job in second_page.get("jobs", [])], [job_ids[0]])
+                self.assertIsNone(second_page.get("nextCursor"))
+
+                bad_since = self._request_raw(endpoint, "action.job.list", {"appId": app_id, "since": "yesterday"})
+                self.assertEqual((bad_since.get("error") or {}).get("code"), "E_BAD_ARG")
+            finally:
+                self._stop_host(host)
+
+    def test_action_job_log_store_survives_restart(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            repo_path = Path(tmp_dir)
+            app_id = "bridge"
+            self._write_fixture_repo(repo_path, app_id)
+            profile_path = repo_path / "host.profile.json"
+            self._write_profile(profile_path, app_id)
+            profile = json.loads(profile_path.read_text(encoding="utf-8"))
+            profile["paths"]["actionJobStore"] = "log"
+            profile_path.write_text(json.dumps(profile, indent=2) + "\n", encoding="utf-8")
+
+            jobs_dir = repo_path / "runtime" / "custom-jobs" / app_id
+            job_id = ""
+            for _ in range(2):
+                endpoint = _pick_endpoint()
+                host = subprocess.Popen(
+                    [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--ipc-endpoint", endpoint],
+                    stdout=subprocess.PIPE,
+                    stderr=subprocess.PIPE,
+                    text=True,
+                )
+                try:
+                    self._wait_ready(endpoint)
+                    if not job_id:
+                        invoke_payload = self._request(endpoint, "action.invoke", {"appId": app_id, "actionName": "run_echo", "args": {}})
+                        job_id = str(invoke_payload.get("jobId") or "")
+                        self._wait_job_terminal(endpoint, app_id, job_id)
+
+                    job_payload = self._request(endpoint, "action.job.get", {"appId": app_id, "jobId": job_id})
+                    self.assertEqual(job_payload.get("state"), "succeeded")
+                finally:
+                    self._stop_host(host)
+
+            self.assertEqual(list(jobs_dir.glob("*.json")), [])
+            self.assertTrue(list((jobs_dir / "journal").glob("segment-*.log")))
+
+            export = subprocess.run(
+                [str(self.host_path), "--repo", str(repo_path), "--host-config", str(profile_path), "--export-action-jobs"],
+                capture_output=True,
+                text=True,
+                timeout=30,
+            )
+            self.assertEqual(export.returncode, 0, msg=export.stderr)
+            exported = json.loads((jobs_dir / f"{job_id}.json").read_text(encoding="utf-8"))
+            self.assertEqual(exported.get("state"), "succeeded")
+
 
 if __name__ == "__main__":
     unittest.main()